@@ -0,0 +1,405 @@
+/*******************************************************************************************
+*
+*   raylib Superman vs Batman - Treasure Race
+*   Native port of batmanvssuperman-small_basic/int2.sb (rules live in bvs_engine.c)
+*   Features:
+*   - Turn-based race to the treasure: Superman on the arrow keys, Batman on WASD
+*   - Either hero can be played by the AI (minimax search, see bvs_engine.h)
+*   - Running score across rounds
+*   - Main menu and how-to-play screen
+*   - The original's Mongolian text, when a Cyrillic font is found (glyphatlas.h)
+*
+********************************************************************************************/
+#include "platform.h"
+#include "assets.h"
+#include "bvs_engine.h"
+#include "glyphatlas.h"
+#include "pacing.h"
+#include "scenes.h"
+#include "store.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_MENU_ITEMS   5
+#define AI_SEARCH_DEPTH  6
+#define AI_MOVE_DELAY   0.25f       // Seconds between AI moves, so they can be followed
+#define UI_FONT_FILE    "ui_font.ttf"   // Copied in by the build when it finds one (GAMES_UI_FONT)
+#define UI_FONT_SIZE       32
+
+typedef enum UiString {
+    UI_SUBTITLE = 0,
+    UI_START_GAME,
+    UI_HOW_TO_PLAY,
+    UI_SUPERMAN_AI,
+    UI_SUPERMAN_PLAYER,
+    UI_BATMAN_AI,
+    UI_BATMAN_PLAYER,
+    UI_EXIT,
+    UI_SUPERMAN,
+    UI_BATMAN,
+    UI_SUPERMAN_TURN,
+    UI_BATMAN_TURN,
+    UI_SUPERMAN_WINS,
+    UI_BATMAN_WINS,
+    UI_DRAW,
+    UI_SUPERMAN_KEYS,
+    UI_BATMAN_KEYS,
+    UI_GOAL,
+    UI_SCORE,
+    UI_STRING_COUNT
+} UiString;
+
+// English, and the Mongolian of int2.sb where it has the string
+static const char *uiStrings[UI_STRING_COUNT][2] = {
+    { "Erdenesiin Uraldaan", "Эрдэнэсийн Уралдаан" },
+    { "START GAME", "ТОГЛООМ ЭХЛҮҮЛЭХ" },
+    { "HOW TO PLAY", "ТОГЛООМЫН ЗААВАР" },
+    { "SUPERMAN: AI", "СУПЕРМЕН: КОМПЬЮТЕР" },
+    { "SUPERMAN: PLAYER", "СУПЕРМЕН: ТОГЛОГЧ" },
+    { "BATMAN: AI", "БЭТМЕН: КОМПЬЮТЕР" },
+    { "BATMAN: PLAYER", "БЭТМЕН: ТОГЛОГЧ" },
+    { "EXIT", "ГАРАХ" },
+    { "Superman", "Супермен" },
+    { "Batman", "Бэтмен" },
+    { "SUPERMAN'S TURN", "СУПЕРМЕН-Ы ЭЭЛЖ" },
+    { "BATMAN'S TURN", "БЭТМЕН-Ы ЭЭЛЖ" },
+    { "SUPERMAN WINS!", "СУПЕРМЕН ХОЖЛОО!" },
+    { "BATMAN WINS!", "БЭТМЕН ХОЖЛОО!" },
+    { "DRAW", "ТЭНЦЛЭЭ" },
+    { "- Superman moves with the ARROW KEYS", "- Супермен: СУМНЫ ТОВЧУУДААР ХӨДӨЛНӨ" },
+    { "- Batman moves with W A S D", "- Бэтмен: WASD ТОВЧУУДААР ХӨДӨЛНӨ" },
+    { "- First to get within 100 px of the treasure WINS!", "- ТҮРҮҮЛЖ ЭРДЭНЭСИЙГ АВАХ НЬ ХОЖНО!" },
+    { "SCORE", "ОНОО" }
+};
+
+//------------------------------------------------------------------------------------
+// Global Variables
+//------------------------------------------------------------------------------------
+static const int screenWidth = 900;
+static const int screenHeight = 600;
+
+static int menuItemSelected = 0;
+
+// Game state
+static BvsGame game = { 0 };
+static BvsRng rng = { 0 };
+static bool aiControlled[2] = { false, true };     // Indexed by BvsHero
+static float aiTimer = 0.0f;
+static int score[2] = { 0 };         // Kept between runs (store.h)
+
+// Telemetry (see telemetry.h)
+static TelemetryMetric *roundsStarted = NULL;
+static TelemetryMetric *aiMoveTime = NULL;
+
+// Graphics
+static GlyphAtlas *uiFont = NULL;      // NULL: no Cyrillic font, English in raylib's default font
+static AssetHandle supermanTexture;
+static AssetHandle batmanTexture;
+static AssetHandle treasureTexture;
+
+//------------------------------------------------------------------------------------
+// Function Declarations
+//------------------------------------------------------------------------------------
+static void LoadUiFont(void);
+static void LoadScores(void);
+static const char *GetUiString(UiString id);
+static void DrawLabel(const char *text, int posX, int posY, int fontSize, Color color);
+static int MeasureLabel(const char *text, int fontSize);
+static void LoadRoundAssets(void);
+static bool IsRoundReady(void);
+static void UnloadRoundAssets(void);
+static void StartRound(void);
+static void UpdateMenu(void);
+static void UpdateHowToPlay(void);
+static void UpdateRound(void);
+static void DrawMenu(void);
+static void DrawHowToPlay(void);
+static void DrawRound(void);
+
+//------------------------------------------------------------------------------------
+// Screens (scenes.h): the heroes load while the menu is up
+//------------------------------------------------------------------------------------
+static const Scene roundScene = {
+    .name = "round", .preload = LoadRoundAssets, .isReady = IsRoundReady, .enter = StartRound,
+    .update = UpdateRound, .draw = DrawRound, .unload = UnloadRoundAssets };
+static const Scene menuScene = { .name = "menu", .update = UpdateMenu, .draw = DrawMenu, .next = &roundScene };
+static const Scene howToPlayScene = { .name = "how to play", .update = UpdateHowToPlay, .draw = DrawHowToPlay };
+
+//------------------------------------------------------------------------------------
+// Program Entry Point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    InitWindow(screenWidth, screenHeight, "Superman vs Batman - Treasure Race");
+    InitAssets(0);
+    InitTelemetry("bvs");
+    MountAssetPack("resources.pak");
+    LoadScores();
+    LoadUiFont();
+
+    roundsStarted = RegisterTelemetryCounter("games_rounds_total", "Games started");
+    aiMoveTime = RegisterTelemetryHistogram("bvs_ai_move_seconds", "Time the AI takes to choose a move", 1e-9);
+
+#if defined(PLATFORM_HEADLESS)
+    // Headless runs replay GAMES_HEADLESS_SEED exactly, so the golden-frame tests see the same AI
+    SeedBvsRng(&rng, (unsigned long long)GetRandomValue(0, 0x7FFFFFFF));
+#else
+    SeedBvsRng(&rng, (unsigned long long)time(NULL) ^ (unsigned long long)GetRandomValue(0, 0x7FFFFFFF));
+#endif
+
+    InitFramePacing(60);
+    InitScenes(&menuScene, SCENE_TRANSITION_SECONDS);
+    RunScenes();
+
+    CloseScenes();
+    UnloadGlyphAtlas(uiFont);
+    CloseStore();
+    CloseTelemetry();
+    CloseAssets();
+    CloseWindow();
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------------
+// UI text
+//------------------------------------------------------------------------------------
+// Every string the game can show is rasterized now, so glyphs never load mid-game
+// GAMES_UI_FONT names another file; set empty, the English fallback is forced (the golden-frame test)
+void LoadUiFont(void)
+{
+    const char *fileName = getenv("GAMES_UI_FONT");
+    if (fileName == NULL) fileName = UI_FONT_FILE;
+    if ((fileName[0] == '\0') || !FileExists(fileName)) return;
+
+    uiFont = LoadGlyphAtlas(fileName, UI_FONT_SIZE);
+    if (uiFont == NULL) return;
+
+    char ascii[96] = { 0 };
+    for (int i = 0; i < 95; i++) ascii[i] = (char)(' ' + i);
+
+    CacheAtlasText(uiFont, ascii);
+    for (int i = 0; i < UI_STRING_COUNT; i++) CacheAtlasText(uiFont, uiStrings[i][1]);
+}
+
+const char *GetUiString(UiString id) { return uiStrings[id][(uiFont != NULL)? 1 : 0]; }
+
+void DrawLabel(const char *text, int posX, int posY, int fontSize, Color color)
+{
+    if (uiFont != NULL) DrawAtlasText(uiFont, text, (Vector2){ (float)posX, (float)posY }, (float)fontSize, 1.0f, color);
+    else DrawText(text, posX, posY, fontSize, color);
+}
+
+int MeasureLabel(const char *text, int fontSize)
+{
+    return (uiFont != NULL)? (int)MeasureAtlasText(uiFont, text, (float)fontSize, 1.0f).x : MeasureText(text, fontSize);
+}
+
+//------------------------------------------------------------------------------------
+// Score
+//------------------------------------------------------------------------------------
+// The running score carries over from the last run; each win is saved as it happens
+void LoadScores(void)
+{
+    int64_t wins = 0;
+
+    OpenStore("bvs");
+    if (GetStoreValue("superman", &wins)) score[BVS_SUPERMAN] = (int)wins;
+    if (GetStoreValue("batman", &wins)) score[BVS_BATMAN] = (int)wins;
+}
+
+//------------------------------------------------------------------------------------
+// Update
+//------------------------------------------------------------------------------------
+// Missing images are drawn as plain boxes (DrawHero()), so only loading ones hold the round back
+void LoadRoundAssets(void)
+{
+    supermanTexture = RequestTexture("resources/bvs_superman.png");
+    batmanTexture = RequestTexture("resources/bvs_batman.png");
+    treasureTexture = RequestTexture("resources/bvs_treasure.png");
+}
+
+bool IsRoundReady(void)
+{
+    return (GetAssetState(supermanTexture) != ASSET_LOADING) && (GetAssetState(batmanTexture) != ASSET_LOADING) &&
+           (GetAssetState(treasureTexture) != ASSET_LOADING);
+}
+
+void UnloadRoundAssets(void)
+{
+    ReleaseAsset(supermanTexture);
+    ReleaseAsset(batmanTexture);
+    ReleaseAsset(treasureTexture);
+}
+
+// StartGame: new treasure and spawn points, Superman moves first as in the original
+void StartRound(void)
+{
+    InitBvsGame(&game, &rng, BVS_SUPERMAN);
+    aiTimer = 0.0f;
+    AddTelemetryCount(roundsStarted, 1);
+}
+
+void UpdateMenu(void)
+{
+    if (IsKeyPressed(KEY_DOWN)) menuItemSelected = (menuItemSelected + 1) % MAX_MENU_ITEMS;
+    if (IsKeyPressed(KEY_UP)) menuItemSelected = (menuItemSelected - 1 + MAX_MENU_ITEMS) % MAX_MENU_ITEMS;
+
+    if (IsKeyPressed(KEY_ENTER))
+    {
+        switch (menuItemSelected)
+        {
+            case 0: SwitchScene(&roundScene); break;
+            case 1: PushScene(&howToPlayScene); break;
+            case 2: aiControlled[BVS_SUPERMAN] = !aiControlled[BVS_SUPERMAN]; break;
+            case 3: aiControlled[BVS_BATMAN] = !aiControlled[BVS_BATMAN]; break;
+            case 4: QuitScenes(); break;
+        }
+    }
+}
+
+void UpdateHowToPlay(void)
+{
+    if (IsKeyPressed(KEY_C) || IsKeyPressed(KEY_ENTER)) PopScene();
+}
+
+// OnKeyDown: refused moves (walls, too close to the other hero) are ignored
+void UpdateRound(void)
+{
+    if (game.result != BVS_PLAYING)
+    {
+        if (IsKeyPressed(KEY_ENTER)) StartRound();
+        if (IsKeyPressed(KEY_C)) SwitchScene(&menuScene);
+        return;
+    }
+
+    if (IsKeyPressed(KEY_C))
+    {
+        SwitchScene(&menuScene);
+        return;
+    }
+
+    BvsMove moves[4];
+    if ((GetBvsLegalMoves(&game, moves) == 1) && (moves[0] == BVS_MOVE_PASS))
+    {
+        ApplyBvsMove(&game, BVS_MOVE_PASS);
+    }
+    else if (aiControlled[game.turn])
+    {
+        aiTimer += GetFrameTime();
+        if (aiTimer >= AI_MOVE_DELAY)
+        {
+            aiTimer = 0.0f;
+            uint64_t searchStart = GetTelemetryTicks();
+            BvsMove move = ChooseBvsMove(&game, BVS_POLICY_MINIMAX, AI_SEARCH_DEPTH, &rng);
+            RecordTelemetrySince(aiMoveTime, searchStart);
+            ApplyBvsMove(&game, move);
+        }
+    }
+    else if (game.turn == BVS_SUPERMAN)
+    {
+        if (IsKeyPressed(KEY_LEFT)) ApplyBvsMove(&game, BVS_MOVE_LEFT);
+        else if (IsKeyPressed(KEY_RIGHT)) ApplyBvsMove(&game, BVS_MOVE_RIGHT);
+        else if (IsKeyPressed(KEY_UP)) ApplyBvsMove(&game, BVS_MOVE_UP);
+        else if (IsKeyPressed(KEY_DOWN)) ApplyBvsMove(&game, BVS_MOVE_DOWN);
+    }
+    else
+    {
+        if (IsKeyPressed(KEY_A)) ApplyBvsMove(&game, BVS_MOVE_LEFT);
+        else if (IsKeyPressed(KEY_D)) ApplyBvsMove(&game, BVS_MOVE_RIGHT);
+        else if (IsKeyPressed(KEY_W)) ApplyBvsMove(&game, BVS_MOVE_UP);
+        else if (IsKeyPressed(KEY_S)) ApplyBvsMove(&game, BVS_MOVE_DOWN);
+    }
+
+    if (game.result == BVS_SUPERMAN_WINS) SetStoreValue("superman", ++score[BVS_SUPERMAN]);
+    else if (game.result == BVS_BATMAN_WINS) SetStoreValue("batman", ++score[BVS_BATMAN]);
+
+    // Forced passes play on the next frame, AI moves once their delay runs out
+    if (game.result == BVS_PLAYING)
+    {
+        if ((GetBvsLegalMoves(&game, moves) == 1) && (moves[0] == BVS_MOVE_PASS)) KeepFramesActive(0.0f);
+        else if (aiControlled[game.turn]) ScheduleFrameWake(AI_MOVE_DELAY - aiTimer);
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Draw
+//------------------------------------------------------------------------------------
+void DrawMenu(void)
+{
+    ClearBackground(WHITE);
+    const char *menuItems[MAX_MENU_ITEMS] = {
+        GetUiString(UI_START_GAME),
+        GetUiString(UI_HOW_TO_PLAY),
+        GetUiString(aiControlled[BVS_SUPERMAN]? UI_SUPERMAN_AI : UI_SUPERMAN_PLAYER),
+        GetUiString(aiControlled[BVS_BATMAN]? UI_BATMAN_AI : UI_BATMAN_PLAYER),
+        GetUiString(UI_EXIT)
+    };
+
+    DrawLabel("Superman VS Batman", screenWidth/2 - MeasureLabel("Superman VS Batman", 40)/2, 60, 40, DARKBLUE);
+    DrawLabel(GetUiString(UI_SUBTITLE), screenWidth/2 - MeasureLabel(GetUiString(UI_SUBTITLE), 20)/2, 110, 20, DARKBLUE);
+
+    for (int i = 0; i < MAX_MENU_ITEMS; i++)
+    {
+        Rectangle button = { 300, 180 + i*60, 300, 40 };
+        DrawRectangleRec(button, (i == menuItemSelected)? DARKBLUE : LIGHTGRAY);
+        DrawLabel(menuItems[i], (int)(button.x + button.width/2) - MeasureLabel(menuItems[i], 20)/2, (int)button.y + 10, 20, (i == menuItemSelected)? WHITE : DARKGRAY);
+    }
+
+    const char *scoreText = FrameFormat("%s  %s %i : %i %s", GetUiString(UI_SCORE), GetUiString(UI_SUPERMAN), score[BVS_SUPERMAN], score[BVS_BATMAN], GetUiString(UI_BATMAN));
+    DrawLabel(scoreText, screenWidth/2 - MeasureLabel(scoreText, 20)/2, 500, 20, GRAY);
+    DrawLabel("Use ARROW KEYS to navigate, ENTER to select",
+             screenWidth/2 - MeasureLabel("Use ARROW KEYS to navigate, ENTER to select", 20)/2, screenHeight - 40, 20, GRAY);
+}
+
+void DrawHowToPlay(void)
+{
+    ClearBackground(WHITE);
+    DrawLabel(GetUiString(UI_HOW_TO_PLAY), screenWidth/2 - MeasureLabel(GetUiString(UI_HOW_TO_PLAY), 40)/2, 40, 40, DARKBLUE);
+
+    DrawLabel(GetUiString(UI_SUPERMAN_KEYS), 60, 130, 25, DARKGRAY);
+    DrawLabel(GetUiString(UI_BATMAN_KEYS), 60, 170, 25, DARKGRAY);
+    DrawLabel("- Turns alternate, one 20 px step each, Superman first", 60, 210, 25, DARKGRAY);
+    DrawLabel("- Heroes cannot come closer than 60 px to each other", 60, 250, 25, DARKGRAY);
+    DrawLabel(GetUiString(UI_GOAL), 60, 290, 25, DARKGRAY);
+    DrawLabel("- C returns to the menu", 60, 330, 25, DARKGRAY);
+
+    DrawLabel("Press C to return to menu", screenWidth/2 - MeasureLabel("Press C to return to menu", 20)/2, screenHeight - 50, 20, GRAY);
+}
+
+static void DrawHero(AssetHandle handle, BvsPoint position, Color fallback)
+{
+    Texture2D texture = GetAssetTexture(handle);
+    if (texture.id > 0) DrawTextureEx(texture, (Vector2){ (float)position.x, (float)position.y }, 0.0f, 1.0f, WHITE);
+    else DrawRectangle(position.x, position.y, 88, 40, fallback);
+}
+
+void DrawRound(void)
+{
+    ClearBackground(WHITE);
+    // Top bar
+    DrawRectangle(0, 0, screenWidth, 40, DARKBLUE);
+    const char *batmanScore = FrameFormat("%s %i", GetUiString(UI_BATMAN), score[BVS_BATMAN]);
+    DrawLabel(FrameFormat("%s %i", GetUiString(UI_SUPERMAN), score[BVS_SUPERMAN]), 10, 10, 20, WHITE);
+    DrawLabel(batmanScore, screenWidth - 10 - MeasureLabel(batmanScore, 20), 10, 20, WHITE);
+
+    const char *turnText = GetUiString((game.turn == BVS_SUPERMAN)? UI_SUPERMAN_TURN : UI_BATMAN_TURN);
+    if (game.result == BVS_PLAYING) DrawLabel(turnText, screenWidth/2 - MeasureLabel(turnText, 20)/2, 10, 20, WHITE);
+
+    DrawHero(treasureTexture, game.treasure, GOLD);
+    DrawHero(supermanTexture, game.hero[BVS_SUPERMAN], BLUE);
+    DrawHero(batmanTexture, game.hero[BVS_BATMAN], DARKGRAY);
+
+    if (game.result != BVS_PLAYING)
+    {
+        const char *winnerMessage = GetUiString((game.result == BVS_SUPERMAN_WINS)? UI_SUPERMAN_WINS : (game.result == BVS_BATMAN_WINS)? UI_BATMAN_WINS : UI_DRAW);
+
+        DrawRectangle(200, 200, 500, 150, DARKBLUE);
+        DrawLabel(winnerMessage, screenWidth/2 - MeasureLabel(winnerMessage, 32)/2, 240, 32, GOLD);
+        DrawLabel("ENTER: play again    C: menu", screenWidth/2 - MeasureLabel("ENTER: play again    C: menu", 20)/2, 300, 20, WHITE);
+    }
+}
@@ -0,0 +1,427 @@
+/*******************************************************************************************
+*
+*   Superman vs Batman treasure race: rules, placement and AI
+*
+*   Placement samples each hero directly from the cells it may occupy: the spawn rectangle
+*   minus one or two excluded discs. Every row holds at most two excluded intervals, so the
+*   allowed cells of a row are counted from precomputed disc half-widths and a uniform index
+*   over all of them is mapped back to (x, y) in one pass over the rows the discs touch (at
+*   most 302 of 500). Unlike the rejection loop in StartGame this cannot spin. The hero
+*   placed first is chosen at random so neither side is favoured by the order.
+*
+*   The AI evaluates positions with the number of steps each hero needs to reach capture
+*   range on an empty board, read from a table built once per process.
+*
+********************************************************************************************/
+#include "bvs_engine.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define SPAWN_WIDTH     (BVS_SPAWN_MAX_X - BVS_SPAWN_MIN_X + 1)
+#define SPAWN_HEIGHT    (BVS_SPAWN_MAX_Y - BVS_SPAWN_MIN_Y + 1)
+#define STEPS_TABLE_DX  (BVS_BOUNDS_MAX_X - BVS_SPAWN_MIN_X)     // Largest |x - treasure.x| + 1
+#define STEPS_TABLE_DY  SPAWN_HEIGHT                            // Largest |y - treasure.y| + 1
+#define SCORE_WIN       100000
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ExcludedDisc {
+    BvsPoint center;
+    int radius;                     // Cells with distance <= radius are excluded
+    const short *halfWidths;        // Per |dy|: excluded cells either side of center.x
+} ExcludedDisc;
+
+typedef struct SearchContext {
+    BvsHero hero;                   // Side the AI plays
+    bool expectimax;                // Opponent nodes average instead of minimise
+} SearchContext;
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static const BvsPoint moveDelta[4] = { { -BVS_STEP, 0 }, { BVS_STEP, 0 }, { 0, -BVS_STEP }, { 0, BVS_STEP } };
+
+static unsigned char stepsTable[STEPS_TABLE_DY][STEPS_TABLE_DX];
+static short treasureGapWidths[BVS_SPAWN_TREASURE_GAP + 1];
+static short heroGapWidths[BVS_SPAWN_HERO_GAP + 1];
+static pthread_once_t tablesOnce = PTHREAD_ONCE_INIT;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static int DistanceSquared(BvsPoint a, BvsPoint b)
+{
+    return (a.x - b.x)*(a.x - b.x) + (a.y - b.y)*(a.y - b.y);
+}
+
+static int IntegerSqrt(int value)
+{
+    int root = (int)sqrt((double)value);
+    while (root*root > value) root--;
+    while ((root + 1)*(root + 1) <= value) root++;
+    return root;
+}
+
+// Minimum a + b such that (dx - 20a)^2 + (dy - 20b)^2 < capture^2; overshooting is allowed
+static int ComputeSteps(int dx, int dy)
+{
+    int best = 255;
+
+    for (int a = 0; a <= dx/BVS_STEP + 1; a++)
+    {
+        int rx = abs(dx - a*BVS_STEP);
+        if (rx >= BVS_CAPTURE_RADIUS) continue;
+
+        int reach = IntegerSqrt(BVS_CAPTURE_RADIUS*BVS_CAPTURE_RADIUS - 1 - rx*rx);
+        int b = (dy > reach)? (dy - reach + BVS_STEP - 1)/BVS_STEP : 0;
+        if ((abs(dy - b*BVS_STEP) <= reach) && (a + b < best)) best = a + b;
+    }
+
+    return best;
+}
+
+static void BuildTables(void)
+{
+    for (int dy = 0; dy < STEPS_TABLE_DY; dy++)
+    {
+        for (int dx = 0; dx < STEPS_TABLE_DX; dx++) stepsTable[dy][dx] = (unsigned char)ComputeSteps(dx, dy);
+    }
+
+    for (int dy = 0; dy <= BVS_SPAWN_TREASURE_GAP; dy++) treasureGapWidths[dy] = (short)IntegerSqrt(BVS_SPAWN_TREASURE_GAP*BVS_SPAWN_TREASURE_GAP - dy*dy);
+    for (int dy = 0; dy <= BVS_SPAWN_HERO_GAP; dy++) heroGapWidths[dy] = (short)IntegerSqrt(BVS_SPAWN_HERO_GAP*BVS_SPAWN_HERO_GAP - dy*dy);
+}
+
+// Excluded x intervals of one spawn row, clipped, sorted and merged; returns the allowed cell count
+static int GetRowIntervals(int y, const ExcludedDisc *discs, int discCount, int *low, int *high, int *intervalCount)
+{
+    int count = 0;
+
+    for (int i = 0; i < discCount; i++)
+    {
+        int dy = abs(y - discs[i].center.y);
+        if (dy > discs[i].radius) continue;
+
+        int halfWidth = discs[i].halfWidths[dy];
+        int l = discs[i].center.x - halfWidth;
+        int h = discs[i].center.x + halfWidth;
+        if (l < BVS_SPAWN_MIN_X) l = BVS_SPAWN_MIN_X;
+        if (h > BVS_SPAWN_MAX_X) h = BVS_SPAWN_MAX_X;
+        if (l > h) continue;
+
+        low[count] = l;
+        high[count] = h;
+        count++;
+    }
+
+    if ((count == 2) && (low[1] < low[0]))
+    {
+        int t = low[0]; low[0] = low[1]; low[1] = t;
+        t = high[0]; high[0] = high[1]; high[1] = t;
+    }
+    if ((count == 2) && (low[1] <= high[0] + 1))
+    {
+        if (high[1] > high[0]) high[0] = high[1];
+        count = 1;
+    }
+
+    int allowed = SPAWN_WIDTH;
+    for (int i = 0; i < count; i++) allowed -= high[i] - low[i] + 1;
+
+    *intervalCount = count;
+    return allowed;
+}
+
+// Uniform over the spawn rectangle minus the discs (at most 2). Only the rows the discs touch
+// are counted one by one; the full rows above and below them are skipped arithmetically.
+static BvsPoint SampleOutsideDiscs(BvsRng *rng, const ExcludedDisc *discs, int discCount)
+{
+    int rowAllowed[SPAWN_HEIGHT];
+    int low[2] = { 0 }, high[2] = { 0 }, intervalCount = 0;
+
+    int first = SPAWN_HEIGHT;
+    int last = -1;
+    for (int i = 0; i < discCount; i++)
+    {
+        int top = discs[i].center.y - discs[i].radius - BVS_SPAWN_MIN_Y;
+        int bottom = discs[i].center.y + discs[i].radius - BVS_SPAWN_MIN_Y;
+        if (top < first) first = (top > 0)? top : 0;
+        if (bottom > last) last = (bottom < SPAWN_HEIGHT - 1)? bottom : SPAWN_HEIGHT - 1;
+    }
+
+    int total = (SPAWN_HEIGHT - (last - first + 1))*SPAWN_WIDTH;
+    for (int row = first; row <= last; row++)
+    {
+        rowAllowed[row] = GetRowIntervals(BVS_SPAWN_MIN_Y + row, discs, discCount, low, high, &intervalCount);
+        total += rowAllowed[row];
+    }
+
+    int index = (int)GetBvsRandom(rng, (unsigned int)total);
+    int row = 0;
+    if (index < first*SPAWN_WIDTH) row = index/SPAWN_WIDTH;
+    else
+    {
+        index -= first*SPAWN_WIDTH;
+        row = first;
+        while ((row <= last) && (index >= rowAllowed[row])) index -= rowAllowed[row++];
+        if (row > last) row += index/SPAWN_WIDTH;
+    }
+    index %= SPAWN_WIDTH;
+
+    BvsPoint point = { BVS_SPAWN_MIN_X + index, BVS_SPAWN_MIN_Y + row };
+    GetRowIntervals(point.y, discs, discCount, low, high, &intervalCount);
+    for (int i = 0; i < intervalCount; i++)
+    {
+        if (point.x >= low[i]) point.x += high[i] - low[i] + 1;
+    }
+
+    return point;
+}
+
+static bool IsMoveLegal(const BvsGame *game, BvsMove move)
+{
+    BvsPoint from = game->hero[game->turn];
+    BvsPoint to = { from.x + moveDelta[move].x, from.y + moveDelta[move].y };
+
+    if ((to.x <= BVS_BOUNDS_MIN_X) || (to.x >= BVS_BOUNDS_MAX_X) || (to.y <= BVS_BOUNDS_MIN_Y) || (to.y >= BVS_BOUNDS_MAX_Y)) return false;
+    return DistanceSquared(to, game->hero[1 - game->turn]) >= BVS_COLLISION_RADIUS*BVS_COLLISION_RADIUS;
+}
+
+// CheckTreasure(): Superman is tested first whoever just moved
+static void CheckTreasure(BvsGame *game)
+{
+    const int capture = BVS_CAPTURE_RADIUS*BVS_CAPTURE_RADIUS;
+
+    if (DistanceSquared(game->hero[BVS_SUPERMAN], game->treasure) < capture) game->result = BVS_SUPERMAN_WINS;
+    else if (DistanceSquared(game->hero[BVS_BATMAN], game->treasure) < capture) game->result = BVS_BATMAN_WINS;
+    else if (game->moves >= BVS_MAX_MOVES) game->result = BVS_DRAW;
+}
+
+static int GetHeroSteps(const BvsGame *game, BvsHero hero)
+{
+    return GetBvsStepsToTreasure(game->hero[hero], game->treasure);
+}
+
+// From Superman's side: step difference, plus half a step of tempo for the side to move
+static int Evaluate(const BvsGame *game)
+{
+    int lead = GetHeroSteps(game, BVS_BATMAN) - GetHeroSteps(game, BVS_SUPERMAN);
+    return 2*lead + ((game->turn == BVS_SUPERMAN)? 1 : -1);
+}
+
+// Children ordered by the mover's remaining steps so alpha-beta sees the likely best first
+static int GetOrderedChildren(const BvsGame *game, BvsMove *moves, BvsGame *children)
+{
+    int count = GetBvsLegalMoves(game, moves);
+    int keys[4];
+
+    for (int i = 0; i < count; i++)
+    {
+        children[i] = *game;
+        ApplyBvsMove(&children[i], moves[i]);
+        keys[i] = GetHeroSteps(&children[i], game->turn);
+    }
+
+    for (int i = 1; i < count; i++)
+    {
+        for (int j = i; (j > 0) && (keys[j] < keys[j - 1]); j--)
+        {
+            int key = keys[j]; keys[j] = keys[j - 1]; keys[j - 1] = key;
+            BvsMove move = moves[j]; moves[j] = moves[j - 1]; moves[j - 1] = move;
+            BvsGame child = children[j]; children[j] = children[j - 1]; children[j - 1] = child;
+        }
+    }
+
+    return count;
+}
+
+// Value from the AI hero's side. Wins are worth more the sooner they come.
+static float Search(const BvsGame *game, int depth, int ply, float alpha, float beta, const SearchContext *context)
+{
+    if (game->result != BVS_PLAYING)
+    {
+        if (game->result == BVS_DRAW) return 0.0f;
+        bool won = ((game->result == BVS_SUPERMAN_WINS) == (context->hero == BVS_SUPERMAN));
+        return won? (float)(SCORE_WIN - ply) : (float)(ply - SCORE_WIN);
+    }
+    if (depth == 0) return (float)((context->hero == BVS_SUPERMAN)? Evaluate(game) : -Evaluate(game));
+
+    BvsMove moves[4];
+    BvsGame children[4];
+    int count = GetOrderedChildren(game, moves, children);
+
+    if (game->turn == context->hero)
+    {
+        float best = -(float)SCORE_WIN*2.0f;
+        for (int i = 0; i < count; i++)
+        {
+            float value = Search(&children[i], depth - 1, ply + 1, alpha, beta, context);
+            if (value > best) best = value;
+            if (best > alpha) alpha = best;
+            if (alpha >= beta) break;
+        }
+        return best;
+    }
+
+    if (context->expectimax)
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < count; i++) sum += Search(&children[i], depth - 1, ply + 1, -(float)SCORE_WIN*2.0f, (float)SCORE_WIN*2.0f, context);
+        return sum/(float)count;
+    }
+
+    float best = (float)SCORE_WIN*2.0f;
+    for (int i = 0; i < count; i++)
+    {
+        float value = Search(&children[i], depth - 1, ply + 1, alpha, beta, context);
+        if (value < best) best = value;
+        if (best < beta) beta = best;
+        if (alpha >= beta) break;
+    }
+    return best;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+// splitmix64: one add and three mixes per draw, good enough for placement and playouts
+void SeedBvsRng(BvsRng *rng, unsigned long long seed)
+{
+    rng->state = seed;
+}
+
+unsigned int GetBvsRandom(BvsRng *rng, unsigned int range)
+{
+    unsigned long long z = (rng->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+    z ^= z >> 31;
+
+    return (unsigned int)(((z >> 32)*(unsigned long long)range) >> 32);
+}
+
+void InitBvsGame(BvsGame *game, BvsRng *rng, BvsHero first)
+{
+    pthread_once(&tablesOnce, BuildTables);
+
+    game->treasure.x = BVS_SPAWN_MIN_X + (int)GetBvsRandom(rng, SPAWN_WIDTH);
+    game->treasure.y = BVS_SPAWN_MIN_Y + (int)GetBvsRandom(rng, SPAWN_HEIGHT);
+
+    ExcludedDisc discs[2] = { { game->treasure, BVS_SPAWN_TREASURE_GAP, treasureGapWidths }, { { 0 }, BVS_SPAWN_HERO_GAP, heroGapWidths } };
+    BvsHero placedFirst = (BvsHero)GetBvsRandom(rng, 2);
+
+    game->hero[placedFirst] = SampleOutsideDiscs(rng, discs, 1);
+    discs[1].center = game->hero[placedFirst];
+    game->hero[1 - placedFirst] = SampleOutsideDiscs(rng, discs, 2);
+
+    game->turn = first;
+    game->first = first;
+    game->result = BVS_PLAYING;
+    game->moves = 0;
+}
+
+int GetBvsLegalMoves(const BvsGame *game, BvsMove *moves)
+{
+    int count = 0;
+    for (int move = BVS_MOVE_LEFT; move <= BVS_MOVE_DOWN; move++)
+    {
+        if (IsMoveLegal(game, (BvsMove)move)) moves[count++] = (BvsMove)move;
+    }
+
+    if (count == 0) moves[count++] = BVS_MOVE_PASS;
+    return count;
+}
+
+bool ApplyBvsMove(BvsGame *game, BvsMove move)
+{
+    if (game->result != BVS_PLAYING) return false;
+
+    if (move == BVS_MOVE_PASS)
+    {
+        BvsMove moves[4];
+        if ((GetBvsLegalMoves(game, moves) != 1) || (moves[0] != BVS_MOVE_PASS)) return false;
+    }
+    else
+    {
+        if (!IsMoveLegal(game, move)) return false;
+        game->hero[game->turn].x += moveDelta[move].x;
+        game->hero[game->turn].y += moveDelta[move].y;
+    }
+
+    game->turn = (BvsHero)(1 - game->turn);
+    game->moves++;
+    CheckTreasure(game);
+
+    return true;
+}
+
+int GetBvsStepsToTreasure(BvsPoint position, BvsPoint treasure)
+{
+    int dx = abs(position.x - treasure.x);
+    int dy = abs(position.y - treasure.y);
+
+    if ((dx < STEPS_TABLE_DX) && (dy < STEPS_TABLE_DY))
+    {
+        pthread_once(&tablesOnce, BuildTables);
+        return stepsTable[dy][dx];
+    }
+    return ComputeSteps(dx, dy);
+}
+
+BvsMove ChooseBvsMove(const BvsGame *game, BvsPolicy policy, int depth, BvsRng *rng)
+{
+    BvsMove moves[4];
+    BvsGame children[4];
+    int count = GetOrderedChildren(game, moves, children);
+    if (count == 1) return moves[0];
+
+    switch (policy)
+    {
+        case BVS_POLICY_RANDOM: return moves[GetBvsRandom(rng, (unsigned int)count)];
+        case BVS_POLICY_GREEDY:
+        {
+            // Children are sorted by steps: pick at random among the equally short ones
+            int ties = 1;
+            int best = GetHeroSteps(&children[0], game->turn);
+            while ((ties < count) && (GetHeroSteps(&children[ties], game->turn) == best)) ties++;
+            return moves[GetBvsRandom(rng, (unsigned int)ties)];
+        }
+        default: break;
+    }
+
+    if (depth < 1) depth = 1;
+    if (depth > BVS_MAX_SEARCH_DEPTH) depth = BVS_MAX_SEARCH_DEPTH;
+
+    SearchContext context = { game->turn, (policy == BVS_POLICY_EXPECTIMAX) };
+    float alpha = -(float)SCORE_WIN*2.0f;
+    BvsMove best = moves[0];
+
+    for (int i = 0; i < count; i++)
+    {
+        float value = Search(&children[i], depth - 1, 1, alpha, (float)SCORE_WIN*2.0f, &context);
+        if (value > alpha)
+        {
+            alpha = value;
+            best = moves[i];
+        }
+    }
+
+    return best;
+}
+
+const char *GetBvsPolicyName(BvsPolicy policy)
+{
+    switch (policy)
+    {
+        case BVS_POLICY_RANDOM: return "random";
+        case BVS_POLICY_GREEDY: return "greedy";
+        case BVS_POLICY_MINIMAX: return "minimax";
+        case BVS_POLICY_EXPECTIMAX: return "expectimax";
+        default: return "?";
+    }
+}
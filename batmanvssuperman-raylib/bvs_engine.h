@@ -0,0 +1,103 @@
+/*******************************************************************************************
+*
+*   Superman vs Batman treasure race: rules, placement and AI (no raylib dependency)
+*
+*   Port of batmanvssuperman-small_basic/int2.sb with the same rules:
+*       - heroes move 20 px per turn, one of four directions, turns alternate
+*       - a move must stay inside 20 < x < 840, 60 < y < 540 and end at least 60 px from
+*         the other hero, otherwise it is refused and the same hero moves again
+*       - after every move, the first hero (Superman checked first) within 100 px of the
+*         treasure wins
+*       - treasure and heroes spawn at 21..820 x 51..550, heroes more than 100 px apart and
+*         more than 50 px from the treasure
+*   Positions are the top-left corners of the sprites, as in Shapes.Move().
+*
+*   Two additions the original could not need: a hero with no legal move passes (the Small
+*   Basic version simply hangs), and a game is drawn after BVS_MAX_MOVES turns so AI-vs-AI
+*   batches always terminate. All distance checks compare squared integers.
+*
+********************************************************************************************/
+#ifndef BVS_ENGINE_H
+#define BVS_ENGINE_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define BVS_STEP                    20
+#define BVS_COLLISION_RADIUS        60
+#define BVS_CAPTURE_RADIUS         100
+#define BVS_BOUNDS_MIN_X            20      // Exclusive bounds for a move
+#define BVS_BOUNDS_MAX_X           840
+#define BVS_BOUNDS_MIN_Y            60
+#define BVS_BOUNDS_MAX_Y           540
+#define BVS_SPAWN_MIN_X             21      // Inclusive spawn area (GetRandomNumber(800) + 20)
+#define BVS_SPAWN_MAX_X            820
+#define BVS_SPAWN_MIN_Y             51      // GetRandomNumber(500) + 50
+#define BVS_SPAWN_MAX_Y            550
+#define BVS_SPAWN_HERO_GAP         100      // Heroes spawn strictly further apart than this
+#define BVS_SPAWN_TREASURE_GAP      50      // ...and strictly further than this from the treasure
+#define BVS_MAX_MOVES             1000
+#define BVS_MAX_SEARCH_DEPTH        16
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum BvsHero { BVS_SUPERMAN = 0, BVS_BATMAN = 1 } BvsHero;
+
+typedef enum BvsMove {
+    BVS_MOVE_LEFT = 0,
+    BVS_MOVE_RIGHT,
+    BVS_MOVE_UP,
+    BVS_MOVE_DOWN,
+    BVS_MOVE_PASS                   // Only legal when no direction is
+} BvsMove;
+
+typedef enum BvsResult {
+    BVS_PLAYING = 0,
+    BVS_SUPERMAN_WINS,
+    BVS_BATMAN_WINS,
+    BVS_DRAW                        // BVS_MAX_MOVES reached
+} BvsResult;
+
+typedef enum BvsPolicy {
+    BVS_POLICY_RANDOM = 0,          // Uniform over legal moves
+    BVS_POLICY_GREEDY,              // Fewest steps to the treasure, ignoring the opponent
+    BVS_POLICY_MINIMAX,             // Alpha-beta against a perfect opponent
+    BVS_POLICY_EXPECTIMAX           // Against an opponent moving uniformly at random
+} BvsPolicy;
+
+typedef struct BvsPoint { int x; int y; } BvsPoint;
+
+typedef struct BvsGame {
+    BvsPoint hero[2];               // Indexed by BvsHero
+    BvsPoint treasure;
+    BvsHero turn;
+    BvsHero first;                  // Who moved first
+    BvsResult result;
+    int moves;
+} BvsGame;
+
+typedef struct BvsRng { unsigned long long state; } BvsRng;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void SeedBvsRng(BvsRng *rng, unsigned long long seed);
+unsigned int GetBvsRandom(BvsRng *rng, unsigned int range);     // [0, range)
+
+void InitBvsGame(BvsGame *game, BvsRng *rng, BvsHero first);    // Place treasure and heroes (bounded work, no retry loop)
+int GetBvsLegalMoves(const BvsGame *game, BvsMove *moves);      // Up to 4; a single BVS_MOVE_PASS when stuck
+bool ApplyBvsMove(BvsGame *game, BvsMove move);                 // false (state unchanged) if the move is refused
+int GetBvsStepsToTreasure(BvsPoint position, BvsPoint treasure); // Moves needed to get within capture range, alone on the board
+BvsMove ChooseBvsMove(const BvsGame *game, BvsPolicy policy, int depth, BvsRng *rng);
+
+const char *GetBvsPolicyName(BvsPolicy policy);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // BVS_ENGINE_H
@@ -0,0 +1,231 @@
+/*******************************************************************************************
+*
+*   bvs-sim - headless batch simulation of the Superman vs Batman treasure race
+*
+*   Usage: bvs-sim [--games N] [--seed S] [--threads T] [--first superman|batman|alternate]
+*                  [--superman POLICY] [--batman POLICY]
+*
+*   POLICY is random, greedy, minimax[:depth] or expectimax[:depth] (default depth 4).
+*   Game i is seeded from (seed, i) alone, so results do not depend on the thread count.
+*   Besides the win counts it reports the first mover's win rate with a 95% interval and how
+*   often the hero that needed fewer steps at the start (the moving one on a tie) went on to
+*   win, i.e. how much of the outcome is decided by placement alone.
+*
+********************************************************************************************/
+#include "bvs_engine.h"
+
+#define PLATFORM_OS_ONLY
+#include "platform.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_SIM_THREADS     64
+#define DEFAULT_DEPTH        4
+
+typedef enum FirstMover { FIRST_SUPERMAN = 0, FIRST_BATMAN, FIRST_ALTERNATE } FirstMover;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct PlayerConfig {
+    BvsPolicy policy;
+    int depth;
+} PlayerConfig;
+
+typedef struct SimConfig {
+    long long games;
+    unsigned long long seed;
+    FirstMover first;
+    PlayerConfig player[2];         // Indexed by BvsHero
+} SimConfig;
+
+typedef struct SimResult {
+    long long wins[2];              // Indexed by BvsHero
+    long long draws;
+    long long firstMoverWins;
+    long long favouriteWins;        // Won by the hero with fewer starting steps
+    long long totalMoves;
+} SimResult;
+
+typedef struct SimTask {
+    const SimConfig *config;
+    long long begin;
+    long long end;
+    SimResult result;
+    pthread_t thread;
+} SimTask;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static unsigned long long MixSeed(unsigned long long seed, unsigned long long index)
+{
+    unsigned long long z = seed + 0x9E3779B97F4A7C15ULL*(index + 1);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static void PlayGame(const SimConfig *config, long long index, SimResult *result)
+{
+    BvsRng rng;
+    SeedBvsRng(&rng, MixSeed(config->seed, (unsigned long long)index));
+
+    BvsHero first = (config->first == FIRST_ALTERNATE)? (BvsHero)(index & 1) : (BvsHero)config->first;
+    BvsGame game;
+    InitBvsGame(&game, &rng, first);
+
+    // The hero that would arrive first on an empty board, the mover winning ties
+    int steps[2] = { GetBvsStepsToTreasure(game.hero[0], game.treasure), GetBvsStepsToTreasure(game.hero[1], game.treasure) };
+    BvsHero favourite = (steps[first] <= steps[1 - first])? first : (BvsHero)(1 - first);
+
+    while (game.result == BVS_PLAYING)
+    {
+        const PlayerConfig *player = &config->player[game.turn];
+        ApplyBvsMove(&game, ChooseBvsMove(&game, player->policy, player->depth, &rng));
+    }
+
+    result->totalMoves += game.moves;
+    if (game.result == BVS_DRAW)
+    {
+        result->draws++;
+        return;
+    }
+
+    BvsHero winner = (game.result == BVS_SUPERMAN_WINS)? BVS_SUPERMAN : BVS_BATMAN;
+    result->wins[winner]++;
+    if (winner == first) result->firstMoverWins++;
+    if (winner == favourite) result->favouriteWins++;
+}
+
+static void *SimMain(void *arg)
+{
+    SimTask *task = (SimTask *)arg;
+    for (long long i = task->begin; i < task->end; i++) PlayGame(task->config, i, &task->result);
+    return NULL;
+}
+
+static bool ParsePlayer(const char *text, PlayerConfig *player)
+{
+    static const BvsPolicy policies[] = { BVS_POLICY_RANDOM, BVS_POLICY_GREEDY, BVS_POLICY_MINIMAX, BVS_POLICY_EXPECTIMAX };
+
+    for (int i = 0; i < 4; i++)
+    {
+        const char *name = GetBvsPolicyName(policies[i]);
+        size_t length = strlen(name);
+        if ((strncmp(text, name, length) != 0) || ((text[length] != '\0') && (text[length] != ':'))) continue;
+
+        player->policy = policies[i];
+        player->depth = (text[length] == ':')? atoi(text + length + 1) : DEFAULT_DEPTH;
+        return player->depth > 0;
+    }
+
+    return false;
+}
+
+static double WallTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+
+static void PrintRate(const char *label, long long count, long long total)
+{
+    printf("  %-28s %12lld  %6.2f%%\n", label, count, (total > 0)? 100.0*(double)count/(double)total : 0.0);
+}
+
+//------------------------------------------------------------------------------------
+// Program Entry Point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    static const char *firstNames[] = { "superman", "batman", "alternate" };
+
+    SimConfig config = { 100000, 1, FIRST_SUPERMAN, { { BVS_POLICY_GREEDY, DEFAULT_DEPTH }, { BVS_POLICY_GREEDY, DEFAULT_DEPTH } } };
+    int threadCount = GetCpuCount();
+    bool ok = true;
+
+    for (int i = 1; ok && (i < argc); i++)
+    {
+        const char *value = (i + 1 < argc)? argv[i + 1] : NULL;
+        ok = (value != NULL);
+        if (!ok) break;
+
+        if (strcmp(argv[i], "--games") == 0) config.games = atoll(value);
+        else if (strcmp(argv[i], "--seed") == 0) config.seed = strtoull(value, NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0) threadCount = atoi(value);
+        else if (strcmp(argv[i], "--superman") == 0) ok = ParsePlayer(value, &config.player[BVS_SUPERMAN]);
+        else if (strcmp(argv[i], "--batman") == 0) ok = ParsePlayer(value, &config.player[BVS_BATMAN]);
+        else if (strcmp(argv[i], "--first") == 0)
+        {
+            ok = false;
+            for (int f = 0; f < 3; f++)
+            {
+                if (strcmp(value, firstNames[f]) == 0) { config.first = (FirstMover)f; ok = true; }
+            }
+        }
+        else ok = false;
+        i++;
+    }
+
+    if (!ok || (config.games <= 0))
+    {
+        fprintf(stderr, "usage: bvs-sim [--games N] [--seed S] [--threads T] [--first superman|batman|alternate]\n"
+                        "               [--superman POLICY] [--batman POLICY]\n"
+                        "       POLICY: random | greedy | minimax[:depth] | expectimax[:depth]\n");
+        return 1;
+    }
+
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > MAX_SIM_THREADS) threadCount = MAX_SIM_THREADS;
+    if (threadCount > config.games) threadCount = (int)config.games;
+
+    static SimTask tasks[MAX_SIM_THREADS];
+    double start = WallTime();
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        tasks[t] = (SimTask){ &config, config.games*t/threadCount, config.games*(t + 1)/threadCount, { { 0 } } };
+        if ((t > 0) && (pthread_create(&tasks[t].thread, NULL, SimMain, &tasks[t]) != 0)) SimMain(&tasks[t]);
+    }
+    SimMain(&tasks[0]);
+
+    SimResult total = { { 0 } };
+    for (int t = 0; t < threadCount; t++)
+    {
+        if (t > 0) pthread_join(tasks[t].thread, NULL);
+        total.wins[0] += tasks[t].result.wins[0];
+        total.wins[1] += tasks[t].result.wins[1];
+        total.draws += tasks[t].result.draws;
+        total.firstMoverWins += tasks[t].result.firstMoverWins;
+        total.favouriteWins += tasks[t].result.favouriteWins;
+        total.totalMoves += tasks[t].result.totalMoves;
+    }
+
+    double elapsed = WallTime() - start;
+    long long decided = total.wins[0] + total.wins[1];
+    double firstRate = (decided > 0)? (double)total.firstMoverWins/(double)decided : 0.0;
+    double margin = (decided > 0)? 1.96*sqrt(firstRate*(1.0 - firstRate)/(double)decided) : 0.0;
+
+    printf("bvs-sim: %lld games, superman=%s batman=%s, first=%s, seed %llu, %i threads, %.2f s (%.2f us/game)\n",
+           config.games, GetBvsPolicyName(config.player[0].policy), GetBvsPolicyName(config.player[1].policy),
+           firstNames[config.first], config.seed, threadCount, elapsed, 1e6*elapsed/(double)config.games);
+    PrintRate("superman wins", total.wins[BVS_SUPERMAN], config.games);
+    PrintRate("batman wins", total.wins[BVS_BATMAN], config.games);
+    PrintRate("draws", total.draws, config.games);
+    PrintRate("first mover wins (decided)", total.firstMoverWins, decided);
+    printf("  %-28s %12s  +/-%.2f%% (95%%)\n", "", "", 100.0*margin);
+    PrintRate("fewer starting steps wins", total.favouriteWins, decided);
+    printf("  %-28s %12.1f\n", "mean game length (moves)", (double)total.totalMoves/(double)config.games);
+
+    return 0;
+}
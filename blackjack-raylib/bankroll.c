@@ -0,0 +1,595 @@
+/*******************************************************************************************
+*
+*   Bankroll engine, see bankroll.h
+*
+*   The iteration runs on the ruin probability U = 1 - V rather than V: with a favourable
+*   game most balances are within 1e-12 of a sure win, and U keeps those digits where V
+*   would round them to 1.0. The recurrence becomes
+*       U(b) = min over x of [win*U(b + payout*x) + loss*U(b - x)]/(1 - push)
+*   with U(0) = 1 and U(>= goal) = 0.
+*
+*   Both terms are kept in layouts that make the bets of one state contiguous: U(b - x) is
+*   read from the grid stored back to front, U(b + payout*x) from the grid split by residue
+*   modulo the payout. The inner min is then two streaming loads per lane.
+*
+********************************************************************************************/
+#include "bankroll.h"
+
+#define PLATFORM_OS_ONLY            // Also built into blackjack-bankroll, which links no raylib
+#include "platform.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_BANKROLL_THREADS    64
+#define MAX_BANKROLL_STATES     (1 << 20)
+
+#define CARD_KINDS              10          // Ace, 2..9, ten-valued
+#define DEALER_STANDS           17
+#define HAND_MEMO_SIZE          (1 << 17)   // Power of two, well above the reachable hands
+
+#define TIE_TOLERANCE           1e-12       // Relative: bets this close to the best count as equal
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct HandMemo {
+    uint64_t key;                   // Player hand and upcard, +1 so that 0 marks an empty slot
+    HandOdds odds;
+} HandMemo;
+
+typedef struct HandSolver {
+    int deck[CARD_KINDS];           // Cards not yet seen by the player (the hole card included)
+    int cards;
+    int payout;
+    HandMemo *memo;
+} HandSolver;
+
+typedef struct Sweep Sweep;
+
+typedef struct SweepWorker {
+    Sweep *sweep;
+    pthread_t thread;
+    int from, to;                   // States [from, to)
+    double change;                  // Largest relative change in the last sweep
+} SweepWorker;
+
+struct Sweep {
+    const BankrollConfig *config;
+    int last;                       // goal/unit: the state index of the goal
+    int residueLength;
+    double win, loss;               // Normalised over the hands that are not pushes
+    const int *policy;              // Fixed bet per state, or NULL to minimise over all bets
+
+    double *ruin;                   // Indexed by state
+    double *next;
+    double *reverse;                // reverse[last - b] = ruin[b]
+    double *residue;                // residue[(b % payout)*residueLength + b/payout] = ruin[b]
+
+    SweepWorker workers[MAX_BANKROLL_THREADS];
+    int threads;
+    pthread_mutex_t start;          // Held while the threads that did start get their share
+    pthread_barrier_t barrier;
+    bool done;
+    int sweeps;
+};
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions: hand odds
+//----------------------------------------------------------------------------------
+static int GetCardPoints(int kind)
+{
+    return kind + 1;                // Aces count 1 here, soft totals add 10 once
+}
+
+static int GetHandValue(int hard, int aces)
+{
+    return ((aces > 0) && (hard + 10 <= 21))? hard + 10 : hard;
+}
+
+// Final dealer totals 17..21 in outcome[0..4], busts in outcome[5]
+static void DrawDealer(HandSolver *solver, int hard, int aces, double probability, double outcome[6])
+{
+    int value = GetHandValue(hard, aces);
+    if (value >= DEALER_STANDS)
+    {
+        outcome[(value > 21)? 5 : value - DEALER_STANDS] += probability;
+        return;
+    }
+
+    double share = probability/solver->cards;
+    for (int kind = 0; kind < CARD_KINDS; kind++)
+    {
+        if (solver->deck[kind] == 0) continue;
+
+        double p = share*solver->deck[kind];
+        solver->deck[kind]--;
+        solver->cards--;
+        DrawDealer(solver, hard + GetCardPoints(kind), aces + (kind == 0), p, outcome);
+        solver->deck[kind]++;
+        solver->cards++;
+    }
+}
+
+static HandOdds GetStandOdds(HandSolver *solver, int playerValue, int upcard)
+{
+    double outcome[6] = { 0 };
+    DrawDealer(solver, GetCardPoints(upcard), (upcard == 0), 1.0, outcome);
+
+    HandOdds odds = { outcome[5], 0.0, 0.0 };
+    for (int total = DEALER_STANDS; total <= 21; total++)
+    {
+        double p = outcome[total - DEALER_STANDS];
+        if (total < playerValue) odds.win += p;
+        else if (total == playerValue) odds.push += p;
+        else odds.loss += p;
+    }
+
+    return odds;
+}
+
+static double GetHandReturn(const HandOdds *odds, int payout)
+{
+    return payout*odds->win - odds->loss;
+}
+
+// Best of hit and stand for the hand held, memoised on its composition: the order the
+// cards came in does not change what is left in the deck
+static HandOdds PlayHand(HandSolver *solver, const int hand[CARD_KINDS], int hard, int aces, int upcard)
+{
+    if (hard > 21) return (HandOdds){ 0.0, 0.0, 1.0 };
+
+    uint64_t key = (uint64_t)upcard;
+    for (int kind = 0; kind < CARD_KINDS; kind++) key = (key << 5) | (uint64_t)hand[kind];
+    key++;
+
+    uint64_t slot = (key*0x9E3779B97F4A7C15ULL) >> (64 - 17);
+    while ((solver->memo[slot].key != 0) && (solver->memo[slot].key != key)) slot = (slot + 1) & (HAND_MEMO_SIZE - 1);
+    if (solver->memo[slot].key == key) return solver->memo[slot].odds;
+
+    HandOdds best = GetStandOdds(solver, GetHandValue(hard, aces), upcard);
+
+    // Hitting hard 21 always busts; every other hand is worth working out
+    if (hard < 21)
+    {
+        HandOdds hit = { 0.0, 0.0, 0.0 };
+        int next[CARD_KINDS];
+        memcpy(next, hand, sizeof(next));
+
+        int cards = solver->cards;
+        for (int kind = 0; kind < CARD_KINDS; kind++)
+        {
+            if (solver->deck[kind] == 0) continue;
+
+            double p = (double)solver->deck[kind]/cards;
+            solver->deck[kind]--;
+            solver->cards--;
+            next[kind]++;
+            HandOdds after = PlayHand(solver, next, hard + GetCardPoints(kind), aces + (kind == 0), upcard);
+            next[kind]--;
+            solver->deck[kind]++;
+            solver->cards++;
+
+            hit.win += p*after.win;
+            hit.push += p*after.push;
+            hit.loss += p*after.loss;
+        }
+
+        if (GetHandReturn(&hit, solver->payout) > GetHandReturn(&best, solver->payout)) best = hit;
+    }
+
+    solver->memo[slot] = (HandMemo){ key, best };
+    return best;
+}
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions: value iteration
+//----------------------------------------------------------------------------------
+static double WallTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+
+// min over i < count of win*up[i] + loss*down[i]
+static double MinBetRuin(const double *up, const double *down, int count, double win, double loss)
+{
+    double best = 1.0;
+    int i = 0;
+
+#if defined(__SSE2__)
+    __m128d w = _mm_set1_pd(win);
+    __m128d l = _mm_set1_pd(loss);
+    __m128d best0 = _mm_set1_pd(1.0);
+    __m128d best1 = best0;
+
+    // Two accumulators keep two independent min chains in flight
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128d a = _mm_add_pd(_mm_mul_pd(w, _mm_loadu_pd(up + i)), _mm_mul_pd(l, _mm_loadu_pd(down + i)));
+        __m128d b = _mm_add_pd(_mm_mul_pd(w, _mm_loadu_pd(up + i + 2)), _mm_mul_pd(l, _mm_loadu_pd(down + i + 2)));
+        best0 = _mm_min_pd(best0, a);
+        best1 = _mm_min_pd(best1, b);
+    }
+
+    best0 = _mm_min_pd(best0, best1);
+    best0 = _mm_min_sd(best0, _mm_unpackhi_pd(best0, best0));
+    best = _mm_cvtsd_f64(best0);
+#endif
+
+    for (; i < count; i++)
+    {
+        double ruin = win*up[i] + loss*down[i];
+        if (ruin < best) best = ruin;
+    }
+
+    return best;
+}
+
+static void StoreRuin(Sweep *sweep, const double *ruin)
+{
+    int payout = sweep->config->payout;
+
+    for (int b = 0; b <= sweep->last; b++)
+    {
+        sweep->reverse[sweep->last - b] = ruin[b];
+        sweep->residue[(b % payout)*sweep->residueLength + b/payout] = ruin[b];
+    }
+}
+
+static void *SweepMain(void *argument)
+{
+    SweepWorker *worker = (SweepWorker *)argument;
+    Sweep *sweep = worker->sweep;
+    int payout = sweep->config->payout;
+    int minUnits = sweep->config->minBet/sweep->config->unit;
+    if (minUnits < 1) minUnits = 1;
+
+    pthread_mutex_lock(&sweep->start);
+    pthread_mutex_unlock(&sweep->start);
+    if (sweep->done) return NULL;
+
+    for (;;)
+    {
+        double change = 0.0;
+
+        for (int b = worker->from; b < worker->to; b++)
+        {
+            const double *up = sweep->residue + (b % payout)*sweep->residueLength + b/payout;
+            const double *down = sweep->reverse + (sweep->last - b);
+            double ruin;
+
+            if (sweep->policy != NULL)
+            {
+                int x = sweep->policy[b];
+                ruin = sweep->win*up[x] + sweep->loss*down[x];
+            }
+            else if (b < minUnits) ruin = sweep->win*up[b] + sweep->loss*down[b];     // Only all-in is allowed
+            else ruin = MinBetRuin(up + minUnits, down + minUnits, b - minUnits + 1, sweep->win, sweep->loss);
+
+            double delta = fabs(ruin - sweep->ruin[b]);
+            if (delta > change*ruin) change = (ruin > 0.0)? delta/ruin : change;
+            sweep->next[b] = ruin;
+        }
+
+        worker->change = change;
+        pthread_barrier_wait(&sweep->barrier);
+
+        if (worker == &sweep->workers[0])
+        {
+            double largest = 0.0;
+            for (int t = 0; t < sweep->threads; t++) if (sweep->workers[t].change > largest) largest = sweep->workers[t].change;
+
+            double *swap = sweep->ruin;
+            sweep->ruin = sweep->next;
+            sweep->next = swap;
+            StoreRuin(sweep, sweep->ruin);
+
+            sweep->sweeps++;
+            sweep->done = (largest <= sweep->config->tolerance) || (sweep->sweeps >= sweep->config->maxSweeps);
+        }
+
+        pthread_barrier_wait(&sweep->barrier);
+        if (sweep->done) break;
+    }
+
+    return NULL;
+}
+
+// Iterates until the ruin probabilities settle; result in ruin[0..last]
+static bool RunSweeps(Sweep *sweep, double *ruin, const int *policy)
+{
+    sweep->policy = policy;
+    sweep->done = false;
+    sweep->sweeps = 0;
+
+    for (int b = 0; b <= sweep->last; b++) sweep->ruin[b] = sweep->next[b] = (b == 0)? 1.0 : 0.0;
+    StoreRuin(sweep, sweep->ruin);
+
+    for (int t = 0; t < sweep->threads; t++) sweep->workers[t].sweep = sweep;
+
+    pthread_mutex_lock(&sweep->start);
+    int started = 1;
+    for (; started < sweep->threads; started++)
+    {
+        if (pthread_create(&sweep->workers[started].thread, NULL, SweepMain, &sweep->workers[started]) != 0) break;
+    }
+
+    // Work per state grows with the balance (one candidate per bet): equal areas under it
+    int threads = started;
+    for (int t = 0; t < threads; t++)
+    {
+        SweepWorker *worker = &sweep->workers[t];
+        worker->from = 1 + (int)((sweep->last - 1)*sqrt((double)t/threads));
+        worker->to = 1 + (int)((sweep->last - 1)*sqrt((double)(t + 1)/threads));
+        worker->change = 0.0;
+    }
+
+    bool ok = (pthread_barrier_init(&sweep->barrier, NULL, (unsigned)threads) == 0);
+    if (!ok)
+    {
+        sweep->done = true;         // Nothing to synchronise on: started threads leave at once
+    }
+    sweep->threads = threads;
+    pthread_mutex_unlock(&sweep->start);
+
+    if (ok) SweepMain(&sweep->workers[0]);
+    for (int t = 1; t < started; t++) pthread_join(sweep->workers[t].thread, NULL);
+
+    if (ok) pthread_barrier_destroy(&sweep->barrier);
+    memcpy(ruin, sweep->ruin, (size_t)(sweep->last + 1)*sizeof(double));
+    return ok;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+BankrollConfig GetDefaultBankrollConfig(void)
+{
+    return (BankrollConfig){ .goal = 100000, .unit = 100, .minBet = 100, .payout = 2, .threads = 0, .tolerance = 1e-10, .maxSweeps = 200000 };
+}
+
+// Exact over every deal of a fresh 52-card deck: two player cards, the upcard, then the
+// hole card and all later draws from what is left (the hole card is dealt before the
+// player hits, but unseen it is just another card still in the deck)
+HandOdds ComputeHandOdds(int payout)
+{
+    HandOdds total = { 0.0, 0.0, 0.0 };
+    HandSolver solver = { .cards = 52, .payout = payout };
+    for (int kind = 0; kind < CARD_KINDS; kind++) solver.deck[kind] = (kind == CARD_KINDS - 1)? 16 : 4;
+
+    solver.memo = (HandMemo *)calloc(HAND_MEMO_SIZE, sizeof(HandMemo));
+    if (solver.memo == NULL) return total;
+
+    for (int first = 0; first < CARD_KINDS; first++)
+    {
+        double p1 = (double)solver.deck[first]/solver.cards;
+        solver.deck[first]--;
+        solver.cards--;
+
+        for (int second = 0; second < CARD_KINDS; second++)
+        {
+            if (solver.deck[second] == 0) continue;
+
+            double p2 = p1*solver.deck[second]/solver.cards;
+            solver.deck[second]--;
+            solver.cards--;
+
+            for (int upcard = 0; upcard < CARD_KINDS; upcard++)
+            {
+                if (solver.deck[upcard] == 0) continue;
+
+                double p = p2*solver.deck[upcard]/solver.cards;
+                solver.deck[upcard]--;
+                solver.cards--;
+
+                int hand[CARD_KINDS] = { 0 };
+                hand[first]++;
+                hand[second]++;
+                HandOdds odds = PlayHand(&solver, hand, GetCardPoints(first) + GetCardPoints(second), (first == 0) + (second == 0), upcard);
+                total.win += p*odds.win;
+                total.push += p*odds.push;
+                total.loss += p*odds.loss;
+
+                solver.deck[upcard]++;
+                solver.cards++;
+            }
+
+            solver.deck[second]++;
+            solver.cards++;
+        }
+
+        solver.deck[first]++;
+        solver.cards++;
+    }
+
+    free(solver.memo);
+    return total;
+}
+
+bool SolveBankroll(BankrollTable *table, const BankrollConfig *config, HandOdds odds)
+{
+    memset(table, 0, sizeof(*table));
+    table->config = (config != NULL)? *config : GetDefaultBankrollConfig();
+    table->odds = odds;
+
+    BankrollConfig *c = &table->config;
+    if ((c->unit <= 0) || (c->payout <= 0) || (c->goal < 2*c->unit) || (c->goal/c->unit >= MAX_BANKROLL_STATES)) return false;
+    if (odds.push >= 1.0) return false;
+    if (c->minBet < c->unit) c->minBet = c->unit;
+    if (c->tolerance <= 0.0) c->tolerance = 1e-10;
+    if (c->maxSweeps <= 0) c->maxSweeps = 200000;
+
+    if (c->threads <= 0) c->threads = GetCpuCount();
+    if (c->threads > MAX_BANKROLL_THREADS) c->threads = MAX_BANKROLL_THREADS;
+
+    int last = c->goal/c->unit;
+    int states = last + 1;
+    table->states = states;
+
+    Sweep *sweep = (Sweep *)calloc(1, sizeof(Sweep));
+    if (sweep == NULL) return false;
+
+    pthread_mutex_init(&sweep->start, NULL);
+    sweep->config = c;
+    sweep->last = last;
+    sweep->threads = (c->threads < last - 1)? c->threads : 1;
+    sweep->win = odds.win/(1.0 - odds.push);
+    sweep->loss = odds.loss/(1.0 - odds.push);
+
+    // Winning the largest bet from just below the goal lands at most payout*last states up,
+    // all of them already past the goal
+    sweep->residueLength = last + last/c->payout + 2;
+
+    sweep->ruin = (double *)malloc((size_t)states*sizeof(double));
+    sweep->next = (double *)malloc((size_t)states*sizeof(double));
+    sweep->reverse = (double *)malloc((size_t)states*sizeof(double));
+    sweep->residue = (double *)calloc((size_t)c->payout*sweep->residueLength, sizeof(double));
+    table->chance = (double *)malloc((size_t)states*sizeof(double));
+    table->kellyChance = (double *)malloc((size_t)states*sizeof(double));
+    table->boldChance = (double *)malloc((size_t)states*sizeof(double));
+    table->bestBet = (int *)calloc((size_t)states, sizeof(int));
+    int *policy = (int *)calloc((size_t)states, sizeof(int));
+
+    bool ok = (sweep->ruin != NULL) && (sweep->next != NULL) && (sweep->reverse != NULL) && (sweep->residue != NULL) &&
+              (table->chance != NULL) && (table->kellyChance != NULL) && (table->boldChance != NULL) && (table->bestBet != NULL) && (policy != NULL);
+
+    double start = WallTime();
+    int minUnits = c->minBet/c->unit;
+
+    // Optimal play, then the bets that achieve it (the smallest among equals)
+    ok = ok && RunSweeps(sweep, table->chance, NULL);
+    table->sweeps = sweep->sweeps;
+
+    if (ok)
+    {
+        for (int b = 1; b < last; b++)
+        {
+            const double *up = sweep->residue + (b % c->payout)*sweep->residueLength + b/c->payout;
+            const double *down = sweep->reverse + (last - b);
+            int x = (b < minUnits)? b : minUnits;
+            double best = (b < minUnits)? 0.0 : MinBetRuin(up + x, down + x, b - x + 1, sweep->win, sweep->loss)*(1.0 + TIE_TOLERANCE);
+
+            while ((x < b) && (sweep->win*up[x] + sweep->loss*down[x] > best)) x++;
+            table->bestBet[b] = x;
+        }
+    }
+
+    // Kelly: the growth-optimal fraction f = (payout*p - q)/payout with pushes left out
+    double p = sweep->win, q = sweep->loss;
+    table->kellyFraction = (c->payout*p - q)/c->payout;
+
+    for (int b = 1; ok && (b < last); b++)
+    {
+        int x = (int)lround(table->kellyFraction*b);
+        if (x < minUnits) x = minUnits;
+        if (x > b) x = b;
+        policy[b] = x;
+    }
+    ok = ok && RunSweeps(sweep, table->kellyChance, policy);
+
+    // Bold play: just enough to reach the goal on a win, or everything
+    for (int b = 1; ok && (b < last); b++)
+    {
+        int x = (last - b + c->payout - 1)/c->payout;
+        if (x < minUnits) x = minUnits;
+        if (x > b) x = b;
+        policy[b] = x;
+    }
+    ok = ok && RunSweeps(sweep, table->boldChance, policy);
+
+    // Stored as ruin until here
+    for (int b = 0; ok && (b < states); b++)
+    {
+        table->chance[b] = 1.0 - table->chance[b];
+        table->kellyChance[b] = 1.0 - table->kellyChance[b];
+        table->boldChance[b] = 1.0 - table->boldChance[b];
+    }
+
+    table->seconds = WallTime() - start;
+
+    free(policy);
+    free(sweep->ruin);
+    free(sweep->next);
+    free(sweep->reverse);
+    free(sweep->residue);
+    pthread_mutex_destroy(&sweep->start);
+    free(sweep);
+
+    if (!ok) UnloadBankroll(table);
+    return ok;
+}
+
+void UnloadBankroll(BankrollTable *table)
+{
+    free(table->chance);
+    free(table->kellyChance);
+    free(table->boldChance);
+    free(table->bestBet);
+    memset(table, 0, sizeof(*table));
+}
+
+static int GetBalanceState(const BankrollTable *table, int balance)
+{
+    if (balance <= 0) return 0;
+    if (balance >= table->config.goal) return table->states - 1;
+    return balance/table->config.unit;
+}
+
+double GetBankrollChance(const BankrollTable *table, int balance)
+{
+    if (table->chance == NULL) return 0.0;
+    return table->chance[GetBalanceState(table, balance)];
+}
+
+// One hand at this bet, optimal play afterwards
+double GetBankrollBetChance(const BankrollTable *table, int balance, int bet)
+{
+    if (table->chance == NULL) return 0.0;
+    if ((balance <= 0) || (balance >= table->config.goal)) return GetBankrollChance(table, balance);
+    if (bet > balance) bet = balance;
+    if (bet <= 0) return GetBankrollChance(table, balance);
+
+    return table->odds.win*GetBankrollChance(table, balance + table->config.payout*bet) +
+           table->odds.push*GetBankrollChance(table, balance) +
+           table->odds.loss*GetBankrollChance(table, balance - bet);
+}
+
+int GetBankrollBestBet(const BankrollTable *table, int balance)
+{
+    if (table->bestBet == NULL) return 0;
+    return table->bestBet[GetBalanceState(table, balance)]*table->config.unit;
+}
+
+int GetBankrollKellyBet(const BankrollTable *table, int balance)
+{
+    int units = (int)lround(table->kellyFraction*GetBalanceState(table, balance));
+    int minUnits = table->config.minBet/table->config.unit;
+    if (units < minUnits) units = minUnits;
+
+    int bet = units*table->config.unit;
+    return (bet > balance)? balance : bet;
+}
+
+int GetBankrollBoldBet(const BankrollTable *table, int balance)
+{
+    int payout = table->config.payout;
+    int units = (table->states - 1 - GetBalanceState(table, balance) + payout - 1)/payout;
+    int minUnits = table->config.minBet/table->config.unit;
+    if (units < minUnits) units = minUnits;
+
+    int bet = units*table->config.unit;
+    return (bet > balance)? balance : bet;
+}
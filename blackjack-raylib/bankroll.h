@@ -0,0 +1,79 @@
+/*******************************************************************************************
+*
+*   Bankroll engine: the chance of reaching the goal balance before ruin, and the bet that
+*   maximises it, for every balance of the blackjack game (no raylib dependency)
+*
+*   The rules are those of blackjack.c: a fresh shuffled 52-card deck every round, hit or
+*   stand only, dealer draws to 17 and stands on soft 17, a win pays the bet twice over, a
+*   loss costs the bet, a tie is a push. ComputeHandOdds() gives the exact win/push/loss
+*   distribution of one hand under the expected-value maximising hit/stand strategy (card
+*   removal included).
+*
+*   SolveBankroll() then runs value iteration over the balance grid (goal/unit + 1 states,
+*   0 and goal absorbing, bets from minBet to all-in in unit steps):
+*       V(b) = max over x of [win*V(b + payout*x) + loss*V(b - x)]/(1 - push)
+*   Each sweep splits the grid over threads and the inner max over bets runs on SIMD lanes.
+*   The same iteration evaluates two fixed policies for comparison: Kelly (bet the fraction
+*   of the balance that maximises expected log wealth) and bold play (the smallest bet that
+*   reaches the goal on a win, or all-in).
+*
+********************************************************************************************/
+#ifndef BANKROLL_H
+#define BANKROLL_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct HandOdds {
+    double win;
+    double push;
+    double loss;
+} HandOdds;
+
+typedef struct BankrollConfig {
+    int goal;                       // Balance that wins the game (reaching or passing it)
+    int unit;                       // Grid step: every bet and balance is a multiple
+    int minBet;
+    int payout;                     // Balance gained per unit bet on a win
+    int threads;                    // 0: one per online core
+    double tolerance;               // Stop when no state moves more than this in a sweep
+    int maxSweeps;
+} BankrollConfig;
+
+typedef struct BankrollTable {
+    BankrollConfig config;
+    HandOdds odds;
+    int states;                     // goal/unit + 1
+    double *chance;                 // Optimal probability of reaching the goal, per state
+    int *bestBet;                   // Optimal bet in units (the smallest among equals)
+    double *kellyChance;            // Probability under the Kelly policy
+    double *boldChance;             // Probability under bold play
+    double kellyFraction;
+    int sweeps;                     // Optimal solve only
+    double seconds;
+} BankrollTable;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+BankrollConfig GetDefaultBankrollConfig(void);     // The blackjack.c rules: goal 100000, unit/min bet 100, payout 2
+HandOdds ComputeHandOdds(int payout);
+
+bool SolveBankroll(BankrollTable *table, const BankrollConfig *config, HandOdds odds);
+void UnloadBankroll(BankrollTable *table);
+
+// Queries, balance and bets in currency; O(1)
+double GetBankrollChance(const BankrollTable *table, int balance);
+double GetBankrollBetChance(const BankrollTable *table, int balance, int bet);
+int GetBankrollBestBet(const BankrollTable *table, int balance);
+int GetBankrollKellyBet(const BankrollTable *table, int balance);
+int GetBankrollBoldBet(const BankrollTable *table, int balance);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // BANKROLL_H
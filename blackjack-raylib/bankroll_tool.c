@@ -0,0 +1,78 @@
+/*******************************************************************************************
+*
+*   blackjack-bankroll - solve the 0 -> goal betting problem for a blackjack rule set
+*
+*   Usage: blackjack-bankroll [--goal G] [--unit U] [--min-bet M] [--payout P] [--threads T]
+*                             [--win W --push H --loss L]
+*
+*   Prints the per-hand odds, then for a spread of balances the chance of reaching the goal
+*   under optimal betting (and the bet that does it), the Kelly bet and bold play. Without
+*   --win/--push/--loss the hand odds are worked out exactly for the blackjack.c rules.
+*
+********************************************************************************************/
+#include "bankroll.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------------
+// Program Entry Point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    BankrollConfig config = GetDefaultBankrollConfig();
+    HandOdds odds = { -1.0, -1.0, -1.0 };
+    bool ok = true;
+
+    for (int i = 1; ok && (i < argc); i++)
+    {
+        const char *value = (i + 1 < argc)? argv[i + 1] : NULL;
+        ok = (value != NULL);
+        if (!ok) break;
+
+        if (strcmp(argv[i], "--goal") == 0) config.goal = atoi(value);
+        else if (strcmp(argv[i], "--unit") == 0) config.unit = atoi(value);
+        else if (strcmp(argv[i], "--min-bet") == 0) config.minBet = atoi(value);
+        else if (strcmp(argv[i], "--payout") == 0) config.payout = atoi(value);
+        else if (strcmp(argv[i], "--threads") == 0) config.threads = atoi(value);
+        else if (strcmp(argv[i], "--win") == 0) odds.win = atof(value);
+        else if (strcmp(argv[i], "--push") == 0) odds.push = atof(value);
+        else if (strcmp(argv[i], "--loss") == 0) odds.loss = atof(value);
+        else ok = false;
+        i++;
+    }
+
+    bool given = (odds.win >= 0.0) || (odds.push >= 0.0) || (odds.loss >= 0.0);
+    if (given) ok = ok && (odds.win >= 0.0) && (odds.push >= 0.0) && (odds.loss >= 0.0);
+    else odds = ComputeHandOdds(config.payout);
+
+    BankrollTable table;
+    if (!ok || !SolveBankroll(&table, &config, odds))
+    {
+        fprintf(stderr, "usage: blackjack-bankroll [--goal G] [--unit U] [--min-bet M] [--payout P] [--threads T]\n"
+                        "                          [--win W --push H --loss L]\n");
+        return 1;
+    }
+
+    printf("blackjack-bankroll: goal %i, unit %i, min bet %i, win pays %i:1\n", table.config.goal, table.config.unit, table.config.minBet, table.config.payout);
+    printf("  hand: win %.6f  push %.6f  loss %.6f  (%+.4f per unit bet)\n", odds.win, odds.push, odds.loss, table.config.payout*odds.win - odds.loss);
+    printf("  %i states, %i sweeps on %i threads, %.3f s\n", table.states, table.sweeps, table.config.threads, table.seconds);
+    printf("  Kelly fraction %.4f\n\n", table.kellyFraction);
+    printf("  %10s  %-22s  %-10s  %-22s  %-22s\n", "balance", "optimal", "best bet", "kelly", "bold");
+
+    static const int fractions[] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 800, 950, 990 };
+    for (int f = 0; f < (int)(sizeof(fractions)/sizeof(fractions[0])); f++)
+    {
+        int balance = table.config.goal/1000*fractions[f];
+        balance -= balance % table.config.unit;
+        if (balance <= 0) continue;
+
+        int state = balance/table.config.unit;
+        printf("  %10i  %.16f  %10i  %.16f  %.16f\n", balance, table.chance[state], GetBankrollBestBet(&table, balance),
+               table.kellyChance[state], table.boldChance[state]);
+    }
+
+    UnloadBankroll(&table);
+    return 0;
+}
@@ -1,5 +1,17 @@
-#include "raylib.h"
+#include "platform.h"
+#include "assets.h"
+#include "bankroll.h"
+#include "handlog.h"
+#include "layers.h"
+#include "pacing.h"
+#include "scenes.h"
+#include "settings.h"
+#include "store.h"
+#include "textcache.h"
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <stdbool.h>
 
@@ -16,11 +28,7 @@
 #define INITIAL_BALANCE 10000
 #define DEFAULT_BET 5000
 #define MIN_BET 100
-
-//----------------------------------------------------------------------------------
-// Game states
-//----------------------------------------------------------------------------------
-typedef enum GameScreen { MENU, PLAY, SETTINGS, HOW_TO_PLAY } GameScreen;
+#define GOAL_BALANCE 100000
 
 //----------------------------------------------------------------------------------
 // Structures
@@ -50,29 +58,44 @@ typedef struct BlackjackGame {
 //------------------------------------------------------------------------------------
 static const int screenWidth = 1000;
 static const int screenHeight = 800;
-static GameScreen currentScreen = MENU;
+
+// menu, tohirgoo, zaawar: texture-d neg zurj, oorchlogdohgui bol dahin ashiglana
+static ScreenLayer menuLayer = { 0 };
+static ScreenLayer settingsLayer = { 0 };
+static ScreenLayer howToPlayLayer = { 0 };
 static int menuItemSelected = 0;
 static const char* menuItems[MAX_MENU_ITEMS] = { "PLAY", "HOW TO PLAY", "SETTINGS", "EXIT" };
 
 static BlackjackGame game;
 
 // Resource textures and sounds
-static Texture2D cardBackTexture;
-static Music backgroundMusic;
-static Sound cardSound;
-static Sound winSound;
-static Sound loseSound;
-
-// Settings-iin huwisagch
-static bool isFullscreen = false;
-static bool musicOn = true;
-static float soundVolume = 0.5f; // Range: 0.0f - 1.0f
+static AssetHandle cardBackTexture;
+static AssetHandle backgroundMusic;
+static AssetHandle cardSound;
+static AssetHandle winSound;
+static AssetHandle loseSound;
 
 // Bet-nii huwisagch (round hoorond hadgalagdaad ywna)
 static int playerBalance = INITIAL_BALANCE;
 static int currentBet = DEFAULT_BET;
 static bool betPlaced = false;      // false = bet tawij baigaa; true = round ehelsen
 
+// Bankroll zowlogoo: background thread deer neg udaa bodogdono
+static BankrollTable bankroll;
+static pthread_t bankrollThread;
+static bool bankrollStarted = false;
+static atomic_bool bankrollReady = false;
+
+// Round buriin tuuh (hands/ dotor, background thread bichne)
+static HandLog *handLog = NULL;
+static uint64_t sessionId = 0;
+static uint32_t handNumber = 0;
+
+// Telemetry (telemetry.h): round-iin ur dun, dansnii uurchlult
+static TelemetryMetric *handsPlayed[3] = { NULL };     // HandOutcome-oor
+static TelemetryMetric *balanceChange[3] = { NULL };   // HAND_LOSS, HAND_WIN (push uurchlultgui)
+static TelemetryMetric *balanceGauge = NULL;
+
 //------------------------------------------------------------------------------------
 // Function Declarations
 //------------------------------------------------------------------------------------
@@ -80,10 +103,18 @@ void InitGame(void);
 void ResetRound(void);
 void UpdateGame(void);
 void DrawGame(void);
+void UpdateMenu(void);
 void DrawMenu(void);
+void UpdateHowToPlay(void);
 void DrawHowToPlay(void);
 void DrawSettings(void);
 void UpdateSettings(void);
+void LoadPlayAssets(void);
+bool IsPlayReady(void);
+void StartPlay(void);
+void UpdatePlay(void);
+void DrawPlay(void);
+void UnloadPlayAssets(void);
 void DrawBlackjackGame(void);
 void UpdateBlackjackGame(void);
 void DrawBettingScreen(void);
@@ -93,6 +124,20 @@ int CalculateHandValue(Card hand[], int count);
 void DealCard(Card hand[], int *count, Card deck[], int *deckIndex, bool revealed);
 void CheckWinCondition(void);
 void CheckLoseCondition(void);
+void *SolveBankrollMain(void *argument);
+void LogRound(int balanceBefore, HandOutcome outcome);
+void CountRound(int balanceBefore, HandOutcome outcome);
+uint64_t GetUnixMillis(void);
+
+//------------------------------------------------------------------------------------
+// Delgetsuud (scenes.h): menu haragdaj baihad togloomiin resource-uud unshigdana
+//------------------------------------------------------------------------------------
+static const Scene playScene = {
+    .name = "play", .preload = LoadPlayAssets, .isReady = IsPlayReady, .enter = StartPlay,
+    .update = UpdatePlay, .draw = DrawPlay, .unload = UnloadPlayAssets };
+static const Scene menuScene = { .name = "menu", .update = UpdateMenu, .draw = DrawMenu, .next = &playScene };
+static const Scene settingsScene = { .name = "settings", .update = UpdateSettings, .draw = DrawSettings };
+static const Scene howToPlayScene = { .name = "how to play", .update = UpdateHowToPlay, .draw = DrawHowToPlay };
 
 //------------------------------------------------------------------------------------
 // Main Entry Point
@@ -101,92 +146,61 @@ int main(void)
 {
     // delgets gargana Fullscreen bolgoj bas bolno
     InitWindow(screenWidth, screenHeight, "Blackjack Game");
+    menuLayer = LoadScreenLayer(0, 0, screenWidth, screenHeight);
+    settingsLayer = LoadScreenLayer(0, 0, screenWidth, screenHeight);
+    howToPlayLayer = LoadScreenLayer(0, 0, screenWidth, screenHeight);
     InitAudioDevice();
+    InitMixer(0);
+    InitAssets(0);
+    InitTelemetry("blackjack");
+    MountAssetPack("resources.pak");
 
-    // resource-uud
-    cardBackTexture = LoadTexture("resources/blackjack_card_back.png");
-    backgroundMusic = LoadMusicStream("resources/blackjack_background.wav");
-    cardSound = LoadSound("resources/blackjack_card.wav");
-    winSound = LoadSound("resources/blackjack_win.wav");
-    loseSound = LoadSound("resources/blackjack_lose.wav");
+    handsPlayed[HAND_WIN] = RegisterTelemetryCounter("blackjack_hands_total{outcome=\"win\"}", "Hands played");
+    handsPlayed[HAND_LOSS] = RegisterTelemetryCounter("blackjack_hands_total{outcome=\"loss\"}", "Hands played");
+    handsPlayed[HAND_PUSH] = RegisterTelemetryCounter("blackjack_hands_total{outcome=\"push\"}", "Hands played");
+    balanceChange[HAND_WIN] = RegisterTelemetryHistogram("blackjack_balance_change_chips{outcome=\"win\"}", "Chips won or lost per hand", 1.0);
+    balanceChange[HAND_LOSS] = RegisterTelemetryHistogram("blackjack_balance_change_chips{outcome=\"loss\"}", "Chips won or lost per hand", 1.0);
+    balanceGauge = RegisterTelemetryGauge("blackjack_balance_chips", "Player balance");
 
-    SetMusicVolume(backgroundMusic, soundVolume);
-    PlayMusicStream(backgroundMusic);
+    // duu (background thread deer unshina); togloomiin resource-uud playScene-tei hamt
+    backgroundMusic = RequestMusic("resources/blackjack_background.wav");
 
     // togloomni turul
     betPlaced = false; //bet tawiagu baihad 
     playerBalance = INITIAL_BALANCE; //dansand 10000 ehlene
     currentBet = DEFAULT_BET; //default betnii hemjee 5000
 
-    SetTargetFPS(60);
-    while (!WindowShouldClose())
-    {
-        // Duu
-        UpdateMusicStream(backgroundMusic);
-
-        // delgetsuud hoorond solih
-        switch(currentScreen) {
-            case MENU:
-                // Menu nav
-                if (IsKeyPressed(KEY_DOWN)) menuItemSelected = (menuItemSelected + 1) % MAX_MENU_ITEMS;
-                if (IsKeyPressed(KEY_UP)) menuItemSelected = (menuItemSelected - 1 + MAX_MENU_ITEMS) % MAX_MENU_ITEMS;
-                if (IsKeyPressed(KEY_ENTER))
-                {
-                    switch(menuItemSelected)
-                    {
-                        case 0: // PLAY
-                            currentScreen = PLAY;
-                            betPlaced = false; // betnii delgets toglohoos umnu haruulna
-                            break;
-                        case 1: // HOW TO PLAY
-                            currentScreen = HOW_TO_PLAY;
-                            break;
-                        case 2: // SETTINGS
-                            currentScreen = SETTINGS;
-                            break;
-                        case 3: // EXIT
-                            CloseWindow();
-                            break;
-                    }
-                }
-                break;
-            case HOW_TO_PLAY:
-                if (IsKeyPressed(KEY_C)) currentScreen = MENU; //c darj main menu ruu orno
-                break;
-            case SETTINGS:
-                UpdateSettings();
-                break;
-            case PLAY:
-                if (!betPlaced)
-                    UpdateBettingScreen();
-                else
-                    UpdateBlackjackGame();
-                break;
-            default:
-                break;
-        }
+    // umnuh udaagiin uldegdel (store.h), baihgui bol 10000-aas ehelne
+    int64_t savedBalance = 0;
+    OpenStore("blackjack");
+    if (GetStoreValue("balance", &savedBalance) && (savedBalance > 0) && (savedBalance < GOAL_BALANCE)) playerBalance = (int)savedBalance;
+    SetTelemetryGauge(balanceGauge, playerBalance);
 
-        BeginDrawing();
-            ClearBackground(DARKGREEN);
-            switch(currentScreen) {
-                case MENU: DrawMenu(); break;
-                case HOW_TO_PLAY: DrawHowToPlay(); break;
-                case SETTINGS: DrawSettings(); break;
-                case PLAY: 
-                    // bet tawigdaagui bol betnii delgets haruulna
-                    if (!betPlaced) DrawBettingScreen();
-                    else DrawBlackjackGame();
-                    break;
-            }
-        EndDrawing();
-    }
+    // bet zowlogoonii husnegt (ehnii frame-uudiig saatuulahgui)
+    bankrollStarted = (pthread_create(&bankrollThread, NULL, SolveBankrollMain, NULL) == 0);
+
+    // tuuh bichij chadahgui bol togloom hewiin ywna
+    sessionId = GetUnixMillis();
+    handLog = OpenHandLog("hands", sessionId, 0);
+
+    InitFramePacing(60);
+    InitScenes(&menuScene, SCENE_TRANSITION_SECONDS);
+    SetSceneMusic(backgroundMusic);
+    RunScenes();
 
     // Cleanup
-    UnloadTexture(cardBackTexture);
-    UnloadMusicStream(backgroundMusic);
-    UnloadSound(cardSound);
-    UnloadSound(winSound);
-    UnloadSound(loseSound);
+    CloseScenes();
+    CloseStore();
+    CloseTelemetry();
+    CloseHandLog(handLog);
+    if (bankrollStarted) pthread_join(bankrollThread, NULL);
+    UnloadBankroll(&bankroll);
+    ReleaseAsset(backgroundMusic);
+    UnloadScreenLayer(&menuLayer);
+    UnloadScreenLayer(&settingsLayer);
+    UnloadScreenLayer(&howToPlayLayer);
+    CloseAssets();
+    CloseMixer();
     CloseAudioDevice();
     CloseWindow();
     return 0;
@@ -230,24 +244,34 @@ void ResetRound(void)
     // ur dungees hamaarch uldegdel mungu uurclugdunu.
     game.playerValue = CalculateHandValue(game.playerHand, game.playerCount);
     game.dealerValue = CalculateHandValue(game.dealerHand, game.dealerCount);
+    int balanceBefore = playerBalance;
+    HandOutcome outcome = HAND_PUSH;
         
     if (game.playerBust) {
         // toglogch hojigdwol
         playerBalance -= currentBet;
-        PlaySound(loseSound);
+        outcome = HAND_LOSS;
+        PlayMixerSound(GetAssetSound(loseSound));
     } else if (game.dealerBust || game.playerValue > game.dealerValue) {
         playerBalance = playerBalance + currentBet * 2;
-        PlaySound(winSound);
+        outcome = HAND_WIN;
+        PlayMixerSound(GetAssetSound(winSound));
     } else if (game.dealerValue > game.playerValue) {
         playerBalance -= currentBet;
-        PlaySound(loseSound);
+        outcome = HAND_LOSS;
+        PlayMixerSound(GetAssetSound(loseSound));
     }
     
+    LogRound(balanceBefore, outcome);
+    CountRound(balanceBefore, outcome);
     betPlaced = false;
     
     //hojson esvel hojigdsoniig shalgana.
     CheckWinCondition();
     CheckLoseCondition();
+
+    // uldegdliig hadgalna: diskiig huleehgui, tetgeleg tasarsan ch ewdrehgui (store.h)
+    SetStoreValue("balance", playerBalance);
 }
 
 //------------------------------------------------------------------------------------
@@ -255,34 +279,10 @@ void ResetRound(void)
 //------------------------------------------------------------------------------------
 void UpdateSettings(void)
 {
-    // F darj full screen bolgono
-    if (IsKeyPressed(KEY_F)) {
-        ToggleFullscreen();
-        isFullscreen = !isFullscreen;
-    }
-    // M darj duug neej haana
-    if (IsKeyPressed(KEY_M)) {
-        if (musicOn) {
-            StopMusicStream(backgroundMusic);
-            musicOn = false;
-        } else {
-            PlayMusicStream(backgroundMusic);
-            musicOn = true;
-        }
-    }
-    // sumaar duug nemj hasna
-    if (IsKeyDown(KEY_RIGHT)) {
-        soundVolume += 0.01f;
-        if (soundVolume > 1.0f) soundVolume = 1.0f;
-        SetMusicVolume(backgroundMusic, soundVolume);
-    }
-    if (IsKeyDown(KEY_LEFT)) {
-        soundVolume -= 0.01f;
-        if (soundVolume < 0.0f) soundVolume = 0.0f;
-        SetMusicVolume(backgroundMusic, soundVolume);
-    }
+    // F, M, sumnuud: buh togloomd neg tohirgoo (settings.h), hadgalagdana
+    UpdateSettingsControls();
     if (IsKeyPressed(KEY_C)) {
-        currentScreen = MENU;
+        PopScene();
     }
 }
 
@@ -291,65 +291,151 @@ void UpdateSettings(void)
 //------------------------------------------------------------------------------------
 void DrawSettings(void)
 {
-    DrawText("SETTINGS", screenWidth/2 - MeasureText("SETTINGS", 50)/2, 50, 50, GOLD);
+    GameSettings settings = GetGameSettings();
+    ClearBackground(DARKGREEN);
+
+    // zuwhun utga ni oorchlogdohod l dahin zurna
+    if (BeginScreenLayer(&settingsLayer, MixLayerKey(MixLayerKey(MixLayerKey(0, settings.fullscreen), settings.musicOn), (int)(settings.musicVolume*100.0f + 0.5f))))
+    {
+        DrawTextCached("SETTINGS", screenWidth/2 - MeasureTextCached("SETTINGS", 50)/2, 50, 50, GOLD);
     
-    // Fullscreen daragdsan eseh
-    DrawText(TextFormat("Fullscreen: %s (Press F)", isFullscreen ? "ON" : "OFF"), 50, 150, 30, WHITE);
+        // Fullscreen daragdsan eseh
+        DrawTextCached(FrameFormat("Fullscreen: %s (Press F)", settings.fullscreen ? "ON" : "OFF"), 50, 150, 30, WHITE);
     
-    // Duug neej haasah eseh
-    DrawText(TextFormat("Music: %s (Press M)", musicOn ? "ON" : "OFF"), 50, 200, 30, WHITE);
+        // Duug neej haasah eseh
+        DrawTextCached(FrameFormat("Music: %s (Press M)", settings.musicOn ? "ON" : "OFF"), 50, 200, 30, WHITE);
     
-    // Sound volume
-    DrawText(TextFormat("Volume: %.2f (<-/-> to adjust)", soundVolume), 50, 250, 30, WHITE);
+        // Sound volume
+        DrawText(FrameFormat("Volume: %.2f (<-/-> to adjust)", settings.musicVolume), 50, 250, 30, WHITE);
     
-    DrawText("Press C to return to MENU", screenWidth/2 - MeasureText("Press C to return to MENU", 20)/2, screenHeight - 50, 20, WHITE);
+        DrawTextCached("Press C to return to MENU", screenWidth/2 - MeasureTextCached("Press C to return to MENU", 20)/2, screenHeight - 50, 20, WHITE);
+        EndScreenLayer(&settingsLayer);
+    }
+    DrawScreenLayer(&settingsLayer, WHITE);
 }
 
 //------------------------------------------------------------------------------------
 // Draw main menu screen
 //------------------------------------------------------------------------------------
-void DrawMenu(void)
+void UpdateMenu(void)
 {
-    DrawText("BLACKJACK", screenWidth/2 - MeasureText("BLACKJACK", 50)/2, 100, 50, GOLD);
-    
-    for (int i = 0; i < MAX_MENU_ITEMS; i++)
+    if (IsKeyPressed(KEY_DOWN)) menuItemSelected = (menuItemSelected + 1) % MAX_MENU_ITEMS;
+    if (IsKeyPressed(KEY_UP)) menuItemSelected = (menuItemSelected - 1 + MAX_MENU_ITEMS) % MAX_MENU_ITEMS;
+    if (IsKeyPressed(KEY_ENTER))
     {
-        Color color = (i == menuItemSelected) ? GOLD : WHITE;
-        DrawText(menuItems[i],
-            screenWidth/2 - MeasureText(menuItems[i], 40)/2,
-            200 + i * 70,
-            40,
-            color);
+        switch(menuItemSelected)
+        {
+            case 0: SwitchScene(&playScene); break;         // PLAY
+            case 1: PushScene(&howToPlayScene); break;      // HOW TO PLAY
+            case 2: PushScene(&settingsScene); break;       // SETTINGS
+            case 3: QuitScenes(); break;                    // EXIT
+        }
     }
+}
+
+void DrawMenu(void)
+{
+    ClearBackground(DARKGREEN);
+    if (BeginScreenLayer(&menuLayer, MixLayerKey(0, menuItemSelected)))
+    {
+        DrawTextCached("BLACKJACK", screenWidth/2 - MeasureTextCached("BLACKJACK", 50)/2, 100, 50, GOLD);
+    
+        for (int i = 0; i < MAX_MENU_ITEMS; i++)
+        {
+            Color color = (i == menuItemSelected) ? GOLD : WHITE;
+            DrawTextCached(menuItems[i],
+                screenWidth/2 - MeasureTextCached(menuItems[i], 40)/2,
+                200 + i * 70,
+                40,
+                color);
+        }
     
-    DrawText("Use ARROW KEYS to navigate, ENTER to select",
-             screenWidth/2 - MeasureText("Use ARROW KEYS to navigate, ENTER to select", 20)/2,
-             screenHeight - 50, 20, WHITE);
+        DrawTextCached("Use ARROW KEYS to navigate, ENTER to select",
+                 screenWidth/2 - MeasureTextCached("Use ARROW KEYS to navigate, ENTER to select", 20)/2,
+                 screenHeight - 50, 20, WHITE);
+        EndScreenLayer(&menuLayer);
+    }
+    DrawScreenLayer(&menuLayer, WHITE);
 }
 
 //------------------------------------------------------------------------------------
 // Draw How To Play screen
 //------------------------------------------------------------------------------------
+void UpdateHowToPlay(void)
+{
+    if (IsKeyPressed(KEY_C)) PopScene(); //c darj main menu ruu orno
+}
+
 void DrawHowToPlay(void)
 {
-    DrawText("HOW TO PLAY BLACKJACK", screenWidth/2 - MeasureText("HOW TO PLAY BLACKJACK", 40)/2, 40, 40, GOLD);
+    ClearBackground(DARKGREEN);
+    if (BeginScreenLayer(&howToPlayLayer, 0))
+    {
+        DrawTextCached("HOW TO PLAY BLACKJACK", screenWidth/2 - MeasureTextCached("HOW TO PLAY BLACKJACK", 40)/2, 40, 40, GOLD);
     
-    DrawText("OBJECTIVE:", 40, 100, 30, WHITE);
-    DrawText("- Get as close to 21 as possible without going over", 60, 140, 25, LIGHTGRAY);
-    DrawText("- Beat the dealer's hand to win", 60, 170, 25, LIGHTGRAY);
+        DrawTextCached("OBJECTIVE:", 40, 100, 30, WHITE);
+        DrawTextCached("- Get as close to 21 as possible without going over", 60, 140, 25, LIGHTGRAY);
+        DrawTextCached("- Beat the dealer's hand to win", 60, 170, 25, LIGHTGRAY);
     
-    DrawText("CARD VALUES:", 40, 220, 30, WHITE);
-    DrawText("- Number cards = face value", 60, 260, 25, LIGHTGRAY);
-    DrawText("- Face cards (J, Q, K) = 10", 60, 290, 25, LIGHTGRAY);
-    DrawText("- Ace = 1 or 11", 60, 320, 25, LIGHTGRAY);
+        DrawTextCached("CARD VALUES:", 40, 220, 30, WHITE);
+        DrawTextCached("- Number cards = face value", 60, 260, 25, LIGHTGRAY);
+        DrawTextCached("- Face cards (J, Q, K) = 10", 60, 290, 25, LIGHTGRAY);
+        DrawTextCached("- Ace = 1 or 11", 60, 320, 25, LIGHTGRAY);
     
-    DrawText("GAMEPLAY:", 40, 370, 30, WHITE);
-    DrawText("- [H] Hit: Take another card (or click on deck)", 60, 410, 25, LIGHTGRAY);
-    DrawText("- [S] Stand: End your turn", 60, 440, 25, LIGHTGRAY);
+        DrawTextCached("GAMEPLAY:", 40, 370, 30, WHITE);
+        DrawTextCached("- [H] Hit: Take another card (or click on deck)", 60, 410, 25, LIGHTGRAY);
+        DrawTextCached("- [S] Stand: End your turn", 60, 440, 25, LIGHTGRAY);
     
-    DrawText("Press C to return to MENU", 
-             screenWidth/2 - MeasureText("Press C to return to MENU", 20)/2,
-             screenHeight - 50, 20, WHITE);
+        DrawTextCached("Press C to return to MENU", 
+                 screenWidth/2 - MeasureTextCached("Press C to return to MENU", 20)/2,
+                 screenHeight - 50, 20, WHITE);
+        EndScreenLayer(&howToPlayLayer);
+    }
+    DrawScreenLayer(&howToPlayLayer, WHITE);
+}
+
+//------------------------------------------------------------------------------------
+// Play screen: betting, then the round
+//------------------------------------------------------------------------------------
+// menu haragdaj baihad unshina; huzriin aryn zurag orj irtel (esvel baihgui gej medegdtel) huleene
+void LoadPlayAssets(void)
+{
+    cardBackTexture = RequestTexture("resources/blackjack_card_back.png");
+    cardSound = RequestSound("resources/blackjack_card.wav");
+    winSound = RequestSound("resources/blackjack_win.wav");
+    loseSound = RequestSound("resources/blackjack_lose.wav");
+}
+
+bool IsPlayReady(void)
+{
+    return GetAssetState(cardBackTexture) != ASSET_LOADING;
+}
+
+void StartPlay(void)
+{
+    betPlaced = false; // betnii delgets toglohoos umnu haruulna
+}
+
+void UpdatePlay(void)
+{
+    if (!betPlaced) UpdateBettingScreen();
+    else UpdateBlackjackGame();
+}
+
+void DrawPlay(void)
+{
+    ClearBackground(DARKGREEN);
+    // bet tawigdaagui bol betnii delgets haruulna
+    if (!betPlaced) DrawBettingScreen();
+    else DrawBlackjackGame();
+}
+
+void UnloadPlayAssets(void)
+{
+    ReleaseAsset(cardBackTexture);
+    ReleaseAsset(cardSound);
+    ReleaseAsset(winSound);
+    ReleaseAsset(loseSound);
 }
 
 //------------------------------------------------------------------------------------
@@ -357,15 +443,30 @@ void DrawHowToPlay(void)
 //------------------------------------------------------------------------------------
 void DrawBettingScreen(void)
 {
-    DrawText(TextFormat("Balance: %d$", playerBalance), 50, 50, 30, WHITE);
+    DrawText(FrameFormat("Balance: %d$", playerBalance), 50, 50, 30, WHITE);
     
-    DrawText(TextFormat("Place Your Bet: %d$ (<-/-> to adjust, ENTER to confirm)", currentBet),
-             screenWidth/2 - MeasureText(TextFormat("Place Your Bet: %d$ (←/→ to adjust, ENTER to confirm)", currentBet), 30)/2,
+    DrawText(FrameFormat("Place Your Bet: %d$ (<-/-> to adjust, ENTER to confirm)", currentBet),
+             screenWidth/2 - MeasureText(FrameFormat("Place Your Bet: %d$ (←/→ to adjust, ENTER to confirm)", currentBet), 30)/2,
              screenHeight/2, 30, YELLOW);
     
     DrawText("Press A to go ALL IN", 
          screenWidth/2 - MeasureText("Press A to go ALL IN", 30)/2, 
          screenHeight/2 + 80, 30, YELLOW);
+
+    // Bet zowlogoo: ene betees 100000$ hurch bolooh magadlal
+    if (atomic_load(&bankrollReady))
+    {
+        int bestBet = GetBankrollBestBet(&bankroll, playerBalance);
+        DrawText(FrameFormat("Chance to reach %d$ with this bet: %.4f%%", GOAL_BALANCE, 100.0*GetBankrollBetChance(&bankroll, playerBalance, currentBet)),
+                 50, screenHeight/2 + 160, 20, LIGHTGRAY);
+        DrawText(FrameFormat("Best bet: %d$ (%.4f%%)  [B] to use it", bestBet, 100.0*GetBankrollChance(&bankroll, playerBalance)),
+                 50, screenHeight/2 + 190, 20, LIGHTGRAY);
+        DrawText(FrameFormat("Kelly: %d$ (%.4f%%)   Bold: %d$ (%.4f%%)",
+                            GetBankrollKellyBet(&bankroll, playerBalance), 100.0*GetBankrollBetChance(&bankroll, playerBalance, GetBankrollKellyBet(&bankroll, playerBalance)),
+                            GetBankrollBoldBet(&bankroll, playerBalance), 100.0*GetBankrollBetChance(&bankroll, playerBalance, GetBankrollBoldBet(&bankroll, playerBalance))),
+                 50, screenHeight/2 + 220, 20, LIGHTGRAY);
+    }
+    else DrawText("Working out the odds...", 50, screenHeight/2 + 160, 20, LIGHTGRAY);
     
     DrawText("Press C to return to MENU", screenWidth/2 - MeasureText("Press C to return to MENU", 20)/2, screenHeight - 50, 20, WHITE);
 }
@@ -375,6 +476,9 @@ void DrawBettingScreen(void)
 //------------------------------------------------------------------------------------
 void UpdateBettingScreen(void)
 {
+    // zowlogoo bodogdoj duustal 4 udaa/sek shalgaj zurna
+    if (!atomic_load(&bankrollReady)) ScheduleFrameWake(0.25f);
+
     // betee sumaar ihesgej bagasgana
     if (IsKeyPressed(KEY_RIGHT)) {
         currentBet += 100;
@@ -388,6 +492,10 @@ void UpdateBettingScreen(void)
     if (IsKeyPressed(KEY_A)) {
         currentBet = playerBalance;
     }
+    // zowlogdson bet
+    if (IsKeyPressed(KEY_B) && atomic_load(&bankrollReady)) {
+        currentBet = GetBankrollBestBet(&bankroll, playerBalance);
+    }
     
     // Enter darwal bet tawigdana
     if (IsKeyPressed(KEY_ENTER)) {
@@ -399,7 +507,7 @@ void UpdateBettingScreen(void)
 
     // C darwal menu ruu butsna
     if (IsKeyPressed(KEY_C)) {
-        currentScreen = MENU;
+        SwitchScene(&menuScene);
     }
 }
 
@@ -413,9 +521,9 @@ void DrawBlackjackGame(void)
     for (int i = 0; i < game.dealerCount; i++) {
         if (game.dealerHand[i].revealed) {
             DrawRectangle(20 + i*(CARD_WIDTH+10), 50, CARD_WIDTH, CARD_HEIGHT, WHITE);
-            DrawText(TextFormat("%c", game.dealerHand[i].rank), 40 + i*(CARD_WIDTH+10), 70, 40, BLACK);
+            DrawText(FrameFormat("%c", game.dealerHand[i].rank), 40 + i*(CARD_WIDTH+10), 70, 40, BLACK);
         } else {
-            DrawTextureEx(cardBackTexture, (Vector2){20 + i*(CARD_WIDTH+10), 50}, 0, 1.0f, WHITE);
+            DrawTextureEx(GetAssetTexture(cardBackTexture), (Vector2){20 + i*(CARD_WIDTH+10), 50}, 0, 1.0f, WHITE);
         }
     }
    
@@ -423,19 +531,19 @@ void DrawBlackjackGame(void)
     DrawText("YOUR HAND:", 20, 300, 20, WHITE);
     for (int i = 0; i < game.playerCount; i++) {
         DrawRectangle(20 + i*(CARD_WIDTH+10), 330, CARD_WIDTH, CARD_HEIGHT, WHITE);
-        DrawText(TextFormat("%c", game.playerHand[i].rank), 40 + i*(CARD_WIDTH+10), 350, 40, BLACK);
+        DrawText(FrameFormat("%c", game.playerHand[i].rank), 40 + i*(CARD_WIDTH+10), 350, 40, BLACK);
     }
     
     // uldsen huzriig hajuu tald n haruulna
-    DrawText(TextFormat("Deck: %d", DECK_SIZE - game.deckIndex), screenWidth - 150, 50, 20, WHITE);
-    DrawTextureEx(cardBackTexture, (Vector2){screenWidth - 150, 80}, 0, 1.0f, WHITE);
+    DrawText(FrameFormat("Deck: %d", DECK_SIZE - game.deckIndex), screenWidth - 150, 50, 20, WHITE);
+    DrawTextureEx(GetAssetTexture(cardBackTexture), (Vector2){screenWidth - 150, 80}, 0, 1.0f, WHITE);
     
     // uy duusval ur dung haruulna
     if (game.gameOver)
     {
         game.playerValue = CalculateHandValue(game.playerHand, game.playerCount);
         game.dealerValue = CalculateHandValue(game.dealerHand, game.dealerCount);
-        DrawText(TextFormat("Dealer: %d | Player: %d", game.dealerValue, game.playerValue), 
+        DrawText(FrameFormat("Dealer: %d | Player: %d", game.dealerValue, game.playerValue), 
                  20, screenHeight - 150, 30, WHITE);
         if (game.playerBust)
             DrawText("BUST! YOU LOSE!", 20, screenHeight - 110, 30, RED);
@@ -449,12 +557,12 @@ void DrawBlackjackGame(void)
             DrawText("PUSH!", 20, screenHeight - 110, 30, YELLOW);
         
         // shineclegdsen dans haruulna
-        DrawText(TextFormat("Balance: %d$", playerBalance), 20, screenHeight - 70, 30, WHITE);
+        DrawText(FrameFormat("Balance: %d$", playerBalance), 20, screenHeight - 70, 30, WHITE);
         DrawText("Press SPACE to start next round", screenWidth/2 - 150, screenHeight - 30, 25, WHITE);
     }
     else
     {
-        DrawText(TextFormat("Current Value: %d", CalculateHandValue(game.playerHand, game.playerCount)),
+        DrawText(FrameFormat("Current Value: %d", CalculateHandValue(game.playerHand, game.playerCount)),
                  20, screenHeight - 60, 30, WHITE);
         DrawText("[H] Hit  [S] Stand  (or click on the deck to Hit)", 
                  20, screenHeight - 30, 25, WHITE);
@@ -472,23 +580,24 @@ void UpdateBlackjackGame(void)
             ResetRound();
         }
         if (IsKeyPressed(KEY_C)) {
-            currentScreen = MENU;
+            SwitchScene(&menuScene);
         }
         return;
     }
 
     // huzrun deer darj bas nemj awj bolno
-    Rectangle deckRect = { screenWidth - 150, 80, cardBackTexture.width, cardBackTexture.height };
+    Texture2D cardBack = GetAssetTexture(cardBackTexture);
+    Rectangle deckRect = { screenWidth - 150, 80, cardBack.width, cardBack.height };
     Vector2 mousePoint = GetMousePosition();
     if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePoint, deckRect)) {
         DealCard(game.playerHand, &game.playerCount, game.deck, &game.deckIndex, true);
-        PlaySound(cardSound);
+        PlayMixerSound(GetAssetSound(cardSound));
     }
 
     // Keyboard input
     if (IsKeyPressed(KEY_H)) {
         DealCard(game.playerHand, &game.playerCount, game.deck, &game.deckIndex, true);
-        PlaySound(cardSound);
+        PlayMixerSound(GetAssetSound(cardSound));
     }
 
     if (IsKeyPressed(KEY_S)) {
@@ -498,7 +607,7 @@ void UpdateBlackjackGame(void)
         // dealer 17 hurtel huzur nemj awna
         while (CalculateHandValue(game.dealerHand, game.dealerCount) < 17) {
             DealCard(game.dealerHand, &game.dealerCount, game.deck, &game.deckIndex, true);
-            PlaySound(cardSound);
+            PlayMixerSound(GetAssetSound(cardSound));
         }
 
         // Evaluate hands
@@ -509,9 +618,9 @@ void UpdateBlackjackGame(void)
         game.gameOver = true;
 
         if (game.playerBust || (game.dealerValue > game.playerValue && !game.dealerBust)) {
-            PlaySound(loseSound);
+            PlayMixerSound(GetAssetSound(loseSound));
         } else if (game.dealerBust || game.playerValue > game.dealerValue) {
-            PlaySound(winSound);
+            PlayMixerSound(GetAssetSound(winSound));
         }
     }
 
@@ -520,7 +629,7 @@ void UpdateBlackjackGame(void)
     if (game.playerValue > 21) {
         game.playerBust = true;
         game.gameOver = true;
-        PlaySound(loseSound);
+        PlayMixerSound(GetAssetSound(loseSound));
     }
 }
 
@@ -587,14 +696,14 @@ void ShuffleDeck(Card deck[])
 //Hojih
 void CheckWinCondition(void)
 {
-    if (playerBalance >= 100000)
+    if (playerBalance >= GOAL_BALANCE)
     {
-        currentScreen = MENU;
+        SwitchScene(&menuScene);
         playerBalance = INITIAL_BALANCE;
         currentBet = DEFAULT_BET;
         betPlaced = false;
         DrawText("YOU WON THE GAME! CONGRATULATIONS!", screenWidth / 2 - 300, screenHeight / 2, 30, GREEN);
-        PlaySound(winSound);
+        PlayMixerSound(GetAssetSound(winSound));
     }
 }
 
@@ -603,9 +712,71 @@ void CheckLoseCondition(void)
 {
     if (playerBalance <= 0)
     {
-        currentScreen = MENU;
+        SwitchScene(&menuScene);
         playerBalance = INITIAL_BALANCE;
         currentBet = DEFAULT_BET;
         betPlaced = false;
     }
-}
\ No newline at end of file
+}
+//------------------------------------------------------------------------------------
+// Solve the betting table for these rules (runs on its own thread, about a second)
+//------------------------------------------------------------------------------------
+void *SolveBankrollMain(void *argument)
+{
+    (void)argument;
+
+    BankrollConfig config = GetDefaultBankrollConfig();
+    config.goal = GOAL_BALANCE;
+    config.unit = MIN_BET;
+    config.minBet = MIN_BET;
+    config.payout = 2;          // ResetRound() ylahad bet-iin 2 dahin ihiig nemne
+
+    if (SolveBankroll(&bankroll, &config, ComputeHandOdds(config.payout))) atomic_store(&bankrollReady, true);
+    return NULL;
+}
+
+//------------------------------------------------------------------------------------
+// Queue the finished round for the hand history (never waits on the disk)
+//------------------------------------------------------------------------------------
+void LogRound(int balanceBefore, HandOutcome outcome)
+{
+    static const char ranks[] = "23456789TJQKA";
+    static const char suits[] = "HDCS";
+
+    HandRecord record = { 0 };
+    record.time = GetUnixMillis();
+    record.session = sessionId;
+    record.hand = ++handNumber;
+    record.bet = currentBet;
+    record.balance = balanceBefore;
+    record.change = playerBalance - balanceBefore;
+    record.outcome = (uint8_t)outcome;
+    record.stood = !game.playerBust;
+
+    // huzur bur rank*4 + suit
+    for (int i = 0; (i < game.playerCount) && (i < HAND_LOG_MAX_CARDS); i++)
+        record.playerCards[record.playerCount++] = (uint8_t)((strchr(ranks, game.playerHand[i].rank) - ranks)*4 + (strchr(suits, game.playerHand[i].suit) - suits));
+    for (int i = 0; (i < game.dealerCount) && (i < HAND_LOG_MAX_CARDS); i++)
+        record.dealerCards[record.dealerCount++] = (uint8_t)((strchr(ranks, game.dealerHand[i].rank) - ranks)*4 + (strchr(suits, game.dealerHand[i].suit) - suits));
+
+    LogHand(handLog, &record);
+}
+
+//------------------------------------------------------------------------------------
+// Round-iin ur dung telemetry-d nemne (hemjilt ni atomic, frame-iig saatuulahgui)
+//------------------------------------------------------------------------------------
+void CountRound(int balanceBefore, HandOutcome outcome)
+{
+    int change = playerBalance - balanceBefore;
+
+    AddTelemetryCount(handsPlayed[outcome], 1);
+    if (outcome != HAND_PUSH) RecordTelemetryValue(balanceChange[outcome], (uint64_t)((change < 0)? -change : change));
+    SetTelemetryGauge(balanceGauge, playerBalance);
+}
+
+uint64_t GetUnixMillis(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t)now.tv_sec*1000 + (uint64_t)(now.tv_nsec/1000000);
+}
@@ -0,0 +1,622 @@
+/*******************************************************************************************
+*
+*   Hand history, see handlog.h
+*
+********************************************************************************************/
+#include "handlog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+    #include <direct.h>
+    #include <io.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define HAND_LOG_QUEUE          1024        // Power of two
+#define DEFAULT_SEGMENT_BYTES   (8u << 20)
+#define MAX_LOG_PATH            512
+#define WRITE_BUFFER_SIZE       (64 << 10)
+#define MAX_RECORD_BYTES        128         // Length prefix and the largest payload
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct HandLog {
+    char directory[MAX_LOG_PATH - 32];     // Room for the segment file names
+    uint32_t segmentBytes;
+
+    // Producer writes head, the writer thread writes tail
+    HandRecord ring[HAND_LOG_QUEUE];
+    atomic_uint head;
+    atomic_uint tail;
+    atomic_ullong dropped;          // Queue full, or the writer could not keep the record
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    atomic_bool closing;
+
+    // Writer thread only
+    FILE *file;
+    uint32_t segment;
+    uint64_t size;                  // Bytes in the segment, buffered ones included
+    uint64_t records;
+    uint64_t firstTime, lastTime, previousTime;
+    uint64_t previousSession;
+    HandCheckpoint *checkpoints;
+    int checkpointCount, checkpointCapacity;
+    uint64_t *sessions;
+    int sessionCount, sessionCapacity;
+    unsigned char buffer[WRITE_BUFFER_SIZE];
+    size_t buffered;
+};
+
+typedef struct MappedFile {
+    const unsigned char *base;
+    size_t size;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} MappedFile;
+
+struct HandLogSegment {
+    MappedFile log;
+    MappedFile index;
+    const HandIndexHeader *header;  // NULL when there is no valid index
+    const HandCheckpoint *checkpoints;
+    const uint64_t *sessions;
+};
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions: encoding
+//----------------------------------------------------------------------------------
+static unsigned char *PutVarint(unsigned char *out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char)value;
+    return out;
+}
+
+static bool GetVarint(const unsigned char **in, const unsigned char *end, uint64_t *value)
+{
+    const unsigned char *p = *in;
+    uint64_t result = 0;
+
+    for (int shift = 0; (p < end) && (shift < 64); shift += 7)
+    {
+        unsigned char byte = *p++;
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (byte < 0x80)
+        {
+            *in = p;
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint64_t ZigZag(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t UnZigZag(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static void GetSegmentPath(char *path, const char *directory, uint32_t segment, const char *extension)
+{
+    snprintf(path, MAX_LOG_PATH, "%s/hands-%06u.%s", directory, segment, extension);
+}
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions: writer thread
+//----------------------------------------------------------------------------------
+static bool FlushLog(HandLog *log)
+{
+    bool ok = true;
+    if ((log->file != NULL) && (log->buffered > 0)) ok = (fwrite(log->buffer, 1, log->buffered, log->file) == log->buffered) && (fflush(log->file) == 0);
+    log->buffered = 0;
+    return ok;
+}
+
+// Claims the next free segment number: O_EXCL keeps two running games from sharing one
+static bool StartSegment(HandLog *log)
+{
+    char path[MAX_LOG_PATH];
+
+    for (uint32_t segment = (log->segment > 0)? log->segment + 1 : 1; segment < 1000000; segment++)
+    {
+        GetSegmentPath(path, log->directory, segment, "log");
+#if defined(_WIN32)
+        int fd = _open(path, _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY, _S_IREAD | _S_IWRITE);
+        FILE *file = (fd >= 0)? _fdopen(fd, "wb") : NULL;
+#else
+        int fd = open(path, O_CREAT | O_EXCL | O_WRONLY, 0644);
+        FILE *file = (fd >= 0)? fdopen(fd, "wb") : NULL;
+#endif
+        if (file == NULL)
+        {
+            if (errno == EEXIST) continue;
+            return false;
+        }
+
+        HandLogHeader header = { { 0 }, HAND_LOG_VERSION, segment, 0 };
+        memcpy(header.magic, HAND_LOG_MAGIC, 4);
+        fwrite(&header, sizeof(header), 1, file);
+
+        log->file = file;
+        log->segment = segment;
+        log->size = sizeof(header);
+        log->records = 0;
+        log->checkpointCount = 0;
+        log->sessionCount = 0;
+        return true;
+    }
+
+    return false;
+}
+
+static int CompareSessions(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Closes the segment and writes its index next to it (through a rename, so a reader
+// never sees half an index)
+static void SealSegment(HandLog *log)
+{
+    if (log->file == NULL) return;
+
+    FlushLog(log);
+    fclose(log->file);
+    log->file = NULL;
+
+    qsort(log->sessions, (size_t)log->sessionCount, sizeof(uint64_t), CompareSessions);
+    int unique = 0;
+    for (int i = 0; i < log->sessionCount; i++) if ((unique == 0) || (log->sessions[unique - 1] != log->sessions[i])) log->sessions[unique++] = log->sessions[i];
+
+    HandIndexHeader header = { { 0 }, HAND_LOG_VERSION, log->segment, (uint32_t)log->checkpointCount, (uint32_t)unique, 0,
+                               log->records, log->size, log->firstTime, log->lastTime };
+    memcpy(header.magic, HAND_INDEX_MAGIC, 4);
+
+    char path[MAX_LOG_PATH], temporary[MAX_LOG_PATH + 4];
+    GetSegmentPath(path, log->directory, log->segment, "idx");
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+    FILE *file = fopen(temporary, "wb");
+    if (file == NULL) return;
+
+    bool ok = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+              (fwrite(log->checkpoints, sizeof(HandCheckpoint), (size_t)log->checkpointCount, file) == (size_t)log->checkpointCount) &&
+              (fwrite(log->sessions, sizeof(uint64_t), (size_t)unique, file) == (size_t)unique);
+    ok = (fclose(file) == 0) && ok;
+
+    if (ok) ok = (rename(temporary, path) == 0);
+    if (!ok) remove(temporary);
+}
+
+static bool Grow(void **items, int *capacity, int count, size_t itemSize)
+{
+    if (count < *capacity) return true;
+
+    int grown = (*capacity > 0)? *capacity*2 : 64;
+    void *resized = realloc(*items, (size_t)grown*itemSize);
+    if (resized == NULL) return false;
+
+    *items = resized;
+    *capacity = grown;
+    return true;
+}
+
+// false: the record could not be kept (no segment open, or no memory for its index entry)
+static bool WriteRecord(HandLog *log, const HandRecord *record)
+{
+    if ((log->file != NULL) && (log->records > 0) && (log->size >= log->segmentBytes))
+    {
+        SealSegment(log);
+        if (!StartSegment(log)) log->file = NULL;
+    }
+    if (log->file == NULL) return false;
+
+    bool checkpoint = ((log->records % HAND_LOG_CHECKPOINT) == 0);
+    if (checkpoint)
+    {
+        if (!Grow((void **)&log->checkpoints, &log->checkpointCapacity, log->checkpointCount, sizeof(HandCheckpoint))) return false;
+        log->checkpoints[log->checkpointCount++] = (HandCheckpoint){ log->size, log->records };
+        log->previousTime = 0;
+    }
+
+    bool newSession = checkpoint || (record->session != log->previousSession);
+    if (newSession)
+    {
+        if (!Grow((void **)&log->sessions, &log->sessionCapacity, log->sessionCount, sizeof(uint64_t))) return false;
+        log->sessions[log->sessionCount++] = record->session;
+    }
+
+    int playerCount = (record->playerCount <= HAND_LOG_MAX_CARDS)? record->playerCount : HAND_LOG_MAX_CARDS;
+    int dealerCount = (record->dealerCount <= HAND_LOG_MAX_CARDS)? record->dealerCount : HAND_LOG_MAX_CARDS;
+
+    unsigned char payload[MAX_RECORD_BYTES];
+    unsigned char *out = payload;
+    out = PutVarint(out, (record->time >= log->previousTime)? record->time - log->previousTime : 0);
+    *out++ = (unsigned char)((record->outcome & 3) | (record->stood? 4 : 0) | (newSession? 8 : 0));
+    if (newSession) out = PutVarint(out, record->session);
+    out = PutVarint(out, record->hand);
+    out = PutVarint(out, (uint32_t)record->bet);
+    out = PutVarint(out, (uint32_t)record->balance);
+    out = PutVarint(out, ZigZag(record->change));
+    *out++ = (unsigned char)((playerCount << 4) | dealerCount);
+    memcpy(out, record->playerCards, (size_t)playerCount);
+    out += playerCount;
+    memcpy(out, record->dealerCards, (size_t)dealerCount);
+    out += dealerCount;
+
+    size_t length = (size_t)(out - payload);
+    if (log->buffered + MAX_RECORD_BYTES + 2 > WRITE_BUFFER_SIZE) FlushLog(log);
+
+    unsigned char *start = log->buffer + log->buffered;
+    unsigned char *at = PutVarint(start, length);
+    memcpy(at, payload, length);
+    at += length;
+
+    log->buffered += (size_t)(at - start);
+    log->size += (uint64_t)(at - start);
+    if (log->records == 0) log->firstTime = record->time;
+    log->lastTime = record->time;
+    log->previousTime = record->time;
+    log->previousSession = record->session;
+    log->records++;
+    return true;
+}
+
+static void *WriterMain(void *argument)
+{
+    HandLog *log = (HandLog *)argument;
+
+    for (;;)
+    {
+        bool closing = atomic_load(&log->closing);
+
+        unsigned int tail = atomic_load_explicit(&log->tail, memory_order_relaxed);
+        unsigned int head = atomic_load(&log->head);
+        for (; tail != head; tail++)
+        {
+            if (!WriteRecord(log, &log->ring[tail & (HAND_LOG_QUEUE - 1)])) atomic_fetch_add_explicit(&log->dropped, 1, memory_order_relaxed);
+            atomic_store(&log->tail, tail + 1);
+        }
+        FlushLog(log);
+
+        // Whatever was queued before closing was set is in by now
+        if (closing) break;
+
+        // Sleep until LogHand() finds the ring empty and signals, sequentially consistent with
+        // the tail stored above, so either it sees that tail or this sees its head
+        pthread_mutex_lock(&log->lock);
+        if (!atomic_load(&log->closing) && (atomic_load(&log->head) == tail)) pthread_cond_wait(&log->wake, &log->lock);
+        pthread_mutex_unlock(&log->lock);
+    }
+
+    SealSegment(log);
+    return NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions: reading
+//----------------------------------------------------------------------------------
+static bool MapFile(MappedFile *mapped, const char *fileName)
+{
+#if defined(_WIN32)
+    mapped->file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mapped->file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mapped->file, &size) || (size.QuadPart == 0)) return false;
+    mapped->size = (size_t)size.QuadPart;
+
+    mapped->mapping = CreateFileMappingA(mapped->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapped->mapping == NULL) return false;
+
+    mapped->base = (const unsigned char *)MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0);
+    return (mapped->base != NULL);
+#else
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    void *data = MAP_FAILED;
+    if ((fstat(fd, &info) == 0) && (info.st_size > 0))
+    {
+        mapped->size = (size_t)info.st_size;
+        data = mmap(NULL, mapped->size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    mapped->base = (data != MAP_FAILED)? (const unsigned char *)data : NULL;
+    return (mapped->base != NULL);
+#endif
+}
+
+static void UnmapFile(MappedFile *mapped)
+{
+#if defined(_WIN32)
+    if (mapped->base != NULL) UnmapViewOfFile(mapped->base);
+    if (mapped->mapping != NULL) CloseHandle(mapped->mapping);
+    if ((mapped->file != NULL) && (mapped->file != INVALID_HANDLE_VALUE)) CloseHandle(mapped->file);
+#else
+    if (mapped->base != NULL) munmap((void *)mapped->base, mapped->size);
+#endif
+    memset(mapped, 0, sizeof(*mapped));
+}
+
+static bool ValidateIndex(const HandLogSegment *segment, uint32_t number)
+{
+    const MappedFile *index = &segment->index;
+    if (index->size < sizeof(HandIndexHeader)) return false;
+
+    const HandIndexHeader *header = (const HandIndexHeader *)index->base;
+    if ((memcmp(header->magic, HAND_INDEX_MAGIC, 4) != 0) || (header->version != HAND_LOG_VERSION) || (header->segment != number)) return false;
+    if (header->dataSize != segment->log.size) return false;        // Index of an older copy of the segment
+
+    uint64_t expected = sizeof(HandIndexHeader) + (uint64_t)header->checkpointCount*sizeof(HandCheckpoint) + (uint64_t)header->sessionCount*sizeof(uint64_t);
+    if (index->size != expected) return false;
+
+    const HandCheckpoint *checkpoints = (const HandCheckpoint *)(index->base + sizeof(HandIndexHeader));
+    for (uint32_t i = 0; i < header->checkpointCount; i++)
+    {
+        if ((checkpoints[i].offset < sizeof(HandLogHeader)) || (checkpoints[i].offset > segment->log.size)) return false;
+        if ((i > 0) && (checkpoints[i].offset <= checkpoints[i - 1].offset)) return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition: writing
+//----------------------------------------------------------------------------------
+HandLog *OpenHandLog(const char *directory, uint64_t session, uint32_t segmentBytes)
+{
+    if (strlen(directory) >= MAX_LOG_PATH - 32) return NULL;
+
+#if defined(_WIN32)
+    _mkdir(directory);
+#else
+    mkdir(directory, 0755);
+#endif
+
+    HandLog *log = (HandLog *)calloc(1, sizeof(HandLog));
+    if (log == NULL) return NULL;
+
+    strcpy(log->directory, directory);
+    log->segmentBytes = (segmentBytes > 0)? segmentBytes : DEFAULT_SEGMENT_BYTES;
+    log->previousSession = session;
+    atomic_init(&log->head, 0);
+    atomic_init(&log->tail, 0);
+    atomic_init(&log->dropped, 0);
+    atomic_init(&log->closing, false);
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_cond_init(&log->wake, NULL);
+
+    if (!StartSegment(log) || (pthread_create(&log->thread, NULL, WriterMain, log) != 0))
+    {
+        if (log->file != NULL) fclose(log->file);
+        pthread_mutex_destroy(&log->lock);
+        pthread_cond_destroy(&log->wake);
+        free(log);
+        return NULL;
+    }
+
+    return log;
+}
+
+bool LogHand(HandLog *log, const HandRecord *record)
+{
+    if (log == NULL) return false;
+
+    unsigned int head = atomic_load_explicit(&log->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&log->tail, memory_order_acquire);
+    if (head - tail >= HAND_LOG_QUEUE)
+    {
+        atomic_fetch_add_explicit(&log->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    log->ring[head & (HAND_LOG_QUEUE - 1)] = *record;
+    atomic_store(&log->head, head + 1);
+
+    // The writer drained everything before this record, so it may be asleep: wake it. Any
+    // other time it is still writing and finds this record before it sleeps again
+    if (atomic_load(&log->tail) == head)
+    {
+        pthread_mutex_lock(&log->lock);
+        pthread_cond_signal(&log->wake);
+        pthread_mutex_unlock(&log->lock);
+    }
+    return true;
+}
+
+void CloseHandLog(HandLog *log)
+{
+    if (log == NULL) return;
+
+    pthread_mutex_lock(&log->lock);
+    atomic_store(&log->closing, true);
+    pthread_cond_signal(&log->wake);
+    pthread_mutex_unlock(&log->lock);
+    pthread_join(log->thread, NULL);
+
+    pthread_mutex_destroy(&log->lock);
+    pthread_cond_destroy(&log->wake);
+    free(log->checkpoints);
+    free(log->sessions);
+    free(log);
+}
+
+uint64_t GetHandLogDropped(const HandLog *log)
+{
+    return (log != NULL)? atomic_load(&((HandLog *)log)->dropped) : 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition: reading
+//----------------------------------------------------------------------------------
+HandLogSegment *LoadHandLogSegment(const char *directory, uint32_t number)
+{
+    if (strlen(directory) + 32 > MAX_LOG_PATH) return NULL;
+
+    HandLogSegment *segment = (HandLogSegment *)calloc(1, sizeof(HandLogSegment));
+    if (segment == NULL) return NULL;
+
+    char path[MAX_LOG_PATH];
+    GetSegmentPath(path, directory, number, "log");
+
+    const HandLogHeader *header = NULL;
+    if (MapFile(&segment->log, path) && (segment->log.size >= sizeof(HandLogHeader))) header = (const HandLogHeader *)segment->log.base;
+    if ((header == NULL) || (memcmp(header->magic, HAND_LOG_MAGIC, 4) != 0) || (header->version != HAND_LOG_VERSION) || (header->segment != number))
+    {
+        UnloadHandLogSegment(segment);
+        return NULL;
+    }
+
+    GetSegmentPath(path, directory, number, "idx");
+    if (MapFile(&segment->index, path) && ValidateIndex(segment, number))
+    {
+        segment->header = (const HandIndexHeader *)segment->index.base;
+        segment->checkpoints = (const HandCheckpoint *)(segment->index.base + sizeof(HandIndexHeader));
+        segment->sessions = (const uint64_t *)(segment->checkpoints + segment->header->checkpointCount);
+    }
+    else UnmapFile(&segment->index);
+
+    return segment;
+}
+
+void UnloadHandLogSegment(HandLogSegment *segment)
+{
+    if (segment == NULL) return;
+
+    UnmapFile(&segment->log);
+    UnmapFile(&segment->index);
+    free(segment);
+}
+
+bool IsHandLogSegmentIndexed(const HandLogSegment *segment)
+{
+    return (segment->header != NULL);
+}
+
+bool HasHandLogSession(const HandLogSegment *segment, uint64_t session)
+{
+    if (segment->header == NULL) return true;
+
+    // Sorted: binary search
+    uint32_t low = 0, high = segment->header->sessionCount;
+    while (low < high)
+    {
+        uint32_t middle = (low + high)/2;
+        if (segment->sessions[middle] < session) low = middle + 1;
+        else high = middle;
+    }
+
+    return (low < segment->header->sessionCount) && (segment->sessions[low] == session);
+}
+
+uint64_t GetHandLogSegmentSize(const HandLogSegment *segment)
+{
+    return segment->log.size;
+}
+
+int GetHandLogCheckpointCount(const HandLogSegment *segment)
+{
+    if ((segment->header == NULL) || (segment->header->checkpointCount == 0)) return 1;
+    return (int)segment->header->checkpointCount;
+}
+
+HandLogCursor GetHandLogCursor(const HandLogSegment *segment, int checkpoint)
+{
+    const unsigned char *base = segment->log.base;
+    HandLogCursor cursor = { base + sizeof(HandLogHeader), base + segment->log.size, 0, 0 };
+
+    if ((segment->header != NULL) && (segment->header->checkpointCount > 0) && (checkpoint >= 0) && (checkpoint < (int)segment->header->checkpointCount))
+    {
+        cursor.at = base + segment->checkpoints[checkpoint].offset;
+        if (checkpoint + 1 < (int)segment->header->checkpointCount) cursor.end = base + segment->checkpoints[checkpoint + 1].offset;
+    }
+
+    return cursor;
+}
+
+bool ReadHandRecord(HandLogCursor *cursor, HandRecord *record)
+{
+    const unsigned char *p = cursor->at;
+    uint64_t length, delta, session, hand, bet, balance, change;
+
+    if (!GetVarint(&p, cursor->end, &length) || (length < 2) || (length > (uint64_t)(cursor->end - p)))
+    {
+        cursor->at = cursor->end;       // End of the range, or a record torn by a crash
+        return false;
+    }
+
+    const unsigned char *end = p + length;
+    bool ok = GetVarint(&p, end, &delta) && (p < end);
+    unsigned char flags = ok? *p++ : 0;
+    session = cursor->session;
+    if (ok && (flags & 8)) ok = GetVarint(&p, end, &session);
+    ok = ok && GetVarint(&p, end, &hand) && GetVarint(&p, end, &bet) && GetVarint(&p, end, &balance) && GetVarint(&p, end, &change) && (p < end);
+
+    int playerCount = ok? (*p >> 4) : 0;
+    int dealerCount = ok? (*p & 15) : 0;
+    p++;
+    ok = ok && (playerCount <= HAND_LOG_MAX_CARDS) && (dealerCount <= HAND_LOG_MAX_CARDS) && (end - p == playerCount + dealerCount);
+
+    if (!ok)
+    {
+        cursor->at = cursor->end;
+        return false;
+    }
+
+    cursor->time += delta;
+    cursor->session = session;
+    cursor->at = end;
+
+    record->time = cursor->time;
+    record->session = session;
+    record->hand = (uint32_t)hand;
+    record->bet = (int32_t)bet;
+    record->balance = (int32_t)balance;
+    record->change = (int32_t)UnZigZag(change);
+    record->outcome = flags & 3;
+    record->stood = (flags & 4) != 0;
+    record->playerCount = (uint8_t)playerCount;
+    record->dealerCount = (uint8_t)dealerCount;
+    memcpy(record->playerCards, p, (size_t)playerCount);
+    memcpy(record->dealerCards, p + playerCount, (size_t)dealerCount);
+
+    return true;
+}
@@ -0,0 +1,129 @@
+/*******************************************************************************************
+*
+*   Hand history: an append-only, segmented binary log of every blackjack round
+*
+*   A directory holds hands-000001.log, hands-000002.log, ... numbered without gaps. Each
+*   game run (a session) starts a new segment, and a segment is sealed once it passes
+*   segmentBytes. Layout (little-endian):
+*
+*       hands-NNNNNN.log    HandLogHeader, then records back to back:
+*                           varint payload length, then the payload:
+*                             varint time delta (ms, from the previous record)
+*                             byte   flags: outcome | stood << 2 | new session << 3
+*                             [varint session]          only with the new session flag
+*                             varint hand, varint bet, varint balance before the hand
+*                             zigzag varint balance change
+*                             byte   player cards << 4 | dealer cards
+*                             cards, one byte each: rank*4 + suit (rank 0..12 for 2..A)
+*       hands-NNNNNN.idx    written when the segment is sealed: HandIndexHeader,
+*                           HandCheckpoint[checkpointCount], uint64 sessions[sessionCount]
+*
+*   Every HAND_LOG_CHECKPOINT records the time delta restarts from zero and the session is
+*   spelled out, so decoding can start at any checkpoint; the index lists their offsets
+*   (for splitting a segment across threads) and the sessions a segment contains. A
+*   segment without a matching index (the live one, or one cut short by a crash) is read
+*   from its start; a torn last record is ignored.
+*
+*   The game thread hands records to LogHand(), which only copies into a single-producer
+*   single-consumer ring; a background thread encodes and writes them. When the ring is
+*   full the record is dropped and counted rather than blocking the frame, as is one the
+*   writer cannot keep (no segment file, or no memory for its index entry). The writer
+*   sleeps while the ring is empty and is woken by the record that ends that.
+*
+********************************************************************************************/
+#ifndef HANDLOG_H
+#define HANDLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HAND_LOG_MAGIC          "BJHL"
+#define HAND_INDEX_MAGIC        "BJHI"
+#define HAND_LOG_VERSION        1
+#define HAND_LOG_MAX_CARDS      12
+#define HAND_LOG_CHECKPOINT     4096
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum HandOutcome {
+    HAND_LOSS = 0,
+    HAND_PUSH,
+    HAND_WIN
+} HandOutcome;
+
+typedef struct HandRecord {
+    uint64_t time;                  // Milliseconds since the epoch
+    uint64_t session;
+    uint32_t hand;                  // Round number within the session, from 1
+    int32_t bet;
+    int32_t balance;                // Before the round
+    int32_t change;
+    uint8_t outcome;                // HandOutcome
+    bool stood;                     // false: the player busted
+    uint8_t playerCount;
+    uint8_t dealerCount;            // Dealer card 0 is the hole card, 1 the upcard
+    uint8_t playerCards[HAND_LOG_MAX_CARDS];
+    uint8_t dealerCards[HAND_LOG_MAX_CARDS];
+} HandRecord;
+
+typedef struct HandLogHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t segment;
+    uint32_t reserved;
+} HandLogHeader;
+
+typedef struct HandIndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t segment;
+    uint32_t checkpointCount;
+    uint32_t sessionCount;
+    uint32_t reserved;
+    uint64_t records;
+    uint64_t dataSize;              // Size of the .log file this index describes
+    uint64_t firstTime;
+    uint64_t lastTime;
+} HandIndexHeader;
+
+typedef struct HandCheckpoint {
+    uint64_t offset;                // Of the record's length prefix, from the start of the .log
+    uint64_t record;
+} HandCheckpoint;
+
+typedef struct HandLog HandLog;
+typedef struct HandLogSegment HandLogSegment;
+
+typedef struct HandLogCursor {
+    const unsigned char *at;
+    const unsigned char *end;
+    uint64_t time;
+    uint64_t session;
+} HandLogCursor;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Writing: one producer thread per log
+HandLog *OpenHandLog(const char *directory, uint64_t session, uint32_t segmentBytes);    // 0: 8 MB segments
+bool LogHand(HandLog *log, const HandRecord *record);   // Never blocks; false if the record was dropped
+void CloseHandLog(HandLog *log);                        // Drains the queue and seals the segment
+uint64_t GetHandLogDropped(const HandLog *log);
+
+// Reading, memory-mapped
+HandLogSegment *LoadHandLogSegment(const char *directory, uint32_t segment);    // NULL past the last segment
+void UnloadHandLogSegment(HandLogSegment *segment);
+bool IsHandLogSegmentIndexed(const HandLogSegment *segment);
+bool HasHandLogSession(const HandLogSegment *segment, uint64_t session);       // true when there is no index to ask
+uint64_t GetHandLogSegmentSize(const HandLogSegment *segment);
+int GetHandLogCheckpointCount(const HandLogSegment *segment);                  // At least 1
+HandLogCursor GetHandLogCursor(const HandLogSegment *segment, int checkpoint);  // Up to the next checkpoint
+bool ReadHandRecord(HandLogCursor *cursor, HandRecord *record);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // HANDLOG_H
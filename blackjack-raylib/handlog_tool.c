@@ -0,0 +1,510 @@
+/*******************************************************************************************
+*
+*   blackjack-hands - aggregate the blackjack hand history, or fill one with simulated play
+*
+*   Usage: blackjack-hands [--dir D] [--session S] [--by upcard|bet|session]... [--threads T]
+*          blackjack-hands --simulate N [--dir D] [--seed S] [--segment-bytes B]
+*
+*   Queries map every segment of the directory (hands by default, as written by the game)
+*   and split indexed segments at their checkpoints across threads. --session keeps one
+*   session, skipping the segments whose index says it is not there. Without --by the
+*   report breaks the hands down by dealer upcard and by bet size.
+*
+*   --simulate plays N rounds with the game's rules through the same background writer: the
+*   player hits below 17 and bets a random slice of the balance, and every run from 10000$
+*   to ruin or 100000$ is a session of its own.
+*
+********************************************************************************************/
+#include "handlog.h"
+
+#define PLATFORM_OS_ONLY
+#include "platform.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_QUERY_THREADS       64
+#define UPCARD_KINDS            10
+#define BET_BUCKETS             8
+
+#define INITIAL_BALANCE         10000
+#define GOAL_BALANCE            100000
+#define MIN_BET                 100
+
+static const int betLimits[BET_BUCKETS - 1] = { 500, 1000, 2500, 5000, 10000, 25000, 50000 };
+static const char *upcardNames[UPCARD_KINDS] = { "A", "2", "3", "4", "5", "6", "7", "8", "9", "T" };
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct HandTally {
+    uint64_t hands;
+    uint64_t outcomes[3];           // By HandOutcome
+    int64_t change;
+    int64_t bets;
+} HandTally;
+
+typedef struct SessionTally {
+    uint64_t session;               // 0: empty slot (sessions are never 0)
+    HandTally tally;
+} SessionTally;
+
+typedef struct QueryItem {
+    const HandLogSegment *segment;
+    int checkpoint;
+} QueryItem;
+
+typedef struct Query {
+    QueryItem *items;
+    int itemCount;
+    atomic_int next;
+    bool filter;
+    uint64_t session;
+    bool bySession;
+} Query;
+
+typedef struct QueryWorker {
+    Query *query;
+    pthread_t thread;
+    HandTally total;
+    HandTally upcards[UPCARD_KINDS];
+    HandTally bets[BET_BUCKETS];
+    SessionTally *sessions;         // Open addressing, power-of-two capacity
+    int sessionCount, sessionCapacity;
+} QueryWorker;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static double WallTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+
+static void AddHand(HandTally *tally, const HandRecord *record)
+{
+    tally->hands++;
+    tally->outcomes[record->outcome % 3]++;
+    tally->change += record->change;
+    tally->bets += record->bet;
+}
+
+static void MergeTally(HandTally *into, const HandTally *from)
+{
+    into->hands += from->hands;
+    for (int i = 0; i < 3; i++) into->outcomes[i] += from->outcomes[i];
+    into->change += from->change;
+    into->bets += from->bets;
+}
+
+static int GetUpcardKind(uint8_t card)
+{
+    int rank = card >> 2;                   // 0..12 for 2..A
+    if (rank == 12) return 0;
+    return (rank >= 8)? 9 : rank + 1;
+}
+
+static int GetBetBucket(int bet)
+{
+    int bucket = 0;
+    while ((bucket < BET_BUCKETS - 1) && (bet >= betLimits[bucket])) bucket++;
+    return bucket;
+}
+
+static HandTally *FindSession(SessionTally **table, int *count, int *capacity, uint64_t session)
+{
+    if (2*(*count + 1) > *capacity)
+    {
+        int grown = (*capacity > 0)? *capacity*2 : 256;
+        SessionTally *resized = (SessionTally *)calloc((size_t)grown, sizeof(SessionTally));
+        if (resized == NULL) return NULL;
+
+        for (int i = 0; i < *capacity; i++)
+        {
+            if ((*table)[i].session == 0) continue;
+            int slot = (int)(((*table)[i].session*0x9E3779B97F4A7C15ULL) >> 40) & (grown - 1);
+            while (resized[slot].session != 0) slot = (slot + 1) & (grown - 1);
+            resized[slot] = (*table)[i];
+        }
+
+        free(*table);
+        *table = resized;
+        *capacity = grown;
+    }
+
+    int slot = (int)((session*0x9E3779B97F4A7C15ULL) >> 40) & (*capacity - 1);
+    while (((*table)[slot].session != 0) && ((*table)[slot].session != session)) slot = (slot + 1) & (*capacity - 1);
+    if ((*table)[slot].session == 0)
+    {
+        (*table)[slot].session = session;
+        (*count)++;
+    }
+
+    return &(*table)[slot].tally;
+}
+
+static void *QueryMain(void *argument)
+{
+    QueryWorker *worker = (QueryWorker *)argument;
+    Query *query = worker->query;
+
+    for (int item = atomic_fetch_add(&query->next, 1); item < query->itemCount; item = atomic_fetch_add(&query->next, 1))
+    {
+        HandLogCursor cursor = GetHandLogCursor(query->items[item].segment, query->items[item].checkpoint);
+        HandRecord record;
+
+        while (ReadHandRecord(&cursor, &record))
+        {
+            if (query->filter && (record.session != query->session)) continue;
+
+            AddHand(&worker->total, &record);
+            if (record.dealerCount > 1) AddHand(&worker->upcards[GetUpcardKind(record.dealerCards[1])], &record);
+            AddHand(&worker->bets[GetBetBucket(record.bet)], &record);
+
+            if (query->bySession)
+            {
+                HandTally *tally = FindSession(&worker->sessions, &worker->sessionCount, &worker->sessionCapacity, record.session);
+                if (tally != NULL) AddHand(tally, &record);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void PrintTally(const char *label, const HandTally *tally)
+{
+    if (tally->hands == 0) return;
+
+    double hands = (double)tally->hands;
+    printf("  %-20s %10llu  %6.2f%%  %6.2f%%  %6.2f%%  %14lld  %10.0f\n", label, (unsigned long long)tally->hands,
+           100.0*tally->outcomes[HAND_WIN]/hands, 100.0*tally->outcomes[HAND_PUSH]/hands, 100.0*tally->outcomes[HAND_LOSS]/hands,
+           (long long)tally->change, tally->bets/hands);
+}
+
+static void PrintTableHeader(const char *title)
+{
+    printf("\n  %-20s %10s  %7s  %7s  %7s  %14s  %10s\n", title, "hands", "win", "push", "loss", "net change", "mean bet");
+}
+
+static int CompareSessionTallies(const void *a, const void *b)
+{
+    uint64_t x = ((const SessionTally *)a)->session, y = ((const SessionTally *)b)->session;
+    return (x > y) - (x < y);
+}
+
+static int RunQuery(const char *directory, bool filter, uint64_t session, bool byUpcard, bool byBet, bool bySession, int threads)
+{
+    double start = WallTime();
+
+    HandLogSegment **segments = NULL;
+    int segmentCount = 0, indexed = 0, itemCount = 0;
+    uint64_t bytes = 0;
+
+    for (uint32_t number = 1;; number++)
+    {
+        HandLogSegment *segment = LoadHandLogSegment(directory, number);
+        if (segment == NULL) break;
+
+        HandLogSegment **grown = (HandLogSegment **)realloc(segments, (size_t)(segmentCount + 1)*sizeof(HandLogSegment *));
+        if (grown == NULL)
+        {
+            UnloadHandLogSegment(segment);
+            break;
+        }
+
+        segments = grown;
+        segments[segmentCount++] = segment;
+        indexed += IsHandLogSegmentIndexed(segment);
+        if (!filter || HasHandLogSession(segment, session))
+        {
+            itemCount += GetHandLogCheckpointCount(segment);
+            bytes += GetHandLogSegmentSize(segment);
+        }
+    }
+
+    if (segmentCount == 0)
+    {
+        fprintf(stderr, "blackjack-hands: no hand history in %s\n", directory);
+        return 1;
+    }
+
+    Query query = { 0 };
+    query.items = (QueryItem *)malloc((size_t)(itemCount + 1)*sizeof(QueryItem));
+    query.filter = filter;
+    query.session = session;
+    query.bySession = bySession;
+    atomic_init(&query.next, 0);
+
+    for (int s = 0; (query.items != NULL) && (s < segmentCount); s++)
+    {
+        if (filter && !HasHandLogSession(segments[s], session)) continue;
+        for (int c = 0; c < GetHandLogCheckpointCount(segments[s]); c++) query.items[query.itemCount++] = (QueryItem){ segments[s], c };
+    }
+
+    if (threads <= 0) threads = GetCpuCount();
+    if (threads > MAX_QUERY_THREADS) threads = MAX_QUERY_THREADS;
+
+    QueryWorker *workers = (QueryWorker *)calloc((size_t)threads, sizeof(QueryWorker));
+    if ((query.items == NULL) || (workers == NULL))
+    {
+        fprintf(stderr, "blackjack-hands: out of memory\n");
+        return 1;
+    }
+
+    for (int t = 0; t < threads; t++)
+    {
+        workers[t].query = &query;
+        if ((t > 0) && (pthread_create(&workers[t].thread, NULL, QueryMain, &workers[t]) != 0)) workers[t].query = NULL;
+    }
+    QueryMain(&workers[0]);
+    for (int t = 1; t < threads; t++) if (workers[t].query != NULL) pthread_join(workers[t].thread, NULL);
+
+    // Merge into worker 0
+    QueryWorker *result = &workers[0];
+    for (int t = 1; t < threads; t++)
+    {
+        MergeTally(&result->total, &workers[t].total);
+        for (int i = 0; i < UPCARD_KINDS; i++) MergeTally(&result->upcards[i], &workers[t].upcards[i]);
+        for (int i = 0; i < BET_BUCKETS; i++) MergeTally(&result->bets[i], &workers[t].bets[i]);
+        for (int i = 0; i < workers[t].sessionCapacity; i++)
+        {
+            if (workers[t].sessions[i].session == 0) continue;
+            HandTally *tally = FindSession(&result->sessions, &result->sessionCount, &result->sessionCapacity, workers[t].sessions[i].session);
+            if (tally != NULL) MergeTally(tally, &workers[t].sessions[i].tally);
+        }
+        free(workers[t].sessions);
+    }
+
+    double seconds = WallTime() - start;
+    printf("blackjack-hands: %s, %i segments (%i indexed), %llu hands, %.1f MB in %.3f s (%.2f M hands/s) on %i threads\n",
+           directory, segmentCount, indexed, (unsigned long long)result->total.hands, bytes/1e6, seconds,
+           (seconds > 0.0)? result->total.hands/seconds/1e6 : 0.0, threads);
+
+    PrintTableHeader("all hands");
+    PrintTally(filter? "session" : "total", &result->total);
+
+    if (byUpcard)
+    {
+        PrintTableHeader("dealer upcard");
+        for (int i = 0; i < UPCARD_KINDS; i++) PrintTally(upcardNames[i], &result->upcards[i]);
+    }
+
+    if (byBet)
+    {
+        PrintTableHeader("bet");
+        for (int i = 0; i < BET_BUCKETS; i++)
+        {
+            char label[32];
+            if (i == 0) snprintf(label, sizeof(label), "< %i", betLimits[0]);
+            else if (i == BET_BUCKETS - 1) snprintf(label, sizeof(label), ">= %i", betLimits[i - 1]);
+            else snprintf(label, sizeof(label), "%i - %i", betLimits[i - 1], betLimits[i] - 1);
+            PrintTally(label, &result->bets[i]);
+        }
+    }
+
+    if (bySession && (result->sessionCount > 0))
+    {
+        // Compact the table in place, then by session (their start times)
+        int count = 0;
+        for (int i = 0; i < result->sessionCapacity; i++) if (result->sessions[i].session != 0) result->sessions[count++] = result->sessions[i];
+        qsort(result->sessions, (size_t)count, sizeof(SessionTally), CompareSessionTallies);
+
+        PrintTableHeader("session");
+        for (int i = 0; i < count; i++)
+        {
+            char label[32];
+            snprintf(label, sizeof(label), "%llu", (unsigned long long)result->sessions[i].session);
+            PrintTally(label, &result->sessions[i].tally);
+        }
+    }
+
+    free(result->sessions);
+    free(workers);
+    free(query.items);
+    for (int s = 0; s < segmentCount; s++) UnloadHandLogSegment(segments[s]);
+    free(segments);
+    return 0;
+}
+
+//----------------------------------------------------------------------------------
+// Simulated play
+//----------------------------------------------------------------------------------
+static uint32_t NextRandom(uint64_t *state)
+{
+    *state = *state*6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(*state >> 33);
+}
+
+static int GetCardsValue(const uint8_t *cards, int count)
+{
+    int value = 0, aces = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int rank = cards[i] >> 2;
+        if (rank == 12) aces++;
+        else value += (rank >= 8)? 10 : rank + 2;
+    }
+
+    value += aces;
+    return ((aces > 0) && (value + 10 <= 21))? value + 10 : value;
+}
+
+// One round as blackjack.c plays it: deal order player, hole, player, upcard
+static void PlayRound(HandRecord *record, uint64_t *rng)
+{
+    uint8_t deck[52];
+    for (int i = 0; i < 52; i++) deck[i] = (uint8_t)((i % 13)*4 + i/13);
+    for (int i = 51; i > 0; i--)
+    {
+        int j = (int)(NextRandom(rng) % (uint32_t)(i + 1));
+        uint8_t card = deck[i];
+        deck[i] = deck[j];
+        deck[j] = card;
+    }
+
+    int next = 0;
+    record->playerCards[0] = deck[next++];
+    record->dealerCards[0] = deck[next++];
+    record->playerCards[1] = deck[next++];
+    record->dealerCards[1] = deck[next++];
+    record->playerCount = 2;
+    record->dealerCount = 2;
+
+    while ((GetCardsValue(record->playerCards, record->playerCount) < 17) && (record->playerCount < HAND_LOG_MAX_CARDS)) record->playerCards[record->playerCount++] = deck[next++];
+
+    int player = GetCardsValue(record->playerCards, record->playerCount);
+    record->stood = (player <= 21);
+    if (!record->stood)
+    {
+        record->outcome = HAND_LOSS;
+        return;
+    }
+
+    while ((GetCardsValue(record->dealerCards, record->dealerCount) < 17) && (record->dealerCount < HAND_LOG_MAX_CARDS)) record->dealerCards[record->dealerCount++] = deck[next++];
+
+    int dealer = GetCardsValue(record->dealerCards, record->dealerCount);
+    record->outcome = ((dealer > 21) || (player > dealer))? HAND_WIN : (dealer > player)? HAND_LOSS : HAND_PUSH;
+}
+
+static int RunSimulation(const char *directory, long long rounds, uint64_t seed, uint32_t segmentBytes)
+{
+    uint64_t rng = seed;
+    uint64_t now = (uint64_t)time(NULL)*1000;
+    uint64_t session = now;
+
+    HandLog *log = OpenHandLog(directory, session, segmentBytes);
+    if (log == NULL)
+    {
+        fprintf(stderr, "blackjack-hands: cannot write to %s\n", directory);
+        return 1;
+    }
+
+    double start = WallTime();
+    int balance = INITIAL_BALANCE;
+    uint32_t hand = 0;
+    long long sessions = 1, retries = 0;
+
+    for (long long round = 0; round < rounds; round++)
+    {
+        HandRecord record = { 0 };
+        record.time = now += 1000 + NextRandom(&rng) % 9000;
+        record.session = session;
+        record.hand = ++hand;
+        record.balance = balance;
+
+        // A random slice of the balance, in 100$ steps as the betting screen allows
+        int steps = balance/MIN_BET;
+        record.bet = MIN_BET*(1 + (int)(NextRandom(&rng) % (uint32_t)((steps + 3)/4)));
+
+        PlayRound(&record, &rng);
+        record.change = (record.outcome == HAND_WIN)? 2*record.bet : (record.outcome == HAND_LOSS)? -record.bet : 0;
+        balance += record.change;
+
+        // The writer catches up within a few milliseconds; a real game never gets here
+        while (!LogHand(log, &record))
+        {
+            retries++;
+            nanosleep(&(struct timespec){ 0, 1000000L }, NULL);
+        }
+
+        if ((balance <= 0) || (balance >= GOAL_BALANCE))
+        {
+            balance = INITIAL_BALANCE;
+            session = now + 1;
+            hand = 0;
+            sessions++;
+        }
+    }
+
+    CloseHandLog(log);
+
+    double seconds = WallTime() - start;
+    printf("blackjack-hands: simulated %lld rounds over %lld sessions into %s in %.3f s (%lld queue-full waits)\n",
+           rounds, sessions, directory, seconds, retries);
+    return 0;
+}
+
+//------------------------------------------------------------------------------------
+// Program Entry Point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const char *directory = "hands";
+    long long simulate = 0;
+    uint64_t seed = 1;
+    uint32_t segmentBytes = 0;
+    bool filter = false;
+    uint64_t session = 0;
+    bool byUpcard = false, byBet = false, bySession = false;
+    int threads = 0;
+    bool ok = true;
+
+    for (int i = 1; ok && (i < argc); i++)
+    {
+        const char *value = (i + 1 < argc)? argv[i + 1] : NULL;
+        ok = (value != NULL);
+        if (!ok) break;
+
+        if (strcmp(argv[i], "--dir") == 0) directory = value;
+        else if (strcmp(argv[i], "--simulate") == 0) ok = ((simulate = atoll(value)) > 0);
+        else if (strcmp(argv[i], "--seed") == 0) seed = strtoull(value, NULL, 10);
+        else if (strcmp(argv[i], "--segment-bytes") == 0) segmentBytes = (uint32_t)strtoul(value, NULL, 10);
+        else if (strcmp(argv[i], "--session") == 0)
+        {
+            filter = true;
+            session = strtoull(value, NULL, 10);
+        }
+        else if (strcmp(argv[i], "--threads") == 0) threads = atoi(value);
+        else if (strcmp(argv[i], "--by") == 0)
+        {
+            if (strcmp(value, "upcard") == 0) byUpcard = true;
+            else if (strcmp(value, "bet") == 0) byBet = true;
+            else if (strcmp(value, "session") == 0) bySession = true;
+            else ok = false;
+        }
+        else ok = false;
+        i++;
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "usage: blackjack-hands [--dir D] [--session S] [--by upcard|bet|session]... [--threads T]\n"
+                        "       blackjack-hands --simulate N [--dir D] [--seed S] [--segment-bytes B]\n");
+        return 1;
+    }
+
+    if (simulate > 0) return RunSimulation(directory, simulate, seed, segmentBytes);
+
+    if (!byUpcard && !byBet && !bySession) byUpcard = byBet = true;
+    return RunQuery(directory, filter, session, byUpcard, byBet, bySession, threads);
+}
@@ -0,0 +1,36 @@
+# Golden-frame check, run by the tests games_add_golden_test() registers:
+#
+#   cmake -DGAME=<exe> -DSEED=<n> -DFRAMES=<n> -DCHECKSUM=<hex> -DSCRATCH=<dir> -P GamesGoldenFrame.cmake
+#
+# Runs GAME headless with the software rasterizer from the working directory and fails unless
+# its last frame has raster checksum CHECKSUM. The store and settings go to SCRATCH, emptied
+# first, so neither a developer's saved state nor an earlier run changes what is drawn.
+foreach(var GAME SEED FRAMES CHECKSUM SCRATCH)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "GamesGoldenFrame: ${var} not set")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE ${SCRATCH})
+file(MAKE_DIRECTORY ${SCRATCH})
+
+set(ENV{GAMES_STORE} ${SCRATCH})
+set(ENV{GAMES_SETTINGS} ${SCRATCH}/settings.ini)
+set(ENV{GAMES_HEADLESS_SEED} ${SEED})
+set(ENV{GAMES_HEADLESS_FRAMES} ${FRAMES})
+set(ENV{GAMES_HEADLESS_RASTER} 1)
+set(ENV{GAMES_HEADLESS_PNG} ${SCRATCH}/frame.png)
+
+execute_process(COMMAND ${GAME} RESULT_VARIABLE result OUTPUT_VARIABLE output ERROR_VARIABLE output)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${GAME} exited with ${result}:\n${output}")
+endif()
+
+string(REGEX MATCH "Frame ([0-9]+) raster checksum ([0-9a-f]+)" line "${output}")
+if(NOT line)
+    message(FATAL_ERROR "${GAME} printed no raster checksum:\n${output}")
+endif()
+if(NOT CMAKE_MATCH_2 STREQUAL CHECKSUM)
+    message(FATAL_ERROR "${GAME} seed ${SEED}: frame ${CMAKE_MATCH_1} checksum ${CMAKE_MATCH_2}, expected ${CHECKSUM} (see ${SCRATCH}/frame.png)")
+endif()
+message(STATUS "${GAME} seed ${SEED}: frame ${CMAKE_MATCH_1} checksum ${CHECKSUM}")
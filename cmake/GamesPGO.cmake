@@ -0,0 +1,33 @@
+# Profile-guided optimisation build types
+#
+#   1. cmake -B build-pgo -DCMAKE_BUILD_TYPE=PGOGenerate -DGAMES_HEADLESS=ON
+#      cmake --build build-pgo --target pgo-train      (runs every game headless, writes profiles)
+#   2. cmake -B build-pgo -DCMAKE_BUILD_TYPE=PGOUse
+#      cmake --build build-pgo                          (rebuilds using the collected profiles)
+#
+# Both steps share GAMES_PGO_DIR so the same build tree can be reused.
+
+set(GAMES_PGO_PROFDATA "${GAMES_PGO_DIR}/default.profdata")
+
+if(CMAKE_C_COMPILER_ID STREQUAL "GNU")
+    set(GAMES_PGO_GENERATE_FLAGS "-fprofile-generate=${GAMES_PGO_DIR} -fprofile-update=prefer-atomic")
+    set(GAMES_PGO_USE_FLAGS "-fprofile-use=${GAMES_PGO_DIR} -fprofile-partial-training -Wno-missing-profile")
+elseif(CMAKE_C_COMPILER_ID MATCHES "Clang")
+    set(GAMES_PGO_GENERATE_FLAGS "-fprofile-generate=${GAMES_PGO_DIR}")
+    set(GAMES_PGO_USE_FLAGS "-fprofile-use=${GAMES_PGO_PROFDATA} -Wno-profile-instr-unprofiled")
+    find_program(GAMES_LLVM_PROFDATA NAMES llvm-profdata)
+endif()
+
+set(CMAKE_C_FLAGS_PGOGENERATE "-O2 -g ${GAMES_PGO_GENERATE_FLAGS}" CACHE STRING "C flags for PGO instrumented builds" FORCE)
+set(CMAKE_EXE_LINKER_FLAGS_PGOGENERATE "${GAMES_PGO_GENERATE_FLAGS}" CACHE STRING "Linker flags for PGO instrumented builds" FORCE)
+set(CMAKE_C_FLAGS_PGOUSE "-O2 -DNDEBUG ${GAMES_PGO_USE_FLAGS}" CACHE STRING "C flags for PGO optimised builds" FORCE)
+set(CMAKE_EXE_LINKER_FLAGS_PGOUSE "${GAMES_PGO_USE_FLAGS}" CACHE STRING "Linker flags for PGO optimised builds" FORCE)
+mark_as_advanced(CMAKE_C_FLAGS_PGOGENERATE CMAKE_EXE_LINKER_FLAGS_PGOGENERATE CMAKE_C_FLAGS_PGOUSE CMAKE_EXE_LINKER_FLAGS_PGOUSE)
+
+# Headless runs registered with games_add_pgo_run() are chained into this target
+add_custom_target(pgo-train COMMENT "Collecting PGO profiles from headless runs")
+if(GAMES_LLVM_PROFDATA)
+    add_custom_command(TARGET pgo-train POST_BUILD
+        COMMAND ${GAMES_LLVM_PROFDATA} merge -output=${GAMES_PGO_PROFDATA} ${GAMES_PGO_DIR}
+        COMMENT "Merging clang profiles into ${GAMES_PGO_PROFDATA}")
+endif()
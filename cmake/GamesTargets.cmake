@@ -0,0 +1,121 @@
+# Helpers shared by the per-game CMakeLists.txt files
+
+# games_add_raylib_game(<target> SOURCES <src>... [RESOURCES <dir>])
+#
+# Builds a raylib game against the platform layer and copies its resources next to the
+# executable so it runs from the build tree. With GAMES_PACK_ASSETS the resources are also
+# packed into resources.pak, which the game mounts in preference to the loose files. In
+# headless builds the game is also added to the pgo-train target, and with
+# GAMES_TRACK_ALLOCATIONS it gets an allocation test (games_add_allocation_test).
+function(games_add_raylib_game target)
+    cmake_parse_arguments(ARG "" "RESOURCES" "SOURCES" ${ARGN})
+
+    add_executable(${target} ${ARG_SOURCES})
+    target_link_libraries(${target} PRIVATE platform)
+
+    if(ARG_RESOURCES)
+        add_custom_command(TARGET ${target} POST_BUILD
+            COMMAND ${CMAKE_COMMAND} -E copy_directory
+                ${CMAKE_CURRENT_SOURCE_DIR}/${ARG_RESOURCES} $<TARGET_FILE_DIR:${target}>/${ARG_RESOURCES})
+
+        if(GAMES_PACK_ASSETS)
+            games_add_resource_pack(${target} ${ARG_RESOURCES})
+        endif()
+    endif()
+
+    if(GAMES_HEADLESS)
+        games_add_pgo_run(${target})
+    endif()
+    if(GAMES_HEADLESS AND GAMES_TRACK_ALLOCATIONS)
+        games_add_allocation_test(${target})
+    endif()
+endfunction()
+
+# games_add_resource_pack(<target> <dir>)
+#
+# Runs tools/respack over every file under <dir> to produce resources.pak next to <target>.
+function(games_add_resource_pack target dir)
+    file(GLOB_RECURSE files CONFIGURE_DEPENDS RELATIVE ${CMAKE_CURRENT_SOURCE_DIR}
+        ${CMAKE_CURRENT_SOURCE_DIR}/${dir}/*)
+    list(SORT files)
+
+    set(pack ${CMAKE_CURRENT_BINARY_DIR}/resources.pak)
+    list(TRANSFORM files PREPEND ${CMAKE_CURRENT_SOURCE_DIR}/ OUTPUT_VARIABLE sources)
+
+    add_custom_command(OUTPUT ${pack}
+        COMMAND respack ${pack} ${CMAKE_CURRENT_SOURCE_DIR} ${files}
+        DEPENDS respack ${sources}
+        COMMENT "Packing ${target} resources")
+    add_custom_target(${target}-pack ALL DEPENDS ${pack})
+endfunction()
+
+# games_add_pgo_run(<target> [ARGS <arg>...] [INPUT <file>])
+#
+# Runs <target> headless over a few input seeds as part of pgo-train. INPUT feeds a file
+# to stdin for the console games. The store and settings go to a scratch directory in the
+# build tree, so training neither reads nor writes the developer's own. The games run with
+# GAMES_HEADLESS_TRAINING, so a menu EXIT cannot end a run early and a run that still stops
+# short of its frames fails the target.
+function(games_add_pgo_run target)
+    cmake_parse_arguments(ARG "" "INPUT" "ARGS" ${ARGN})
+
+    set(scratch ${CMAKE_CURRENT_BINARY_DIR}/pgo-state-${target})
+    set(env GAMES_STORE=${scratch} GAMES_SETTINGS=${scratch}/settings.ini GAMES_HEADLESS_FRAMES=20000 GAMES_HEADLESS_TRAINING=1)
+
+    set(commands COMMAND ${CMAKE_COMMAND} -E remove_directory ${scratch})
+    foreach(seed 1 2 3 4)
+        if(ARG_INPUT)
+            list(APPEND commands COMMAND ${CMAKE_COMMAND} -E env ${env} GAMES_HEADLESS_SEED=${seed}
+                sh -c "\"$<TARGET_FILE:${target}>\" ${ARG_ARGS} < \"${ARG_INPUT}\" > /dev/null")
+        else()
+            list(APPEND commands COMMAND ${CMAKE_COMMAND} -E env ${env} GAMES_HEADLESS_SEED=${seed}
+                $<TARGET_FILE:${target}> ${ARG_ARGS})
+        endif()
+    endforeach()
+
+    add_custom_target(pgo-train-${target} ${commands}
+        WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+        DEPENDS ${target}
+        COMMENT "PGO training run: ${target}")
+    add_dependencies(pgo-train pgo-train-${target})
+endfunction()
+
+# games_add_golden_test(<target> SEED <n> FRAMES <n> CHECKSUM <hex> [ENV <var>=<value>...])
+#
+# Adds a test that runs <target> headless with the software rasterizer for FRAMES frames of
+# input seed SEED and compares the last frame's raster checksum (see GamesGoldenFrame.cmake).
+# The frame is kept as golden-<target>-<seed>/frame.png for inspection. Headless builds only.
+function(games_add_golden_test target)
+    cmake_parse_arguments(ARG "" "SEED;FRAMES;CHECKSUM" "ENV" ${ARGN})
+    if(NOT GAMES_HEADLESS)
+        return()
+    endif()
+
+    add_test(NAME golden-${target}-${ARG_SEED}
+        COMMAND ${CMAKE_COMMAND} -E env ${ARG_ENV}
+            ${CMAKE_COMMAND} -DGAME=$<TARGET_FILE:${target}> -DSEED=${ARG_SEED} -DFRAMES=${ARG_FRAMES}
+                -DCHECKSUM=${ARG_CHECKSUM} -DSCRATCH=${CMAKE_CURRENT_BINARY_DIR}/golden-${target}-${ARG_SEED}
+                -P ${PROJECT_SOURCE_DIR}/cmake/GamesGoldenFrame.cmake
+        WORKING_DIRECTORY $<TARGET_FILE_DIR:${target}>)
+endfunction()
+
+# games_add_allocation_test(<target>)
+#
+# Adds a test that plays <target> headless for 20000 frames of input seed 1 with
+# GAMES_ALLOC_CHECK=fail, so any heap allocation by the game thread after the warm-up aborts
+# it (arena.h). Training mode keeps the run in the game for every frame. The store and
+# settings start empty in a scratch directory. Needs GAMES_TRACK_ALLOCATIONS.
+function(games_add_allocation_test target)
+    set(scratch ${CMAKE_CURRENT_BINARY_DIR}/allocations-${target})
+
+    add_test(NAME allocations-${target}-setup COMMAND ${CMAKE_COMMAND} -E remove_directory ${scratch})
+    set_tests_properties(allocations-${target}-setup PROPERTIES FIXTURES_SETUP allocations-${target})
+
+    add_test(NAME allocations-${target}
+        COMMAND ${CMAKE_COMMAND} -E env GAMES_ALLOC_CHECK=fail GAMES_HEADLESS_TRAINING=1
+            GAMES_HEADLESS_SEED=1 GAMES_HEADLESS_FRAMES=20000
+            GAMES_STORE=${scratch} GAMES_SETTINGS=${scratch}/settings.ini
+            $<TARGET_FILE:${target}>
+        WORKING_DIRECTORY $<TARGET_FILE_DIR:${target}>)
+    set_tests_properties(allocations-${target} PROPERTIES FIXTURES_REQUIRED allocations-${target})
+endfunction()
@@ -0,0 +1,276 @@
+/*******************************************************************************************
+*
+*   Arena, see arena.h
+*
+********************************************************************************************/
+#include "arena.h"
+#include "platform.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(GAMES_TRACK_ALLOCATIONS) && defined(__GLIBC__)
+    #define TRACK_ALLOCATIONS
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define ARENA_ALIGNMENT         16
+#define MAX_FRAME_SITES          4      // Allocations per frame reported with their caller
+#define MAX_REPORTED_FRAMES      8      // Then only the exit summary
+#define DEFAULT_WARMUP_FRAMES   60
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static _Alignas(ARENA_ALIGNMENT) unsigned char frameArena[FRAME_ARENA_SIZE];
+static size_t arenaOffset = 0;
+static size_t arenaPeak = 0;
+static unsigned long arenaFailures = 0;
+
+static unsigned long frames = 0;
+static unsigned long warmupFrames = DEFAULT_WARMUP_FRAMES;
+static bool failOnAllocation = false;
+static unsigned long lastFrameAllocations = 0;
+static unsigned long steadyAllocations = 0;
+static unsigned long allocatingFrames = 0;
+
+#if defined(TRACK_ALLOCATIONS)
+typedef struct AllocationSite {
+    size_t size;
+    void *caller;
+} AllocationSite;
+
+static _Thread_local bool gameThread = false;   // Set on the thread that ends the frames
+static unsigned long frameAllocations = 0;
+static size_t frameAllocatedBytes = 0;
+static AllocationSite frameSites[MAX_FRAME_SITES];
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static void ReportMemory(void)
+{
+    TraceLog(LOG_INFO, "MEMORY: Frame arena peak %zu of %zu bytes over %lu frames (%lu allocations did not fit)",
+             arenaPeak, (size_t)FRAME_ARENA_SIZE, frames, arenaFailures);
+#if defined(TRACK_ALLOCATIONS)
+    TraceLog((steadyAllocations > 0)? LOG_WARNING : LOG_INFO, "MEMORY: %lu heap allocations in %lu frames after the %lu-frame warm-up",
+             steadyAllocations, allocatingFrames, warmupFrames);
+#endif
+}
+
+static void StartTracking(void)
+{
+    const char *check = getenv("GAMES_ALLOC_CHECK");
+    const char *warmup = getenv("GAMES_ALLOC_WARMUP");
+
+    failOnAllocation = (check != NULL) && (strcmp(check, "fail") == 0);
+    if (warmup != NULL) warmupFrames = strtoul(warmup, NULL, 10);
+#if defined(TRACK_ALLOCATIONS)
+    gameThread = true;
+#endif
+    atexit(ReportMemory);
+}
+
+#if defined(TRACK_ALLOCATIONS)
+static inline void CountAllocation(size_t size, void *caller)
+{
+    if (!gameThread) return;
+
+    if (frameAllocations < MAX_FRAME_SITES) frameSites[frameAllocations] = (AllocationSite){ size, caller };
+    frameAllocations++;
+    frameAllocatedBytes += size;
+}
+
+// Closes the tracked frame. Whatever the reporting itself allocates is dropped with the counts
+static void CheckFrameAllocations(void)
+{
+    unsigned long count = frameAllocations;
+    size_t bytes = frameAllocatedBytes;
+    lastFrameAllocations = count;
+
+    if ((count > 0) && (frames > warmupFrames))
+    {
+        steadyAllocations += count;
+        if (allocatingFrames++ < MAX_REPORTED_FRAMES)
+        {
+            TraceLog(LOG_WARNING, "MEMORY: Frame %lu made %lu heap allocations (%zu bytes)", frames, count, bytes);
+            for (unsigned long i = 0; (i < count) && (i < MAX_FRAME_SITES); i++)
+            {
+                TraceLog(LOG_WARNING, "MEMORY:     %zu bytes from %p", frameSites[i].size, frameSites[i].caller);
+            }
+        }
+
+        if (failOnAllocation)
+        {
+            ReportMemory();
+            TraceLog(LOG_ERROR, "MEMORY: Heap allocation in a steady-state frame (GAMES_ALLOC_CHECK=fail)");
+            abort();
+        }
+    }
+
+    frameAllocations = 0;
+    frameAllocatedBytes = 0;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void *FrameAlloc(size_t size)
+{
+    size_t aligned = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    if ((aligned < size) || (aligned > FRAME_ARENA_SIZE - arenaOffset))
+    {
+        if (arenaFailures++ == 0) TraceLog(LOG_WARNING, "MEMORY: Frame arena full (%zu bytes), raise FRAME_ARENA_SIZE", (size_t)FRAME_ARENA_SIZE);
+        return NULL;
+    }
+
+    void *memory = frameArena + arenaOffset;
+    arenaOffset += aligned;
+    return memory;
+}
+
+const char *FrameFormat(const char *text, ...)
+{
+    // Format straight into the free end of the arena, then claim what was used
+    size_t available = FRAME_ARENA_SIZE - arenaOffset;
+    char *buffer = (char *)frameArena + arenaOffset;
+
+    va_list args;
+    va_start(args, text);
+    int length = (available > 0)? vsnprintf(buffer, available, text, args) : -1;
+    va_end(args);
+
+    if ((length < 0) || ((size_t)length >= available))
+    {
+        if (arenaFailures++ == 0) TraceLog(LOG_WARNING, "MEMORY: Frame arena full (%zu bytes), raise FRAME_ARENA_SIZE", (size_t)FRAME_ARENA_SIZE);
+        return "";
+    }
+
+    FrameAlloc((size_t)length + 1);
+    return buffer;
+}
+
+void EndMemoryFrame(void)
+{
+    if (frames == 0) StartTracking();
+    frames++;
+
+    if (arenaOffset > arenaPeak) arenaPeak = arenaOffset;
+    arenaOffset = 0;
+
+#if defined(TRACK_ALLOCATIONS)
+    CheckFrameAllocations();
+#endif
+}
+
+MemoryPool LoadMemoryPool(size_t objectSize, int capacity)
+{
+    MemoryPool pool = { 0 };
+
+    if (objectSize < sizeof(void *)) objectSize = sizeof(void *);
+    pool.objectSize = (objectSize + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    pool.storage = (capacity > 0)? (unsigned char *)malloc(pool.objectSize*(size_t)capacity) : NULL;
+
+    if (pool.storage != NULL) pool.capacity = capacity;
+    else if (capacity > 0) TraceLog(LOG_WARNING, "MEMORY: Failed to allocate a pool of %i x %zu bytes", capacity, pool.objectSize);
+
+    return pool;
+}
+
+void UnloadMemoryPool(MemoryPool *pool)
+{
+    free(pool->storage);
+    *pool = (MemoryPool){ 0 };
+}
+
+void *PoolAlloc(MemoryPool *pool)
+{
+    void *object = pool->freeList;
+
+    if (object != NULL) memcpy(&pool->freeList, object, sizeof(void *));
+    else if (pool->fresh < pool->capacity) object = pool->storage + pool->objectSize*(size_t)pool->fresh++;
+    else return NULL;
+
+    memset(object, 0, pool->objectSize);
+    if (++pool->used > pool->peak) pool->peak = pool->used;
+    return object;
+}
+
+void PoolFree(MemoryPool *pool, void *object)
+{
+    if (object == NULL) return;
+
+    memcpy(object, &pool->freeList, sizeof(void *));
+    pool->freeList = object;
+    pool->used--;
+}
+
+MemoryStats GetMemoryStats(void)
+{
+    MemoryStats stats = { 0 };
+
+    stats.frames = frames;
+    stats.arenaSize = FRAME_ARENA_SIZE;
+    stats.arenaPeak = (arenaOffset > arenaPeak)? arenaOffset : arenaPeak;
+    stats.arenaFailures = arenaFailures;
+#if defined(TRACK_ALLOCATIONS)
+    stats.tracking = true;
+#endif
+    stats.frameAllocations = lastFrameAllocations;
+    stats.steadyAllocations = steadyAllocations;
+    stats.allocatingFrames = allocatingFrames;
+
+    return stats;
+}
+
+//----------------------------------------------------------------------------------
+// Heap wrappers: glibc's allocator underneath, counted on the game thread
+//----------------------------------------------------------------------------------
+#if defined(TRACK_ALLOCATIONS)
+void *malloc(size_t size)
+{
+    CountAllocation(size, __builtin_return_address(0));
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    CountAllocation(count*size, __builtin_return_address(0));
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    CountAllocation(size, __builtin_return_address(0));
+    return __libc_realloc(pointer, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    CountAllocation(size, __builtin_return_address(0));
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **memory, size_t alignment, size_t size)
+{
+    if ((alignment < sizeof(void *)) || ((alignment & (alignment - 1)) != 0)) return EINVAL;
+
+    CountAllocation(size, __builtin_return_address(0));
+    *memory = __libc_memalign(alignment, size);
+    return (*memory != NULL)? 0 : ENOMEM;
+}
+#endif
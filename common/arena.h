@@ -0,0 +1,82 @@
+/*******************************************************************************************
+*
+*   Arena: per-frame scratch memory, fixed-capacity object pools and a heap allocation tracker
+*
+*   The frame arena is a static block handed out linearly by FrameAlloc()/FrameFormat() and
+*   rewound by EndMemoryFrame(), which EndDrawing() calls, so anything a frame builds for
+*   itself (formatted text, scratch arrays) costs a pointer bump and is gone next frame.
+*   Only the game (main) thread may use it. When the block runs out FrameAlloc() returns
+*   NULL rather than reaching for the heap.
+*
+*   A MemoryPool holds objects of one size that outlive a frame: all the storage is taken
+*   when the pool is loaded, after which PoolAlloc()/PoolFree() are free-list pushes and pops.
+*   Pools do no locking of their own.
+*
+*   With GAMES_TRACK_ALLOCATIONS (cmake -DGAMES_TRACK_ALLOCATIONS=ON, glibc only) malloc,
+*   calloc, realloc and the aligned variants are wrapped, and every heap allocation the game
+*   thread makes between two EndDrawing() calls is counted. After a warm-up of
+*   GAMES_ALLOC_WARMUP frames (default 60) any such allocation is reported with its caller
+*   address; GAMES_ALLOC_CHECK=fail aborts on it, so a headless run doubles as the test that
+*   the steady state makes no heap allocations; headless builds register that run per game
+*   as the allocations-<game> ctest. Worker threads are not counted.
+*
+********************************************************************************************/
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if !defined(FRAME_ARENA_SIZE)
+    #define FRAME_ARENA_SIZE    (256*1024)
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct MemoryPool {
+    unsigned char *storage;
+    size_t objectSize;              // Rounded up to the pool alignment
+    int capacity;
+    int fresh;                      // Objects never handed out start here
+    int used;
+    int peak;
+    void *freeList;                 // Released objects, linked through their first bytes
+} MemoryPool;
+
+typedef struct MemoryStats {
+    unsigned long frames;
+    size_t arenaSize;
+    size_t arenaPeak;               // Most arena bytes one frame used
+    unsigned long arenaFailures;    // FrameAlloc() calls that did not fit
+    bool tracking;                  // Built with GAMES_TRACK_ALLOCATIONS
+    unsigned long frameAllocations;     // Heap allocations on the game thread, last frame
+    unsigned long steadyAllocations;    // Same, summed over the frames after the warm-up
+    unsigned long allocatingFrames;     // Frames after the warm-up with any allocation
+} MemoryStats;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Frame arena (game thread only)
+void *FrameAlloc(size_t size);                          // 16-byte aligned, NULL when the arena is full
+const char *FrameFormat(const char *text, ...);         // TextFormat() without the four-buffer reuse
+void EndMemoryFrame(void);                              // Rewinds the arena and closes the tracked frame
+
+// Object pools
+MemoryPool LoadMemoryPool(size_t objectSize, int capacity);
+void UnloadMemoryPool(MemoryPool *pool);
+void *PoolAlloc(MemoryPool *pool);                      // Zeroed, NULL when the pool is exhausted
+void PoolFree(MemoryPool *pool, void *object);
+
+#define LoadTypedPool(type, capacity)   LoadMemoryPool(sizeof(type), (capacity))
+#define PoolNew(pool, type)             ((type *)PoolAlloc(pool))
+
+MemoryStats GetMemoryStats(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // ARENA_H
@@ -0,0 +1,713 @@
+/*******************************************************************************************
+*
+*   Asset manager: background decoding, main-thread upload, ref-counted handles, hot reload
+*
+*   Slots live in a fixed table owned by the main thread. Workers never touch a slot: a load
+*   job carries a copy of the path plus the slot index/generation, and the decoded result
+*   comes back through the completion queue. UpdateAssets() drops results whose generation
+*   no longer matches (the asset was released while it was decoding).
+*
+*   The watcher thread only reads path/mtime under slotLock and queues reload jobs, so the
+*   game thread never waits on stat() or file I/O.
+*
+********************************************************************************************/
+#include "assets.h"
+#include "arena.h"
+#include "mixer.h"
+#include "pack.h"
+#include "platform.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_ASSETS                  256
+#define MAX_ASSET_PATH              256
+#define MAX_ASSET_WORKERS             4
+#define MAX_UPLOADS_PER_FRAME         4     // Bounds the main-thread cost of a burst of loads
+#define MAX_ASSET_PACKS               4
+#define MAX_ASSET_JOBS      (2*MAX_ASSETS)  // A load and a queued reload per slot
+
+typedef enum AssetType { ASSET_TEXTURE = 0, ASSET_SOUND, ASSET_MUSIC } AssetType;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct AssetSlot {
+    char path[MAX_ASSET_PATH];
+    AssetType type;
+    AssetState state;
+    unsigned int generation;
+    int refCount;
+    bool reloadQueued;
+    bool packed;                    // Served from a mounted pack: immutable, not watched
+    time_t modTime;
+    Texture2D texture;
+    MixerSound sound;               // Sounds and music
+    Wave wave;                      // Samples behind sound
+    bool waveMapped;                // wave.data points into fileData or a pack mapping
+    unsigned char *fileData;        // Owned file bytes backing a streamed music track (loose files only)
+} AssetSlot;
+
+typedef struct AssetJob {
+    struct AssetJob *next;
+    char path[MAX_ASSET_PATH];
+    AssetType type;
+    int index;
+    unsigned int generation;
+    bool reload;
+    const ResourcePack *pack;       // Non-NULL: load from this pack entry instead of the file
+    const PackEntry *entry;
+
+    // Filled by the worker
+    AssetState result;
+    time_t modTime;
+    Image image;
+    bool imageMapped;               // image.data points into a pack mapping
+    Wave wave;
+    bool waveMapped;                // wave.data points into fileData or a pack mapping
+    unsigned char *fileData;        // Owned copy (loose music files)
+} AssetJob;
+
+typedef struct JobQueue {
+    AssetJob *head;
+    AssetJob *tail;
+} JobQueue;
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static AssetSlot slots[MAX_ASSETS] = { 0 };
+static pthread_mutex_t slotLock = PTHREAD_MUTEX_INITIALIZER;
+
+static JobQueue pendingJobs = { 0 };
+static JobQueue doneJobs = { 0 };
+static MemoryPool jobPool = { 0 };          // Under jobLock: hot reloads never reach the heap
+static int jobsInFlight = 0;                // Queued + decoding + awaiting upload
+static pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobAvailable = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t jobDone = PTHREAD_COND_INITIALIZER;
+
+static pthread_t workers[MAX_ASSET_WORKERS];
+static int workerCount = 0;
+static pthread_t watcher;
+static pthread_cond_t watcherWake = PTHREAD_COND_INITIALIZER;
+static bool watcherRunning = false;
+#if defined(NDEBUG)
+static bool hotReload = false;              // Under slotLock. Release builds never stat() their assets
+#else
+static bool hotReload = true;
+#endif
+static float hotReloadInterval = 0.5f;      // Under slotLock
+static bool shuttingDown = false;
+static int reloadCount = 0;
+static ResourcePack *packs[MAX_ASSET_PACKS] = { 0 };
+static int packCount = 0;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static void PushJob(JobQueue *queue, AssetJob *job)
+{
+    job->next = NULL;
+    if (queue->tail != NULL) queue->tail->next = job;
+    else queue->head = job;
+    queue->tail = job;
+}
+
+static AssetJob *PopJob(JobQueue *queue)
+{
+    AssetJob *job = queue->head;
+    if (job != NULL)
+    {
+        queue->head = job->next;
+        if (queue->head == NULL) queue->tail = NULL;
+    }
+    return job;
+}
+
+static bool GetModTime(const char *path, time_t *modTime)
+{
+    struct stat info;
+    if (stat(path, &info) != 0) return false;
+
+    *modTime = info.st_mtime;
+    return true;
+}
+
+static unsigned char *ReadWholeFile(const char *path, int *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char *data = (length > 0)? (unsigned char *)malloc((size_t)length) : NULL;
+    if ((data != NULL) && (fread(data, 1, (size_t)length, file) != (size_t)length))
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+
+    *size = (data != NULL)? (int)length : 0;
+    return data;
+}
+
+// PCM WAV music is streamed by the mixer straight from the file bytes; anything else
+// (QOA from a pack, compressed formats) is decoded here in full
+static void DecodeWave(AssetJob *job, const unsigned char *data, int size, const char *fileType)
+{
+    if (job->type == ASSET_MUSIC) job->wave = GetMixerWaveView(data, size);
+    job->waveMapped = (job->wave.data != NULL);
+    if (!job->waveMapped) job->wave = LoadWaveFromMemory(fileType, data, size);
+
+    job->result = (job->wave.data != NULL)? ASSET_READY : ASSET_FAILED;
+}
+
+// Worker side for packed entries: raw images and music streams are used in place
+static void DecodePackedJob(AssetJob *job)
+{
+    const PackEntry *entry = job->entry;
+    const unsigned char *data = GetPackEntryData(job->pack, entry);
+    const char *fileType = (entry->kind == PACK_ENTRY_QOA)? ".qoa" : GetFileExtension(job->path);
+
+    switch (job->type)
+    {
+        case ASSET_TEXTURE:
+            if (entry->kind == PACK_ENTRY_IMAGE)
+            {
+                job->image = (Image){ (void *)data, entry->width, entry->height, 1, (int)entry->format };
+                job->imageMapped = true;
+            }
+            else job->image = LoadImageFromMemory(fileType, data, (int)entry->size);
+            job->result = (job->image.width > 0)? ASSET_READY : ASSET_FAILED;
+            break;
+        case ASSET_SOUND:
+        case ASSET_MUSIC:
+            DecodeWave(job, data, (int)entry->size, fileType);
+            break;
+    }
+}
+
+// Worker side: everything that can run without the GL context or audio device
+static void DecodeJob(AssetJob *job)
+{
+    if (job->entry != NULL)
+    {
+        DecodePackedJob(job);
+        return;
+    }
+
+    if (!GetModTime(job->path, &job->modTime))
+    {
+        job->result = ASSET_MISSING;
+        return;
+    }
+
+    switch (job->type)
+    {
+        case ASSET_TEXTURE:
+            job->image = LoadImage(job->path);
+            job->result = (job->image.width > 0)? ASSET_READY : ASSET_FAILED;
+            break;
+        case ASSET_SOUND:
+            job->wave = LoadWave(job->path);
+            job->result = (job->wave.data != NULL)? ASSET_READY : ASSET_FAILED;
+            break;
+        case ASSET_MUSIC:
+        {
+            int size = 0;
+            job->fileData = ReadWholeFile(job->path, &size);
+            DecodeWave(job, job->fileData, size, GetFileExtension(job->path));
+            if (!job->waveMapped)
+            {
+                free(job->fileData);
+                job->fileData = NULL;
+            }
+        } break;
+    }
+}
+
+static void FreeJob(AssetJob *job)
+{
+    if ((job->image.data != NULL) && !job->imageMapped) UnloadImage(job->image);
+    if ((job->wave.data != NULL) && !job->waveMapped) UnloadWave(job->wave);
+    free(job->fileData);
+
+    pthread_mutex_lock(&jobLock);
+    PoolFree(&jobPool, job);
+    pthread_mutex_unlock(&jobLock);
+}
+
+static void *WorkerMain(void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&jobLock);
+    while (true)
+    {
+        while (!shuttingDown && (pendingJobs.head == NULL)) pthread_cond_wait(&jobAvailable, &jobLock);
+        if (shuttingDown) break;
+
+        AssetJob *job = PopJob(&pendingJobs);
+        pthread_mutex_unlock(&jobLock);
+
+        DecodeJob(job);
+
+        pthread_mutex_lock(&jobLock);
+        PushJob(&doneJobs, job);
+        pthread_cond_broadcast(&jobDone);
+    }
+    pthread_mutex_unlock(&jobLock);
+
+    return NULL;
+}
+
+// Called with slotLock held so the path copy is consistent
+static void QueueLoad(int index, bool reload)
+{
+    pthread_mutex_lock(&jobLock);
+    AssetJob *job = PoolNew(&jobPool, AssetJob);
+    pthread_mutex_unlock(&jobLock);
+    if (job == NULL)
+    {
+        // Never leave the slot waiting on a job that does not exist; a failed reload keeps the previous version
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Failed to queue asset load (job pool exhausted)", slots[index].path);
+        if (slots[index].state != ASSET_READY) slots[index].state = ASSET_FAILED;
+        slots[index].reloadQueued = false;
+        return;
+    }
+
+    memcpy(job->path, slots[index].path, MAX_ASSET_PATH);
+    job->type = slots[index].type;
+    job->index = index;
+    job->generation = slots[index].generation;
+    job->reload = reload;
+
+    for (int i = 0; (i < packCount) && (job->entry == NULL); i++)
+    {
+        job->entry = FindPackEntry(packs[i], job->path);
+        job->pack = packs[i];
+    }
+
+    pthread_mutex_lock(&jobLock);
+    jobsInFlight++;
+    if (workerCount > 0)
+    {
+        PushJob(&pendingJobs, job);
+        pthread_cond_signal(&jobAvailable);
+    }
+    else
+    {
+        // No pool (threads unavailable): decode inline, upload still happens in UpdateAssets()
+        DecodeJob(job);
+        PushJob(&doneJobs, job);
+    }
+    pthread_mutex_unlock(&jobLock);
+}
+
+static void *WatcherMain(void *arg)
+{
+    (void)arg;
+
+    static char paths[MAX_ASSETS][MAX_ASSET_PATH];
+    static unsigned int generations[MAX_ASSETS];
+    static time_t knownTimes[MAX_ASSETS];
+    static bool knownMissing[MAX_ASSETS];
+
+    pthread_mutex_lock(&slotLock);
+    while (!shuttingDown)
+    {
+        // Switched off, the watcher sleeps until SetAssetsHotReload() or CloseAssets()
+        if (!hotReload)
+        {
+            pthread_cond_wait(&watcherWake, &slotLock);
+            continue;
+        }
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        long long nanos = deadline.tv_nsec + (long long)(hotReloadInterval*1e9f);
+        deadline.tv_sec += (time_t)(nanos/1000000000LL);
+        deadline.tv_nsec = (long)(nanos%1000000000LL);
+
+        pthread_cond_timedwait(&watcherWake, &slotLock, &deadline);
+        if (shuttingDown || !hotReload) continue;
+
+        // Snapshot under the lock, stat() without it
+        int count = 0;
+        int indices[MAX_ASSETS];
+        for (int i = 0; i < MAX_ASSETS; i++)
+        {
+            AssetSlot *slot = &slots[i];
+            if ((slot->refCount == 0) || slot->packed || slot->reloadQueued || (slot->state == ASSET_LOADING)) continue;
+
+            indices[count] = i;
+            memcpy(paths[count], slot->path, MAX_ASSET_PATH);
+            generations[count] = slot->generation;
+            knownTimes[count] = slot->modTime;
+            knownMissing[count] = (slot->state == ASSET_MISSING);
+            count++;
+        }
+        pthread_mutex_unlock(&slotLock);
+
+        bool changed[MAX_ASSETS];
+        for (int n = 0; n < count; n++)
+        {
+            time_t modTime = 0;
+            changed[n] = GetModTime(paths[n], &modTime) && (knownMissing[n] || (modTime != knownTimes[n]));
+        }
+
+        pthread_mutex_lock(&slotLock);
+        for (int n = 0; n < count; n++)
+        {
+            AssetSlot *slot = &slots[indices[n]];
+            if (!changed[n] || (slot->refCount == 0) || (slot->generation != generations[n]) || slot->reloadQueued) continue;
+
+            slot->reloadQueued = true;
+            QueueLoad(indices[n], true);
+        }
+    }
+    pthread_mutex_unlock(&slotLock);
+
+    return NULL;
+}
+
+static void UnloadSlotResource(AssetSlot *slot)
+{
+    switch (slot->type)
+    {
+        case ASSET_TEXTURE: if (slot->texture.id > 0) UnloadTexture(slot->texture); break;
+        case ASSET_SOUND:
+        case ASSET_MUSIC:
+            UnloadMixerSound(slot->sound);      // Returns once the mixer has let go of the samples
+            if ((slot->wave.data != NULL) && !slot->waveMapped) UnloadWave(slot->wave);
+            free(slot->fileData);
+            break;
+    }
+
+    slot->texture = (Texture2D){ 0 };
+    slot->sound = (MixerSound){ 0 };
+    slot->wave = (Wave){ 0 };
+    slot->waveMapped = false;
+    slot->fileData = NULL;
+}
+
+// Main-thread side of a finished job: GPU/audio-device upload and slot update
+static void CompleteJob(AssetJob *job)
+{
+    AssetSlot *slot = &slots[job->index];
+    if ((slot->refCount == 0) || (slot->generation != job->generation)) return;
+
+    if (job->result != ASSET_READY)
+    {
+        // A failed reload keeps the previous version on screen
+        bool report = (slot->state != ASSET_READY) && (slot->state != job->result);
+
+        pthread_mutex_lock(&slotLock);
+        slot->modTime = job->modTime;
+        if (slot->state != ASSET_READY) slot->state = job->result;
+        pthread_mutex_unlock(&slotLock);
+
+        if (report && (job->result == ASSET_MISSING)) TraceLog(LOG_WARNING, "ASSETS: [%s] Missing asset (file not found)", slot->path);
+        else if (report) TraceLog(LOG_WARNING, "ASSETS: [%s] Failed to decode asset", slot->path);
+        return;
+    }
+
+    bool wasPlaying = false;
+    if (job->reload && (slot->state == ASSET_READY))
+    {
+        if (slot->type == ASSET_MUSIC) wasPlaying = IsMixerMusicPlaying(slot->sound);
+        UnloadSlotResource(slot);
+        reloadCount++;
+        TraceLog(LOG_INFO, "ASSETS: [%s] Hot reloaded", slot->path);
+    }
+
+    switch (slot->type)
+    {
+        case ASSET_TEXTURE: slot->texture = LoadTextureFromImage(job->image); break;
+        case ASSET_SOUND:
+        case ASSET_MUSIC:
+            // The slot takes over the samples; the job must not free them
+            slot->wave = job->wave;
+            slot->waveMapped = job->waveMapped;
+            slot->fileData = job->fileData;
+            job->wave = (Wave){ 0 };
+            job->fileData = NULL;
+            slot->sound = LoadMixerSound(slot->wave);
+            if (wasPlaying) PlayMixerMusic(slot->sound);
+            break;
+    }
+
+    pthread_mutex_lock(&slotLock);
+    slot->modTime = job->modTime;
+    slot->packed = (job->entry != NULL);
+    slot->state = ASSET_READY;
+    pthread_mutex_unlock(&slotLock);
+}
+
+static void ProcessCompleted(int maxUploads)
+{
+    for (int uploads = 0; (maxUploads <= 0) || (uploads < maxUploads); uploads++)
+    {
+        pthread_mutex_lock(&jobLock);
+        AssetJob *job = PopJob(&doneJobs);
+        pthread_mutex_unlock(&jobLock);
+        if (job == NULL) break;
+
+        CompleteJob(job);
+
+        pthread_mutex_lock(&slotLock);
+        if (slots[job->index].generation == job->generation) slots[job->index].reloadQueued = false;
+        pthread_mutex_unlock(&slotLock);
+
+        pthread_mutex_lock(&jobLock);
+        jobsInFlight--;
+        pthread_cond_broadcast(&jobDone);
+        pthread_mutex_unlock(&jobLock);
+
+        FreeJob(job);
+    }
+}
+
+static AssetSlot *GetSlot(AssetHandle handle)
+{
+    int index = (int)(handle.id & 0xFFFF) - 1;
+    if ((index < 0) || (index >= MAX_ASSETS)) return NULL;
+
+    AssetSlot *slot = &slots[index];
+    return ((slot->refCount > 0) && (slot->generation == (handle.id >> 16)))? slot : NULL;
+}
+
+static AssetHandle RequestAsset(const char *fileName, AssetType type)
+{
+    AssetHandle handle = { 0 };
+    if ((fileName == NULL) || (strlen(fileName) >= MAX_ASSET_PATH))
+    {
+        TraceLog(LOG_WARNING, "ASSETS: Invalid asset path");
+        return handle;
+    }
+
+    int freeIndex = -1;
+    for (int i = 0; i < MAX_ASSETS; i++)
+    {
+        if (slots[i].refCount == 0)
+        {
+            if (freeIndex < 0) freeIndex = i;
+            continue;
+        }
+
+        if ((slots[i].type == type) && (strcmp(slots[i].path, fileName) == 0))
+        {
+            pthread_mutex_lock(&slotLock);
+            slots[i].refCount++;
+            pthread_mutex_unlock(&slotLock);
+            handle.id = (slots[i].generation << 16) | (unsigned int)(i + 1);
+            return handle;
+        }
+    }
+
+    if (freeIndex < 0)
+    {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Asset table full (%i slots)", fileName, MAX_ASSETS);
+        return handle;
+    }
+
+    pthread_mutex_lock(&slotLock);
+    AssetSlot *slot = &slots[freeIndex];
+    strcpy(slot->path, fileName);
+    slot->type = type;
+    slot->state = ASSET_LOADING;
+    slot->refCount = 1;
+    slot->reloadQueued = false;
+    slot->packed = false;
+    slot->modTime = 0;
+    QueueLoad(freeIndex, false);
+    pthread_mutex_unlock(&slotLock);
+
+    handle.id = (slot->generation << 16) | (unsigned int)(freeIndex + 1);
+    return handle;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void InitAssets(int count)
+{
+    if (count <= 0)
+    {
+        int cores = GetCpuCount();
+        count = (cores > 1)? cores - 1 : 1;
+    }
+    if (count > MAX_ASSET_WORKERS) count = MAX_ASSET_WORKERS;
+
+    shuttingDown = false;
+    workerCount = 0;
+    if (jobPool.storage == NULL) jobPool = LoadTypedPool(AssetJob, MAX_ASSET_JOBS);
+    for (int i = 0; i < count; i++)
+    {
+        if (pthread_create(&workers[workerCount], NULL, WorkerMain, NULL) == 0) workerCount++;
+    }
+
+    watcherRunning = (pthread_create(&watcher, NULL, WatcherMain, NULL) == 0);
+
+    TraceLog(LOG_INFO, "ASSETS: Asset manager initialized (%i workers, hot reload %s)", workerCount, hotReload? "on" : "off");
+}
+
+void CloseAssets(void)
+{
+    pthread_mutex_lock(&slotLock);
+    pthread_mutex_lock(&jobLock);
+    shuttingDown = true;
+    pthread_cond_broadcast(&jobAvailable);
+    pthread_cond_signal(&watcherWake);
+    pthread_mutex_unlock(&jobLock);
+    pthread_mutex_unlock(&slotLock);
+
+    for (int i = 0; i < workerCount; i++) pthread_join(workers[i], NULL);
+    if (watcherRunning) pthread_join(watcher, NULL);
+    workerCount = 0;
+    watcherRunning = false;
+
+    AssetJob *job = NULL;
+    while ((job = PopJob(&pendingJobs)) != NULL) FreeJob(job);
+    while ((job = PopJob(&doneJobs)) != NULL) FreeJob(job);
+    jobsInFlight = 0;
+    UnloadMemoryPool(&jobPool);
+
+    for (int i = 0; i < MAX_ASSETS; i++)
+    {
+        if (slots[i].refCount > 0) UnloadSlotResource(&slots[i]);
+        slots[i].refCount = 0;
+        slots[i].state = ASSET_EMPTY;
+        slots[i].generation = (slots[i].generation + 1) & 0xFFFF;
+    }
+
+    // Music streams read straight from the mappings, so packs go last
+    for (int i = 0; i < packCount; i++) UnloadResourcePack(packs[i]);
+    packCount = 0;
+}
+
+bool MountAssetPack(const char *fileName)
+{
+    if (packCount >= MAX_ASSET_PACKS) return false;
+
+    ResourcePack *pack = LoadResourcePack(fileName);
+    if (pack == NULL)
+    {
+        TraceLog(LOG_INFO, "ASSETS: [%s] No resource pack, using loose files", fileName);
+        return false;
+    }
+
+    packs[packCount++] = pack;
+    return true;
+}
+
+void UpdateAssets(void)
+{
+    ProcessCompleted(MAX_UPLOADS_PER_FRAME);
+}
+
+void WaitAssets(void)
+{
+    while (true)
+    {
+        ProcessCompleted(0);
+
+        pthread_mutex_lock(&jobLock);
+        bool idle = (jobsInFlight == 0);
+        if (!idle && (doneJobs.head == NULL)) pthread_cond_wait(&jobDone, &jobLock);
+        pthread_mutex_unlock(&jobLock);
+
+        if (idle) break;
+    }
+}
+
+// The watcher re-arms at once, so a new interval or switch applies now
+void SetAssetsHotReload(bool enabled, float intervalSeconds)
+{
+    pthread_mutex_lock(&slotLock);
+    hotReload = enabled;
+    if (intervalSeconds > 0.0f) hotReloadInterval = intervalSeconds;
+    pthread_cond_signal(&watcherWake);
+    pthread_mutex_unlock(&slotLock);
+}
+
+AssetHandle RequestTexture(const char *fileName) { return RequestAsset(fileName, ASSET_TEXTURE); }
+AssetHandle RequestSound(const char *fileName) { return RequestAsset(fileName, ASSET_SOUND); }
+AssetHandle RequestMusic(const char *fileName) { return RequestAsset(fileName, ASSET_MUSIC); }
+
+void ReleaseAsset(AssetHandle handle)
+{
+    AssetSlot *slot = GetSlot(handle);
+    if (slot == NULL) return;
+
+    pthread_mutex_lock(&slotLock);
+    bool unload = (--slot->refCount == 0);
+    if (unload)
+    {
+        slot->state = ASSET_EMPTY;
+        slot->generation = (slot->generation + 1) & 0xFFFF;
+    }
+    pthread_mutex_unlock(&slotLock);
+
+    if (unload) UnloadSlotResource(slot);
+}
+
+AssetState GetAssetState(AssetHandle handle)
+{
+    AssetSlot *slot = GetSlot(handle);
+    return (slot != NULL)? slot->state : ASSET_EMPTY;
+}
+
+bool IsAssetReady(AssetHandle handle) { return GetAssetState(handle) == ASSET_READY; }
+
+Texture2D GetAssetTexture(AssetHandle handle)
+{
+    AssetSlot *slot = GetSlot(handle);
+    return ((slot != NULL) && (slot->type == ASSET_TEXTURE))? slot->texture : (Texture2D){ 0 };
+}
+
+MixerSound GetAssetSound(AssetHandle handle)
+{
+    AssetSlot *slot = GetSlot(handle);
+    return ((slot != NULL) && (slot->type == ASSET_SOUND))? slot->sound : (MixerSound){ 0 };
+}
+
+MixerSound GetAssetMusic(AssetHandle handle)
+{
+    AssetSlot *slot = GetSlot(handle);
+    return ((slot != NULL) && (slot->type == ASSET_MUSIC))? slot->sound : (MixerSound){ 0 };
+}
+
+AssetStats GetAssetStats(void)
+{
+    AssetStats stats = { 0 };
+
+    for (int i = 0; i < MAX_ASSETS; i++)
+    {
+        if (slots[i].refCount == 0) continue;
+
+        stats.live++;
+        switch (slots[i].state)
+        {
+            case ASSET_LOADING: stats.loading++; break;
+            case ASSET_READY: stats.ready++; break;
+            case ASSET_MISSING: stats.missing++; break;
+            case ASSET_FAILED: stats.failed++; break;
+            default: break;
+        }
+    }
+    stats.reloads = reloadCount;
+
+    return stats;
+}
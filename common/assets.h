@@ -0,0 +1,76 @@
+/*******************************************************************************************
+*
+*   Asset manager: background decoding, main-thread upload, ref-counted handles, hot reload
+*
+*   RequestTexture()/RequestSound()/RequestMusic() return immediately with a handle; files
+*   are read and decoded on a small worker pool and turned into GPU textures / audio buffers
+*   by UpdateAssets() on the main thread (which owns the GL context), or registered with the
+*   mixer (see mixer.h) for sounds and music. Requesting a path that is already cached just
+*   bumps its reference count.
+*
+*   Always fetch the resource through GetAsset*() at the point of use rather than keeping a
+*   copy: a hot reload replaces (and unloads) the underlying texture or sound.
+*
+*   Paths found in a mounted resource pack are served from the mapping instead of the file
+*   system: pre-converted images upload straight from it and PCM music streams from it.
+*
+*   Missing files are reported once through TraceLog(LOG_WARNING) and stay in the table, so
+*   they are picked up by the watcher if they appear later. The watcher polls file times only
+*   while hot reload is on: by default in development builds (no NDEBUG), off in release ones.
+*
+********************************************************************************************/
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "platform.h"
+#include "mixer.h"
+
+typedef struct AssetHandle {
+    unsigned int id;        // 0 = invalid
+} AssetHandle;
+
+typedef enum AssetState {
+    ASSET_EMPTY = 0,
+    ASSET_LOADING,          // Queued or decoding on a worker
+    ASSET_READY,
+    ASSET_MISSING,          // File not found
+    ASSET_FAILED            // File present but could not be decoded
+} AssetState;
+
+typedef struct AssetStats {
+    int live;               // Slots in use
+    int loading;
+    int ready;
+    int missing;
+    int failed;
+    int reloads;            // Hot reloads applied since InitAssets()
+} AssetStats;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void InitAssets(int workerCount);                   // Start the worker pool (<= 0: pick from core count)
+void CloseAssets(void);                             // Stop workers and unload everything still cached
+void UpdateAssets(void);                            // Upload finished decodes (call once per frame, main thread)
+void WaitAssets(void);                              // Block until every queued asset is ready, missing or failed
+void SetAssetsHotReload(bool enabled, float intervalSeconds);
+bool MountAssetPack(const char *fileName);          // Serve matching paths from a resource pack (see pack.h)
+
+AssetHandle RequestTexture(const char *fileName);
+AssetHandle RequestSound(const char *fileName);
+AssetHandle RequestMusic(const char *fileName);
+void ReleaseAsset(AssetHandle handle);              // Drop one reference; unloads at zero
+
+AssetState GetAssetState(AssetHandle handle);
+bool IsAssetReady(AssetHandle handle);
+Texture2D GetAssetTexture(AssetHandle handle);      // Zeroed texture until ready
+MixerSound GetAssetSound(AssetHandle handle);       // Invalid sound until ready (safe to PlayMixerSound)
+MixerSound GetAssetMusic(AssetHandle handle);       // Invalid sound until ready (safe to PlayMixerMusic)
+AssetStats GetAssetStats(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // ASSETS_H
@@ -0,0 +1,529 @@
+/*******************************************************************************************
+*
+*   Console platform layer for the terminal games (ttt)
+*
+*   Screen output is double-buffered: ConsolePrint() fills an off-screen cell buffer and
+*   ConsolePresent() compares it with what the terminal is known to show, emitting cursor
+*   moves, SGR attribute changes and characters only for the cells that differ, all in one
+*   write(). Nothing is cleared on screen, so there is no flicker and no shell process.
+*
+*   Whatever the user types after a prompt is echoed by the terminal behind our back, so the
+*   rest of the prompt row is marked unknown after every present and rewritten next time. A
+*   terminal resize, or a prompt on the bottom row (the echoed newline scrolls the screen),
+*   forces a full repaint instead.
+*
+********************************************************************************************/
+#include "console.h"
+#include "mixer.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !defined(_WIN32)
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+#elif !defined(PLATFORM_HEADLESS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+    #include <mmsystem.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_CONSOLE_SOUNDS      8
+#define MAX_CONSOLE_SOUND_PATH  128
+
+#define MAX_CONSOLE_COLUMNS   256
+#define MAX_CONSOLE_ROWS      128
+#define DEFAULT_CONSOLE_COLUMNS 80
+#define DEFAULT_CONSOLE_ROWS    24
+#define MAX_CONSOLE_PRINT    1024      // Formatted once on the stack, longer text goes to the heap
+
+#define CELL_UNKNOWN           -1      // Front buffer: the terminal content is not known
+
+// Cell attributes, packed as flags | fg << 6 | bg << 11 (colour 0 is the default, 1-8 the
+// normal palette, 9-16 the bright one)
+#define ATTR_BOLD           0x01
+#define ATTR_DIM            0x02
+#define ATTR_ITALIC         0x04
+#define ATTR_UNDERLINE      0x08
+#define ATTR_BLINK          0x10
+#define ATTR_REVERSE        0x20
+#define ATTR_FG_SHIFT          6
+#define ATTR_BG_SHIFT         11
+#define ATTR_COLOR_MASK     0x1F
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ConsoleCell {
+    int codepoint;              // CELL_UNKNOWN only in the front buffer
+    unsigned short attr;
+} ConsoleCell;
+
+typedef struct ConsoleScreen {
+    ConsoleCell back[MAX_CONSOLE_ROWS][MAX_CONSOLE_COLUMNS];    // Frame being printed
+    ConsoleCell front[MAX_CONSOLE_ROWS][MAX_CONSOLE_COLUMNS];   // What the terminal shows
+    int columns, rows;
+    int cursorX, cursorY;       // Print position in the back buffer
+    unsigned short pen;         // Attribute for the next printed character (persists across frames)
+    unsigned short shownPen;    // Attribute the terminal was left with by the last present
+    bool repaint;               // Front buffer invalid: clear the terminal on the next present
+    bool pending;               // Back buffer changed since the last present
+    bool initialized;
+    char *output;               // Escape stream for one present, grown as needed
+    size_t outputSize, outputCapacity;
+} ConsoleScreen;
+
+typedef struct ConsoleSound {
+    char fileName[MAX_CONSOLE_SOUND_PATH];
+    Wave wave;
+    MixerSound sound;           // Invalid when the file could not be loaded (reported once)
+} ConsoleSound;
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static ConsoleSound consoleSounds[MAX_CONSOLE_SOUNDS] = { 0 };
+static int consoleSoundCount = 0;
+static bool consoleSoundsRegistered = false;      // Waves freed at exit (CloseMixer() just forgets their sounds)
+
+static ConsoleScreen screen = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static void UnloadConsoleSounds(void)
+{
+    for (int i = 0; i < consoleSoundCount; i++)
+    {
+        UnloadMixerSound(consoleSounds[i].sound);
+        UnloadWave(consoleSounds[i].wave);
+    }
+    consoleSoundCount = 0;
+}
+
+static void GetTerminalSize(int *columns, int *rows)
+{
+    *columns = DEFAULT_CONSOLE_COLUMNS;
+    *rows = DEFAULT_CONSOLE_ROWS;
+
+#if !defined(_WIN32)
+    struct winsize size;
+    if ((ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) && (size.ws_col > 0) && (size.ws_row > 0))
+    {
+        *columns = size.ws_col;
+        *rows = size.ws_row;
+    }
+#endif
+
+    if (*columns > MAX_CONSOLE_COLUMNS) *columns = MAX_CONSOLE_COLUMNS;
+    if (*rows > MAX_CONSOLE_ROWS) *rows = MAX_CONSOLE_ROWS;
+}
+
+static void ClearCells(ConsoleCell *cells, int count, int codepoint)
+{
+    for (int i = 0; i < count; i++) cells[i] = (ConsoleCell){ codepoint, 0 };
+}
+
+static void CloseConsoleScreen(void)
+{
+    ConsolePresent();
+    free(screen.output);
+    screen.output = NULL;
+    screen.outputCapacity = 0;
+}
+
+static void InitConsoleScreen(void)
+{
+    if (screen.initialized) return;
+
+    screen.initialized = true;
+    screen.repaint = true;
+    GetTerminalSize(&screen.columns, &screen.rows);
+    for (int y = 0; y < MAX_CONSOLE_ROWS; y++) ClearCells(screen.back[y], MAX_CONSOLE_COLUMNS, ' ');
+    atexit(CloseConsoleScreen);
+}
+
+// Terminal behaviour when printing past the bottom row: everything moves up one line
+static void ScrollBackBuffer(void)
+{
+    memmove(screen.back[0], screen.back[1], sizeof(screen.back[0])*(size_t)(screen.rows - 1));
+    ClearCells(screen.back[screen.rows - 1], MAX_CONSOLE_COLUMNS, ' ');
+    screen.cursorY = screen.rows - 1;
+}
+
+static void NewLine(void)
+{
+    screen.cursorX = 0;
+    if (++screen.cursorY >= screen.rows) ScrollBackBuffer();
+}
+
+static void PutCodepoint(int codepoint)
+{
+    if (screen.cursorX >= screen.columns) NewLine();     // Auto-wrap, as the terminal would
+
+    screen.back[screen.cursorY][screen.cursorX++] = (ConsoleCell){ codepoint, screen.pen };
+}
+
+static unsigned short SetAttrColor(unsigned short attr, int shift, int color)
+{
+    return (unsigned short)((attr & ~(ATTR_COLOR_MASK << shift)) | (color << shift));
+}
+
+// Select Graphic Rendition; parameters the cell buffer cannot represent are ignored
+static void ApplySgr(const int *params, int count)
+{
+    static const unsigned short flags[10] = { 0, ATTR_BOLD, ATTR_DIM, ATTR_ITALIC, ATTR_UNDERLINE, ATTR_BLINK, 0, ATTR_REVERSE, 0, 0 };
+
+    if (count == 0) screen.pen = 0;      // "ESC[m" is a reset
+
+    for (int i = 0; i < count; i++)
+    {
+        int p = params[i];
+
+        if (p == 0) screen.pen = 0;
+        else if (p < 10) screen.pen |= flags[p];
+        else if (p == 22) screen.pen &= ~(ATTR_BOLD | ATTR_DIM);
+        else if ((p >= 23) && (p <= 27)) screen.pen &= ~flags[p - 20];
+        else if ((p >= 30) && (p <= 37)) screen.pen = SetAttrColor(screen.pen, ATTR_FG_SHIFT, p - 30 + 1);
+        else if (p == 39) screen.pen = SetAttrColor(screen.pen, ATTR_FG_SHIFT, 0);
+        else if ((p >= 40) && (p <= 47)) screen.pen = SetAttrColor(screen.pen, ATTR_BG_SHIFT, p - 40 + 1);
+        else if (p == 49) screen.pen = SetAttrColor(screen.pen, ATTR_BG_SHIFT, 0);
+        else if ((p >= 90) && (p <= 97)) screen.pen = SetAttrColor(screen.pen, ATTR_FG_SHIFT, p - 90 + 9);
+        else if ((p >= 100) && (p <= 107)) screen.pen = SetAttrColor(screen.pen, ATTR_BG_SHIFT, p - 100 + 9);
+    }
+}
+
+// Control sequence starting after "ESC[", returns the bytes consumed
+static int ParseCsi(const unsigned char *text)
+{
+    int params[16] = { 0 };
+    int count = 0;
+    int i = 0;
+
+    while (((text[i] >= '0') && (text[i] <= '9')) || (text[i] == ';'))
+    {
+        if (count == 0) count = 1;
+        if (text[i] == ';') { if (count < 16) count++; }
+        else params[count - 1] = params[count - 1]*10 + (text[i] - '0');
+        i++;
+    }
+
+    if (text[i] == '\0') return i;
+
+    if (text[i] == 'm') ApplySgr(params, count);
+    else if ((text[i] == 'J') && (params[0] == 2)) ConsoleClear();
+    else if (text[i] == 'H')
+    {
+        screen.cursorY = (count > 0)? params[0] - 1 : 0;
+        screen.cursorX = (count > 1)? params[1] - 1 : 0;
+        if ((screen.cursorY < 0) || (screen.cursorY >= screen.rows)) screen.cursorY = 0;
+        if ((screen.cursorX < 0) || (screen.cursorX >= screen.columns)) screen.cursorX = 0;
+    }
+
+    return i + 1;
+}
+
+// Decode one UTF-8 sequence, invalid bytes come out as '?'
+static int DecodeUtf8(const unsigned char *text, int *codepoint)
+{
+    int length = (text[0] < 0x80)? 1 : ((text[0] & 0xE0) == 0xC0)? 2 : ((text[0] & 0xF0) == 0xE0)? 3 : ((text[0] & 0xF8) == 0xF0)? 4 : 0;
+    if (length == 0) { *codepoint = '?'; return 1; }
+
+    *codepoint = (length == 1)? text[0] : (text[0] & (0x7F >> length));
+    for (int i = 1; i < length; i++)
+    {
+        if ((text[i] & 0xC0) != 0x80) { *codepoint = '?'; return i; }
+        *codepoint = (*codepoint << 6) | (text[i] & 0x3F);
+    }
+
+    return length;
+}
+
+static void Emit(const char *data, size_t size)
+{
+    if (screen.outputSize + size > screen.outputCapacity)
+    {
+        size_t capacity = (screen.outputCapacity > 0)? screen.outputCapacity : 4096;
+        while (capacity < screen.outputSize + size) capacity *= 2;
+
+        char *output = (char *)realloc(screen.output, capacity);
+        if (output == NULL) return;
+        screen.output = output;
+        screen.outputCapacity = capacity;
+    }
+
+    memcpy(screen.output + screen.outputSize, data, size);
+    screen.outputSize += size;
+}
+
+static void EmitFormat(const char *format, int a, int b)
+{
+    char text[32];
+    int length = snprintf(text, sizeof(text), format, a, b);
+    Emit(text, (size_t)length);
+}
+
+static void EmitAttr(unsigned short attr)
+{
+    static const char flagCodes[6] = { '1', '2', '3', '4', '5', '7' };
+
+    char text[40] = "\033[0";
+    int length = 3;
+
+    for (int i = 0; i < 6; i++)
+    {
+        if (attr & (1 << i)) { text[length++] = ';'; text[length++] = flagCodes[i]; }
+    }
+
+    int fg = (attr >> ATTR_FG_SHIFT) & ATTR_COLOR_MASK;
+    int bg = (attr >> ATTR_BG_SHIFT) & ATTR_COLOR_MASK;
+    if (fg > 0) length += sprintf(text + length, ";%i", (fg <= 8)? 30 + fg - 1 : 90 + fg - 9);
+    if (bg > 0) length += sprintf(text + length, ";%i", (bg <= 8)? 40 + bg - 1 : 100 + bg - 9);
+
+    text[length++] = 'm';
+    Emit(text, (size_t)length);
+}
+
+static void EmitCodepoint(int codepoint)
+{
+    char text[4];
+    int length = 1;
+
+    if (codepoint < 0x80) text[0] = (char)codepoint;
+    else if (codepoint < 0x800) { text[0] = (char)(0xC0 | (codepoint >> 6)); text[1] = (char)(0x80 | (codepoint & 0x3F)); length = 2; }
+    else if (codepoint < 0x10000) { text[0] = (char)(0xE0 | (codepoint >> 12)); text[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F)); text[2] = (char)(0x80 | (codepoint & 0x3F)); length = 3; }
+    else { text[0] = (char)(0xF0 | (codepoint >> 18)); text[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F)); text[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F)); text[3] = (char)(0x80 | (codepoint & 0x3F)); length = 4; }
+
+    Emit(text, (size_t)length);
+}
+
+static void WriteOutput(void)
+{
+    fflush(stdout);     // Anything printed with stdio must land before the frame
+
+#if defined(_WIN32)
+    fwrite(screen.output, 1, screen.outputSize, stdout);
+    fflush(stdout);
+#else
+    size_t written = 0;
+    while (written < screen.outputSize)
+    {
+        ssize_t result = write(STDOUT_FILENO, screen.output + written, screen.outputSize - written);
+        if (result <= 0) break;
+        written += (size_t)result;
+    }
+#endif
+
+    screen.outputSize = 0;
+}
+
+static ConsoleSound *GetConsoleSound(const char *fileName)
+{
+    for (int i = 0; i < consoleSoundCount; i++)
+    {
+        if (strcmp(consoleSounds[i].fileName, fileName) == 0) return &consoleSounds[i];
+    }
+
+    if ((consoleSoundCount == MAX_CONSOLE_SOUNDS) || (strlen(fileName) >= MAX_CONSOLE_SOUND_PATH)) return NULL;
+
+    ConsoleSound *sound = &consoleSounds[consoleSoundCount++];
+    strcpy(sound->fileName, fileName);
+    sound->wave = LoadWave(fileName);
+    if (sound->wave.data != NULL) sound->sound = LoadMixerSound(sound->wave);
+
+    return sound;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void ConsoleClear(void)
+{
+    InitConsoleScreen();
+
+    int columns, rows;
+    GetTerminalSize(&columns, &rows);
+    if ((columns != screen.columns) || (rows != screen.rows))
+    {
+        screen.columns = columns;
+        screen.rows = rows;
+        screen.repaint = true;
+    }
+
+    for (int y = 0; y < screen.rows; y++) ClearCells(screen.back[y], screen.columns, ' ');
+    screen.cursorX = 0;
+    screen.cursorY = 0;
+    screen.pending = true;
+}
+
+void ConsolePrint(const char *format, ...)
+{
+    InitConsoleScreen();
+
+    char buffer[MAX_CONSOLE_PRINT];
+    char *text = buffer;
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (length < 0) return;
+    if (length >= (int)sizeof(buffer))
+    {
+        text = (char *)malloc((size_t)length + 1);
+        if (text == NULL) return;
+
+        va_start(args, format);
+        vsnprintf(text, (size_t)length + 1, format, args);
+        va_end(args);
+    }
+
+    const unsigned char *c = (const unsigned char *)text;
+    while (*c != '\0')
+    {
+        if ((c[0] == '\033') && (c[1] == '[')) { c += 2 + ParseCsi(c + 2); continue; }
+
+        switch (*c)
+        {
+            case '\n': NewLine(); c++; break;
+            case '\r': screen.cursorX = 0; c++; break;
+            case '\b': if (screen.cursorX > 0) screen.cursorX--; c++; break;
+            case '\t': do PutCodepoint(' '); while (screen.cursorX % 8); c++; break;
+            default:
+            {
+                int codepoint = 0;
+                c += DecodeUtf8(c, &codepoint);
+                if (codepoint >= ' ') PutCodepoint(codepoint);
+            } break;
+        }
+    }
+
+    if (text != buffer) free(text);
+    screen.pending = true;
+}
+
+void ConsolePresent(void)
+{
+    if (!screen.initialized || !screen.pending) return;
+
+    int x = -1, y = -1;         // Terminal cursor, -1 when unknown
+    unsigned short attr = screen.shownPen;
+
+    if (screen.repaint)
+    {
+        const char *clear = "\033[0m\033[H\033[2J";
+        Emit(clear, strlen(clear));
+        for (int row = 0; row < screen.rows; row++) ClearCells(screen.front[row], screen.columns, ' ');
+        x = y = 0;
+        attr = 0;
+        screen.repaint = false;
+    }
+
+    for (int row = 0; row < screen.rows; row++)
+    {
+        // Past the last printed cell the row is blank, which one erase-to-end-of-line covers
+        int blankFrom = screen.columns;
+        while ((blankFrom > 0) && (screen.back[row][blankFrom - 1].codepoint == ' ') && (screen.back[row][blankFrom - 1].attr == 0)) blankFrom--;
+
+        for (int column = 0; column < screen.columns; column++)
+        {
+            ConsoleCell cell = screen.back[row][column];
+            ConsoleCell *shown = &screen.front[row][column];
+            if ((shown->codepoint == cell.codepoint) && (shown->attr == cell.attr)) continue;
+
+            if (column >= blankFrom)
+            {
+                if ((y != row) || (x != column)) EmitFormat("\033[%i;%iH", row + 1, column + 1);
+                if (attr != 0) { EmitAttr(0); attr = 0; }
+                Emit("\033[K", 3);
+                ClearCells(shown, screen.columns - column, ' ');
+                y = row;
+                x = column;
+                break;
+            }
+
+            // Short gaps are cheaper to overwrite than to jump over
+            if ((y == row) && (x >= 0) && (x < column) && (column - x <= 4))
+            {
+                for (; x < column; x++)
+                {
+                    ConsoleCell skip = screen.back[row][x];
+                    if (skip.attr != attr) { EmitAttr(skip.attr); attr = skip.attr; }
+                    EmitCodepoint(skip.codepoint);
+                    screen.front[row][x] = skip;
+                }
+            }
+            else if ((y != row) || (x != column)) EmitFormat("\033[%i;%iH", row + 1, column + 1);
+
+            if (cell.attr != attr) { EmitAttr(cell.attr); attr = cell.attr; }
+            EmitCodepoint(cell.codepoint);
+            *shown = cell;
+
+            // Writing the last column leaves the cursor in a pending-wrap state
+            y = row;
+            x = (column + 1 < screen.columns)? column + 1 : -1;
+        }
+    }
+
+    // Park the cursor after the text, with the pen the next input echo should use
+    if ((y != screen.cursorY) || (x != screen.cursorX)) EmitFormat("\033[%i;%iH", screen.cursorY + 1, screen.cursorX + 1);
+    if (screen.pen != attr) EmitAttr(screen.pen);
+    screen.shownPen = screen.pen;
+
+    WriteOutput();
+
+    // Typed input lands after the prompt; a newline typed on the bottom row scrolls everything
+    for (int column = screen.cursorX; column < screen.columns; column++) screen.front[screen.cursorY][column].codepoint = CELL_UNKNOWN;
+    if (screen.cursorY + 1 >= screen.rows) screen.repaint = true;
+
+    screen.pending = false;
+}
+
+// The mixer only when the game opened one; the terminal games need no audio device otherwise
+void ConsolePlaySound(const char *fileName, int flags)
+{
+    if (!IsMixerReady())
+    {
+#if defined(_WIN32) && !defined(PLATFORM_HEADLESS)
+        DWORD sndFlags = SND_FILENAME;
+        if (flags & CONSOLE_SOUND_ASYNC) sndFlags |= SND_ASYNC;
+        if (flags & CONSOLE_SOUND_LOOP) sndFlags |= SND_LOOP;
+        PlaySoundA(fileName, NULL, sndFlags);
+#endif
+        return;
+    }
+
+    if (!consoleSoundsRegistered)
+    {
+        consoleSoundsRegistered = true;
+        atexit(UnloadConsoleSounds);
+    }
+
+    ConsoleSound *sound = GetConsoleSound(fileName);
+    if ((sound == NULL) || (sound->sound.id == 0)) return;
+
+    // Menus re-request their loop on every redraw; keep it running rather than restarting it
+    if (flags & CONSOLE_SOUND_LOOP)
+    {
+        if (!IsMixerMusicPlaying(sound->sound)) PlayMixerMusic(sound->sound);
+        return;
+    }
+
+    // Sounds overlap instead of cutting each other off; only a synchronous play waits
+    PlayMixerSound(sound->sound);
+    if (!(flags & CONSOLE_SOUND_ASYNC))
+    {
+        float seconds = GetMixerSoundLength(sound->sound);
+        struct timespec wait = { (time_t)seconds, (long)((seconds - (float)(time_t)seconds)*1e9f) };
+        nanosleep(&wait, NULL);
+    }
+}
@@ -0,0 +1,39 @@
+/*******************************************************************************************
+*
+*   Console platform layer for the terminal games (ttt)
+*
+*   Wraps the Windows-only pieces (system("cls"), winmm PlaySound) so the console games
+*   build on Linux. Text is printed into an off-screen cell buffer and ConsolePresent()
+*   writes only the cells that changed since the last frame, as ANSI escapes in a single
+*   write: no shell process, no full-screen clear, no flicker on slow links. SGR colour
+*   escapes in the printed text are kept. When the game has opened the mixer (mixer.h),
+*   sounds go through it, so an async sound no longer cuts off the one before it the way
+*   SND_ASYNC did. Otherwise Windows plays them with winmm PlaySound and other platforms
+*   drop them: the console never opens an audio device itself.
+*
+*   Present before reading input; pending output is also presented at exit.
+*
+********************************************************************************************/
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdbool.h>
+
+// Flags for ConsolePlaySound(), mirroring winmm SND_ASYNC/SND_LOOP
+#define CONSOLE_SOUND_ASYNC   1
+#define CONSOLE_SOUND_LOOP    2
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void ConsoleClear(void);                                    // Start a new frame: blank the off-screen buffer, home its cursor
+void ConsolePrint(const char *format, ...);                 // printf into the off-screen buffer (\n, \r, \t, \b and SGR escapes)
+void ConsolePresent(void);                                  // Write the changed cells in one write, cursor left after the text
+void ConsolePlaySound(const char *fileName, int flags);     // Play a WAV file (LOOP: as music, replacing the last loop)
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CONSOLE_H
@@ -0,0 +1,50 @@
+/*******************************************************************************************
+*
+*   Fixed, see fixed.h
+*
+********************************************************************************************/
+#include "fixed.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+int CheckCollisionFixedRecPairs(const Fixed *ax, const Fixed *ay, const Fixed *aw, const Fixed *ah,
+                                const Fixed *bx, const Fixed *by, const Fixed *bw, const Fixed *bh,
+                                int count, uint8_t *hits)
+{
+    int total = 0;
+    int i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x0 = _mm_loadu_si128((const __m128i *)(ax + i));
+        __m128i y0 = _mm_loadu_si128((const __m128i *)(ay + i));
+        __m128i x1 = _mm_loadu_si128((const __m128i *)(bx + i));
+        __m128i y1 = _mm_loadu_si128((const __m128i *)(by + i));
+        __m128i right0 = _mm_add_epi32(x0, _mm_loadu_si128((const __m128i *)(aw + i)));
+        __m128i bottom0 = _mm_add_epi32(y0, _mm_loadu_si128((const __m128i *)(ah + i)));
+        __m128i right1 = _mm_add_epi32(x1, _mm_loadu_si128((const __m128i *)(bw + i)));
+        __m128i bottom1 = _mm_add_epi32(y1, _mm_loadu_si128((const __m128i *)(bh + i)));
+
+        __m128i overlapX = _mm_and_si128(_mm_cmplt_epi32(x0, right1), _mm_cmpgt_epi32(right0, x1));
+        __m128i overlapY = _mm_and_si128(_mm_cmplt_epi32(y0, bottom1), _mm_cmpgt_epi32(bottom0, y1));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(overlapX, overlapY)));
+
+        for (int lane = 0; lane < 4; lane++) hits[i + lane] = (mask >> lane) & 1;
+        total += __builtin_popcount(mask);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        hits[i] = CheckCollisionFixedRecs((FixedRect){ ax[i], ay[i], aw[i], ah[i] }, (FixedRect){ bx[i], by[i], bw[i], bh[i] });
+        total += hits[i];
+    }
+
+    return total;
+}
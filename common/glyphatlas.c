@@ -0,0 +1,381 @@
+/*******************************************************************************************
+*
+*   Glyph atlas, see glyphatlas.h
+*
+********************************************************************************************/
+#include "glyphatlas.h"
+#include "textcache.h"
+
+#if !defined(PLATFORM_HEADLESS)
+    #include "rlgl.h"
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_ATLAS_SHELVES        64
+#define GLYPH_HASH_SIZE        1024         // Power of two, at least twice MAX_ATLAS_GLYPHS
+#define GLYPH_PADDING             1         // Transparent border, so filtering never reaches a neighbour
+#define SHELF_ROUNDING            4         // Shelf heights are multiples of this, so similar glyphs share
+#define FREE_GLYPH               -1         // Codepoint of an unused slot; never matches a lookup
+#define NO_SHELF                 -1         // Slot with no pixels (spaces)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct AtlasShelf {
+    int y;
+    int height;                     // Padding included
+    int used;                       // Pixels taken from the left
+    unsigned int stamp;             // Last string that drew from it
+} AtlasShelf;
+
+struct GlyphAtlas {
+    unsigned char *fontData;
+    int fontDataSize;
+    int pixelSize;
+    Texture2D texture;
+
+    // The Font view: slot i is recs[i]/glyphs[i], free slots hold FREE_GLYPH
+    Rectangle recs[MAX_ATLAS_GLYPHS];
+    GlyphInfo glyphs[MAX_ATLAS_GLYPHS];
+    short shelfOf[MAX_ATLAS_GLYPHS];
+    int slotCount;                  // Slots ever handed out, the view's glyphCount
+    int freeSlots[MAX_ATLAS_GLYPHS];
+    int freeCount;
+    short hash[GLYPH_HASH_SIZE];    // Slot + 1, 0: empty
+
+    AtlasShelf shelves[MAX_ATLAS_SHELVES];
+    int shelfCount;
+    int top;                        // First row no shelf covers
+    unsigned int stamp;
+
+    Color *scratch;                 // One padded glyph, RGBA
+    int scratchSide;
+    bool overflowed;                // Warned that a string did not fit
+    GlyphAtlasStats stats;
+};
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static inline uint32_t HashCodepoint(int codepoint) { return (uint32_t)codepoint*2654435761u; }
+
+static int FindGlyph(const GlyphAtlas *atlas, int codepoint)
+{
+    for (uint32_t i = HashCodepoint(codepoint);; i++)
+    {
+        int slot = atlas->hash[i & (GLYPH_HASH_SIZE - 1)] - 1;
+        if ((slot < 0) || (atlas->glyphs[slot].value == codepoint)) return slot;
+    }
+}
+
+static void InsertGlyph(GlyphAtlas *atlas, int slot)
+{
+    uint32_t i = HashCodepoint(atlas->glyphs[slot].value);
+    while (atlas->hash[i & (GLYPH_HASH_SIZE - 1)] != 0) i++;
+    atlas->hash[i & (GLYPH_HASH_SIZE - 1)] = (short)(slot + 1);
+}
+
+// Open addressing cannot just blank a deleted key; evictions are rare enough to rebuild
+static void RebuildHash(GlyphAtlas *atlas)
+{
+    memset(atlas->hash, 0, sizeof(atlas->hash));
+    for (int i = 0; i < atlas->slotCount; i++)
+    {
+        if (atlas->glyphs[i].value != FREE_GLYPH) InsertGlyph(atlas, i);
+    }
+}
+
+static void FreeSlot(GlyphAtlas *atlas, int slot)
+{
+    atlas->recs[slot] = (Rectangle){ 0 };
+    atlas->glyphs[slot] = (GlyphInfo){ .value = FREE_GLYPH };
+    atlas->shelfOf[slot] = NO_SHELF;
+    atlas->freeSlots[atlas->freeCount++] = slot;
+    atlas->stats.glyphs--;
+}
+
+// Pixels about to be overwritten may still be sampled by queued quads and cached layouts
+static void ReleaseAtlasPixels(void)
+{
+    rlDrawRenderBatchActive();
+    ClearTextCache();
+}
+
+static void EvictShelf(GlyphAtlas *atlas, int shelf)
+{
+    ReleaseAtlasPixels();
+
+    for (int i = 0; i < atlas->slotCount; i++)
+    {
+        if ((atlas->glyphs[i].value != FREE_GLYPH) && (atlas->shelfOf[i] == shelf)) FreeSlot(atlas, i);
+    }
+
+    atlas->shelves[shelf].used = 0;
+    atlas->stats.evictions++;
+    RebuildHash(atlas);
+}
+
+static void ResetGlyphAtlas(GlyphAtlas *atlas)
+{
+    ReleaseAtlasPixels();
+
+    memset(atlas->hash, 0, sizeof(atlas->hash));
+    atlas->slotCount = 0;
+    atlas->freeCount = 0;
+    atlas->shelfCount = 0;
+    atlas->top = 0;
+    atlas->stats.glyphs = 0;
+    atlas->stats.shelves = 0;
+    atlas->stats.resets++;
+}
+
+// Least recently stamped shelf not in use by the current string, at least height tall; -1: none
+static int FindEvictableShelf(const GlyphAtlas *atlas, int height)
+{
+    int victim = -1;
+
+    for (int i = 0; i < atlas->shelfCount; i++)
+    {
+        const AtlasShelf *shelf = &atlas->shelves[i];
+        if ((shelf->stamp == atlas->stamp) || (shelf->height < height)) continue;
+        if ((victim < 0) || (shelf->stamp < atlas->shelves[victim].stamp)) victim = i;
+    }
+
+    return victim;
+}
+
+// Tightest shelf with room; a new shelf when that would waste over a third of the height;
+// then any shelf with room; then the least recently used one tall enough, emptied
+static int PlaceGlyph(GlyphAtlas *atlas, int width, int height)
+{
+    int best = -1;
+
+    for (int i = 0; i < atlas->shelfCount; i++)
+    {
+        const AtlasShelf *shelf = &atlas->shelves[i];
+        if ((shelf->height < height) || (shelf->used + width > GLYPH_ATLAS_SIZE)) continue;
+        if ((best < 0) || (shelf->height < atlas->shelves[best].height)) best = i;
+    }
+
+    int shelfHeight = (height + SHELF_ROUNDING - 1)/SHELF_ROUNDING*SHELF_ROUNDING;
+    bool roomBelow = (atlas->shelfCount < MAX_ATLAS_SHELVES) && (atlas->top + shelfHeight <= GLYPH_ATLAS_SIZE);
+
+    if ((best >= 0) && (!roomBelow || (atlas->shelves[best].height*2 <= height*3))) return best;
+
+    if (roomBelow)
+    {
+        atlas->shelves[atlas->shelfCount] = (AtlasShelf){ atlas->top, shelfHeight, 0, 0 };
+        atlas->top += shelfHeight;
+        atlas->stats.shelves = atlas->shelfCount + 1;
+        return atlas->shelfCount++;
+    }
+
+    if (best >= 0) return best;
+
+    int victim = FindEvictableShelf(atlas, height);
+    if (victim >= 0) EvictShelf(atlas, victim);
+    return victim;
+}
+
+// The slot comes back blank, so an eviction before it is filled passes it by
+static int TakeSlot(GlyphAtlas *atlas)
+{
+    int slot = -1;
+
+    if (atlas->freeCount > 0) slot = atlas->freeSlots[--atlas->freeCount];
+    else if (atlas->slotCount < MAX_ATLAS_GLYPHS) slot = atlas->slotCount++;
+    else
+    {
+        // Every slot resident: empty the least recently used shelf to get some back
+        int victim = FindEvictableShelf(atlas, 0);
+        if (victim >= 0) EvictShelf(atlas, victim);
+        if (atlas->freeCount > 0) slot = atlas->freeSlots[--atlas->freeCount];
+    }
+
+    if (slot >= 0)
+    {
+        atlas->recs[slot] = (Rectangle){ 0 };
+        atlas->glyphs[slot] = (GlyphInfo){ .value = FREE_GLYPH };
+        atlas->shelfOf[slot] = NO_SHELF;
+    }
+
+    return slot;
+}
+
+// White with the glyph's coverage as alpha, in a transparent border, as LoadFontEx() builds it
+static void UploadGlyph(GlyphAtlas *atlas, Image image, int x, int y)
+{
+    int width = image.width + 2*GLYPH_PADDING, height = image.height + 2*GLYPH_PADDING;
+    const unsigned char *coverage = (const unsigned char *)image.data;
+
+    for (int i = 0; i < width*height; i++) atlas->scratch[i] = (Color){ 255, 255, 255, 0 };
+    for (int row = 0; row < image.height; row++)
+    {
+        Color *line = &atlas->scratch[(row + GLYPH_PADDING)*width + GLYPH_PADDING];
+        for (int col = 0; col < image.width; col++) line[col].a = coverage[row*image.width + col];
+    }
+
+    UpdateTextureRec(atlas->texture, (Rectangle){ (float)x, (float)y, (float)width, (float)height }, atlas->scratch);
+}
+
+static bool RequireGlyph(GlyphAtlas *atlas, int codepoint)
+{
+    int slot = FindGlyph(atlas, codepoint);
+    if (slot >= 0)
+    {
+        if (atlas->shelfOf[slot] != NO_SHELF) atlas->shelves[atlas->shelfOf[slot]].stamp = atlas->stamp;
+        return true;
+    }
+
+    slot = TakeSlot(atlas);
+    if (slot < 0) return false;
+
+    // A codepoint the font cannot give is kept as an empty glyph, so it is only asked once
+    GlyphInfo *rasterized = LoadFontData(atlas->fontData, atlas->fontDataSize, atlas->pixelSize, &codepoint, 1, FONT_DEFAULT);
+    GlyphInfo glyph = (rasterized != NULL)? rasterized[0] : (GlyphInfo){ 0 };
+    int width = glyph.image.width + 2*GLYPH_PADDING, height = glyph.image.height + 2*GLYPH_PADDING;
+    bool hasPixels = (codepoint != ' ') && (codepoint != '\t') && (glyph.image.data != NULL) &&
+                     (glyph.image.width > 0) && (glyph.image.height > 0) && (glyph.image.format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+
+    if (hasPixels && ((width > atlas->scratchSide) || (height > atlas->scratchSide)))
+    {
+        TraceLog(LOG_WARNING, "GLYPHS: Glyph U+%04X too large for the atlas (%i x %i)", codepoint, glyph.image.width, glyph.image.height);
+        hasPixels = false;
+    }
+
+    int shelf = hasPixels? PlaceGlyph(atlas, width, height) : NO_SHELF;
+    if (hasPixels && (shelf < 0))
+    {
+        atlas->freeSlots[atlas->freeCount++] = slot;
+        UnloadFontData(rasterized, 1);
+        return false;
+    }
+
+    atlas->glyphs[slot] = (GlyphInfo){ codepoint, glyph.offsetX, glyph.offsetY, glyph.advanceX, { 0 } };
+    atlas->recs[slot] = (Rectangle){ 0.0f, 0.0f, (float)glyph.image.width, (float)glyph.image.height };
+    atlas->shelfOf[slot] = (short)shelf;
+
+    if (hasPixels)
+    {
+        AtlasShelf *target = &atlas->shelves[shelf];
+        UploadGlyph(atlas, glyph.image, target->used, target->y);
+        atlas->recs[slot].x = (float)(target->used + GLYPH_PADDING);
+        atlas->recs[slot].y = (float)(target->y + GLYPH_PADDING);
+        target->used += width;
+        target->stamp = atlas->stamp;
+    }
+
+    InsertGlyph(atlas, slot);
+    atlas->stats.glyphs++;
+    atlas->stats.rasterized++;
+
+    if (rasterized != NULL) UnloadFontData(rasterized, 1);
+    return true;
+}
+
+// Rasterizes whatever is missing for text, stamping the shelves it uses; false: no room
+static bool RequireText(GlyphAtlas *atlas, const char *text)
+{
+    atlas->stamp++;
+
+    for (int i = 0; text[i] != '\0';)
+    {
+        int size = 0;
+        int codepoint = GetCodepointNext(&text[i], &size);
+        i += size;
+
+        if ((codepoint != '\n') && !RequireGlyph(atlas, codepoint)) return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+GlyphAtlas *LoadGlyphAtlas(const char *fileName, int pixelSize)
+{
+    if ((pixelSize <= 0) || (pixelSize > GLYPH_ATLAS_SIZE/4)) return NULL;
+
+    GlyphAtlas *atlas = (GlyphAtlas *)calloc(1, sizeof(GlyphAtlas));
+    if (atlas == NULL) return NULL;
+
+    atlas->fontData = LoadFileData(fileName, &atlas->fontDataSize);
+    atlas->pixelSize = pixelSize;
+    atlas->scratchSide = 2*pixelSize + 2*GLYPH_PADDING;
+    atlas->scratch = (Color *)malloc((size_t)atlas->scratchSide*atlas->scratchSide*sizeof(Color));
+
+    Image blank = GenImageColor(GLYPH_ATLAS_SIZE, GLYPH_ATLAS_SIZE, (Color){ 255, 255, 255, 0 });
+    if ((atlas->fontData != NULL) && (atlas->scratch != NULL) && (blank.data != NULL)) atlas->texture = LoadTextureFromImage(blank);
+    UnloadImage(blank);
+
+    if (atlas->texture.id == 0)
+    {
+        TraceLog(LOG_WARNING, "GLYPHS: [%s] Failed to load glyph atlas", fileName);
+        UnloadGlyphAtlas(atlas);
+        return NULL;
+    }
+
+    SetTextureFilter(atlas->texture, TEXTURE_FILTER_BILINEAR);
+    TraceLog(LOG_INFO, "GLYPHS: [%s] Glyph atlas loaded (%i px glyphs, %i x %i texture)", fileName, pixelSize, GLYPH_ATLAS_SIZE, GLYPH_ATLAS_SIZE);
+    return atlas;
+}
+
+void UnloadGlyphAtlas(GlyphAtlas *atlas)
+{
+    if (atlas == NULL) return;
+
+    if (atlas->texture.id > 0)
+    {
+        ReleaseAtlasPixels();
+        UnloadTexture(atlas->texture);
+    }
+    UnloadFileData(atlas->fontData);
+    free(atlas->scratch);
+    free(atlas);
+}
+
+// A string that does not fit next to the glyphs already resident gets the whole atlas
+bool CacheAtlasText(GlyphAtlas *atlas, const char *text)
+{
+    if (RequireText(atlas, text)) return true;
+
+    ResetGlyphAtlas(atlas);
+    if (RequireText(atlas, text)) return true;
+
+    if (!atlas->overflowed) TraceLog(LOG_WARNING, "GLYPHS: Text needs more glyphs than the atlas holds, some are not drawn");
+    atlas->overflowed = true;
+    return false;
+}
+
+Font GetGlyphAtlasFont(const GlyphAtlas *atlas)
+{
+    return (Font){ atlas->pixelSize, atlas->slotCount, GLYPH_PADDING, atlas->texture, (Rectangle *)atlas->recs, (GlyphInfo *)atlas->glyphs };
+}
+
+void DrawAtlasText(GlyphAtlas *atlas, const char *text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    CacheAtlasText(atlas, text);
+
+    Font font = GetGlyphAtlasFont(atlas);
+    const TextLayout *layout = GetTextLayout(font, text, fontSize, spacing);
+    if (layout != NULL) DrawTextLayout(layout, position, tint);
+    else DrawTextEx(font, text, position, fontSize, spacing, tint);
+}
+
+Vector2 MeasureAtlasText(GlyphAtlas *atlas, const char *text, float fontSize, float spacing)
+{
+    CacheAtlasText(atlas, text);
+
+    Font font = GetGlyphAtlasFont(atlas);
+    const TextLayout *layout = GetTextLayout(font, text, fontSize, spacing);
+    return (layout != NULL)? layout->size : MeasureTextEx(font, text, fontSize, spacing);
+}
+
+GlyphAtlasStats GetGlyphAtlasStats(const GlyphAtlas *atlas) { return atlas->stats; }
@@ -0,0 +1,69 @@
+/*******************************************************************************************
+*
+*   Glyph atlas: TrueType text with glyphs rasterized on demand into one fixed texture
+*
+*   raylib's default font is ASCII only, and LoadFontEx() with the Cyrillic block (or all of
+*   a font's glyphs) rasterizes and uploads every one of them at start-up. A GlyphAtlas keeps
+*   the font file in memory and rasterizes a codepoint the first time a string needs it, into
+*   a GLYPH_ATLAS_SIZE square texture packed in shelves: rows of glyphs of similar height,
+*   filled left to right.
+*
+*   Each string drawn stamps the shelves its glyphs sit on. When a new glyph finds no room,
+*   the least recently stamped shelf that is tall enough is emptied and reused; the glyphs of
+*   the string being drawn are never evicted. If that still leaves no room the whole atlas is
+*   cleared and the string's glyphs are brought back in. Evictions flush the pending batch
+*   before the texture changes, and drop the text cache, whose layouts point into the atlas.
+*
+*   Layout and drawing go through the text cache (textcache.h) with the atlas as a raylib
+*   Font, so a string's UTF-8 decoding, glyph lookups and advances are worked out once and it
+*   is drawn as one batch of quads on the atlas texture. A glyph already resident costs a hash
+*   lookup per draw, which also keeps the stamps current.
+*
+*   Glyphs are rasterized at the atlas' pixel size and scaled to the size drawn, like any
+*   raylib Font; load one atlas per size if text is drawn far from it. Rasterizing allocates
+*   (raylib's LoadFontData()), so games warm the atlas with CacheAtlasText() at start-up for
+*   the strings they know. Game thread only.
+*
+********************************************************************************************/
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include "platform.h"
+
+#define GLYPH_ATLAS_SIZE    512     // Texture width and height, pixels
+#define MAX_ATLAS_GLYPHS    512     // Resident codepoints, spaces included
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct GlyphAtlas GlyphAtlas;
+
+typedef struct GlyphAtlasStats {
+    int glyphs;                     // Resident now
+    int shelves;
+    int rasterized;                 // Since the atlas was loaded
+    int evictions;                  // Shelves emptied for new glyphs
+    int resets;                     // Times the whole atlas was cleared
+} GlyphAtlasStats;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+GlyphAtlas *LoadGlyphAtlas(const char *fileName, int pixelSize);   // NULL: font file missing or unreadable
+void UnloadGlyphAtlas(GlyphAtlas *atlas);
+
+bool CacheAtlasText(GlyphAtlas *atlas, const char *text);     // Makes text's glyphs resident; false: they do not all fit
+Font GetGlyphAtlasFont(const GlyphAtlas *atlas);                 // Resident glyphs only, valid until the next eviction
+
+// DrawTextEx()/MeasureTextEx() with the atlas as the font
+void DrawAtlasText(GlyphAtlas *atlas, const char *text, Vector2 position, float fontSize, float spacing, Color tint);
+Vector2 MeasureAtlasText(GlyphAtlas *atlas, const char *text, float fontSize, float spacing);
+
+GlyphAtlasStats GetGlyphAtlasStats(const GlyphAtlas *atlas);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // GLYPHATLAS_H
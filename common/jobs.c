@@ -0,0 +1,257 @@
+/*******************************************************************************************
+*
+*   Jobs, see jobs.h
+*
+*   The deque follows Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+*   Work-Stealing for Weak Memory Models" (PPoPP 2013), with a fixed-size ring: a push that
+*   finds its deque full runs the job inline instead.
+*
+********************************************************************************************/
+#include "jobs.h"
+#include "platform.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define JOB_DEQUE_SIZE      1024        // Power of two
+#define MAX_FOR_CHUNKS      256
+#define IDLE_SPINS          64          // Failed steal rounds before a worker sleeps
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct JobDeque {
+    atomic_long top;                    // Thieves take from here
+    char padding[64 - sizeof(atomic_long)];
+    atomic_long bottom;                 // The owner pushes and pops here
+    _Atomic(Job *) slots[JOB_DEQUE_SIZE];
+} JobDeque;
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static JobDeque deques[MAX_JOB_WORKERS];
+static pthread_t threads[MAX_JOB_WORKERS];
+static int threadCount = 1;             // Index 0 is the thread that called InitJobs()
+static bool running = false;
+
+static _Thread_local int workerIndex = -1;
+
+// Sleeping: a worker waits only while no push has happened since it last looked
+static atomic_uint workEpoch;
+static atomic_int sleepers;
+static atomic_bool shuttingDown;
+static pthread_mutex_t sleepLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sleepWake = PTHREAD_COND_INITIALIZER;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static bool PushJob(JobDeque *deque, Job *job)
+{
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if (bottom - top >= JOB_DEQUE_SIZE) return false;
+
+    atomic_store_explicit(&deque->slots[bottom & (JOB_DEQUE_SIZE - 1)], job, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return true;
+}
+
+static Job *PopJob(JobDeque *deque)
+{
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    Job *job = atomic_load_explicit(&deque->slots[bottom & (JOB_DEQUE_SIZE - 1)], memory_order_relaxed);
+    if (top == bottom)
+    {
+        // Last job: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) job = NULL;
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+
+    return job;
+}
+
+static Job *StealJob(JobDeque *deque)
+{
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom) return NULL;
+
+    Job *job = atomic_load_explicit(&deque->slots[top & (JOB_DEQUE_SIZE - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) return NULL;
+    return job;
+}
+
+static void ExecuteJob(Job *job)
+{
+    job->function(job->data, job->begin, job->end);
+    atomic_fetch_sub_explicit(&job->counter->pending, 1, memory_order_release);
+}
+
+// Own deque first (most recent, still in cache), then the others round-robin from a
+// different start per worker so thieves do not all hit the same victim
+static Job *FindJob(int self)
+{
+    Job *job = PopJob(&deques[self]);
+
+    for (int i = 1; (job == NULL) && (i < threadCount); i++) job = StealJob(&deques[(self + i) % threadCount]);
+    return job;
+}
+
+static void *WorkerMain(void *argument)
+{
+    workerIndex = (int)(ptrdiff_t)argument;
+    int idle = 0;
+
+    while (!atomic_load(&shuttingDown))
+    {
+        unsigned int epoch = atomic_load(&workEpoch);
+        Job *job = FindJob(workerIndex);
+
+        if (job != NULL)
+        {
+            ExecuteJob(job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < IDLE_SPINS) continue;
+
+        pthread_mutex_lock(&sleepLock);
+        atomic_fetch_add(&sleepers, 1);
+        while ((atomic_load(&workEpoch) == epoch) && !atomic_load(&shuttingDown)) pthread_cond_wait(&sleepWake, &sleepLock);
+        atomic_fetch_sub(&sleepers, 1);
+        pthread_mutex_unlock(&sleepLock);
+        idle = 0;
+    }
+
+    return NULL;
+}
+
+static void WakeWorkers(void)
+{
+    atomic_fetch_add(&workEpoch, 1);
+    if (atomic_load(&sleepers) > 0)
+    {
+        pthread_mutex_lock(&sleepLock);
+        pthread_cond_broadcast(&sleepWake);
+        pthread_mutex_unlock(&sleepLock);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void InitJobs(int workers)
+{
+    if (running) return;
+
+    if (workers <= 0)
+    {
+        workers = GetCpuCount() - 1;
+    }
+    if (workers > MAX_JOB_WORKERS - 1) workers = MAX_JOB_WORKERS - 1;
+
+    atomic_store(&shuttingDown, false);
+    workerIndex = 0;
+    threadCount = 1;
+    running = true;
+
+    for (int i = 1; i <= workers; i++)
+    {
+        atomic_store(&deques[i].top, 0);
+        atomic_store(&deques[i].bottom, 0);
+        if (pthread_create(&threads[i], NULL, WorkerMain, (void *)(ptrdiff_t)i) != 0) break;
+        threadCount++;
+    }
+
+    TraceLog(LOG_INFO, "JOBS: Job system initialized (%i worker threads)", threadCount - 1);
+}
+
+void CloseJobs(void)
+{
+    if (!running) return;
+
+    pthread_mutex_lock(&sleepLock);
+    atomic_store(&shuttingDown, true);
+    pthread_cond_broadcast(&sleepWake);
+    pthread_mutex_unlock(&sleepLock);
+
+    for (int i = 1; i < threadCount; i++) pthread_join(threads[i], NULL);
+
+    threadCount = 1;
+    workerIndex = -1;
+    running = false;
+}
+
+int GetJobThreadCount(void)
+{
+    return threadCount;
+}
+
+void RunJobs(Job *jobs, int count, JobCounter *counter)
+{
+    atomic_fetch_add_explicit(&counter->pending, count, memory_order_relaxed);
+
+    int self = workerIndex;
+    for (int i = 0; i < count; i++)
+    {
+        jobs[i].counter = counter;
+        if ((self < 0) || (threadCount == 1) || !PushJob(&deques[self], &jobs[i])) ExecuteJob(&jobs[i]);
+    }
+
+    if ((self >= 0) && (threadCount > 1)) WakeWorkers();
+}
+
+void WaitJobs(JobCounter *counter)
+{
+    int self = workerIndex;
+
+    while (atomic_load_explicit(&counter->pending, memory_order_acquire) > 0)
+    {
+        Job *job = (self >= 0)? FindJob(self) : NULL;
+        if (job != NULL) ExecuteJob(job);
+    }
+}
+
+void ParallelFor(int count, int grain, JobFunction function, void *data)
+{
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+    if ((count + grain - 1)/grain > MAX_FOR_CHUNKS) grain = (count + MAX_FOR_CHUNKS - 1)/MAX_FOR_CHUNKS;
+
+    // A single chunk, or nobody to share with: no queueing at all
+    if ((count <= grain) || (threadCount == 1) || (workerIndex < 0))
+    {
+        function(data, 0, count);
+        return;
+    }
+
+    Job jobs[MAX_FOR_CHUNKS];
+    int chunks = 0;
+    for (int begin = 0; begin < count; begin += grain)
+    {
+        jobs[chunks++] = (Job){ function, data, begin, (begin + grain < count)? begin + grain : count, NULL };
+    }
+
+    JobCounter counter = { 0 };
+    RunJobs(jobs, chunks, &counter);
+    WaitJobs(&counter);
+}
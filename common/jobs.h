@@ -0,0 +1,64 @@
+/*******************************************************************************************
+*
+*   Jobs: a small work-stealing job system for the per-frame update phases
+*
+*   InitJobs() starts the workers and makes the calling (main) thread worker 0. Every worker
+*   owns a Chase-Lev deque: it pushes and pops its own jobs at the bottom while idle workers
+*   steal from the top, so a parallel-for spawned on the main thread spreads over the cores
+*   without a shared queue lock. Idle workers sleep until new jobs are pushed.
+*
+*   A JobCounter counts the jobs of a batch still to finish. WaitJobs() does not block: the
+*   waiting thread runs queued jobs (its own first, then stolen ones) until the counter
+*   reaches zero, so jobs may spawn and wait on jobs of their own.
+*
+*   Jobs only ever write their own slice of the output; merging the slices (score, kills,
+*   sounds, random numbers) stays on the caller in index order, which is what keeps a run
+*   identical however many workers there are. Threads other than the workers and the one
+*   that called InitJobs() run everything inline.
+*
+********************************************************************************************/
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#define MAX_JOB_WORKERS     32
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef void (*JobFunction)(void *data, int begin, int end);
+
+typedef struct JobCounter {
+    atomic_int pending;
+} JobCounter;
+
+typedef struct Job {
+    JobFunction function;
+    void *data;
+    int begin;                      // Range handed to function
+    int end;
+    JobCounter *counter;            // Decremented when the job has run
+} Job;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void InitJobs(int workers);                     // Threads besides the caller (0: one per extra core)
+void CloseJobs(void);
+int GetJobThreadCount(void);                    // Workers plus the main thread
+
+void RunJobs(Job *jobs, int count, JobCounter *counter);   // jobs must outlive WaitJobs(counter)
+void WaitJobs(JobCounter *counter);
+
+// Splits [0, count) into chunks of grain (more when there would be over 256 chunks) and
+// waits for them. The split depends on count and grain only, never on the worker count
+void ParallelFor(int count, int grain, JobFunction function, void *data);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // JOBS_H
@@ -0,0 +1,96 @@
+/*******************************************************************************************
+*
+*   Layers, see layers.h
+*
+********************************************************************************************/
+#include "layers.h"
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static struct {
+    bool active;
+    RenderTexture2D target;
+    Camera2D camera;
+} frame = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+ScreenLayer LoadScreenLayer(int x, int y, int width, int height)
+{
+    ScreenLayer layer = { 0 };
+
+    layer.target = LoadRenderTexture(width, height);
+    layer.position = (Vector2){ (float)x, (float)y };
+    return layer;
+}
+
+void UnloadScreenLayer(ScreenLayer *layer)
+{
+    if (layer->target.id != 0) UnloadRenderTexture(layer->target);
+    *layer = (ScreenLayer){ 0 };
+}
+
+// Without a render texture the contents are drawn straight to the screen every frame
+bool BeginScreenLayer(ScreenLayer *layer, unsigned int key)
+{
+    if (layer->target.id == 0) return true;
+    if (layer->valid && (layer->key == key)) return false;
+
+    layer->key = key;
+    BeginTextureMode(layer->target);
+    ClearBackground(BLANK);
+    return true;
+}
+
+void EndScreenLayer(ScreenLayer *layer)
+{
+    if (layer->target.id == 0) return;
+
+    EndTextureMode();
+    if (frame.active)
+    {
+        BeginTextureMode(frame.target);
+        BeginMode2D(frame.camera);
+    }
+    layer->valid = true;
+}
+
+void DrawScreenLayer(const ScreenLayer *layer, Color tint)
+{
+    Texture2D texture = layer->target.texture;
+    if (layer->target.id == 0) return;
+
+    // Render textures are stored bottom-up: a negative source height flips them back
+    DrawTextureRec(texture, (Rectangle){ 0, 0, (float)texture.width, -(float)texture.height }, layer->position, tint);
+}
+
+void InvalidateScreenLayer(ScreenLayer *layer)
+{
+    layer->valid = false;
+}
+
+unsigned int MixLayerKey(unsigned int key, int value)
+{
+    key ^= (unsigned int)value + 0x9E3779B9u + (key << 6) + (key >> 2);
+    return key;
+}
+
+void BeginFrameTarget(RenderTexture2D target, Camera2D camera)
+{
+    frame.active = true;
+    frame.target = target;
+    frame.camera = camera;
+    BeginTextureMode(target);
+    BeginMode2D(camera);
+}
+
+void EndFrameTarget(void)
+{
+    if (!frame.active) return;
+
+    EndMode2D();
+    EndTextureMode();
+    frame.active = false;
+}
@@ -0,0 +1,56 @@
+/*******************************************************************************************
+*
+*   Layers: screens and HUD pieces rendered once into a texture and redrawn from it
+*
+*   A ScreenLayer owns a RenderTexture2D and the key of the inputs its contents were drawn
+*   from (menu selection, volume, score...). Each frame the game builds the key and calls
+*   BeginScreenLayer(): only when the key changed does it return true, with texture mode on,
+*   for the game to draw the contents, then EndScreenLayer(). DrawScreenLayer() puts the
+*   texture on screen as a single textured quad, so an unchanged menu costs one quad a frame
+*   however much text it holds.
+*
+*   Inside BeginScreenLayer()/EndScreenLayer() coordinates are relative to the layer's top-left
+*   corner. Render textures need the window: load layers after InitWindow(), unload them
+*   before CloseWindow(). A layer whose render texture failed to load has the game draw its
+*   contents straight to the screen every frame instead.
+*
+*   When the whole frame is drawn into a render texture (quality.h), BeginFrameTarget() tells
+*   the layers, so EndScreenLayer() goes back to that texture and its camera, not the screen.
+*
+********************************************************************************************/
+#ifndef LAYERS_H
+#define LAYERS_H
+
+#include "platform.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ScreenLayer {
+    RenderTexture2D target;
+    Vector2 position;               // Where DrawScreenLayer() puts the top-left corner
+    unsigned int key;               // Inputs the current contents were drawn from
+    bool valid;
+} ScreenLayer;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+ScreenLayer LoadScreenLayer(int x, int y, int width, int height);
+void UnloadScreenLayer(ScreenLayer *layer);
+bool BeginScreenLayer(ScreenLayer *layer, unsigned int key);    // true: redraw the contents now
+void EndScreenLayer(ScreenLayer *layer);
+void DrawScreenLayer(const ScreenLayer *layer, Color tint);
+void InvalidateScreenLayer(ScreenLayer *layer);
+
+unsigned int MixLayerKey(unsigned int key, int value);  // Folds one input into a key
+
+void BeginFrameTarget(RenderTexture2D target, Camera2D camera);    // Texture and 2D mode on, until EndFrameTarget()
+void EndFrameTarget(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // LAYERS_H
@@ -0,0 +1,858 @@
+/*******************************************************************************************
+*
+*   Mixer: software audio mixing on a dedicated thread
+*
+*   Three parties share as little as possible:
+*       game thread     owns the sound table and the voice serials, and only writes commands
+*       mixer thread    owns the voices and per-sound limits, drains commands, mixes blocks
+*       device callback copies mixed frames out of the output ring, never blocks or mixes
+*
+*   Commands and output both go through single-producer/single-consumer rings indexed by
+*   free-running counters, so no lock is ever taken on the audio path. UnloadMixerSound() is
+*   the only call that waits, until the mixer has acknowledged the command that drops the
+*   sound's voices, since the caller frees the samples right after.
+*
+*   With no voice playing and no command queued the mixer thread sleeps on a condition
+*   variable until the next command, and lets the ring run dry: the device plays silence
+*   without counting underruns. The lock only guards those sleeps and wakes, never a ring.
+*
+********************************************************************************************/
+#include "mixer.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_MIXER_SOUNDS            256
+#define MAX_MIXER_VOICES             64
+#define DEFAULT_MIXER_VOICES         32
+#define MIXER_COMMAND_CAPACITY     1024     // Power of two
+#define MIXER_BACKLOG_CAPACITY      256     // Must-deliver commands held back while the queue is full
+#define MIXER_BLOCK_FRAMES          256     // ~5.8 ms, also the length of the stop fade
+#define MIXER_RING_FRAMES          4096     // Power of two
+#define MIXER_TARGET_FRAMES        1536     // Mixed ahead of the device, ~35 ms
+#define MIXER_POLL_NANOSECONDS  2000000     // Refill period while voices play
+#define DEFAULT_MAX_INSTANCES         4
+#define DEFAULT_MIN_INTERVAL      0.04f
+
+typedef enum MixerCommandType {
+    MIXER_CMD_REGISTER = 0,
+    MIXER_CMD_UNREGISTER,
+    MIXER_CMD_LIMITS,
+    MIXER_CMD_PLAY,
+    MIXER_CMD_PLAY_MUSIC,
+    MIXER_CMD_STOP_VOICE,
+    MIXER_CMD_STOP_SOUND,
+    MIXER_CMD_STOP_MUSIC,
+    MIXER_CMD_SOUND_VOLUME,
+    MIXER_CMD_MUSIC_VOLUME
+} MixerCommandType;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct MixerCommand {
+    MixerCommandType type;
+    int sound;                      // Sound table index
+    unsigned int serial;            // Voice serial (play/stop)
+    float volume;
+    float pitch;
+    float pan;
+    int priority;
+    int maxInstances;
+    unsigned int intervalFrames;
+    Wave wave;                      // MIXER_CMD_REGISTER
+} MixerCommand;
+
+// Mixer-thread view of a sound
+typedef struct SoundState {
+    Wave wave;
+    int maxInstances;
+    unsigned int intervalFrames;
+    unsigned long long lastStart;
+    bool started;
+} SoundState;
+
+typedef struct Voice {
+    bool active;
+    bool music;                     // Music bus, looping, never stolen
+    bool stopping;                  // Fades out over the next block
+    int sound;
+    unsigned int serial;
+    int priority;
+    unsigned long long startClock;
+    unsigned long long position;    // 32.32 fixed point, in source frames
+    unsigned long long step;
+    float gainLeft;
+    float gainRight;
+} Voice;
+
+// Game-thread view of a sound
+typedef struct SoundSlot {
+    bool used;
+    unsigned int generation;
+    unsigned int frameCount;
+    unsigned int sampleRate;
+} SoundSlot;
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+// Game thread
+static SoundSlot sounds[MAX_MIXER_SOUNDS] = { 0 };
+static unsigned int nextVoiceSerial = 0;
+static MixerSound currentMusic = { 0 };
+static float soundVolumeSent = 1.0f;
+static float musicVolumeSent = 1.0f;
+static unsigned int pushedCommands = 0;
+static MixerCommand backlog[MIXER_BACKLOG_CAPACITY];
+static int backlogCount = 0;
+static AudioStream outputStream = { 0 };
+static pthread_t mixerThread;
+
+// Mixer thread
+static SoundState soundStates[MAX_MIXER_SOUNDS] = { 0 };
+static Voice voices[MAX_MIXER_VOICES] = { 0 };
+static int voiceCount = DEFAULT_MIXER_VOICES;
+static unsigned long long mixClock = 0;    // Frames mixed since InitMixer()
+static float soundBusVolume = 1.0f;
+static float musicBusVolume = 1.0f;
+static float mixBuffer[MIXER_BLOCK_FRAMES*2];
+
+// Shared
+static MixerCommand commands[MIXER_COMMAND_CAPACITY];
+static atomic_uint commandHead = 0;         // Written by the game thread
+static atomic_uint commandTail = 0;         // Written by the mixer thread
+static atomic_uint processedCommands = 0;
+static short outputRing[MIXER_RING_FRAMES*2];
+static atomic_uint ringWrite = 0;           // Written by the mixer thread
+static atomic_uint ringRead = 0;            // Written by the device callback
+static atomic_bool running = false;
+static atomic_bool idle = false;            // Mixer asleep (or about to be), ring left to run dry
+static pthread_mutex_t wakeLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mixerWake = PTHREAD_COND_INITIALIZER;     // Commands pushed while idle, or closing
+static pthread_cond_t commandsDone = PTHREAD_COND_INITIALIZER;  // Commands applied
+
+static atomic_int statVoices = 0;
+static atomic_int statPeakVoices = 0;
+static atomic_int statSteals = 0;
+static atomic_int statLimited = 0;
+static atomic_int statUnderruns = 0;
+static atomic_int statDroppedCommands = 0;
+static atomic_int statMixNanoseconds = 0;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions (mixer thread)
+//----------------------------------------------------------------------------------
+static inline void ReadFrame(const Wave *wave, unsigned int frame, float *left, float *right)
+{
+    size_t index = (size_t)frame*wave->channels;
+
+    switch (wave->sampleSize)
+    {
+        case 8:
+        {
+            const unsigned char *p = (const unsigned char *)wave->data + index;
+            *left = ((float)p[0] - 128.0f)*(1.0f/128.0f);
+            *right = (wave->channels > 1)? ((float)p[1] - 128.0f)*(1.0f/128.0f) : *left;
+        } break;
+        case 16:
+        {
+            short s[2];
+            memcpy(s, (const short *)wave->data + index, ((wave->channels > 1)? 2 : 1)*sizeof(short));
+            *left = (float)s[0]*(1.0f/32768.0f);
+            *right = (wave->channels > 1)? (float)s[1]*(1.0f/32768.0f) : *left;
+        } break;
+        default:
+        {
+            float f[2];
+            memcpy(f, (const float *)wave->data + index, ((wave->channels > 1)? 2 : 1)*sizeof(float));
+            *left = f[0];
+            *right = (wave->channels > 1)? f[1] : *left;
+        } break;
+    }
+}
+
+static void StartVoice(Voice *voice, const MixerCommand *command, bool music)
+{
+    const Wave *wave = &soundStates[command->sound].wave;
+    float pan = (command->pan < 0.0f)? 0.0f : (command->pan > 1.0f)? 1.0f : command->pan;
+    double step = (double)wave->sampleRate/MIXER_SAMPLE_RATE*((command->pitch > 0.0f)? command->pitch : 1.0f);
+
+    *voice = (Voice){ 0 };
+    voice->active = true;
+    voice->music = music;
+    voice->sound = command->sound;
+    voice->serial = command->serial;
+    voice->priority = command->priority;
+    voice->startClock = mixClock;
+    voice->step = (unsigned long long)(step*4294967296.0);
+    voice->gainLeft = command->volume*((pan <= 0.5f)? 1.0f : 2.0f*(1.0f - pan));
+    voice->gainRight = command->volume*((pan >= 0.5f)? 1.0f : 2.0f*pan);
+}
+
+static void PlayCommand(const MixerCommand *command)
+{
+    SoundState *state = &soundStates[command->sound];
+    if (state->wave.frameCount == 0) return;
+
+    // Per-sound limits: a burst of identical plays collapses instead of piling up
+    if (state->started && (mixClock - state->lastStart < state->intervalFrames))
+    {
+        atomic_fetch_add_explicit(&statLimited, 1, memory_order_relaxed);
+        return;
+    }
+
+    int instances = 0;
+    Voice *target = NULL;
+    Voice *victim = NULL;
+    for (int i = 0; i < voiceCount; i++)
+    {
+        Voice *voice = &voices[i];
+        if (!voice->active)
+        {
+            if (target == NULL) target = voice;
+            continue;
+        }
+        if ((voice->sound == command->sound) && !voice->stopping && !voice->music) instances++;
+        if (voice->music) continue;
+
+        // Steal candidate: lowest priority first, then the one that has played longest
+        if ((victim == NULL) || (voice->priority < victim->priority) ||
+            ((voice->priority == victim->priority) && (voice->startClock < victim->startClock))) victim = voice;
+    }
+
+    if ((instances >= state->maxInstances) || ((target == NULL) && ((victim == NULL) || (victim->priority > command->priority))))
+    {
+        atomic_fetch_add_explicit(&statLimited, 1, memory_order_relaxed);
+        return;
+    }
+
+    if (target == NULL)
+    {
+        target = victim;
+        atomic_fetch_add_explicit(&statSteals, 1, memory_order_relaxed);
+    }
+
+    StartVoice(target, command, false);
+    state->lastStart = mixClock;
+    state->started = true;
+}
+
+static void ApplyCommand(const MixerCommand *command)
+{
+    switch (command->type)
+    {
+        case MIXER_CMD_REGISTER:
+            soundStates[command->sound] = (SoundState){ command->wave, DEFAULT_MAX_INSTANCES, (unsigned int)(DEFAULT_MIN_INTERVAL*MIXER_SAMPLE_RATE), 0, false };
+            break;
+        case MIXER_CMD_UNREGISTER:
+            for (int i = 0; i < MAX_MIXER_VOICES; i++)
+            {
+                if (voices[i].active && (voices[i].sound == command->sound)) voices[i].active = false;
+            }
+            soundStates[command->sound] = (SoundState){ 0 };
+            break;
+        case MIXER_CMD_LIMITS:
+            soundStates[command->sound].maxInstances = command->maxInstances;
+            soundStates[command->sound].intervalFrames = command->intervalFrames;
+            break;
+        case MIXER_CMD_PLAY: PlayCommand(command); break;
+        case MIXER_CMD_PLAY_MUSIC:
+        {
+            // Music outranks every effect: take a free voice, else the cheapest effect
+            Voice *target = NULL;
+            Voice *victim = NULL;
+            for (int i = 0; i < voiceCount; i++)
+            {
+                Voice *voice = &voices[i];
+                if (voice->active && voice->music) voice->stopping = true;
+                else if (!voice->active) { if (target == NULL) target = voice; }
+                else if ((victim == NULL) || (voice->priority < victim->priority)) victim = voice;
+            }
+            if (target == NULL) target = victim;
+            if (target != NULL) StartVoice(target, command, true);
+        } break;
+        case MIXER_CMD_STOP_VOICE:
+        case MIXER_CMD_STOP_SOUND:
+        case MIXER_CMD_STOP_MUSIC:
+            for (int i = 0; i < voiceCount; i++)
+            {
+                Voice *voice = &voices[i];
+                if (!voice->active) continue;
+                if (((command->type == MIXER_CMD_STOP_VOICE) && (voice->serial == command->serial)) ||
+                    ((command->type == MIXER_CMD_STOP_SOUND) && (voice->sound == command->sound) && !voice->music) ||
+                    ((command->type == MIXER_CMD_STOP_MUSIC) && voice->music)) voice->stopping = true;
+            }
+            break;
+        case MIXER_CMD_SOUND_VOLUME: soundBusVolume = command->volume; break;
+        case MIXER_CMD_MUSIC_VOLUME: musicBusVolume = command->volume; break;
+    }
+}
+
+static void ProcessCommands(void)
+{
+    unsigned int tail = atomic_load_explicit(&commandTail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&commandHead, memory_order_acquire);
+    if (tail == head) return;
+
+    for (; tail != head; tail++)
+    {
+        ApplyCommand(&commands[tail & (MIXER_COMMAND_CAPACITY - 1)]);
+        atomic_store_explicit(&commandTail, tail + 1, memory_order_release);
+        atomic_fetch_add_explicit(&processedCommands, 1, memory_order_release);
+    }
+
+    // For a game thread waiting in SyncMixer()
+    pthread_mutex_lock(&wakeLock);
+    pthread_cond_broadcast(&commandsDone);
+    pthread_mutex_unlock(&wakeLock);
+}
+
+static bool HasActiveVoices(void)
+{
+    for (int i = 0; i < voiceCount; i++)
+    {
+        if (voices[i].active) return true;
+    }
+    return false;
+}
+
+static void MixVoice(Voice *voice)
+{
+    const Wave *wave = &soundStates[voice->sound].wave;
+    unsigned long long length = (unsigned long long)wave->frameCount << 32;
+    float bus = voice->music? musicBusVolume : soundBusVolume;
+    float gainLeft = voice->gainLeft*bus;
+    float gainRight = voice->gainRight*bus;
+
+    for (int f = 0; f < MIXER_BLOCK_FRAMES; f++)
+    {
+        if (voice->position >= length)
+        {
+            if (!voice->music)
+            {
+                voice->active = false;
+                return;
+            }
+            voice->position -= length;
+        }
+
+        unsigned int frame = (unsigned int)(voice->position >> 32);
+        unsigned int next = (frame + 1 < wave->frameCount)? frame + 1 : (voice->music? 0 : frame);
+        float t = (float)(voice->position & 0xFFFFFFFFULL)*(1.0f/4294967296.0f);
+
+        float left0, right0, left1, right1;
+        ReadFrame(wave, frame, &left0, &right0);
+        ReadFrame(wave, next, &left1, &right1);
+
+        float fade = voice->stopping? 1.0f - (float)f/MIXER_BLOCK_FRAMES : 1.0f;
+        mixBuffer[2*f] += (left0 + (left1 - left0)*t)*gainLeft*fade;
+        mixBuffer[2*f + 1] += (right0 + (right1 - right0)*t)*gainRight*fade;
+
+        voice->position += voice->step;
+    }
+
+    if (voice->stopping) voice->active = false;
+}
+
+static void MixBlock(void)
+{
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    memset(mixBuffer, 0, sizeof(mixBuffer));
+
+    int active = 0;
+    for (int i = 0; i < voiceCount; i++)
+    {
+        if (!voices[i].active) continue;
+        MixVoice(&voices[i]);
+        active++;
+    }
+
+    unsigned int write = atomic_load_explicit(&ringWrite, memory_order_relaxed);
+    for (int f = 0; f < MIXER_BLOCK_FRAMES; f++)
+    {
+        short *out = &outputRing[((write + (unsigned int)f) & (MIXER_RING_FRAMES - 1))*2];
+        for (int c = 0; c < 2; c++)
+        {
+            float sample = mixBuffer[2*f + c];
+            sample = (sample > 1.0f)? 1.0f : (sample < -1.0f)? -1.0f : sample;
+            out[c] = (short)(sample*32767.0f);
+        }
+    }
+    atomic_store_explicit(&ringWrite, write + MIXER_BLOCK_FRAMES, memory_order_release);
+    mixClock += MIXER_BLOCK_FRAMES;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    int nanos = (int)((end.tv_sec - start.tv_sec)*1000000000LL + (end.tv_nsec - start.tv_nsec));
+    int average = atomic_load_explicit(&statMixNanoseconds, memory_order_relaxed);
+    atomic_store_explicit(&statMixNanoseconds, average + (nanos - average)/16, memory_order_relaxed);
+
+    atomic_store_explicit(&statVoices, active, memory_order_relaxed);
+    if (active > atomic_load_explicit(&statPeakVoices, memory_order_relaxed)) atomic_store_explicit(&statPeakVoices, active, memory_order_relaxed);
+}
+
+static void *MixerMain(void *arg)
+{
+    (void)arg;
+
+    while (atomic_load_explicit(&running, memory_order_acquire))
+    {
+        ProcessCommands();
+
+        while (atomic_load_explicit(&ringWrite, memory_order_relaxed) - atomic_load_explicit(&ringRead, memory_order_acquire) + MIXER_BLOCK_FRAMES <= MIXER_TARGET_FRAMES)
+        {
+            MixBlock();
+        }
+        atomic_store_explicit(&idle, false, memory_order_relaxed);
+
+        unsigned int tail = atomic_load_explicit(&commandTail, memory_order_relaxed);
+        pthread_mutex_lock(&wakeLock);
+        if (atomic_load_explicit(&running, memory_order_relaxed) && (atomic_load_explicit(&commandHead, memory_order_acquire) == tail))
+        {
+            if (!HasActiveVoices())
+            {
+                // Publish idle before the last look at the queue: PostCommand() stores the head
+                // before it reads idle, so either this sees the command or it sees idle and signals
+                atomic_store(&idle, true);
+                while (atomic_load_explicit(&running, memory_order_relaxed) && (atomic_load(&commandHead) == tail))
+                {
+                    pthread_cond_wait(&mixerWake, &wakeLock);
+                }
+            }
+            else
+            {
+                // Commands pushed meanwhile are picked up on the next pass; nothing signals
+                struct timespec until;
+                clock_gettime(CLOCK_REALTIME, &until);
+                until.tv_nsec += MIXER_POLL_NANOSECONDS;
+                if (until.tv_nsec >= 1000000000L)
+                {
+                    until.tv_sec++;
+                    until.tv_nsec -= 1000000000L;
+                }
+                pthread_cond_timedwait(&mixerWake, &wakeLock, &until);
+            }
+        }
+        pthread_mutex_unlock(&wakeLock);
+    }
+
+    // Let a final UnloadMixerSound() through
+    ProcessCommands();
+
+    return NULL;
+}
+
+// Device thread: copy out whatever is ready, pad with silence
+static void MixerStreamCallback(void *bufferData, unsigned int frames)
+{
+    short *out = (short *)bufferData;
+    unsigned int read = atomic_load_explicit(&ringRead, memory_order_relaxed);
+    unsigned int available = atomic_load_explicit(&ringWrite, memory_order_acquire) - read;
+    unsigned int count = (frames < available)? frames : available;
+
+    for (unsigned int f = 0; f < count; f++)
+    {
+        const short *in = &outputRing[((read + f) & (MIXER_RING_FRAMES - 1))*2];
+        out[2*f] = in[0];
+        out[2*f + 1] = in[1];
+    }
+
+    if (count < frames)
+    {
+        memset(out + 2*count, 0, (size_t)(frames - count)*2*sizeof(short));
+        if (!atomic_load_explicit(&idle, memory_order_relaxed)) atomic_fetch_add_explicit(&statUnderruns, 1, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&ringRead, read + count, memory_order_release);
+}
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions (game thread)
+//----------------------------------------------------------------------------------
+// Publish one command; false if the queue is full. Only wakes the mixer when it sleeps
+static bool PostCommand(const MixerCommand *command)
+{
+    unsigned int head = atomic_load_explicit(&commandHead, memory_order_relaxed);
+    if (head - atomic_load_explicit(&commandTail, memory_order_acquire) >= MIXER_COMMAND_CAPACITY) return false;
+
+    commands[head & (MIXER_COMMAND_CAPACITY - 1)] = *command;
+    atomic_store(&commandHead, head + 1);
+    pushedCommands++;
+
+    if (atomic_load(&idle))
+    {
+        pthread_mutex_lock(&wakeLock);
+        pthread_cond_signal(&mixerWake);
+        pthread_mutex_unlock(&wakeLock);
+    }
+
+    return true;
+}
+
+// Move held-back commands into the queue, oldest first, as far as there is room
+static void FlushBacklog(void)
+{
+    int sent = 0;
+    while ((sent < backlogCount) && PostCommand(&backlog[sent])) sent++;
+    if (sent == 0) return;
+
+    backlogCount -= sent;
+    memmove(backlog, backlog + sent, (size_t)backlogCount*sizeof(MixerCommand));
+}
+
+static bool PushCommand(const MixerCommand *command, bool mustDeliver)
+{
+    if (!atomic_load_explicit(&running, memory_order_relaxed))
+    {
+        // No mixer thread: keep the table consistent, there is nothing to play on
+        if ((command->type == MIXER_CMD_PLAY) || (command->type == MIXER_CMD_PLAY_MUSIC)) return false;
+        ApplyCommand(command);
+        pushedCommands++;
+        atomic_fetch_add_explicit(&processedCommands, 1, memory_order_relaxed);
+        return true;
+    }
+
+    FlushBacklog();
+    if ((backlogCount == 0) && PostCommand(command)) return true;
+
+    // Queue full: the frame never waits on the mixer. Plays are dropped; anything else is held
+    // back in order and sent by the next command. A newer bus volume replaces a held one, and
+    // a stop repeating the last held command is already covered by it
+    if (mustDeliver)
+    {
+        bool volume = (command->type == MIXER_CMD_SOUND_VOLUME) || (command->type == MIXER_CMD_MUSIC_VOLUME);
+        for (int i = 0; volume && (i < backlogCount); i++)
+        {
+            if (backlog[i].type == command->type)
+            {
+                backlog[i] = *command;
+                return true;
+            }
+        }
+
+        const MixerCommand *last = (backlogCount > 0)? &backlog[backlogCount - 1] : NULL;
+        bool stop = (command->type == MIXER_CMD_STOP_VOICE) || (command->type == MIXER_CMD_STOP_SOUND) || (command->type == MIXER_CMD_STOP_MUSIC);
+        if (stop && (last != NULL) && (last->type == command->type) && (last->sound == command->sound) && (last->serial == command->serial)) return true;
+
+        if (backlogCount < MIXER_BACKLOG_CAPACITY)
+        {
+            backlog[backlogCount++] = *command;
+            return true;
+        }
+    }
+
+    atomic_fetch_add_explicit(&statDroppedCommands, 1, memory_order_relaxed);
+    return false;
+}
+
+// Block until the mixer has applied every command pushed so far (held-back ones included)
+static void SyncMixer(void)
+{
+    do
+    {
+        FlushBacklog();
+
+        pthread_mutex_lock(&wakeLock);
+        while (atomic_load_explicit(&processedCommands, memory_order_acquire) != pushedCommands) pthread_cond_wait(&commandsDone, &wakeLock);
+        pthread_mutex_unlock(&wakeLock);
+    } while (backlogCount > 0);
+}
+
+static int GetSoundIndex(MixerSound sound)
+{
+    int index = (int)(sound.id & 0xFFFF) - 1;
+    if ((index < 0) || (index >= MAX_MIXER_SOUNDS)) return -1;
+
+    return (sounds[index].used && (sounds[index].generation == (sound.id >> 16)))? index : -1;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool InitMixer(int count)
+{
+    if (atomic_load(&running)) return true;
+
+    voiceCount = (count <= 0)? DEFAULT_MIXER_VOICES : (count > MAX_MIXER_VOICES)? MAX_MIXER_VOICES : count;
+    memset(voices, 0, sizeof(voices));
+    mixClock = 0;
+
+    if (!IsAudioDeviceReady())
+    {
+        TraceLog(LOG_WARNING, "MIXER: Audio device not ready, sounds will be silent");
+        return false;
+    }
+
+    outputStream = LoadAudioStream(MIXER_SAMPLE_RATE, 16, 2);
+    if (!IsAudioStreamReady(outputStream))
+    {
+        TraceLog(LOG_WARNING, "MIXER: Failed to open output stream");
+        return false;
+    }
+
+    // Start one target's worth of silence ahead so the first callbacks don't underrun
+    memset(outputRing, 0, sizeof(outputRing));
+    atomic_store(&ringRead, 0);
+    atomic_store(&ringWrite, MIXER_TARGET_FRAMES);
+    atomic_store(&idle, false);
+
+    atomic_store(&running, true);
+    if (pthread_create(&mixerThread, NULL, MixerMain, NULL) != 0)
+    {
+        atomic_store(&running, false);
+        UnloadAudioStream(outputStream);
+        outputStream = (AudioStream){ 0 };
+        TraceLog(LOG_WARNING, "MIXER: Failed to start mixer thread");
+        return false;
+    }
+
+    SetAudioStreamCallback(outputStream, MixerStreamCallback);
+    PlayAudioStream(outputStream);
+
+    TraceLog(LOG_INFO, "MIXER: Mixer initialized (%i voices, %i Hz, %.1f ms ahead)", voiceCount, MIXER_SAMPLE_RATE, 1000.0f*MIXER_TARGET_FRAMES/MIXER_SAMPLE_RATE);
+    return true;
+}
+
+void CloseMixer(void)
+{
+    if (atomic_load(&running))
+    {
+        StopAudioStream(outputStream);
+        UnloadAudioStream(outputStream);
+        outputStream = (AudioStream){ 0 };
+
+        pthread_mutex_lock(&wakeLock);
+        atomic_store(&running, false);
+        pthread_cond_signal(&mixerWake);
+        pthread_mutex_unlock(&wakeLock);
+        pthread_join(mixerThread, NULL);
+    }
+
+    for (int i = 0; i < MAX_MIXER_SOUNDS; i++)
+    {
+        sounds[i].used = false;
+        sounds[i].generation = (sounds[i].generation + 1) & 0xFFFF;
+    }
+    memset(soundStates, 0, sizeof(soundStates));
+    memset(voices, 0, sizeof(voices));
+    currentMusic = (MixerSound){ 0 };
+    soundBusVolume = musicBusVolume = 1.0f;
+    soundVolumeSent = musicVolumeSent = 1.0f;
+
+    atomic_store(&commandHead, 0);
+    atomic_store(&commandTail, 0);
+    atomic_store(&processedCommands, 0);
+    pushedCommands = 0;
+    backlogCount = 0;
+}
+
+bool IsMixerReady(void) { return atomic_load(&running); }
+
+Wave GetMixerWaveView(const unsigned char *fileData, int dataSize)
+{
+    Wave wave = { 0 };
+    if ((fileData == NULL) || (dataSize < 12) || (memcmp(fileData, "RIFF", 4) != 0) || (memcmp(fileData + 8, "WAVE", 4) != 0)) return wave;
+
+    int format = 0;
+    size_t size = (size_t)dataSize;
+    size_t pos = 12;
+    while (pos + 8 <= size)
+    {
+        const unsigned char *chunk = fileData + pos;
+        size_t chunkSize = (size_t)chunk[4] | ((size_t)chunk[5] << 8) | ((size_t)chunk[6] << 16) | ((size_t)chunk[7] << 24);
+
+        if ((memcmp(chunk, "fmt ", 4) == 0) && (chunkSize >= 16) && (pos + 8 + chunkSize <= size))
+        {
+            format = chunk[8] | (chunk[9] << 8);
+            wave.channels = chunk[10] | (chunk[11] << 8);
+            wave.sampleRate = (unsigned int)(chunk[12] | (chunk[13] << 8) | (chunk[14] << 16) | ((unsigned int)chunk[15] << 24));
+            wave.sampleSize = chunk[22] | (chunk[23] << 8);
+
+            // WAVE_FORMAT_EXTENSIBLE: the real tag leads the sub-format GUID
+            if ((format == 0xFFFE) && (chunkSize >= 40)) format = chunk[32] | (chunk[33] << 8);
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            bool supported = (wave.channels > 0) && (wave.sampleRate > 0) &&
+                             (((format == 1) && ((wave.sampleSize == 8) || (wave.sampleSize == 16))) ||
+                              ((format == 3) && (wave.sampleSize == 32)));
+            if (!supported) break;
+
+            if (chunkSize > size - pos - 8) chunkSize = size - pos - 8;
+            wave.frameCount = (unsigned int)(chunkSize/(wave.channels*(wave.sampleSize/8)));
+            wave.data = (void *)(chunk + 8);
+            return wave;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    return (Wave){ 0 };
+}
+
+MixerSound LoadMixerSound(Wave wave)
+{
+    MixerSound sound = { 0 };
+
+    bool supported = (wave.data != NULL) && (wave.frameCount > 0) && (wave.sampleRate > 0) && (wave.channels > 0) &&
+                     ((wave.sampleSize == 8) || (wave.sampleSize == 16) || (wave.sampleSize == 32));
+    if (!supported)
+    {
+        TraceLog(LOG_WARNING, "MIXER: Unsupported wave (%u Hz, %u bit, %u channels)", wave.sampleRate, wave.sampleSize, wave.channels);
+        return sound;
+    }
+
+    int index = 0;
+    while ((index < MAX_MIXER_SOUNDS) && sounds[index].used) index++;
+    if (index == MAX_MIXER_SOUNDS)
+    {
+        TraceLog(LOG_WARNING, "MIXER: Sound table full (%i sounds)", MAX_MIXER_SOUNDS);
+        return sound;
+    }
+
+    SoundSlot *slot = &sounds[index];
+    slot->used = true;
+    slot->frameCount = wave.frameCount;
+    slot->sampleRate = wave.sampleRate;
+
+    MixerCommand command = { .type = MIXER_CMD_REGISTER, .sound = index, .wave = wave };
+    PushCommand(&command, true);
+
+    sound.id = (slot->generation << 16) | (unsigned int)(index + 1);
+    return sound;
+}
+
+void UnloadMixerSound(MixerSound sound)
+{
+    int index = GetSoundIndex(sound);
+    if (index < 0) return;
+
+    if (currentMusic.id == sound.id) currentMusic = (MixerSound){ 0 };
+
+    MixerCommand command = { .type = MIXER_CMD_UNREGISTER, .sound = index };
+    PushCommand(&command, true);
+    SyncMixer();
+
+    sounds[index].used = false;
+    sounds[index].generation = (sounds[index].generation + 1) & 0xFFFF;
+}
+
+void SetMixerSoundLimits(MixerSound sound, int maxInstances, float minInterval)
+{
+    int index = GetSoundIndex(sound);
+    if (index < 0) return;
+
+    MixerCommand command = { .type = MIXER_CMD_LIMITS, .sound = index };
+    command.maxInstances = (maxInstances > 0)? maxInstances : 1;
+    command.intervalFrames = (minInterval > 0.0f)? (unsigned int)(minInterval*MIXER_SAMPLE_RATE) : 0;
+    PushCommand(&command, true);
+}
+
+float GetMixerSoundLength(MixerSound sound)
+{
+    int index = GetSoundIndex(sound);
+    return (index >= 0)? (float)sounds[index].frameCount/(float)sounds[index].sampleRate : 0.0f;
+}
+
+MixerVoice PlayMixerSound(MixerSound sound)
+{
+    return PlayMixerSoundEx(sound, 1.0f, 1.0f, 0.5f, MIXER_PRIORITY_DEFAULT);
+}
+
+MixerVoice PlayMixerSoundEx(MixerSound sound, float volume, float pitch, float pan, int priority)
+{
+    MixerVoice voice = { 0 };
+    int index = GetSoundIndex(sound);
+    if (index < 0) return voice;
+
+    if (++nextVoiceSerial == 0) nextVoiceSerial = 1;
+
+    MixerCommand command = { .type = MIXER_CMD_PLAY, .sound = index, .serial = nextVoiceSerial };
+    command.volume = volume;
+    command.pitch = pitch;
+    command.pan = pan;
+    command.priority = priority;
+    if (PushCommand(&command, false)) voice.id = nextVoiceSerial;
+
+    return voice;
+}
+
+void StopMixerVoice(MixerVoice voice)
+{
+    if (voice.id == 0) return;
+
+    MixerCommand command = { .type = MIXER_CMD_STOP_VOICE, .serial = voice.id };
+    PushCommand(&command, true);
+}
+
+void StopMixerSound(MixerSound sound)
+{
+    int index = GetSoundIndex(sound);
+    if (index < 0) return;
+
+    MixerCommand command = { .type = MIXER_CMD_STOP_SOUND, .sound = index };
+    PushCommand(&command, true);
+}
+
+void SetMixerSoundVolume(float volume)
+{
+    if (volume == soundVolumeSent) return;
+    soundVolumeSent = volume;
+
+    MixerCommand command = { .type = MIXER_CMD_SOUND_VOLUME, .volume = volume };
+    PushCommand(&command, true);
+}
+
+void PlayMixerMusic(MixerSound sound)
+{
+    int index = GetSoundIndex(sound);
+    if (index < 0) return;
+
+    MixerCommand command = { .type = MIXER_CMD_PLAY_MUSIC, .sound = index, .volume = 1.0f, .pitch = 1.0f, .pan = 0.5f };
+    if (PushCommand(&command, true)) currentMusic = sound;
+}
+
+void StopMixerMusic(void)
+{
+    if (currentMusic.id == 0) return;
+
+    MixerCommand command = { .type = MIXER_CMD_STOP_MUSIC };
+    PushCommand(&command, true);
+    currentMusic = (MixerSound){ 0 };
+}
+
+bool IsMixerMusicPlaying(MixerSound sound)
+{
+    return (sound.id != 0) && (currentMusic.id == sound.id);
+}
+
+void SetMixerMusicVolume(float volume)
+{
+    if (volume == musicVolumeSent) return;
+    musicVolumeSent = volume;
+
+    MixerCommand command = { .type = MIXER_CMD_MUSIC_VOLUME, .volume = volume };
+    PushCommand(&command, true);
+}
+
+MixerStats GetMixerStats(void)
+{
+    MixerStats stats = { 0 };
+
+    stats.voices = atomic_load_explicit(&statVoices, memory_order_relaxed);
+    stats.peakVoices = atomic_load_explicit(&statPeakVoices, memory_order_relaxed);
+    stats.steals = atomic_load_explicit(&statSteals, memory_order_relaxed);
+    stats.limited = atomic_load_explicit(&statLimited, memory_order_relaxed);
+    stats.underruns = atomic_load_explicit(&statUnderruns, memory_order_relaxed);
+    stats.droppedCommands = atomic_load_explicit(&statDroppedCommands, memory_order_relaxed);
+    stats.mixMicroseconds = (float)atomic_load_explicit(&statMixNanoseconds, memory_order_relaxed)/1000.0f;
+
+    return stats;
+}
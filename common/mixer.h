@@ -0,0 +1,80 @@
+/*******************************************************************************************
+*
+*   Mixer: software audio mixing on a dedicated thread
+*
+*   The game thread never touches the audio device. PlayMixerSound() and friends only post
+*   a command to a lock-free single-producer queue; the mixer thread drains it, mixes the
+*   active voices and keeps a small ring of output ahead of the device callback, so a long
+*   frame on the game thread no longer starves the music.
+*
+*   Voices come from a fixed pool. Each sound has an instance limit and a minimum interval
+*   between starts (defaults: 4 instances, 40 ms); plays beyond either are dropped. When the
+*   pool is full the lowest-priority, oldest voice is stolen, but only by a play of equal or
+*   higher priority. Music is a looping voice that is never stolen.
+*
+*   Sample data is converted (format, channels, rate) while mixing, so a music track stored
+*   as PCM WAV is streamed straight from its file or pack mapping without a decoded copy.
+*   The caller owns the Wave passed to LoadMixerSound() and must keep it alive until
+*   UnloadMixerSound() returns.
+*
+*   All functions must be called from a single thread (the game thread).
+*
+********************************************************************************************/
+#ifndef MIXER_H
+#define MIXER_H
+
+#include "platform.h"
+
+#define MIXER_SAMPLE_RATE       44100
+#define MIXER_PRIORITY_DEFAULT      0
+
+typedef struct MixerSound {
+    unsigned int id;        // 0 = invalid
+} MixerSound;
+
+typedef struct MixerVoice {
+    unsigned int id;        // 0 = nothing started
+} MixerVoice;
+
+typedef struct MixerStats {
+    int voices;             // Voices playing at the last mixed block
+    int peakVoices;
+    int steals;             // Voices taken over by a newer play
+    int limited;            // Plays dropped by instance limit, interval or priority
+    int underruns;          // Device callbacks that found the ring short
+    int droppedCommands;    // Queue full (game thread outran the mixer)
+    float mixMicroseconds;  // Average cost of one mixed block
+} MixerStats;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+bool InitMixer(int voiceCount);                     // Open the output stream and start the mixer thread (<= 0: default pool)
+void CloseMixer(void);                              // Stop the thread and forget every sound
+bool IsMixerReady(void);
+
+Wave GetMixerWaveView(const unsigned char *fileData, int dataSize);    // PCM WAV file -> Wave pointing into fileData (zeroed if unsupported)
+MixerSound LoadMixerSound(Wave wave);               // Register 8/16-bit or float PCM (mono/stereo, any rate)
+void UnloadMixerSound(MixerSound sound);            // Stops its voices; returns once the mixer no longer reads it
+void SetMixerSoundLimits(MixerSound sound, int maxInstances, float minInterval);
+float GetMixerSoundLength(MixerSound sound);        // Seconds
+
+MixerVoice PlayMixerSound(MixerSound sound);
+MixerVoice PlayMixerSoundEx(MixerSound sound, float volume, float pitch, float pan, int priority);
+void StopMixerVoice(MixerVoice voice);
+void StopMixerSound(MixerSound sound);              // Every voice playing this sound
+void SetMixerSoundVolume(float volume);             // Effects bus
+
+void PlayMixerMusic(MixerSound sound);              // Loop on the music bus, replacing the current track
+void StopMixerMusic(void);
+bool IsMixerMusicPlaying(MixerSound sound);
+void SetMixerMusicVolume(float volume);             // Music bus
+
+MixerStats GetMixerStats(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // MIXER_H
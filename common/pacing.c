@@ -0,0 +1,74 @@
+/*******************************************************************************************
+*
+*   Pacing, see pacing.h
+*
+********************************************************************************************/
+#include "pacing.h"
+#include "assets.h"
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static int activeFps = 60;
+static double activeUntil = 0.0;
+static double wakeAt = 0.0;                 // 0: no timer pending
+static FramePacingMode mode = FRAMES_CONTINUOUS;
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void InitFramePacing(int fps)
+{
+    activeFps = (fps > 0)? fps : 60;
+    activeUntil = 0.0;
+    wakeAt = 0.0;
+    mode = FRAMES_CONTINUOUS;
+
+    DisableEventWaiting();
+    SetTargetFPS(activeFps);
+}
+
+void KeepFramesActive(float seconds)
+{
+    double until = GetTime() + seconds;
+    if (until > activeUntil) activeUntil = until;
+}
+
+void ScheduleFrameWake(float seconds)
+{
+    double at = GetTime() + seconds;
+    if ((wakeAt == 0.0) || (at < wakeAt)) wakeAt = at;
+}
+
+void UpdateFramePacing(void)
+{
+    double now = GetTime();
+    FramePacingMode next = FRAMES_EVENTS;
+
+    // A timer that comes due gets one continuous frame; callers still waiting schedule again
+    if ((wakeAt != 0.0) && (wakeAt <= now))
+    {
+        wakeAt = 0.0;
+        activeUntil = now;
+    }
+
+    if ((now <= activeUntil) || (GetAssetStats().loading > 0)) next = FRAMES_CONTINUOUS;
+    else if (wakeAt != 0.0) next = (wakeAt - now < 1.0/IDLE_TICK_FPS)? FRAMES_CONTINUOUS : FRAMES_TIMER;
+
+    if (next == mode) return;
+    mode = next;
+
+    if (mode == FRAMES_EVENTS) EnableEventWaiting();
+    else DisableEventWaiting();
+    SetTargetFPS((mode == FRAMES_TIMER)? IDLE_TICK_FPS : activeFps);
+}
+
+FramePacingMode GetFramePacingMode(void)
+{
+    return mode;
+}
+
+int GetFramePacingFps(void)
+{
+    return activeFps;
+}
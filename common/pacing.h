@@ -0,0 +1,49 @@
+/*******************************************************************************************
+*
+*   Pacing: event-driven frames for screens that sit still between key presses
+*
+*   UpdateFramePacing() runs once per loop iteration, before drawing, and picks how the
+*   EndDrawing() that follows waits for the next frame:
+*
+*       continuous  the target frame rate, while something moves (KeepFramesActive()) or
+*                   assets are still loading
+*       timer       a slow IDLE_TICK_FPS tick while a ScheduleFrameWake() is pending
+*       events      EnableEventWaiting(): the loop sleeps until the next input event
+*
+*   A key press wakes the loop, the game updates and draws once, and it goes back to sleep,
+*   so an untouched menu or table costs nothing. Audio needs no wakes: the mixer runs on its
+*   own thread and loops the music by itself.
+*
+********************************************************************************************/
+#ifndef PACING_H
+#define PACING_H
+
+#include "platform.h"
+
+#define IDLE_TICK_FPS   10
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum FramePacingMode {
+    FRAMES_CONTINUOUS = 0,
+    FRAMES_TIMER,
+    FRAMES_EVENTS
+} FramePacingMode;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void InitFramePacing(int fps);              // Replaces SetTargetFPS(): the rate while active
+void KeepFramesActive(float seconds);       // Render continuously until this long from now (0: this frame)
+void ScheduleFrameWake(float seconds);      // A timer: be awake again within this long
+void UpdateFramePacing(void);
+FramePacingMode GetFramePacingMode(void);
+int GetFramePacingFps(void);                // The rate while active
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PACING_H
@@ -0,0 +1,206 @@
+/*******************************************************************************************
+*
+*   Resource packs: one indexed, memory-mapped archive per game
+*
+********************************************************************************************/
+#include "pack.h"
+#include "platform.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct ResourcePack {
+    const unsigned char *base;
+    size_t size;
+    const PackHeader *header;
+    const PackEntry *entries;
+    const char *strings;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static const unsigned char *MapFile(ResourcePack *pack, const char *fileName)
+{
+#if defined(_WIN32)
+    pack->file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (pack->file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(pack->file, &size);
+    pack->size = (size_t)size.QuadPart;
+
+    pack->mapping = CreateFileMappingA(pack->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (pack->mapping == NULL) return NULL;
+
+    return (const unsigned char *)MapViewOfFile(pack->mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat info;
+    void *data = MAP_FAILED;
+    if ((fstat(fd, &info) == 0) && (info.st_size > 0))
+    {
+        pack->size = (size_t)info.st_size;
+        data = mmap(NULL, pack->size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    return (data != MAP_FAILED)? (const unsigned char *)data : NULL;
+#endif
+}
+
+static void UnmapFile(ResourcePack *pack)
+{
+#if defined(_WIN32)
+    if (pack->base != NULL) UnmapViewOfFile(pack->base);
+    if (pack->mapping != NULL) CloseHandle(pack->mapping);
+    if ((pack->file != NULL) && (pack->file != INVALID_HANDLE_VALUE)) CloseHandle(pack->file);
+#else
+    if (pack->base != NULL) munmap((void *)pack->base, pack->size);
+#endif
+}
+
+static bool ValidatePack(const ResourcePack *pack)
+{
+    if (pack->size < sizeof(PackHeader)) return false;
+
+    const PackHeader *header = pack->header;
+    if ((memcmp(header->magic, PACK_MAGIC, 4) != 0) || (header->version != PACK_VERSION)) return false;
+
+    uint64_t indexBytes = (uint64_t)header->entryCount*sizeof(PackEntry);
+    if ((header->indexOffset > pack->size) || (indexBytes + header->stringsSize > pack->size - header->indexOffset)) return false;
+
+    const PackEntry *entries = (const PackEntry *)(pack->base + header->indexOffset);
+    for (uint32_t i = 0; i < header->entryCount; i++)
+    {
+        if ((entries[i].offset > pack->size) || (entries[i].size > pack->size - entries[i].offset)) return false;
+        if (entries[i].nameOffset >= header->stringsSize) return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+uint32_t PackHashName(const char *name)
+{
+    if ((name[0] == '.') && ((name[1] == '/') || (name[1] == '\\'))) name += 2;
+
+    uint32_t hash = 2166136261u;
+    for (const char *c = name; *c != '\0'; c++)
+    {
+        hash ^= (unsigned char)((*c == '\\')? '/' : *c);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+ResourcePack *LoadResourcePack(const char *fileName)
+{
+    ResourcePack *pack = (ResourcePack *)calloc(1, sizeof(ResourcePack));
+    if (pack == NULL) return NULL;
+
+    pack->base = MapFile(pack, fileName);
+    if (pack->base == NULL)
+    {
+        UnmapFile(pack);
+        free(pack);
+        return NULL;
+    }
+
+    pack->header = (const PackHeader *)pack->base;
+    if (!ValidatePack(pack))
+    {
+        TraceLog(LOG_WARNING, "PACK: [%s] Invalid or incompatible resource pack", fileName);
+        UnmapFile(pack);
+        free(pack);
+        return NULL;
+    }
+
+    pack->entries = (const PackEntry *)(pack->base + pack->header->indexOffset);
+    pack->strings = (const char *)(pack->entries + pack->header->entryCount);
+
+    TraceLog(LOG_INFO, "PACK: [%s] Resource pack mapped (%u entries, %zu bytes)", fileName, pack->header->entryCount, pack->size);
+    return pack;
+}
+
+void UnloadResourcePack(ResourcePack *pack)
+{
+    if (pack == NULL) return;
+
+    UnmapFile(pack);
+    free(pack);
+}
+
+const PackEntry *FindPackEntry(const ResourcePack *pack, const char *name)
+{
+    if ((pack == NULL) || (name == NULL)) return NULL;
+
+    uint32_t hash = PackHashName(name);
+    if ((name[0] == '.') && ((name[1] == '/') || (name[1] == '\\'))) name += 2;
+
+    // Lower bound on the sorted hashes, then compare names across any collisions
+    uint32_t low = 0;
+    uint32_t high = pack->header->entryCount;
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low)/2;
+        if (pack->entries[mid].nameHash < hash) low = mid + 1;
+        else high = mid;
+    }
+
+    for (uint32_t i = low; (i < pack->header->entryCount) && (pack->entries[i].nameHash == hash); i++)
+    {
+        const char *entryName = pack->strings + pack->entries[i].nameOffset;
+        const char *a = entryName;
+        const char *b = name;
+        while ((*a != '\0') && ((*a == *b) || ((*a == '/') && (*b == '\\')))) { a++; b++; }
+        if ((*a == '\0') && (*b == '\0')) return &pack->entries[i];
+    }
+
+    return NULL;
+}
+
+const unsigned char *GetPackEntryData(const ResourcePack *pack, const PackEntry *entry)
+{
+    return ((pack != NULL) && (entry != NULL))? pack->base + entry->offset : NULL;
+}
+
+const char *GetPackEntryName(const ResourcePack *pack, const PackEntry *entry)
+{
+    return ((pack != NULL) && (entry != NULL))? pack->strings + entry->nameOffset : NULL;
+}
+
+int GetPackEntryCount(const ResourcePack *pack)
+{
+    return (pack != NULL)? (int)pack->header->entryCount : 0;
+}
+
+const PackEntry *GetPackEntry(const ResourcePack *pack, int index)
+{
+    if ((pack == NULL) || (index < 0) || (index >= (int)pack->header->entryCount)) return NULL;
+    return &pack->entries[index];
+}
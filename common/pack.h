@@ -0,0 +1,73 @@
+/*******************************************************************************************
+*
+*   Resource packs: one indexed, memory-mapped archive per game
+*
+*   Layout (little-endian):
+*       PackHeader
+*       entry data, each blob aligned to PACK_DATA_ALIGNMENT
+*       PackEntry[entryCount], sorted by nameHash
+*       name strings (NUL-terminated, referenced by PackEntry.nameOffset)
+*
+*   Entries are stored either as the original file bytes (PACK_ENTRY_FILE) or pre-converted
+*   by tools/respack: raw pixels ready for LoadTextureFromImage() (PACK_ENTRY_IMAGE) and
+*   QOA-compressed audio (PACK_ENTRY_QOA). The whole file is mapped read-only and entry data
+*   is handed out as pointers into the mapping, so nothing is copied until it is uploaded.
+*
+********************************************************************************************/
+#ifndef PACK_H
+#define PACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PACK_MAGIC              "GPAK"
+#define PACK_VERSION            1
+#define PACK_DATA_ALIGNMENT     64
+
+typedef enum PackEntryKind {
+    PACK_ENTRY_FILE = 0,        // Original file bytes, decoded by extension
+    PACK_ENTRY_IMAGE,           // Raw pixels: width, height, format (raylib PixelFormat)
+    PACK_ENTRY_QOA              // QOA audio, load with fileType ".qoa"
+} PackEntryKind;
+
+typedef struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t stringsSize;
+    uint64_t indexOffset;
+} PackHeader;
+
+typedef struct PackEntry {
+    uint32_t nameHash;          // PackHashName() of the name
+    uint32_t nameOffset;        // Into the string table
+    uint32_t kind;              // PackEntryKind
+    uint32_t format;            // PixelFormat for PACK_ENTRY_IMAGE
+    uint64_t offset;            // From the start of the file
+    uint64_t size;
+    int32_t width;
+    int32_t height;
+    uint32_t sourceSize;        // Size of the original file, for reporting
+    uint32_t reserved;
+} PackEntry;
+
+typedef struct ResourcePack ResourcePack;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+ResourcePack *LoadResourcePack(const char *fileName);      // Map and validate a pack (NULL on failure)
+void UnloadResourcePack(ResourcePack *pack);
+const PackEntry *FindPackEntry(const ResourcePack *pack, const char *name);
+const unsigned char *GetPackEntryData(const ResourcePack *pack, const PackEntry *entry);
+const char *GetPackEntryName(const ResourcePack *pack, const PackEntry *entry);
+int GetPackEntryCount(const ResourcePack *pack);
+const PackEntry *GetPackEntry(const ResourcePack *pack, int index);
+uint32_t PackHashName(const char *name);                    // FNV-1a over the normalised ('/') path
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PACK_H
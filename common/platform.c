@@ -0,0 +1,31 @@
+/*******************************************************************************************
+*
+*   Platform, see platform.h
+*
+********************************************************************************************/
+#define PLATFORM_OS_ONLY
+#include "platform.h"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+int GetCpuCount(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long cores = (long)info.dwNumberOfProcessors;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return (cores > 0)? (int)cores : 1;
+}
@@ -0,0 +1,44 @@
+/*******************************************************************************************
+*
+*   Platform layer shared by the raylib games
+*
+*   Games include this header instead of "raylib.h" directly. On a normal build it simply
+*   forwards to raylib; when PLATFORM_HEADLESS is defined (cmake -DGAMES_HEADLESS=ON) the
+*   window, input and audio calls resolve to raylib_headless.c instead, which runs without
+*   a display or audio device so simulations, benchmarks and PGO training can run on CI.
+*
+*   Either way EndDrawing() also ends the memory frame (see arena.h) and the telemetry frame
+*   (see telemetry.h): the headless stand-in calls EndMemoryFrame() and EndTelemetryFrame()
+*   itself, raylib's own EndDrawing() is followed by them here.
+*
+*   The operating system queries below (platform.c) are also used by the command-line tools,
+*   which link the platform_os library instead of raylib: they define PLATFORM_OS_ONLY before
+*   including this header.
+*
+********************************************************************************************/
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#if !defined(PLATFORM_OS_ONLY)
+    #if defined(PLATFORM_HEADLESS)
+        #include "raylib_headless.h"
+    #else
+        #include "raylib.h"
+        #define EndDrawing()    do { (EndDrawing)(); EndMemoryFrame(); EndTelemetryFrame(); } while (0)
+    #endif
+
+    #include "arena.h"
+    #include "telemetry.h"
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+int GetCpuCount(void);                      // Online logical processors, at least 1
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PLATFORM_H
@@ -0,0 +1,199 @@
+/*******************************************************************************************
+*
+*   Quality, see quality.h
+*
+********************************************************************************************/
+#include "quality.h"
+#include "layers.h"
+#include "pacing.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define LATE_INTERVAL       1.25f   // Of the budget: the frame missed its slot
+#define BUSY_WORK           0.90f   // Of the budget: the next bit of load misses it
+#define IDLE_WORK           0.50f   // Of the budget: room for the level above
+#define MAX_UP_BACKOFF      8.0f
+
+static const QualityLevel levels[QUALITY_LEVELS] = {
+    { 1.00f, 1.000f, true,  true  },
+    { 0.85f, 0.500f, true,  true  },
+    { 0.70f, 0.250f, false, true  },
+    { 0.50f, 0.125f, false, false },
+};
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static int level = 0;
+static bool adaptive = true;
+
+static RenderTexture2D frameTarget = { 0 };    // Screen-sized; lower levels use its top-left part
+static int screenWidth = 0;
+static int screenHeight = 0;
+static bool scaled = false;                 // This frame is going to frameTarget
+
+// Frames since the last change, the last QUALITY_WINDOW_FRAMES of them kept
+static uint64_t work[QUALITY_WINDOW_FRAMES] = { 0 };
+static bool over[QUALITY_WINDOW_FRAMES] = { 0 };
+static int windowCount = 0;
+static int windowNext = 0;
+static int overCount = 0;
+static uint64_t workSum = 0;
+static int framesAtLevel = 0;
+static bool lastContinuous = false;
+
+static float upSeconds = QUALITY_UP_SECONDS;
+static bool probing = false;                // The last change was a step up, still on trial
+
+static TelemetryMetric *levelGauge = NULL;
+static TelemetryMetric *changeCount = NULL;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static void ResetWindow(void)
+{
+    windowCount = 0;
+    windowNext = 0;
+    overCount = 0;
+    workSum = 0;
+    framesAtLevel = 0;
+}
+
+static void ChangeLevel(int next, float budget, const char *reason)
+{
+    double meanWork = (windowCount > 0)? (double)workSum/windowCount/1e6 : 0.0;
+
+    TraceLog(LOG_INFO, "QUALITY: Level %i -> %i, %s: %i of %i frames over %.1f ms, %.2f ms mean work (scale %.2f, particles %.0f%%)",
+             level, next, reason, overCount, windowCount, budget*1000.0f, meanWork, levels[next].renderScale, levels[next].particleShare*100.0f);
+
+    probing = (next < level);
+    level = next;
+    ResetWindow();
+
+    SetTelemetryGauge(levelGauge, level);
+    AddTelemetryCount(changeCount, 1);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void InitQuality(void)
+{
+    const char *setting = getenv("GAMES_QUALITY");
+
+#if defined(PLATFORM_HEADLESS)
+    adaptive = false;
+#else
+    adaptive = true;
+#endif
+    level = 0;
+    if ((setting != NULL) && (strcmp(setting, "auto") == 0)) adaptive = true;
+    else if ((setting != NULL) && (setting[0] != '\0'))
+    {
+        adaptive = false;
+        level = atoi(setting);
+        level = (level < 0)? 0 : (level >= QUALITY_LEVELS)? QUALITY_LEVELS - 1 : level;
+    }
+
+    levelGauge = RegisterTelemetryGauge("games_quality_level", "Quality level the governor holds (0: full)");
+    changeCount = RegisterTelemetryCounter("games_quality_changes_total", "Quality level changes made by the governor");
+    SetTelemetryGauge(levelGauge, level);
+
+    // Scaled frames need the texture up front, so a change of level never allocates
+    screenWidth = GetScreenWidth();
+    screenHeight = GetScreenHeight();
+    if (adaptive || (levels[level].renderScale < 1.0f))
+    {
+        frameTarget = LoadRenderTexture(screenWidth, screenHeight);
+        SetTextureFilter(frameTarget.texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    upSeconds = QUALITY_UP_SECONDS;
+    probing = false;
+    lastContinuous = false;
+    ResetWindow();
+}
+
+void CloseQuality(void)
+{
+    if (frameTarget.id != 0) UnloadRenderTexture(frameTarget);
+    frameTarget = (RenderTexture2D){ 0 };
+}
+
+void BeginQualityFrame(void)
+{
+    float scale = levels[level].renderScale;
+
+    scaled = (frameTarget.id != 0) && (scale < 1.0f);
+    if (scaled) BeginFrameTarget(frameTarget, (Camera2D){ .zoom = scale });
+}
+
+// Render textures are stored bottom-up: the top-left part is the bottom of the texture
+void EndQualityFrame(void)
+{
+    if (!scaled) return;
+
+    float width = screenWidth*levels[level].renderScale;
+    float height = screenHeight*levels[level].renderScale;
+
+    EndFrameTarget();
+    DrawTexturePro(frameTarget.texture, (Rectangle){ 0, frameTarget.texture.height - height, width, -height },
+                   (Rectangle){ 0, 0, (float)screenWidth, (float)screenHeight }, (Vector2){ 0 }, 0.0f, WHITE);
+    scaled = false;
+}
+
+void RecordQualityFrame(uint64_t workTicks)
+{
+    if (!adaptive) return;
+
+    // The first frame after an idle wait reports the wait as its interval
+    bool continuous = (GetFramePacingMode() == FRAMES_CONTINUOUS);
+    bool afterWait = !lastContinuous;
+    lastContinuous = continuous;
+    if (!continuous || afterWait) return;
+
+    int fps = GetFramePacingFps();
+    float budget = 1.0f/fps;
+    bool isOver = (GetFrameTime() > budget*LATE_INTERVAL) || (workTicks > (uint64_t)(budget*BUSY_WORK*1e9f));
+
+    if (windowCount == QUALITY_WINDOW_FRAMES)
+    {
+        workSum -= work[windowNext];
+        overCount -= over[windowNext];
+    }
+    else windowCount++;
+
+    work[windowNext] = workTicks;
+    over[windowNext] = isOver;
+    workSum += workTicks;
+    overCount += isOver;
+    windowNext = (windowNext + 1)%QUALITY_WINDOW_FRAMES;
+    framesAtLevel++;
+
+    if (probing && (framesAtLevel >= QUALITY_PROBE_SECONDS*fps))
+    {
+        probing = false;
+        upSeconds = QUALITY_UP_SECONDS;
+    }
+
+    // A quarter of a window at a level before judging it, so one load spike drops one level
+    if ((overCount >= QUALITY_WINDOW_FRAMES/10) && (windowCount >= QUALITY_WINDOW_FRAMES/4) && (level < QUALITY_LEVELS - 1))
+    {
+        // A step up taken back: wait longer before the next try
+        if (probing && (upSeconds < QUALITY_UP_SECONDS*MAX_UP_BACKOFF)) upSeconds *= 2.0f;
+        ChangeLevel(level + 1, budget, "too slow");
+    }
+    else if ((level > 0) && (windowCount == QUALITY_WINDOW_FRAMES) && (overCount == 0) &&
+             (workSum < (uint64_t)(budget*IDLE_WORK*1e9f)*QUALITY_WINDOW_FRAMES) && (framesAtLevel >= upSeconds*fps))
+    {
+        ChangeLevel(level - 1, budget, "headroom");
+    }
+}
+
+int GetQualityLevel(void) { return level; }
+QualityLevel GetQuality(void) { return levels[level]; }
@@ -0,0 +1,75 @@
+/*******************************************************************************************
+*
+*   Quality: a governor that trades detail for frame time when a machine falls behind
+*
+*   A slow frame does not just look worse: SetTargetFPS() stretches it, and games that count
+*   frames (snake's framesCounter) slow down with it. The scene loop (scenes.h) reports each
+*   continuous frame's work, update start to EndDrawing(), and the interval EndDrawing()
+*   measured, which also holds the GPU and buffer swap: raylib has no GPU timer queries,
+*   so a GPU-bound frame shows up as an interval over the budget. Idle frames (pacing.h) and
+*   scene changes, which upload assets, are not reported.
+*
+*   Over a rolling window of QUALITY_WINDOW_FRAMES a frame is over budget when its interval
+*   runs a quarter past 1/fps or its work takes 90% of it. The governor steps down a level
+*   once 10% of the frames since the last change are over, and up only after a full window
+*   with none over, work under half the budget and QUALITY_UP_SECONDS at the level. A step up
+*   that has to be taken back within QUALITY_PROBE_SECONDS doubles that wait, so a machine at
+*   the edge of a level does not flip between it and the next every few seconds. Every change
+*   is logged ("QUALITY: ...") and counted in games_quality_changes_total; the level is the
+*   games_quality_level gauge.
+*
+*   Each level lowers:
+*
+*       renderScale     the frame is drawn into a render texture this fraction of the screen
+*                       (a 2D camera scales the games' coordinates) and stretched onto it
+*       particleShare   the fraction of each particle pool new particles may fill
+*       gridLines       board lines and other background detail drawn as many small shapes
+*       background      full-screen background textures (a plain clear instead)
+*
+*   Text needs no level: every string drawn each frame is laid out once (textcache.h) or
+*   drawn from a screen layer (layers.h) already.
+*
+*   GAMES_QUALITY=auto runs the governor, GAMES_QUALITY=<level> holds a level. Default: auto,
+*   and level 0 in headless builds, whose frames are timed by the CPU rasterizer instead of a
+*   GPU and must replay the same for a seed.
+*
+********************************************************************************************/
+#ifndef QUALITY_H
+#define QUALITY_H
+
+#include "platform.h"
+
+#define QUALITY_LEVELS          4       // 0: full quality
+#define QUALITY_WINDOW_FRAMES   60
+#define QUALITY_UP_SECONDS      3.0f    // Doubled, up to 8 times, after each failed step up
+#define QUALITY_PROBE_SECONDS   5.0f
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct QualityLevel {
+    float renderScale;              // Of the screen, each way
+    float particleShare;            // Of each particle pool's capacity
+    bool gridLines;
+    bool background;
+} QualityLevel;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void InitQuality(void);                     // Call after InitWindow() and InitTelemetry()
+void CloseQuality(void);
+
+void BeginQualityFrame(void);               // After BeginDrawing(): draws go to the scaled frame
+void EndQualityFrame(void);                 // Stretches it onto the screen
+void RecordQualityFrame(uint64_t workTicks);    // After EndDrawing(): nanoseconds of update and draw
+
+int GetQualityLevel(void);
+QualityLevel GetQuality(void);              // The current level's settings
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // QUALITY_H
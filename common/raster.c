@@ -0,0 +1,450 @@
+/*******************************************************************************************
+*
+*   Raster, see raster.h
+*
+********************************************************************************************/
+#include "raster.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define PNG_STORED_BLOCK    65535           // Largest uncompressed deflate block
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static inline uint32_t PackColor(Color color)
+{
+    uint32_t value;
+    memcpy(&value, &color, sizeof(value));
+    return value;
+}
+
+static inline uint32_t *SurfaceRow(const RasterSurface *surface, int y)
+{
+    return surface->pixels + (ptrdiff_t)y*surface->stride;
+}
+
+// round(t/255) for t <= 255*255, the same in the scalar and the SSE2 paths
+static inline unsigned int Div255(unsigned int t)
+{
+    t += 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+static inline void BlendPixel(uint32_t *pixel, Color src)
+{
+    if (src.a == 255) { *pixel = PackColor(src); return; }
+    if (src.a == 0) return;
+
+    unsigned char *dst = (unsigned char *)pixel;
+    unsigned int inv = 255 - src.a;
+    dst[0] = (unsigned char)Div255(src.r*src.a + dst[0]*inv);
+    dst[1] = (unsigned char)Div255(src.g*src.a + dst[1]*inv);
+    dst[2] = (unsigned char)Div255(src.b*src.a + dst[2]*inv);
+    dst[3] = (unsigned char)Div255(src.a*src.a + dst[3]*inv);
+}
+
+static void FillSpan(uint32_t *row, int count, uint32_t value)
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    __m128i fill = _mm_set1_epi32((int)value);
+    for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i *)(row + i), fill);
+#endif
+
+    for (; i < count; i++) row[i] = value;
+}
+
+// One translucent color over a run of pixels: dst*(255 - a) plus a constant per channel
+static void BlendSpan(uint32_t *row, int count, Color color)
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    unsigned int a = color.a;
+    __m128i inv = _mm_set1_epi16((short)(255 - a));
+    __m128i src = _mm_setr_epi16((short)(color.r*a + 128), (short)(color.g*a + 128), (short)(color.b*a + 128), (short)(a*a + 128),
+                                 (short)(color.r*a + 128), (short)(color.g*a + 128), (short)(color.b*a + 128), (short)(a*a + 128));
+    __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i dst = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), inv), src);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), inv), src);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i *)(row + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < count; i++) BlendPixel(&row[i], color);
+}
+
+// Texels blended 1:1 over a run of pixels, each with its own alpha; all-clear and all-opaque
+// groups of four (most of a render texture layer) skip the arithmetic
+static void BlendTexelSpan(uint32_t *row, const uint32_t *texels, int count)
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    __m128i full = _mm_set1_epi16(255);
+    __m128i bias = _mm_set1_epi16(128);
+    __m128i alphaMask = _mm_set1_epi32((int)0xFF000000u);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i src = _mm_loadu_si128((const __m128i *)(texels + i));
+        __m128i alpha = _mm_and_si128(src, alphaMask);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xFFFF) continue;
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) == 0xFFFF)
+        {
+            _mm_storeu_si128((__m128i *)(row + i), src);
+            continue;
+        }
+
+        __m128i dst = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i srcLo = _mm_unpacklo_epi8(src, zero), srcHi = _mm_unpackhi_epi8(src, zero);
+        __m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(srcLo, 0xFF), 0xFF);
+        __m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(srcHi, 0xFF), 0xFF);
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(srcLo, alphaLo),
+                                                 _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), _mm_sub_epi16(full, alphaLo))), bias);
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(srcHi, alphaHi),
+                                                 _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), _mm_sub_epi16(full, alphaHi))), bias);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i *)(row + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        Color texel;
+        memcpy(&texel, &texels[i], sizeof(texel));
+        BlendPixel(&row[i], texel);
+    }
+}
+
+// Pixels whose centres fall in [start, end)
+static inline void CoveredRange(float start, float end, int size, int *first, int *last)
+{
+    *first = (int)ceilf(start - 0.5f);
+    *last = (int)ceilf(end - 0.5f);
+    if (*first < 0) *first = 0;
+    if (*last > size) *last = size;
+}
+
+static inline int WrapTexel(int i, int size)
+{
+    if ((unsigned int)i < (unsigned int)size) return i;
+
+    i %= size;
+    return (i < 0)? i + size : i;
+}
+
+static inline Color SampleTexel(const RasterSurface *texture, float u, float v, Color tint)
+{
+    int x = WrapTexel((int)floorf(u), texture->width);
+    int y = WrapTexel((int)floorf(v), texture->height);
+    const unsigned char *texel = (const unsigned char *)&SurfaceRow(texture, y)[x];
+
+    return (Color){ (unsigned char)Div255(texel[0]*tint.r), (unsigned char)Div255(texel[1]*tint.g),
+                    (unsigned char)Div255(texel[2]*tint.b), (unsigned char)Div255(texel[3]*tint.a) };
+}
+
+static uint32_t Crc32(uint32_t crc, const unsigned char *data, size_t size)
+{
+    static uint32_t table[256] = { 0 };
+
+    if (table[1] == 0)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1)? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+            table[i] = c;
+        }
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void PutBE32(unsigned char *p, uint32_t value)
+{
+    p[0] = (unsigned char)(value >> 24);
+    p[1] = (unsigned char)(value >> 16);
+    p[2] = (unsigned char)(value >> 8);
+    p[3] = (unsigned char)value;
+}
+
+static bool WritePNGChunk(FILE *file, const char *type, const unsigned char *data, size_t size)
+{
+    unsigned char header[8], footer[4];
+    PutBE32(header, (uint32_t)size);
+    memcpy(header + 4, type, 4);
+    PutBE32(footer, Crc32(Crc32(0, header + 4, 4), data, size));
+
+    return (fwrite(header, 1, 8, file) == 8) && (fwrite(data, 1, size, file) == size) && (fwrite(footer, 1, 4, file) == 4);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+RasterSurface LoadRasterSurface(int width, int height)
+{
+    RasterSurface surface = { 0 };
+
+    if ((width > 0) && (height > 0))
+    {
+        surface.pixels = (uint32_t *)calloc((size_t)width*height, sizeof(uint32_t));
+        if (surface.pixels != NULL)
+        {
+            surface.width = width;
+            surface.height = height;
+            surface.stride = width;
+        }
+    }
+
+    return surface;
+}
+
+void UnloadRasterSurface(RasterSurface *surface)
+{
+    // A bottom-up view points at the last row: free the block from its first
+    if ((surface->pixels != NULL) && (surface->stride < 0)) free(SurfaceRow(surface, surface->height - 1));
+    else free(surface->pixels);
+    *surface = (RasterSurface){ 0 };
+}
+
+RasterSurface GetRasterSurfaceFlipped(RasterSurface surface)
+{
+    if (surface.pixels == NULL) return surface;
+
+    surface.pixels = SurfaceRow(&surface, surface.height - 1);
+    surface.stride = -surface.stride;
+    return surface;
+}
+
+void RasterClear(RasterSurface *surface, Color color)
+{
+    if (surface->pixels == NULL) return;
+
+    uint32_t value = PackColor(color);
+    for (int y = 0; y < surface->height; y++) FillSpan(SurfaceRow(surface, y), surface->width, value);
+}
+
+void RasterPixel(RasterSurface *surface, int x, int y, Color color)
+{
+    if ((surface->pixels == NULL) || (x < 0) || (y < 0) || (x >= surface->width) || (y >= surface->height)) return;
+
+    SurfaceRow(surface, y)[x] = PackColor(color);
+}
+
+void RasterRectangle(RasterSurface *surface, Rectangle rec, Color color)
+{
+    if ((surface->pixels == NULL) || (color.a == 0)) return;
+
+    int x0, x1, y0, y1;
+    CoveredRange(rec.x, rec.x + rec.width, surface->width, &x0, &x1);
+    CoveredRange(rec.y, rec.y + rec.height, surface->height, &y0, &y1);
+    if ((x0 >= x1) || (y0 >= y1)) return;
+
+    uint32_t value = PackColor(color);
+    for (int y = y0; y < y1; y++)
+    {
+        if (color.a == 255) FillSpan(SurfaceRow(surface, y) + x0, x1 - x0, value);
+        else BlendSpan(SurfaceRow(surface, y) + x0, x1 - x0, color);
+    }
+}
+
+// One pixel per step along the major axis, sampled at the step centres
+void RasterLine(RasterSurface *surface, Vector2 start, Vector2 end, Color color)
+{
+    if ((surface->pixels == NULL) || (color.a == 0)) return;
+
+    float dx = end.x - start.x, dy = end.y - start.y;
+    int steps = (int)ceilf(fmaxf(fabsf(dx), fabsf(dy)));
+
+    for (int i = 0; i < steps; i++)
+    {
+        float t = ((float)i + 0.5f)/(float)steps;
+        int x = (int)floorf(start.x + dx*t);
+        int y = (int)floorf(start.y + dy*t);
+
+        if ((x >= 0) && (y >= 0) && (x < surface->width) && (y < surface->height)) BlendPixel(&SurfaceRow(surface, y)[x], color);
+    }
+}
+
+void RasterTexture(RasterSurface *surface, const RasterSurface *texture, Rectangle source, Rectangle dest,
+                   Vector2 origin, float rotation, Color tint)
+{
+    if ((surface->pixels == NULL) || (texture == NULL) || (texture->pixels == NULL) || (tint.a == 0)) return;
+    if ((dest.width <= 0.0f) || (dest.height <= 0.0f)) return;
+
+    // A negative source size walks the texels back from the far edge, as DrawTexturePro() flips
+    if (source.width < 0.0f) source.x -= source.width;
+    if (source.height < 0.0f) source.y -= source.height;
+
+    float du = source.width/dest.width;
+    float dv = source.height/dest.height;
+    int x0, x1, y0, y1;
+
+    if (rotation == 0.0f)
+    {
+        float left = dest.x - origin.x, top = dest.y - origin.y;
+        CoveredRange(left, left + dest.width, surface->width, &x0, &x1);
+        CoveredRange(top, top + dest.height, surface->height, &y0, &y1);
+
+        bool untinted = (tint.r == 255) && (tint.g == 255) && (tint.b == 255) && (tint.a == 255);
+        bool unscaled = (du == 1.0f) && ((dv == 1.0f) || (dv == -1.0f));
+
+        for (int y = y0; y < y1; y++)
+        {
+            uint32_t *row = SurfaceRow(surface, y);
+            float v = source.y + ((float)y + 0.5f - top)*dv;
+            int start = (int)floorf(source.x + ((float)x0 + 0.5f - left)*du);
+
+            // Screen layers and unscaled sprites: a texel row lines up with the pixel row
+            if (untinted && unscaled && (start >= 0) && (start + (x1 - x0) <= texture->width))
+            {
+                BlendTexelSpan(row + x0, SurfaceRow(texture, WrapTexel((int)floorf(v), texture->height)) + start, x1 - x0);
+                continue;
+            }
+
+            for (int x = x0; x < x1; x++) BlendPixel(&row[x], SampleTexel(texture, source.x + ((float)x + 0.5f - left)*du, v, tint));
+        }
+        return;
+    }
+
+    // Rotated about (dest.x, dest.y): scan the bounding box, map each pixel centre back
+    float sinr = sinf(rotation*DEG2RAD), cosr = cosf(rotation*DEG2RAD);
+    float minX = dest.x, maxX = dest.x, minY = dest.y, maxY = dest.y;
+    Vector2 corners[4] = { { -origin.x, -origin.y }, { dest.width - origin.x, -origin.y },
+                           { dest.width - origin.x, dest.height - origin.y }, { -origin.x, dest.height - origin.y } };
+
+    for (int i = 0; i < 4; i++)
+    {
+        float x = dest.x + corners[i].x*cosr - corners[i].y*sinr;
+        float y = dest.y + corners[i].x*sinr + corners[i].y*cosr;
+        minX = (i == 0)? x : fminf(minX, x);
+        maxX = (i == 0)? x : fmaxf(maxX, x);
+        minY = (i == 0)? y : fminf(minY, y);
+        maxY = (i == 0)? y : fmaxf(maxY, y);
+    }
+
+    CoveredRange(minX, maxX, surface->width, &x0, &x1);
+    CoveredRange(minY, maxY, surface->height, &y0, &y1);
+
+    for (int y = y0; y < y1; y++)
+    {
+        uint32_t *row = SurfaceRow(surface, y);
+        float py = (float)y + 0.5f - dest.y;
+
+        for (int x = x0; x < x1; x++)
+        {
+            float px = (float)x + 0.5f - dest.x;
+            float lx = px*cosr + py*sinr + origin.x;
+            float ly = -px*sinr + py*cosr + origin.y;
+
+            if ((lx < 0.0f) || (ly < 0.0f) || (lx >= dest.width) || (ly >= dest.height)) continue;
+            BlendPixel(&row[x], SampleTexel(texture, source.x + lx*du, source.y + ly*dv, tint));
+        }
+    }
+}
+
+// FNV-1a over the pixels in display order, with the size mixed in first
+uint64_t GetRasterChecksum(const RasterSurface *surface)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    hash = (hash ^ (uint64_t)surface->width)*1099511628211ULL;
+    hash = (hash ^ (uint64_t)surface->height)*1099511628211ULL;
+    if (surface->pixels == NULL) return hash;
+
+    for (int y = 0; y < surface->height; y++)
+    {
+        const uint32_t *row = SurfaceRow(surface, y);
+        for (int x = 0; x < surface->width; x++) hash = (hash ^ row[x])*1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// Stored (uncompressed) deflate blocks keep the writer small; golden images are few and tiny next to a build
+bool ExportRasterPNG(const RasterSurface *surface, const char *fileName)
+{
+    if (surface->pixels == NULL) return false;
+
+    size_t rowBytes = 1 + (size_t)surface->width*4;
+    size_t rawBytes = rowBytes*surface->height;
+    size_t blocks = (rawBytes + PNG_STORED_BLOCK - 1)/PNG_STORED_BLOCK;
+    size_t idatBytes = 2 + blocks*5 + rawBytes + 4;
+
+    unsigned char *raw = (unsigned char *)malloc(rawBytes);
+    unsigned char *idat = (unsigned char *)malloc(idatBytes);
+    FILE *file = ((raw != NULL) && (idat != NULL))? fopen(fileName, "wb") : NULL;
+    bool success = false;
+
+    if (file != NULL)
+    {
+        // Filter type 0 on every row, then the RGBA bytes as stored
+        for (int y = 0; y < surface->height; y++)
+        {
+            raw[y*rowBytes] = 0;
+            memcpy(raw + y*rowBytes + 1, SurfaceRow(surface, y), (size_t)surface->width*4);
+        }
+
+        uint32_t adlerA = 1, adlerB = 0;
+        size_t pos = 0;
+        idat[pos++] = 0x78;
+        idat[pos++] = 0x01;
+
+        for (size_t offset = 0; offset < rawBytes; offset += PNG_STORED_BLOCK)
+        {
+            size_t size = (rawBytes - offset < PNG_STORED_BLOCK)? rawBytes - offset : PNG_STORED_BLOCK;
+            idat[pos++] = (offset + size == rawBytes)? 1 : 0;
+            idat[pos++] = (unsigned char)(size & 0xFF);
+            idat[pos++] = (unsigned char)(size >> 8);
+            idat[pos++] = (unsigned char)(~size & 0xFF);
+            idat[pos++] = (unsigned char)((~size >> 8) & 0xFF);
+            memcpy(idat + pos, raw + offset, size);
+            pos += size;
+
+            for (size_t i = 0; i < size; i++)
+            {
+                adlerA = (adlerA + raw[offset + i])%65521;
+                adlerB = (adlerB + adlerA)%65521;
+            }
+        }
+        PutBE32(idat + pos, (adlerB << 16) | adlerA);
+
+        unsigned char ihdr[13] = { 0 };
+        PutBE32(ihdr, (uint32_t)surface->width);
+        PutBE32(ihdr + 4, (uint32_t)surface->height);
+        ihdr[8] = 8;                // Bits per channel
+        ihdr[9] = 6;                // RGBA
+
+        success = (fwrite("\x89PNG\r\n\x1a\n", 1, 8, file) == 8) && WritePNGChunk(file, "IHDR", ihdr, sizeof(ihdr)) &&
+                  WritePNGChunk(file, "IDAT", idat, idatBytes) && WritePNGChunk(file, "IEND", NULL, 0);
+        success = (fclose(file) == 0) && success;
+    }
+
+    free(raw);
+    free(idat);
+    return success;
+}
@@ -0,0 +1,1216 @@
+/*******************************************************************************************
+*
+*   Headless stand-in for the subset of raylib used by the games
+*
+*   See raylib_headless.h for the environment variables that drive a run. At CloseWindow()
+*   a one-line summary with frame count and wall-clock cost per frame is printed, which is
+*   what the benchmark and PGO training targets read.
+*
+********************************************************************************************/
+#include "raylib_headless.h"
+#include "arena.h"
+#include "telemetry.h"
+#include "raster.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_TEXTFORMAT_BUFFERS      4
+#define MAX_TEXT_BUFFER_LENGTH   1024
+#define DEFAULT_FRAME_LIMIT      3600
+#define AUDIO_PERIOD_FRAMES       512     // Frames per device callback, ~11.6 ms at 44.1 kHz
+#define FONT_FIRST_CHAR            32
+#define FONT_GLYPHS                95
+#define MAX_RASTER_TEXTURES       256     // Texture ids beyond this are not rasterized
+#define TEXT_LINE_SPACING           2     // raylib's default extra gap between lines
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static struct {
+    bool ready;
+    bool shouldClose;
+    bool fullscreen;
+    int width;
+    int height;
+    int targetFPS;
+    int frameCounter;
+    int frameLimit;
+    bool training;                  // GAMES_HEADLESS_TRAINING
+    bool eventWaiting;
+    long long ticks;                // Frames plus the input polls slept through while waiting
+    long long waitedTicks;
+    long long tickBase;             // GetTime() counts from here at the current targetFPS
+    double timeBase;
+    double startWallTime;
+} window = { 0 };
+
+static struct {
+    unsigned long long state;
+    int pressedKey;
+    int heldKey;
+    int releasedKey;
+    bool mousePressed;
+    Vector2 mousePosition;
+} input = { 0 };
+
+// rlgl stand-in: one vertex stream, flushed into a draw call count
+static struct {
+    rlRenderBatch *active;          // NULL: the default batch
+    int vertexCount;                // Since the last flush
+    long long drawCalls;
+} batching = { 0 };
+
+static int traceLogLevel = LOG_INFO;
+static bool audioReady = false;
+static unsigned int textureCounter = 1;         // Id 1 is rlgl's default white texture
+
+// Software rasterizer (GAMES_HEADLESS_RASTER): the screen, a surface per texture id, rlgl state
+static struct {
+    bool enabled;
+    RasterSurface screen;
+    RasterSurface target;           // The screen, or the render texture being drawn (bottom-up)
+    bool mode2D;                    // BeginMode2D(): draws go through camera
+    Camera2D camera;
+    RasterSurface textures[MAX_RASTER_TEXTURES];
+    unsigned int texture;           // rlSetTexture(); 0: the default texture
+    int mode;                       // rlBegin()
+    Color color;
+    Vector2 texcoord;
+    Vector2 vertices[4];
+    Vector2 texcoords[4];
+    Color colors[4];
+    int vertexCount;
+    int goldenFrame;                // Checksummed (and written as PNG) at its EndDrawing(); 0: the last
+    const char *pngFile;
+} raster = { 0 };
+
+// The callback stream and the thread standing in for the sound card
+static struct {
+    bool loaded;
+    bool running;
+    AudioStream stream;
+    AudioCallback callback;
+    pthread_t thread;
+    pthread_mutex_t lock;
+} audioDevice = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// Keys the input monkey may press; duplicates weight the choice
+static const int monkeyKeys[] = {
+    KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_DOWN, KEY_RIGHT,
+    KEY_ENTER, KEY_SPACE, KEY_SPACE, KEY_SPACE,
+    KEY_H, KEY_S, KEY_A, KEY_C, KEY_P, KEY_M, KEY_F
+};
+static const int monkeyHeldKeys[] = { KEY_NULL, KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT };
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static double WallTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+
+static int EnvInt(const char *name, int defaultValue)
+{
+    const char *value = getenv(name);
+    return (value != NULL && value[0] != '\0')? atoi(value) : defaultValue;
+}
+
+static RasterSurface *GetRasterTexture(unsigned int id)
+{
+    if (id == 0) id = rlGetTextureIdDefault();
+    return ((id < MAX_RASTER_TEXTURES) && (raster.textures[id].pixels != NULL))? &raster.textures[id] : NULL;
+}
+
+// Stand-in pixels for a texture: 8 px checker, colors picked by its size so they survive reloads
+static void LoadRasterTexture(unsigned int id, int width, int height, bool checker)
+{
+    if (!raster.enabled || (id >= MAX_RASTER_TEXTURES)) return;
+
+    unsigned int seed = (unsigned int)width*73856093u ^ (unsigned int)height*19349663u;
+    Color light = { (unsigned char)(160 + (seed & 63)), (unsigned char)(160 + ((seed >> 6) & 63)), (unsigned char)(160 + ((seed >> 12) & 63)), 255 };
+    Color dark = { (unsigned char)(light.r/2), (unsigned char)(light.g/2), (unsigned char)(light.b/2), 255 };
+
+    UnloadRasterSurface(&raster.textures[id]);
+    raster.textures[id] = LoadRasterSurface(width, height);
+    for (int y = 0; checker && (y < height); y++)
+    {
+        for (int x = 0; x < width; x++) RasterPixel(&raster.textures[id], x, y, (((x >> 3) ^ (y >> 3)) & 1)? dark : light);
+    }
+}
+
+// 5x7 dots from a hash of the codepoint, the stand-in for its shape
+static unsigned long long GetGlyphDots(int codepoint)
+{
+    unsigned long long bits = (unsigned long long)codepoint*0x9E3779B97F4A7C15ULL;
+    bits ^= bits >> 29;
+    return (codepoint == ' ')? 0 : bits;
+}
+
+// Each glyph cell gets its dots, white on transparent
+static void LoadRasterFont(Font font)
+{
+    LoadRasterTexture(font.texture.id, font.texture.width, font.texture.height, false);
+    RasterSurface *atlas = GetRasterTexture(font.texture.id);
+
+    for (int i = 0; (atlas != NULL) && (i < font.glyphCount); i++)
+    {
+        unsigned long long bits = GetGlyphDots(font.glyphs[i].value);
+
+        for (int dot = 0; dot < 35; dot++)
+        {
+            if ((bits >> dot) & 1) RasterPixel(atlas, (int)font.recs[i].x + dot%5, (int)font.recs[i].y + 1 + dot/5, WHITE);
+        }
+    }
+}
+
+// Where a point drawn under BeginMode2D() lands on the target
+static Vector2 ViewPoint(Vector2 point)
+{
+    if (!raster.mode2D) return point;
+    return (Vector2){ (point.x - raster.camera.target.x)*raster.camera.zoom + raster.camera.offset.x,
+                      (point.y - raster.camera.target.y)*raster.camera.zoom + raster.camera.offset.y };
+}
+
+static Rectangle ViewRec(Rectangle rec)
+{
+    if (!raster.mode2D) return rec;
+
+    Vector2 corner = ViewPoint((Vector2){ rec.x, rec.y });
+    return (Rectangle){ corner.x, corner.y, rec.width*raster.camera.zoom, rec.height*raster.camera.zoom };
+}
+
+// rlgl quads are drawn as they complete; the games only emit axis-aligned ones
+static void RasterQuad(void)
+{
+    RasterSurface *texture = GetRasterTexture(raster.texture);
+    if (texture == NULL) return;
+
+    Vector2 a = raster.vertices[0], c = raster.vertices[2];
+    Vector2 ta = raster.texcoords[0], tc = raster.texcoords[2];
+    Rectangle source = { fminf(ta.x, tc.x)*texture->width, fminf(ta.y, tc.y)*texture->height,
+                         (tc.x - ta.x)*texture->width, (tc.y - ta.y)*texture->height };
+
+    RasterTexture(&raster.target, texture, source, (Rectangle){ a.x, a.y, c.x - a.x, c.y - a.y }, (Vector2){ 0 }, 0.0f, raster.colors[0]);
+}
+
+// xorshift64*, independent of rand() so game-side srand() calls don't perturb the input
+static unsigned int NextInputRandom(void)
+{
+    input.state ^= input.state >> 12;
+    input.state ^= input.state << 25;
+    input.state ^= input.state >> 27;
+    return (unsigned int)((input.state*2685821657736338717ULL) >> 32);
+}
+
+static void PollInputEvents(void)
+{
+    input.releasedKey = KEY_NULL;
+    input.pressedKey = KEY_NULL;
+    input.mousePressed = false;
+
+    if ((NextInputRandom() % 6) == 0)
+    {
+        input.pressedKey = monkeyKeys[NextInputRandom() % (sizeof(monkeyKeys)/sizeof(monkeyKeys[0]))];
+    }
+
+    if ((NextInputRandom() % 16) == 0)
+    {
+        input.releasedKey = input.heldKey;
+        input.heldKey = monkeyHeldKeys[NextInputRandom() % (sizeof(monkeyHeldKeys)/sizeof(monkeyHeldKeys[0]))];
+    }
+
+    if ((NextInputRandom() % 120) == 0)
+    {
+        input.mousePressed = true;
+        input.mousePosition.x = (float)(NextInputRandom() % (unsigned int)(window.width > 0? window.width : 1));
+        input.mousePosition.y = (float)(NextInputRandom() % (unsigned int)(window.height > 0? window.height : 1));
+    }
+}
+
+// What glfwWaitEvents() would wake up for: a key going down or up, a click
+static bool PollInputChanged(void)
+{
+    int heldKey = input.heldKey;
+    PollInputEvents();
+
+    return (input.pressedKey != KEY_NULL) || (input.releasedKey != KEY_NULL) || (input.heldKey != heldKey) || input.mousePressed;
+}
+
+static unsigned char *ReadFileHead(const char *fileName, size_t *bytesRead, size_t maxBytes)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to open file", fileName);
+        return NULL;
+    }
+
+    unsigned char *data = (unsigned char *)malloc(maxBytes);
+    *bytesRead = (data != NULL)? fread(data, 1, maxBytes, file) : 0;
+    fclose(file);
+
+    return data;
+}
+
+static unsigned int ReadBE32(const unsigned char *p) { return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8) | p[3]; }
+static unsigned int ReadBE16(const unsigned char *p) { return ((unsigned int)p[0] << 8) | p[1]; }
+static unsigned int ReadLE32(const unsigned char *p) { return ((unsigned int)p[3] << 24) | ((unsigned int)p[2] << 16) | ((unsigned int)p[1] << 8) | p[0]; }
+static unsigned int ReadLE16(const unsigned char *p) { return ((unsigned int)p[1] << 8) | p[0]; }
+
+// Only the image dimensions are needed to lay out sprites, so PNG/JPEG headers are enough
+static bool ReadImageSize(const unsigned char *data, size_t size, int *width, int *height)
+{
+    if ((size >= 24) && (memcmp(data, "\x89PNG", 4) == 0))
+    {
+        *width = (int)ReadBE32(data + 16);
+        *height = (int)ReadBE32(data + 20);
+        return true;
+    }
+
+    if ((size >= 4) && (data[0] == 0xFF) && (data[1] == 0xD8))
+    {
+        size_t pos = 2;
+        while (pos + 9 < size)
+        {
+            if (data[pos] != 0xFF) { pos++; continue; }
+
+            unsigned char marker = data[pos + 1];
+            bool isFrameHeader = (marker >= 0xC0) && (marker <= 0xCF) &&
+                                 (marker != 0xC4) && (marker != 0xC8) && (marker != 0xCC);
+            if (isFrameHeader)
+            {
+                *height = (int)ReadBE16(data + pos + 5);
+                *width = (int)ReadBE16(data + pos + 7);
+                return true;
+            }
+            pos += 2 + ReadBE16(data + pos + 2);
+        }
+    }
+
+    return false;
+}
+
+// Parses a RIFF/WAVE header; *samples points at the PCM data inside the buffer
+static bool ParseWave(const unsigned char *data, size_t size, Wave *wave, const unsigned char **samples, unsigned int *sampleBytes)
+{
+    if ((data == NULL) || (size < 12) || (memcmp(data, "RIFF", 4) != 0) || (memcmp(data + 8, "WAVE", 4) != 0)) return false;
+
+    size_t pos = 12;
+    while (pos + 8 <= size)
+    {
+        unsigned int chunkSize = ReadLE32(data + pos + 4);
+        if ((memcmp(data + pos, "fmt ", 4) == 0) && (pos + 24 <= size))
+        {
+            wave->channels = ReadLE16(data + pos + 10);
+            wave->sampleRate = ReadLE32(data + pos + 12);
+            wave->sampleSize = ReadLE16(data + pos + 22);
+        }
+        else if (memcmp(data + pos, "data", 4) == 0)
+        {
+            unsigned int frameBytes = wave->channels*(wave->sampleSize/8);
+            wave->frameCount = (frameBytes > 0)? chunkSize/frameBytes : 0;
+            if (samples != NULL) *samples = data + pos + 8;
+            if (sampleBytes != NULL) *sampleBytes = chunkSize;
+            return true;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    return false;
+}
+
+// Pulls one period at a time on an absolute schedule, like a sound card draining its buffer
+static void *AudioDeviceMain(void *arg)
+{
+    (void)arg;
+
+    unsigned int frameBytes = audioDevice.stream.channels*(audioDevice.stream.sampleSize/8);
+    unsigned char *buffer = (unsigned char *)calloc(AUDIO_PERIOD_FRAMES, (frameBytes > 0)? frameBytes : 1);
+    long long periodNanos = 1000000000LL*AUDIO_PERIOD_FRAMES/((audioDevice.stream.sampleRate > 0)? audioDevice.stream.sampleRate : 44100);
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    pthread_mutex_lock(&audioDevice.lock);
+    while (audioDevice.running && (buffer != NULL))
+    {
+        if (audioDevice.callback != NULL) audioDevice.callback(buffer, AUDIO_PERIOD_FRAMES);
+        pthread_mutex_unlock(&audioDevice.lock);
+
+        long long nanos = next.tv_nsec + periodNanos;
+        next.tv_sec += (time_t)(nanos/1000000000LL);
+        next.tv_nsec = (long)(nanos%1000000000LL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+        pthread_mutex_lock(&audioDevice.lock);
+    }
+    pthread_mutex_unlock(&audioDevice.lock);
+
+    free(buffer);
+    return NULL;
+}
+
+static void StopAudioDevice(void)
+{
+    pthread_mutex_lock(&audioDevice.lock);
+    bool wasRunning = audioDevice.running;
+    audioDevice.running = false;
+    pthread_mutex_unlock(&audioDevice.lock);
+
+    if (wasRunning) pthread_join(audioDevice.thread, NULL);
+}
+
+//----------------------------------------------------------------------------------
+// Window and timing
+//----------------------------------------------------------------------------------
+void InitWindow(int width, int height, const char *title)
+{
+    window.width = width;
+    window.height = height;
+    window.targetFPS = 60;
+    window.frameCounter = 0;
+    window.eventWaiting = false;
+    window.ticks = window.waitedTicks = window.tickBase = 0;
+    window.timeBase = 0.0;
+    window.frameLimit = EnvInt("GAMES_HEADLESS_FRAMES", DEFAULT_FRAME_LIMIT);
+    window.training = (EnvInt("GAMES_HEADLESS_TRAINING", 0) != 0);
+    window.shouldClose = false;
+    window.ready = true;
+    window.startWallTime = WallTime();
+
+    unsigned int seed = (unsigned int)EnvInt("GAMES_HEADLESS_SEED", 1);
+    input.state = 0x9E3779B97F4A7C15ULL ^ seed;
+    if (input.state == 0) input.state = 1;
+    SetRandomSeed(seed);
+
+    raster.enabled = (EnvInt("GAMES_HEADLESS_RASTER", 0) != 0);
+    if (raster.enabled)
+    {
+        raster.screen = LoadRasterSurface(width, height);
+        raster.target = raster.screen;
+        raster.goldenFrame = EnvInt("GAMES_HEADLESS_GOLDEN_FRAME", 0);
+        raster.pngFile = getenv("GAMES_HEADLESS_PNG");
+        LoadRasterTexture(rlGetTextureIdDefault(), 1, 1, false);
+        RasterPixel(&raster.textures[rlGetTextureIdDefault()], 0, 0, WHITE);
+        LoadRasterFont(GetFontDefault());
+    }
+
+    TraceLog(LOG_INFO, "DISPLAY: Headless window initialized: %s (%i x %i, %i frames%s)", title, width, height, window.frameLimit,
+             raster.enabled? ", software raster" : "");
+}
+
+// The golden frame: its checksum is what a rendering regression test compares
+static void CheckRasterFrame(long long frame)
+{
+    TraceLog(LOG_INFO, "HEADLESS: Frame %lld raster checksum %016llx", frame, (unsigned long long)GetRasterChecksum(&raster.screen));
+    if ((raster.pngFile == NULL) || (raster.pngFile[0] == '\0')) return;
+
+    if (ExportRasterPNG(&raster.screen, raster.pngFile)) TraceLog(LOG_INFO, "HEADLESS: Frame %lld written to %s", frame, raster.pngFile);
+    else TraceLog(LOG_WARNING, "HEADLESS: [%s] Failed to write frame", raster.pngFile);
+}
+
+void CloseWindow(void)
+{
+    if (!window.ready) return;
+
+    double elapsed = WallTime() - window.startWallTime;
+    TraceLog(LOG_INFO, "HEADLESS: %i frames in %.3f ms (%.3f us/frame)", window.frameCounter, elapsed*1000.0,
+             (window.frameCounter > 0)? elapsed*1e6/window.frameCounter : 0.0);
+    if (batching.drawCalls > 0) TraceLog(LOG_INFO, "HEADLESS: %lld rlgl batch draw calls", batching.drawCalls);
+    if (raster.enabled)
+    {
+        if (raster.goldenFrame == 0) CheckRasterFrame(window.ticks);
+
+        UnloadRasterSurface(&raster.screen);
+        for (int i = 0; i < MAX_RASTER_TEXTURES; i++) UnloadRasterSurface(&raster.textures[i]);
+        raster.target = raster.screen;
+        raster.enabled = false;
+    }
+    if (window.waitedTicks > 0) TraceLog(LOG_INFO, "HEADLESS: %lld idle frames skipped waiting for input (%.1f%% of %lld)",
+                                         window.waitedTicks, 100.0*window.waitedTicks/window.ticks, window.ticks);
+
+    window.ready = false;
+    window.shouldClose = true;
+
+    // A short training run profiles the menu instead of the game
+    if (window.training && (window.frameLimit > 0) && (window.ticks < window.frameLimit))
+    {
+        TraceLog(LOG_FATAL, "HEADLESS: Training run ended after %lld of %i frames", window.ticks, window.frameLimit);
+    }
+}
+
+bool WindowShouldClose(void)
+{
+    if ((window.frameLimit > 0) && (window.ticks >= window.frameLimit)) window.shouldClose = true;
+    return window.shouldClose;
+}
+
+bool IsWindowReady(void) { return window.ready; }
+bool IsWindowFullscreen(void) { return window.fullscreen; }
+void ToggleFullscreen(void) { window.fullscreen = !window.fullscreen; }
+int GetScreenWidth(void) { return window.width; }
+int GetScreenHeight(void) { return window.height; }
+int GetFPS(void) { return window.targetFPS; }
+float GetFrameTime(void) { return 1.0f/(float)window.targetFPS; }
+double GetTime(void) { return window.timeBase + (double)(window.ticks - window.tickBase)/(double)window.targetFPS; }
+void EnableEventWaiting(void) { window.eventWaiting = true; }
+void DisableEventWaiting(void) { window.eventWaiting = false; }
+
+// The clock is rebased so a new rate only changes how fast time runs from now on
+void SetTargetFPS(int fps)
+{
+    window.timeBase = GetTime();
+    window.tickBase = window.ticks;
+    window.targetFPS = (fps > 0)? fps : 60;
+}
+
+void SetHeadlessFrameLimit(int frames) { window.frameLimit = frames; }
+bool IsHeadlessTraining(void) { return window.training; }
+int GetHeadlessFrameCount(void) { return window.frameCounter; }
+
+//----------------------------------------------------------------------------------
+// Drawing
+//----------------------------------------------------------------------------------
+void BeginDrawing(void) { }
+
+void EndDrawing(void)
+{
+    rlDrawRenderBatchActive();
+    EndMemoryFrame();
+    EndTelemetryFrame();
+    window.frameCounter++;
+    window.ticks++;
+
+    long long shownFrom = window.ticks;
+    bool inputChanged = PollInputChanged();
+
+    // Event waiting: sleep through the frames where the monkey does nothing, like
+    // glfwWaitEvents() would, with the virtual clock still running. Input is polled once per
+    // frame either way, so a seed plays out the same whether or not the game was waiting
+    while (window.eventWaiting && !inputChanged && ((window.frameLimit <= 0) || (window.ticks < window.frameLimit)))
+    {
+        window.ticks++;
+        window.waitedTicks++;
+        inputChanged = PollInputChanged();
+    }
+
+    // The golden frame is whatever was on screen at that point, so possibly this one slept through
+    if (raster.enabled && (raster.goldenFrame >= shownFrom) && (raster.goldenFrame <= window.ticks)) CheckRasterFrame(raster.goldenFrame);
+}
+
+// Like rlgl's modelview: a new render target starts from the identity
+void BeginMode2D(Camera2D camera)
+{
+    rlDrawRenderBatchActive();
+    raster.camera = camera;
+    raster.mode2D = true;
+}
+
+void EndMode2D(void)
+{
+    rlDrawRenderBatchActive();
+    raster.mode2D = false;
+}
+
+void ClearBackground(Color color) { RasterClear(&raster.target, color); }
+void DrawLineV(Vector2 startPos, Vector2 endPos, Color color) { RasterLine(&raster.target, ViewPoint(startPos), ViewPoint(endPos), color); }
+void DrawRectangle(int posX, int posY, int width, int height, Color color) { DrawRectangleRec((Rectangle){ (float)posX, (float)posY, (float)width, (float)height }, color); }
+void DrawRectangleV(Vector2 position, Vector2 size, Color color) { DrawRectangleRec((Rectangle){ position.x, position.y, size.x, size.y }, color); }
+void DrawRectangleRec(Rectangle rec, Color color) { RasterRectangle(&raster.target, ViewRec(rec), color); }
+
+void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint)
+{
+    Rectangle source = { 0.0f, 0.0f, (float)texture.width, (float)texture.height };
+    Rectangle dest = { position.x, position.y, (float)texture.width*scale, (float)texture.height*scale };
+    DrawTexturePro(texture, source, dest, (Vector2){ 0 }, rotation, tint);
+}
+
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    float zoom = raster.mode2D? raster.camera.zoom : 1.0f;
+    if (texture.id != 0) RasterTexture(&raster.target, GetRasterTexture(texture.id), source, ViewRec(dest),
+                                       (Vector2){ origin.x*zoom, origin.y*zoom }, rotation, tint);
+}
+
+// Same glyph walk as raylib's DrawTextEx()
+void DrawTextEx(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    if ((raster.target.pixels == NULL) || (text == NULL) || (font.glyphCount == 0)) return;
+
+    float scale = fontSize/(float)font.baseSize;
+    float padding = (float)font.glyphPadding;
+    float x = 0.0f, y = 0.0f;
+
+    for (int i = 0; text[i] != '\0';)
+    {
+        int size = 0;
+        int codepoint = GetCodepointNext(&text[i], &size);
+        i += size;
+
+        if (codepoint == '\n')
+        {
+            x = 0.0f;
+            y += fontSize + TEXT_LINE_SPACING;
+            continue;
+        }
+
+        int index = GetGlyphIndex(font, codepoint);
+        Rectangle rec = font.recs[index];
+        GlyphInfo glyph = font.glyphs[index];
+
+        if ((codepoint != ' ') && (codepoint != '\t'))
+        {
+            Rectangle source = { rec.x - padding, rec.y - padding, rec.width + 2.0f*padding, rec.height + 2.0f*padding };
+            Rectangle dest = { position.x + x + (glyph.offsetX - padding)*scale, position.y + y + (glyph.offsetY - padding)*scale,
+                               source.width*scale, source.height*scale };
+            DrawTexturePro(font.texture, source, dest, (Vector2){ 0 }, 0.0f, tint);
+        }
+
+        x += ((glyph.advanceX != 0)? (float)glyph.advanceX : rec.width)*scale + spacing;
+    }
+}
+
+void DrawText(const char *text, int posX, int posY, int fontSize, Color color)
+{
+    if (raster.target.pixels == NULL) return;
+    if (fontSize < 10) fontSize = 10;
+    DrawTextEx(GetFontDefault(), text, (Vector2){ (float)posX, (float)posY }, (float)fontSize, (float)(fontSize/10), color);
+}
+
+// Same widths as raylib's MeasureTextEx(): the widest line, spacing between glyphs only
+Vector2 MeasureTextEx(Font font, const char *text, float fontSize, float spacing)
+{
+    float scale = fontSize/(float)font.baseSize;
+    float lineWidth = 0.0f, maxWidth = 0.0f;
+    int lineGlyphs = 0, lines = 1;
+
+    for (int i = 0; (text != NULL) && (font.glyphCount > 0) && (text[i] != '\0');)
+    {
+        int size = 0;
+        int codepoint = GetCodepointNext(&text[i], &size);
+        i += size;
+
+        if (codepoint == '\n')
+        {
+            lines++;
+            lineWidth = 0.0f;
+            lineGlyphs = 0;
+            continue;
+        }
+
+        int index = GetGlyphIndex(font, codepoint);
+        GlyphInfo glyph = font.glyphs[index];
+        lineWidth += ((glyph.advanceX != 0)? (float)glyph.advanceX : font.recs[index].width + glyph.offsetX)*scale;
+        lineGlyphs++;
+
+        float width = lineWidth + (float)(lineGlyphs - 1)*spacing;
+        if (width > maxWidth) maxWidth = width;
+    }
+
+    return (Vector2){ maxWidth, fontSize + (float)(lines - 1)*(fontSize + TEXT_LINE_SPACING) };
+}
+
+// Approximates raylib's default font: ~0.6 em advance per glyph including spacing
+int MeasureText(const char *text, int fontSize)
+{
+    if (text == NULL) return 0;
+    if (fontSize < 10) fontSize = 10;
+
+    int length = (int)strlen(text);
+    return (length*fontSize*6)/10;
+}
+
+const char *TextFormat(const char *text, ...)
+{
+    static char buffers[MAX_TEXTFORMAT_BUFFERS][MAX_TEXT_BUFFER_LENGTH] = { 0 };
+    static int index = 0;
+
+    char *currentBuffer = buffers[index];
+
+    va_list args;
+    va_start(args, text);
+    vsnprintf(currentBuffer, MAX_TEXT_BUFFER_LENGTH, text, args);
+    va_end(args);
+
+    index = (index + 1) % MAX_TEXTFORMAT_BUFFERS;
+    return currentBuffer;
+}
+
+Font GetFontDefault(void)
+{
+    static Rectangle recs[FONT_GLYPHS] = { 0 };
+    static GlyphInfo glyphs[FONT_GLYPHS] = { 0 };
+    static Font font = { 0 };
+
+    if (font.glyphCount == 0)
+    {
+        for (int i = 0; i < FONT_GLYPHS; i++)
+        {
+            recs[i] = (Rectangle){ (float)(1 + (i%16)*6), (float)(1 + (i/16)*11), 5, 10 };
+            glyphs[i].value = FONT_FIRST_CHAR + i;
+        }
+
+        font = (Font){ 10, FONT_GLYPHS, 0, { ++textureCounter, 128, 128, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 }, recs, glyphs };
+    }
+
+    return font;
+}
+
+// As raylib: a missing codepoint gets '?', or glyph 0 if the font has no '?' either
+int GetGlyphIndex(Font font, int codepoint)
+{
+    int fallback = 0;
+
+    for (int i = 0; i < font.glyphCount; i++)
+    {
+        if (font.glyphs[i].value == codepoint) return i;
+        if (font.glyphs[i].value == '?') fallback = i;
+    }
+
+    return fallback;
+}
+
+int GetCodepointNext(const char *text, int *codepointSize)
+{
+    const unsigned char *bytes = (const unsigned char *)text;
+    int length = (bytes[0] < 0x80)? 1 : ((bytes[0] & 0xE0) == 0xC0)? 2 : ((bytes[0] & 0xF0) == 0xE0)? 3 : ((bytes[0] & 0xF8) == 0xF0)? 4 : 0;
+    int codepoint = (length == 1)? bytes[0] : (length == 2)? (bytes[0] & 0x1F) : (length == 3)? (bytes[0] & 0x0F) : (bytes[0] & 0x07);
+
+    for (int i = 1; i < length; i++)
+    {
+        if ((bytes[i] & 0xC0) != 0x80) length = 0;
+        else codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+    }
+
+    *codepointSize = (length > 0)? length : 1;
+    return (length > 0)? codepoint : 0x3F;
+}
+
+// No TrueType parsing: every glyph is its hash dots scaled to 0.6 x 0.7 em, sitting on a
+// baseline 0.8 em down, so layouts and atlases get realistic sizes from any font file
+GlyphInfo *LoadFontData(const unsigned char *fileData, int dataSize, int fontSize, int *codepoints, int codepointCount, int type)
+{
+    if ((fileData == NULL) || (dataSize <= 0) || (fontSize <= 0) || (type != FONT_DEFAULT)) return NULL;
+    if (codepoints == NULL) codepointCount = FONT_GLYPHS;
+
+    GlyphInfo *glyphs = (GlyphInfo *)calloc((size_t)codepointCount, sizeof(GlyphInfo));
+    int width = (fontSize*3 + 4)/5, height = (fontSize*7 + 9)/10;
+
+    for (int i = 0; (glyphs != NULL) && (i < codepointCount); i++)
+    {
+        int codepoint = (codepoints != NULL)? codepoints[i] : FONT_FIRST_CHAR + i;
+        unsigned long long bits = GetGlyphDots(codepoint);
+
+        glyphs[i] = (GlyphInfo){ codepoint, 0, fontSize/10, width + fontSize/10, { 0 } };
+        if (bits == 0) continue;
+
+        unsigned char *pixels = (unsigned char *)calloc((size_t)width*height, 1);
+        for (int y = 0; (pixels != NULL) && (y < height); y++)
+        {
+            for (int x = 0; x < width; x++) pixels[y*width + x] = ((bits >> (x*5/width + (y*7/height)*5)) & 1)? 255 : 0;
+        }
+
+        if (pixels != NULL) glyphs[i].image = (Image){ pixels, width, height, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE };
+    }
+
+    return glyphs;
+}
+
+void UnloadFontData(GlyphInfo *glyphs, int glyphCount)
+{
+    for (int i = 0; (glyphs != NULL) && (i < glyphCount); i++) free(glyphs[i].image.data);
+    free(glyphs);
+}
+
+//----------------------------------------------------------------------------------
+// rlgl subset
+//----------------------------------------------------------------------------------
+rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
+{
+    rlRenderBatch batch = { 0 };
+    batch.bufferCount = numBuffers;
+    batch.vertexBuffer = (rlVertexBuffer *)calloc((size_t)numBuffers, sizeof(rlVertexBuffer));
+    for (int i = 0; (batch.vertexBuffer != NULL) && (i < numBuffers); i++) batch.vertexBuffer[i].elementCount = bufferElements;
+    return batch;
+}
+
+void rlUnloadRenderBatch(rlRenderBatch batch) { free(batch.vertexBuffer); }
+
+void rlDrawRenderBatch(rlRenderBatch *batch)
+{
+    (void)batch;
+    if (batching.vertexCount > 0) batching.drawCalls++;
+    batching.vertexCount = 0;
+}
+
+void rlSetRenderBatchActive(rlRenderBatch *batch)
+{
+    rlDrawRenderBatch(batching.active);
+    batching.active = batch;
+}
+
+void rlDrawRenderBatchActive(void) { rlDrawRenderBatch(batching.active); }
+void rlBegin(int mode) { raster.mode = mode; raster.vertexCount = 0; }
+void rlEnd(void) { raster.vertexCount = 0; }
+void rlTexCoord2f(float x, float y) { raster.texcoord = (Vector2){ x, y }; }
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a) { raster.color = (Color){ r, g, b, a }; }
+void rlSetTexture(unsigned int id) { raster.texture = id; }
+
+void rlVertex2f(float x, float y)
+{
+    batching.vertexCount++;
+    if (!raster.enabled || (raster.mode != RL_QUADS)) return;
+
+    raster.vertices[raster.vertexCount] = ViewPoint((Vector2){ x, y });
+    raster.texcoords[raster.vertexCount] = raster.texcoord;
+    raster.colors[raster.vertexCount] = raster.color;
+    if (++raster.vertexCount == 4)
+    {
+        RasterQuad();
+        raster.vertexCount = 0;
+    }
+}
+bool rlCheckRenderBatchLimit(int vCount) { (void)vCount; return false; }
+unsigned int rlGetTextureIdDefault(void) { return 1; }
+
+//----------------------------------------------------------------------------------
+// Textures
+//----------------------------------------------------------------------------------
+// Headless images carry dimensions only; no pixel data is decoded
+Image LoadImage(const char *fileName)
+{
+    Image image = { 0 };
+    size_t size = 0;
+    unsigned char *data = ReadFileHead(fileName, &size, 64*1024);
+
+    if (data != NULL)
+    {
+        if (ReadImageSize(data, size, &image.width, &image.height))
+        {
+            image.mipmaps = 1;
+            image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        }
+        else TraceLog(LOG_WARNING, "IMAGE: [%s] Data format not supported", fileName);
+
+        free(data);
+    }
+
+    return image;
+}
+
+Image LoadImageFromMemory(const char *fileType, const unsigned char *fileData, int dataSize)
+{
+    Image image = { 0 };
+
+    if (ReadImageSize(fileData, (size_t)dataSize, &image.width, &image.height))
+    {
+        image.mipmaps = 1;
+        image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    }
+    else TraceLog(LOG_WARNING, "IMAGE: Data format not supported (%s)", (fileType != NULL)? fileType : "?");
+
+    return image;
+}
+
+void UnloadImage(Image image) { free(image.data); }
+
+Image GenImageColor(int width, int height, Color color)
+{
+    Color *pixels = (Color *)malloc((size_t)width*height*sizeof(Color));
+    for (int i = 0; (pixels != NULL) && (i < width*height); i++) pixels[i] = color;
+
+    return (Image){ pixels, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+}
+
+Texture2D LoadTextureFromImage(Image image)
+{
+    Texture2D texture = { 0 };
+
+    if ((image.width > 0) && (image.height > 0))
+    {
+        texture.id = ++textureCounter;
+        texture.width = image.width;
+        texture.height = image.height;
+        texture.mipmaps = 1;
+        texture.format = image.format;
+        LoadRasterTexture(texture.id, texture.width, texture.height, image.data == NULL);
+        if (image.data != NULL) UpdateTextureRec(texture, (Rectangle){ 0, 0, (float)image.width, (float)image.height }, image.data);
+        TraceLog(LOG_INFO, "TEXTURE: [ID %i] Headless texture loaded (%i x %i)", texture.id, texture.width, texture.height);
+    }
+
+    return texture;
+}
+
+Texture2D LoadTexture(const char *fileName)
+{
+    Image image = LoadImage(fileName);
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+
+    return texture;
+}
+
+void UnloadTexture(Texture2D texture)
+{
+    if ((texture.id > 0) && (texture.id < MAX_RASTER_TEXTURES)) UnloadRasterSurface(&raster.textures[texture.id]);
+}
+
+// Generated images (GenImageColor(), glyph atlases) are the only ones with pixels headless
+void UpdateTextureRec(Texture2D texture, Rectangle rec, const void *pixels)
+{
+    RasterSurface *surface = GetRasterTexture(texture.id);
+    const Color *colors = (const Color *)pixels;
+    int width = (int)rec.width, height = (int)rec.height;
+
+    if ((surface == NULL) || (texture.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)) return;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++) RasterPixel(surface, (int)rec.x + x, (int)rec.y + y, colors[y*width + x]);
+    }
+}
+
+void SetTextureFilter(Texture2D texture, int filter) { (void)texture; (void)filter; }
+
+void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint)
+{
+    Rectangle dest = { position.x, position.y, fabsf(source.width), fabsf(source.height) };
+    DrawTexturePro(texture, source, dest, (Vector2){ 0 }, 0.0f, tint);
+}
+
+RenderTexture2D LoadRenderTexture(int width, int height)
+{
+    RenderTexture2D target = { 0 };
+
+    if ((width > 0) && (height > 0))
+    {
+        target.id = ++textureCounter;
+        target.texture = (Texture2D){ ++textureCounter, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        LoadRasterTexture(target.texture.id, width, height, false);
+        TraceLog(LOG_INFO, "FBO: [ID %i] Headless render texture loaded (%i x %i)", target.id, width, height);
+    }
+
+    return target;
+}
+
+void UnloadRenderTexture(RenderTexture2D target) { UnloadTexture(target.texture); }
+
+// Switching targets flushes the batch, as on a real framebuffer. Render textures are stored
+// bottom-up like GL's, so they are drawn through a flipped view
+void BeginTextureMode(RenderTexture2D target)
+{
+    RasterSurface *surface = GetRasterTexture(target.texture.id);
+
+    rlDrawRenderBatchActive();
+    raster.target = (surface != NULL)? GetRasterSurfaceFlipped(*surface) : (RasterSurface){ 0 };
+    raster.mode2D = false;
+}
+
+void EndTextureMode(void)
+{
+    rlDrawRenderBatchActive();
+    raster.target = raster.screen;
+    raster.mode2D = false;
+}
+
+//----------------------------------------------------------------------------------
+// Input
+//----------------------------------------------------------------------------------
+bool IsKeyPressed(int key) { return (key != KEY_NULL) && (key == input.pressedKey); }
+bool IsKeyDown(int key) { return (key != KEY_NULL) && ((key == input.heldKey) || (key == input.pressedKey)); }
+bool IsKeyReleased(int key) { return (key != KEY_NULL) && (key == input.releasedKey); }
+bool IsKeyUp(int key) { return !IsKeyDown(key); }
+int GetKeyPressed(void) { return input.pressedKey; }
+bool IsMouseButtonPressed(int button) { return (button == MOUSE_BUTTON_LEFT) && input.mousePressed; }
+Vector2 GetMousePosition(void) { return input.mousePosition; }
+
+//----------------------------------------------------------------------------------
+// Shapes and misc
+//----------------------------------------------------------------------------------
+bool CheckCollisionRecs(Rectangle rec1, Rectangle rec2)
+{
+    return (rec1.x < (rec2.x + rec2.width)) && ((rec1.x + rec1.width) > rec2.x) &&
+           (rec1.y < (rec2.y + rec2.height)) && ((rec1.y + rec1.height) > rec2.y);
+}
+
+bool CheckCollisionPointRec(Vector2 point, Rectangle rec)
+{
+    return (point.x >= rec.x) && (point.x < (rec.x + rec.width)) &&
+           (point.y >= rec.y) && (point.y < (rec.y + rec.height));
+}
+
+int GetRandomValue(int min, int max)
+{
+    if (min > max)
+    {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+
+    return (rand()%(abs(max - min) + 1) + min);
+}
+
+void SetRandomSeed(unsigned int seed) { srand(seed); }
+
+void SetTraceLogLevel(int logLevel) { traceLogLevel = logLevel; }
+
+bool FileExists(const char *fileName)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file != NULL) fclose(file);
+
+    return (file != NULL);
+}
+
+unsigned char *LoadFileData(const char *fileName, int *dataSize)
+{
+    FILE *file = fopen(fileName, "rb");
+    unsigned char *data = NULL;
+    long size = -1;
+
+    *dataSize = 0;
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to open file", fileName);
+        return NULL;
+    }
+
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if ((size > 0) && (fseek(file, 0, SEEK_SET) == 0) && ((data = (unsigned char *)malloc((size_t)size)) != NULL))
+    {
+        if (fread(data, 1, (size_t)size, file) == (size_t)size) *dataSize = (int)size;
+        else
+        {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+
+    return data;
+}
+
+void UnloadFileData(unsigned char *data) { free(data); }
+
+const char *GetFileExtension(const char *fileName)
+{
+    const char *dot = strrchr(fileName, '.');
+    return ((dot == NULL) || (dot == fileName))? NULL : dot;
+}
+
+void TraceLog(int logLevel, const char *text, ...)
+{
+    if (logLevel < traceLogLevel) return;
+
+    static const char *prefixes[] = { "", "TRACE: ", "DEBUG: ", "INFO: ", "WARNING: ", "ERROR: ", "FATAL: ", "" };
+
+    va_list args;
+    va_start(args, text);
+    fputs(prefixes[(logLevel >= LOG_ALL && logLevel <= LOG_NONE)? logLevel : LOG_INFO], stderr);
+    vfprintf(stderr, text, args);
+    fputc('\n', stderr);
+    va_end(args);
+
+    if (logLevel == LOG_FATAL) exit(EXIT_FAILURE);
+}
+
+//----------------------------------------------------------------------------------
+// Audio
+//----------------------------------------------------------------------------------
+void InitAudioDevice(void)
+{
+    audioReady = true;
+    TraceLog(LOG_INFO, "AUDIO: Headless audio device initialized (no output)");
+}
+
+void CloseAudioDevice(void)
+{
+    StopAudioDevice();
+    audioReady = false;
+}
+
+bool IsAudioDeviceReady(void) { return audioReady; }
+
+Wave LoadWaveFromMemory(const char *fileType, const unsigned char *fileData, int dataSize)
+{
+    Wave wave = { 0 };
+    const unsigned char *samples = NULL;
+    unsigned int sampleBytes = 0;
+
+    if (ParseWave(fileData, (size_t)dataSize, &wave, &samples, &sampleBytes) &&
+        (samples + sampleBytes <= fileData + dataSize))
+    {
+        wave.data = malloc(sampleBytes);
+        if (wave.data != NULL) memcpy(wave.data, samples, sampleBytes);
+    }
+    else
+    {
+        TraceLog(LOG_WARNING, "WAVE: Data format not supported (%s)", (fileType != NULL)? fileType : "?");
+        wave = (Wave){ 0 };
+    }
+
+    return wave;
+}
+
+Wave LoadWave(const char *fileName)
+{
+    Wave wave = { 0 };
+    FILE *file = fopen(fileName, "rb");
+
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to open file", fileName);
+        return wave;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char *data = (size > 0)? (unsigned char *)malloc((size_t)size) : NULL;
+    if ((data != NULL) && (fread(data, 1, (size_t)size, file) == (size_t)size)) wave = LoadWaveFromMemory(".wav", data, (int)size);
+
+    free(data);
+    fclose(file);
+    return wave;
+}
+
+void UnloadWave(Wave wave) { free(wave.data); }
+
+Sound LoadSoundFromWave(Wave wave)
+{
+    Sound sound = { 0 };
+
+    if (wave.data != NULL)
+    {
+        sound.frameCount = wave.frameCount;
+        sound.stream.sampleRate = wave.sampleRate;
+        sound.stream.sampleSize = wave.sampleSize;
+        sound.stream.channels = wave.channels;
+    }
+
+    return sound;
+}
+
+Sound LoadSound(const char *fileName)
+{
+    Wave wave = LoadWave(fileName);
+    Sound sound = LoadSoundFromWave(wave);
+    UnloadWave(wave);
+
+    return sound;
+}
+
+void UnloadSound(Sound sound) { (void)sound; }
+void PlaySound(Sound sound) { (void)sound; }
+void SetSoundVolume(Sound sound, float volume) { (void)sound; (void)volume; }
+
+Music LoadMusicStreamFromMemory(const char *fileType, const unsigned char *data, int dataSize)
+{
+    Music music = { 0 };
+    Wave wave = { 0 };
+
+    if (ParseWave(data, (size_t)dataSize, &wave, NULL, NULL))
+    {
+        music.frameCount = wave.frameCount;
+        music.looping = true;
+        music.stream.sampleRate = wave.sampleRate;
+        music.stream.sampleSize = wave.sampleSize;
+        music.stream.channels = wave.channels;
+    }
+    else TraceLog(LOG_WARNING, "STREAM: Data format not supported (%s)", (fileType != NULL)? fileType : "?");
+
+    return music;
+}
+
+Music LoadMusicStream(const char *fileName)
+{
+    Music music = { 0 };
+    size_t size = 0;
+    unsigned char *data = ReadFileHead(fileName, &size, 4096);
+
+    // Only the header is read: the stream would be decoded incrementally while playing
+    Wave wave = { 0 };
+    if (ParseWave(data, size, &wave, NULL, NULL))
+    {
+        music.frameCount = wave.frameCount;
+        music.looping = true;
+        music.stream.sampleRate = wave.sampleRate;
+        music.stream.sampleSize = wave.sampleSize;
+        music.stream.channels = wave.channels;
+    }
+    else TraceLog(LOG_WARNING, "STREAM: [%s] Failed to load music stream", fileName);
+
+    free(data);
+    return music;
+}
+
+void UnloadMusicStream(Music music) { (void)music; }
+void PlayMusicStream(Music music) { (void)music; }
+void StopMusicStream(Music music) { (void)music; }
+void UpdateMusicStream(Music music) { (void)music; }
+bool IsMusicStreamPlaying(Music music) { return music.frameCount > 0; }
+void SetMusicVolume(Music music, float volume) { (void)music; (void)volume; }
+
+AudioStream LoadAudioStream(unsigned int sampleRate, unsigned int sampleSize, unsigned int channels)
+{
+    AudioStream stream = { 0 };
+    if (audioDevice.loaded)
+    {
+        TraceLog(LOG_WARNING, "STREAM: Headless audio supports a single callback stream");
+        return stream;
+    }
+
+    // buffer only marks the stream as valid, nothing is allocated behind it
+    stream = (AudioStream){ &audioDevice, NULL, sampleRate, sampleSize, channels };
+    audioDevice.stream = stream;
+    audioDevice.callback = NULL;
+    audioDevice.loaded = true;
+
+    return stream;
+}
+
+bool IsAudioStreamReady(AudioStream stream) { return (stream.buffer != NULL) && audioDevice.loaded; }
+
+void UnloadAudioStream(AudioStream stream)
+{
+    if (stream.buffer == NULL) return;
+
+    StopAudioDevice();
+    audioDevice.loaded = false;
+    audioDevice.callback = NULL;
+}
+
+void PlayAudioStream(AudioStream stream)
+{
+    if ((stream.buffer == NULL) || !audioReady || audioDevice.running) return;
+
+    audioDevice.running = true;
+    if (pthread_create(&audioDevice.thread, NULL, AudioDeviceMain, NULL) != 0) audioDevice.running = false;
+}
+
+void StopAudioStream(AudioStream stream)
+{
+    if (stream.buffer != NULL) StopAudioDevice();
+}
+
+void SetAudioStreamCallback(AudioStream stream, AudioCallback callback)
+{
+    if (stream.buffer == NULL) return;
+
+    pthread_mutex_lock(&audioDevice.lock);
+    audioDevice.callback = callback;
+    pthread_mutex_unlock(&audioDevice.lock);
+}
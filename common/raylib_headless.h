@@ -0,0 +1,393 @@
+/*******************************************************************************************
+*
+*   Headless stand-in for the subset of raylib used by the games
+*
+*   Types, key codes and colors mirror raylib 5.x so game code compiles unchanged. Window,
+*   drawing and audio calls do no real work; the frame clock is virtual (1/targetFPS per
+*   EndDrawing, and per input poll slept through under EnableEventWaiting()) and input comes from a seeded pseudo-random "monkey" so every run with the
+*   same seed follows the same path through the game.
+*
+*   The one exception is an audio stream with a callback: a device thread pulls from it at
+*   the real sample rate and discards the output, so the mixer runs under the same timing
+*   as on a sound card.
+*
+*   Environment:
+*       GAMES_HEADLESS_FRAMES   frames to run before WindowShouldClose() fires (default 3600),
+*                               counting those slept through under EnableEventWaiting()
+*       GAMES_HEADLESS_SEED     seed for input and GetRandomValue() (default 1)
+*       GAMES_HEADLESS_RASTER   1: draw into a CPU framebuffer (raster.h) instead of discarding
+*                               draws, and print the golden frame's checksum
+*       GAMES_HEADLESS_GOLDEN_FRAME  that frame, counting from 1 (default: the last one drawn)
+*       GAMES_HEADLESS_PNG      with RASTER, also write the golden frame to this PNG file
+*       GAMES_HEADLESS_TRAINING 1: a PGO training run. QuitScenes() is ignored, so the monkey
+*                               picking EXIT in a menu cannot end it, and a run that still
+*                               closes before GAMES_HEADLESS_FRAMES fails (exit status 1)
+*
+*   Headless images carry no pixels, so with RASTER each texture is drawn as a checker of
+*   its own size and the default font as a fixed dot pattern per glyph: enough to see every
+*   quad's placement, source rectangle, flip and tint in a golden image.
+*
+********************************************************************************************/
+#ifndef RAYLIB_HEADLESS_H
+#define RAYLIB_HEADLESS_H
+
+#include <stdbool.h>
+#include <stdarg.h>
+
+//----------------------------------------------------------------------------------
+// Types (layout-compatible with raylib)
+//----------------------------------------------------------------------------------
+typedef struct Vector2 { float x; float y; } Vector2;
+typedef struct Rectangle { float x; float y; float width; float height; } Rectangle;
+typedef struct Color { unsigned char r; unsigned char g; unsigned char b; unsigned char a; } Color;
+
+typedef struct Image {
+    void *data;
+    int width;
+    int height;
+    int mipmaps;
+    int format;
+} Image;
+
+typedef struct Texture {
+    unsigned int id;
+    int width;
+    int height;
+    int mipmaps;
+    int format;
+} Texture;
+typedef Texture Texture2D;
+
+typedef struct RenderTexture {
+    unsigned int id;
+    Texture texture;
+    Texture depth;
+} RenderTexture;
+typedef RenderTexture RenderTexture2D;
+
+typedef struct Camera2D {
+    Vector2 offset;
+    Vector2 target;
+    float rotation;                 // Ignored: the games only zoom and shift
+    float zoom;
+} Camera2D;
+
+typedef struct GlyphInfo {
+    int value;
+    int offsetX;
+    int offsetY;
+    int advanceX;
+    Image image;
+} GlyphInfo;
+
+typedef struct Font {
+    int baseSize;
+    int glyphCount;
+    int glyphPadding;
+    Texture2D texture;
+    Rectangle *recs;
+    GlyphInfo *glyphs;
+} Font;
+
+typedef struct Wave {
+    unsigned int frameCount;
+    unsigned int sampleRate;
+    unsigned int sampleSize;
+    unsigned int channels;
+    void *data;
+} Wave;
+
+typedef struct AudioStream {
+    void *buffer;
+    void *processor;
+    unsigned int sampleRate;
+    unsigned int sampleSize;
+    unsigned int channels;
+} AudioStream;
+
+typedef struct Sound {
+    AudioStream stream;
+    unsigned int frameCount;
+} Sound;
+
+typedef void (*AudioCallback)(void *bufferData, unsigned int frames);
+
+typedef struct Music {
+    AudioStream stream;
+    unsigned int frameCount;
+    bool looping;
+    int ctxType;
+    void *ctxData;
+} Music;
+
+typedef enum {
+    LOG_ALL = 0,
+    LOG_TRACE,
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR,
+    LOG_FATAL,
+    LOG_NONE
+} TraceLogLevel;
+
+typedef enum {
+    PIXELFORMAT_UNCOMPRESSED_GRAYSCALE = 1,
+    PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA,
+    PIXELFORMAT_UNCOMPRESSED_R5G6B5,
+    PIXELFORMAT_UNCOMPRESSED_R8G8B8,
+    PIXELFORMAT_UNCOMPRESSED_R5G5B5A1,
+    PIXELFORMAT_UNCOMPRESSED_R4G4B4A4,
+    PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+} PixelFormat;
+
+typedef enum {
+    TEXTURE_FILTER_POINT = 0,
+    TEXTURE_FILTER_BILINEAR
+} TextureFilter;
+
+typedef enum {
+    FONT_DEFAULT = 0,
+    FONT_BITMAP,
+    FONT_SDF
+} FontType;
+
+typedef enum {
+    KEY_NULL = 0,
+    KEY_SPACE = 32,
+    KEY_A = 65, KEY_B = 66, KEY_C = 67, KEY_D = 68, KEY_E = 69, KEY_F = 70, KEY_G = 71,
+    KEY_H = 72, KEY_I = 73, KEY_J = 74, KEY_K = 75, KEY_L = 76, KEY_M = 77, KEY_N = 78,
+    KEY_O = 79, KEY_P = 80, KEY_Q = 81, KEY_R = 82, KEY_S = 83, KEY_T = 84, KEY_U = 85,
+    KEY_V = 86, KEY_W = 87, KEY_X = 88, KEY_Y = 89, KEY_Z = 90,
+    KEY_ESCAPE = 256,
+    KEY_ENTER = 257,
+    KEY_TAB = 258,
+    KEY_BACKSPACE = 259,
+    KEY_RIGHT = 262,
+    KEY_LEFT = 263,
+    KEY_DOWN = 264,
+    KEY_UP = 265
+} KeyboardKey;
+
+typedef enum {
+    MOUSE_BUTTON_LEFT = 0,
+    MOUSE_BUTTON_RIGHT = 1,
+    MOUSE_BUTTON_MIDDLE = 2
+} MouseButton;
+
+// rlgl batching, for code that builds its own vertex stream (particles)
+#define RL_LINES            0x0001
+#define RL_TRIANGLES        0x0004
+#define RL_QUADS            0x0007
+
+typedef struct rlVertexBuffer {
+    int elementCount;
+    float *vertices;
+    float *texcoords;
+    float *normals;
+    unsigned char *colors;
+    unsigned int *indices;
+    unsigned int vaoId;
+    unsigned int vboId[5];
+} rlVertexBuffer;
+
+typedef struct rlDrawCall {
+    int mode;
+    int vertexCount;
+    int vertexAlignment;
+    unsigned int textureId;
+} rlDrawCall;
+
+typedef struct rlRenderBatch {
+    int bufferCount;
+    int currentBuffer;
+    rlVertexBuffer *vertexBuffer;
+    rlDrawCall *draws;
+    int drawCounter;
+    float currentDepth;
+} rlRenderBatch;
+
+#define MOUSE_LEFT_BUTTON   MOUSE_BUTTON_LEFT
+#define MOUSE_RIGHT_BUTTON  MOUSE_BUTTON_RIGHT
+#define MOUSE_MIDDLE_BUTTON MOUSE_BUTTON_MIDDLE
+
+#define CLITERAL(type)      (type)
+
+#define PI                  3.14159265358979323846f
+#define DEG2RAD             (PI/180.0f)
+
+#define LIGHTGRAY  CLITERAL(Color){ 200, 200, 200, 255 }
+#define GRAY       CLITERAL(Color){ 130, 130, 130, 255 }
+#define DARKGRAY   CLITERAL(Color){ 80, 80, 80, 255 }
+#define YELLOW     CLITERAL(Color){ 253, 249, 0, 255 }
+#define GOLD       CLITERAL(Color){ 255, 203, 0, 255 }
+#define ORANGE     CLITERAL(Color){ 255, 161, 0, 255 }
+#define PINK       CLITERAL(Color){ 255, 109, 194, 255 }
+#define RED        CLITERAL(Color){ 230, 41, 55, 255 }
+#define MAROON     CLITERAL(Color){ 190, 33, 55, 255 }
+#define GREEN      CLITERAL(Color){ 0, 228, 48, 255 }
+#define LIME       CLITERAL(Color){ 0, 158, 47, 255 }
+#define DARKGREEN  CLITERAL(Color){ 0, 117, 44, 255 }
+#define SKYBLUE    CLITERAL(Color){ 102, 191, 255, 255 }
+#define BLUE       CLITERAL(Color){ 0, 121, 241, 255 }
+#define DARKBLUE   CLITERAL(Color){ 0, 82, 172, 255 }
+#define PURPLE     CLITERAL(Color){ 200, 122, 255, 255 }
+#define VIOLET     CLITERAL(Color){ 135, 60, 190, 255 }
+#define DARKPURPLE CLITERAL(Color){ 112, 31, 126, 255 }
+#define BEIGE      CLITERAL(Color){ 211, 176, 131, 255 }
+#define BROWN      CLITERAL(Color){ 127, 106, 79, 255 }
+#define DARKBROWN  CLITERAL(Color){ 76, 63, 47, 255 }
+#define WHITE      CLITERAL(Color){ 255, 255, 255, 255 }
+#define BLACK      CLITERAL(Color){ 0, 0, 0, 255 }
+#define BLANK      CLITERAL(Color){ 0, 0, 0, 0 }
+#define MAGENTA    CLITERAL(Color){ 255, 0, 255, 255 }
+#define RAYWHITE   CLITERAL(Color){ 245, 245, 245, 255 }
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Window and timing
+//----------------------------------------------------------------------------------
+void InitWindow(int width, int height, const char *title);
+void CloseWindow(void);
+bool WindowShouldClose(void);
+bool IsWindowReady(void);
+bool IsWindowFullscreen(void);
+void ToggleFullscreen(void);
+int GetScreenWidth(void);
+int GetScreenHeight(void);
+void SetTargetFPS(int fps);
+int GetFPS(void);
+float GetFrameTime(void);
+double GetTime(void);
+void EnableEventWaiting(void);              // EndDrawing() blocks until the next input event
+void DisableEventWaiting(void);
+
+//----------------------------------------------------------------------------------
+// Drawing
+//----------------------------------------------------------------------------------
+void BeginDrawing(void);
+void EndDrawing(void);
+void BeginMode2D(Camera2D camera);          // Until EndMode2D() or a change of render target
+void EndMode2D(void);
+void ClearBackground(Color color);
+void DrawLineV(Vector2 startPos, Vector2 endPos, Color color);
+void DrawRectangle(int posX, int posY, int width, int height, Color color);
+void DrawRectangleV(Vector2 position, Vector2 size, Color color);
+void DrawRectangleRec(Rectangle rec, Color color);
+void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint);
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+void DrawText(const char *text, int posX, int posY, int fontSize, Color color);
+void DrawTextEx(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint);
+int MeasureText(const char *text, int fontSize);
+Vector2 MeasureTextEx(Font font, const char *text, float fontSize, float spacing);
+const char *TextFormat(const char *text, ...);
+Font GetFontDefault(void);                  // 10 px cells, ASCII 32..126, 5 px wide (MeasureText's 0.6 em with spacing)
+int GetGlyphIndex(Font font, int codepoint);
+int GetCodepointNext(const char *text, int *codepointSize);
+GlyphInfo *LoadFontData(const unsigned char *fileData, int dataSize, int fontSize, int *codepoints, int codepointCount, int type);  // Hash-dot glyphs, 0.6 em wide
+void UnloadFontData(GlyphInfo *glyphs, int glyphCount);
+
+//----------------------------------------------------------------------------------
+// rlgl subset: vertices are counted, not drawn
+//----------------------------------------------------------------------------------
+rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements);
+void rlUnloadRenderBatch(rlRenderBatch batch);
+void rlDrawRenderBatch(rlRenderBatch *batch);
+void rlSetRenderBatchActive(rlRenderBatch *batch);     // NULL: back to the default batch
+void rlDrawRenderBatchActive(void);
+void rlBegin(int mode);
+void rlEnd(void);
+void rlVertex2f(float x, float y);
+void rlTexCoord2f(float x, float y);
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+void rlSetTexture(unsigned int id);
+bool rlCheckRenderBatchLimit(int vCount);
+unsigned int rlGetTextureIdDefault(void);
+
+//----------------------------------------------------------------------------------
+// Textures
+//----------------------------------------------------------------------------------
+Image LoadImage(const char *fileName);
+Image LoadImageFromMemory(const char *fileType, const unsigned char *fileData, int dataSize);
+void UnloadImage(Image image);
+Image GenImageColor(int width, int height, Color color);
+Texture2D LoadTexture(const char *fileName);
+Texture2D LoadTextureFromImage(Image image);
+void UnloadTexture(Texture2D texture);
+void UpdateTextureRec(Texture2D texture, Rectangle rec, const void *pixels);   // RGBA8 pixels
+void SetTextureFilter(Texture2D texture, int filter);   // Sampling stays nearest-neighbour
+void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint);
+RenderTexture2D LoadRenderTexture(int width, int height);
+void UnloadRenderTexture(RenderTexture2D target);
+void BeginTextureMode(RenderTexture2D target);
+void EndTextureMode(void);
+
+//----------------------------------------------------------------------------------
+// Input
+//----------------------------------------------------------------------------------
+bool IsKeyPressed(int key);
+bool IsKeyDown(int key);
+bool IsKeyReleased(int key);
+bool IsKeyUp(int key);
+int GetKeyPressed(void);
+bool IsMouseButtonPressed(int button);
+Vector2 GetMousePosition(void);
+
+//----------------------------------------------------------------------------------
+// Shapes and misc
+//----------------------------------------------------------------------------------
+bool CheckCollisionRecs(Rectangle rec1, Rectangle rec2);
+bool CheckCollisionPointRec(Vector2 point, Rectangle rec);
+int GetRandomValue(int min, int max);
+void SetRandomSeed(unsigned int seed);
+void TraceLog(int logLevel, const char *text, ...);
+void SetTraceLogLevel(int logLevel);
+bool FileExists(const char *fileName);
+unsigned char *LoadFileData(const char *fileName, int *dataSize);
+void UnloadFileData(unsigned char *data);
+const char *GetFileExtension(const char *fileName);
+
+//----------------------------------------------------------------------------------
+// Audio
+//----------------------------------------------------------------------------------
+void InitAudioDevice(void);
+void CloseAudioDevice(void);
+bool IsAudioDeviceReady(void);
+Wave LoadWave(const char *fileName);
+Wave LoadWaveFromMemory(const char *fileType, const unsigned char *fileData, int dataSize);
+void UnloadWave(Wave wave);
+Sound LoadSound(const char *fileName);
+Sound LoadSoundFromWave(Wave wave);
+void UnloadSound(Sound sound);
+void PlaySound(Sound sound);
+void SetSoundVolume(Sound sound, float volume);
+Music LoadMusicStream(const char *fileName);
+Music LoadMusicStreamFromMemory(const char *fileType, const unsigned char *data, int dataSize);
+void UnloadMusicStream(Music music);
+void PlayMusicStream(Music music);
+void StopMusicStream(Music music);
+void UpdateMusicStream(Music music);
+bool IsMusicStreamPlaying(Music music);
+void SetMusicVolume(Music music, float volume);
+AudioStream LoadAudioStream(unsigned int sampleRate, unsigned int sampleSize, unsigned int channels);
+bool IsAudioStreamReady(AudioStream stream);
+void UnloadAudioStream(AudioStream stream);
+void PlayAudioStream(AudioStream stream);
+void StopAudioStream(AudioStream stream);
+void SetAudioStreamCallback(AudioStream stream, AudioCallback callback);     // One callback stream at a time
+
+//----------------------------------------------------------------------------------
+// Headless-only controls
+//----------------------------------------------------------------------------------
+void SetHeadlessFrameLimit(int frames);     // Override GAMES_HEADLESS_FRAMES (0 = run until CloseWindow)
+int GetHeadlessFrameCount(void);            // Frames completed so far
+bool IsHeadlessTraining(void);              // GAMES_HEADLESS_TRAINING is set
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // RAYLIB_HEADLESS_H
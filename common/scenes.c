@@ -0,0 +1,293 @@
+/*******************************************************************************************
+*
+*   Scenes, see scenes.h
+*
+********************************************************************************************/
+#include "scenes.h"
+#include "pacing.h"
+#include "quality.h"
+#include "settings.h"
+
+#if defined(PLATFORM_WEB)
+    #include <emscripten/emscripten.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_FADE_STEP   (1.0f/30.0f)    // The first frame after an idle wait reports the whole wait
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum SceneChange {
+    CHANGE_NONE = 0,
+    CHANGE_SWITCH,
+    CHANGE_PUSH,
+    CHANGE_POP
+} SceneChange;
+
+typedef enum TransitionPhase {
+    PHASE_IDLE = 0,
+    PHASE_WAITING,                  // Target still loading, current scene shown (input frozen)
+    PHASE_FADE_OUT,                 // Input frozen
+    PHASE_FADE_IN                   // Target entered, already updating
+} TransitionPhase;
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static const Scene *stack[MAX_SCENE_STACK] = { 0 };
+static int stackCount = 0;
+static const Scene *preloaded[MAX_PRELOADED_SCENES] = { 0 };
+static int preloadedCount = 0;
+
+static SceneChange change = CHANGE_NONE;
+static const Scene *target = NULL;
+static TransitionPhase phase = PHASE_IDLE;
+static float fadeSeconds = 0.0f;    // Each way
+static float fadeTime = 0.0f;
+static uint64_t changeStart = 0;
+
+static bool quitRequested = false;
+static AssetHandle music = { 0 };
+
+static TelemetryMetric *updateTime = NULL;
+static TelemetryMetric *switchTime = NULL;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static void RequestChange(SceneChange type, const Scene *scene)
+{
+    if (change != CHANGE_NONE) return;
+    if ((type == CHANGE_POP) && (stackCount < 2)) return;
+    if ((type != CHANGE_POP) && (scene == NULL)) return;
+    if ((type == CHANGE_PUSH) && (stackCount == MAX_SCENE_STACK))
+    {
+        TraceLog(LOG_WARNING, "SCENES: [%s] Stack full, not pushed", scene->name);
+        return;
+    }
+
+    change = type;
+    target = (type == CHANGE_POP)? stack[stackCount - 2] : scene;
+    phase = PHASE_WAITING;
+    changeStart = GetTelemetryTicks();
+    PreloadScene(target);
+}
+
+static void ApplyChange(void)
+{
+    if ((change != CHANGE_PUSH) && (stackCount > 0))
+    {
+        const Scene *top = stack[--stackCount];
+        if (top->exit != NULL) top->exit();
+    }
+
+    if (change != CHANGE_POP)
+    {
+        stack[stackCount++] = target;
+        if (target->enter != NULL) target->enter();
+    }
+
+    RecordTelemetrySince(switchTime, changeStart);
+    if (target->next != NULL) PreloadScene(target->next);
+}
+
+static void UpdateTransition(void)
+{
+    float step = GetFrameTime();
+    if (step > MAX_FADE_STEP) step = MAX_FADE_STEP;
+
+    switch (phase)
+    {
+        case PHASE_WAITING:
+        {
+#if defined(PLATFORM_HEADLESS)
+            // Headless frames outrun the decoders: wait, so a replay never depends on their timing
+            if ((target->isReady != NULL) && !target->isReady()) WaitAssets();
+#endif
+            if ((target->isReady != NULL) && !target->isReady()) break;
+
+            // Nothing to fade out from before the first scene
+            fadeTime = 0.0f;
+            phase = PHASE_FADE_OUT;
+            if ((stackCount == 0) || (fadeSeconds <= 0.0f))
+            {
+                ApplyChange();
+                phase = PHASE_FADE_IN;
+            }
+        } break;
+        case PHASE_FADE_OUT:
+        {
+            fadeTime += step;
+            if (fadeTime >= fadeSeconds)
+            {
+                ApplyChange();
+                fadeTime = 0.0f;
+                phase = PHASE_FADE_IN;
+            }
+        } break;
+        case PHASE_FADE_IN:
+        {
+            fadeTime += step;
+            if (fadeTime >= fadeSeconds)
+            {
+                change = CHANGE_NONE;
+                target = NULL;
+                phase = PHASE_IDLE;
+            }
+        } break;
+        default: break;
+    }
+}
+
+static void UpdateSceneMusic(void)
+{
+    MixerSound track = GetAssetMusic(music);
+    if (GetGameSettings().musicOn && IsAssetReady(music) && !IsMixerMusicPlaying(track)) PlayMixerMusic(track);
+}
+
+// From the highest scene that is not an overlay up, at the governor's scale, then the fade
+// over all of them
+static void DrawScenes(void)
+{
+    int bottom = stackCount - 1;
+    while ((bottom > 0) && stack[bottom]->overlay) bottom--;
+
+    BeginQualityFrame();
+    if (stackCount == 0) ClearBackground(BLACK);
+    for (int i = bottom; i < stackCount; i++)
+    {
+        if (stack[i]->draw != NULL) stack[i]->draw();
+    }
+    EndQualityFrame();
+
+    if ((phase == PHASE_FADE_OUT) || (phase == PHASE_FADE_IN))
+    {
+        float progress = (fadeSeconds > 0.0f)? fadeTime/fadeSeconds : 1.0f;
+        if (progress > 1.0f) progress = 1.0f;
+        float alpha = (phase == PHASE_FADE_OUT)? progress : 1.0f - progress;
+        DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), (Color){ 0, 0, 0, (unsigned char)(255.0f*alpha) });
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void InitScenes(const Scene *first, float transitionSeconds)
+{
+    LoadGameSettings();
+    InitQuality();
+
+    updateTime = RegisterTelemetryHistogram("games_update_seconds", "Time spent updating the game each frame", 1e-9);
+    switchTime = RegisterTelemetryHistogram("games_scene_switch_seconds", "Time from a scene change request to the new scene's enter", 1e-9);
+
+    stackCount = 0;
+    preloadedCount = 0;
+    change = CHANGE_NONE;
+    phase = PHASE_IDLE;
+    fadeSeconds = (transitionSeconds > 0.0f)? transitionSeconds/2.0f : 0.0f;
+    quitRequested = false;
+
+    RequestChange(CHANGE_SWITCH, first);
+}
+
+void CloseScenes(void)
+{
+    while (stackCount > 0)
+    {
+        const Scene *top = stack[--stackCount];
+        if (top->exit != NULL) top->exit();
+    }
+
+    while (preloadedCount > 0)
+    {
+        const Scene *scene = preloaded[--preloadedCount];
+        if (scene->unload != NULL) scene->unload();
+    }
+
+    change = CHANGE_NONE;
+    target = NULL;
+    phase = PHASE_IDLE;
+    music = (AssetHandle){ 0 };
+    CloseQuality();
+}
+
+void SwitchScene(const Scene *scene) { RequestChange(CHANGE_SWITCH, scene); }
+void PushScene(const Scene *scene) { RequestChange(CHANGE_PUSH, scene); }
+void PopScene(void) { RequestChange(CHANGE_POP, NULL); }
+void QuitScenes(void)
+{
+#if defined(PLATFORM_HEADLESS)
+    // Training runs spend their whole frame budget in the game (raylib_headless.h)
+    if (IsHeadlessTraining()) return;
+#endif
+    quitRequested = true;
+}
+
+void PreloadScene(const Scene *scene)
+{
+    for (int i = 0; i < preloadedCount; i++)
+    {
+        if (preloaded[i] == scene) return;
+    }
+
+    if (preloadedCount == MAX_PRELOADED_SCENES)
+    {
+        TraceLog(LOG_WARNING, "SCENES: [%s] Too many scenes, not preloaded", scene->name);
+        return;
+    }
+
+    preloaded[preloadedCount++] = scene;
+    if (scene->preload != NULL) scene->preload();
+}
+
+const Scene *GetCurrentScene(void) { return (stackCount > 0)? stack[stackCount - 1] : NULL; }
+
+void SetSceneMusic(AssetHandle handle) { music = handle; }
+
+void UpdateSceneFrame(void)
+{
+    uint64_t frameStart = GetTelemetryTicks();
+
+    UpdateAssets();
+    UpdateSceneMusic();
+    UpdateTransition();
+
+    const Scene *top = GetCurrentScene();
+    if ((top != NULL) && (top->update != NULL) && ((phase == PHASE_IDLE) || (phase == PHASE_FADE_IN)))
+    {
+        uint64_t updateStart = GetTelemetryTicks();
+        top->update();
+        RecordTelemetrySince(updateTime, updateStart);
+    }
+
+    // Changes apply in UpdateTransition(), so top is still the scene that updated
+    bool animating = (top != NULL) && (top->isAnimating != NULL) && top->isAnimating();
+    if (animating || (phase != PHASE_IDLE)) KeepFramesActive(0.0f);
+    UpdateFramePacing();
+
+    // Scene changes upload assets: their frames say nothing about the load of either scene
+    bool steady = (phase == PHASE_IDLE);
+
+    BeginDrawing();
+        DrawScenes();
+        uint64_t workTicks = GetTelemetryTicks() - frameStart;
+    EndDrawing();
+
+    if (steady) RecordQualityFrame(workTicks);
+
+#if defined(PLATFORM_WEB)
+    if (quitRequested) emscripten_cancel_main_loop();
+#endif
+}
+
+void RunScenes(void)
+{
+#if defined(PLATFORM_WEB)
+    emscripten_set_main_loop(UpdateSceneFrame, 0, 1);
+#else
+    while (!WindowShouldClose() && !quitRequested) UpdateSceneFrame();
+#endif
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************************
+*
+*   Scenes: the frame loop every game shares, as a stack of screens with hooks
+*
+*   A Scene is a screen (menu, settings, play...) described by callbacks, all optional:
+*
+*       preload      request its assets (assets.h); called once, ahead of time
+*       isReady      true once they can be used (NULL: at once)
+*       enter/exit   when it becomes / stops being on the stack
+*       update/draw  every frame; only the top scene updates, and draw is between
+*                    BeginDrawing()/EndDrawing(), so it clears the screen itself
+*       isAnimating  true while it needs continuous frames (pacing.h); otherwise the loop
+*                    sleeps until the next input
+*       unload       release what preload requested, at CloseScenes()
+*
+*   Entering a scene preloads its next, the scene the player most likely goes to from it
+*   (the menu's next is the game), so its assets decode in the background while the menu is
+*   on screen. SwitchScene()/PushScene()/PopScene() never block: the current scene stays on
+*   screen until the target is ready, then fades out to black and the target fades in. Input
+*   is frozen from the request until the screen is black, so no key acts on both scenes.
+*   Requests made while a change is under way are ignored.
+*
+*   Switch replaces the top scene (exit, then the new one's enter), Push enters a scene above
+*   it, and Pop exits the top one, uncovering the one below as it was left. An overlay scene
+*   is drawn over the scenes below it instead of replacing them.
+*
+*   InitScenes() also loads the shared settings (settings.h), and the manager keeps the music
+*   set by SetSceneMusic() playing while they have it on. It registers games_update_seconds
+*   (update callbacks) and games_scene_switch_seconds (request to the target's enter). The
+*   scenes are drawn at the quality governor's scale (quality.h), which each frame reports to.
+*
+********************************************************************************************/
+#ifndef SCENES_H
+#define SCENES_H
+
+#include "platform.h"
+#include "assets.h"
+
+#define MAX_SCENE_STACK             8
+#define MAX_PRELOADED_SCENES       16
+#define SCENE_TRANSITION_SECONDS    0.3f    // Fade out and in, together
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Scene Scene;
+
+struct Scene {
+    const char *name;
+    void (*preload)(void);
+    bool (*isReady)(void);
+    void (*enter)(void);
+    void (*exit)(void);
+    void (*update)(void);
+    void (*draw)(void);
+    bool (*isAnimating)(void);
+    void (*unload)(void);
+    const Scene *next;              // Preloaded when this scene is entered
+    bool overlay;                   // Draw the scenes below first
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Call after InitWindow(), InitMixer() and InitTelemetry(); first fades in once it is ready
+void InitScenes(const Scene *first, float transitionSeconds);
+void CloseScenes(void);                     // Exit the stack, unload every preloaded scene
+
+void SwitchScene(const Scene *scene);
+void PushScene(const Scene *scene);
+void PopScene(void);
+void QuitScenes(void);                      // RunScenes() returns after this frame
+void PreloadScene(const Scene *scene);      // Start loading now; once per scene
+const Scene *GetCurrentScene(void);         // Top of the stack (NULL before the first enter)
+void SetSceneMusic(AssetHandle music);      // Looped while the settings have music on
+
+void UpdateSceneFrame(void);                // One frame: assets, update, pacing, draw
+void RunScenes(void);                       // Until the window closes or QuitScenes()
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SCENES_H
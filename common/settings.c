@@ -0,0 +1,139 @@
+/*******************************************************************************************
+*
+*   Settings, see settings.h
+*
+********************************************************************************************/
+#include "settings.h"
+#include "mixer.h"
+#include "pacing.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+    #include <io.h>
+    #define OpenSettingsFile(path)  _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE)
+    #define WriteSettingsFile       _write
+    #define CloseSettingsFile       _close
+#else
+    #include <unistd.h>
+    #define OpenSettingsFile(path)  open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)
+    #define WriteSettingsFile       write
+    #define CloseSettingsFile       close
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define SETTINGS_FILE_NAME      "raylib-games.cfg"
+#define MAX_SETTINGS_PATH       512
+#define VOLUME_STEP             0.01f       // Per frame while LEFT/RIGHT is held
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static GameSettings settings = { false, true, 0.5f };
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+// false: no settings file for this run
+static bool GetSettingsPath(char *path, size_t size)
+{
+    const char *override = getenv("GAMES_SETTINGS");
+    if ((override != NULL) && (override[0] != '\0')) return (snprintf(path, size, "%s", override) < (int)size);
+
+#if defined(PLATFORM_HEADLESS)
+    return false;
+#elif defined(_WIN32)
+    const char *appData = getenv("APPDATA");
+    return (appData != NULL) && (snprintf(path, size, "%s\\%s", appData, SETTINGS_FILE_NAME) < (int)size);
+#else
+    const char *config = getenv("XDG_CONFIG_HOME");
+    const char *home = getenv("HOME");
+    if ((config != NULL) && (config[0] != '\0')) return (snprintf(path, size, "%s/%s", config, SETTINGS_FILE_NAME) < (int)size);
+    return (home != NULL) && (snprintf(path, size, "%s/.config/%s", home, SETTINGS_FILE_NAME) < (int)size);
+#endif
+}
+
+static void ApplyGameSettings(void)
+{
+    if (IsWindowFullscreen() != settings.fullscreen) ToggleFullscreen();
+    if (!settings.musicOn) StopMixerMusic();
+    SetMixerMusicVolume(settings.musicVolume);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void LoadGameSettings(void)
+{
+    char path[MAX_SETTINGS_PATH];
+    FILE *file = GetSettingsPath(path, sizeof(path))? fopen(path, "r") : NULL;
+
+    if (file != NULL)
+    {
+        char line[128], key[32];
+        float value = 0.0f;
+
+        while (fgets(line, sizeof(line), file) != NULL)
+        {
+            if (sscanf(line, " %31[a-z_] = %f", key, &value) != 2) continue;
+
+            if (strcmp(key, "fullscreen") == 0) settings.fullscreen = (value != 0.0f);
+            else if (strcmp(key, "music") == 0) settings.musicOn = (value != 0.0f);
+            else if (strcmp(key, "music_volume") == 0) settings.musicVolume = (value < 0.0f)? 0.0f : (value > 1.0f)? 1.0f : value;
+        }
+
+        fclose(file);
+        TraceLog(LOG_INFO, "SETTINGS: [%s] Settings loaded", path);
+    }
+
+    ApplyGameSettings();
+}
+
+// Saved from the settings screen mid-game: formatted on the stack and written without stdio,
+// whose FILE and buffer would be the only heap allocations of a steady-state frame
+void SaveGameSettings(void)
+{
+    char path[MAX_SETTINGS_PATH];
+    if (!GetSettingsPath(path, sizeof(path))) return;
+
+    char text[128];
+    int length = snprintf(text, sizeof(text), "fullscreen = %i\nmusic = %i\nmusic_volume = %.2f\n", settings.fullscreen, settings.musicOn, settings.musicVolume);
+
+    int fd = OpenSettingsFile(path);
+    bool saved = (fd >= 0) && (WriteSettingsFile(fd, text, (unsigned int)length) == length);
+    if (fd >= 0) CloseSettingsFile(fd);
+    if (!saved) TraceLog(LOG_WARNING, "SETTINGS: [%s] Failed to save settings", path);
+}
+
+GameSettings GetGameSettings(void) { return settings; }
+
+void SetGameSettings(GameSettings newSettings)
+{
+    settings = newSettings;
+    ApplyGameSettings();
+}
+
+// Held volume keys change it every frame; the file is written once they are let go
+bool UpdateSettingsControls(void)
+{
+    GameSettings changed = settings;
+
+    if (IsKeyPressed(KEY_F)) changed.fullscreen = !changed.fullscreen;
+    if (IsKeyPressed(KEY_M)) changed.musicOn = !changed.musicOn;
+    if (IsKeyDown(KEY_RIGHT)) changed.musicVolume = (changed.musicVolume + VOLUME_STEP > 1.0f)? 1.0f : changed.musicVolume + VOLUME_STEP;
+    if (IsKeyDown(KEY_LEFT)) changed.musicVolume = (changed.musicVolume - VOLUME_STEP < 0.0f)? 0.0f : changed.musicVolume - VOLUME_STEP;
+    if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_LEFT)) KeepFramesActive(0.0f);
+
+    bool isChanged = (changed.fullscreen != settings.fullscreen) || (changed.musicOn != settings.musicOn) ||
+                     (changed.musicVolume != settings.musicVolume);
+    if (isChanged) SetGameSettings(changed);
+
+    if (IsKeyPressed(KEY_F) || IsKeyPressed(KEY_M) || IsKeyReleased(KEY_RIGHT) || IsKeyReleased(KEY_LEFT)) SaveGameSettings();
+    return isChanged;
+}
@@ -0,0 +1,44 @@
+/*******************************************************************************************
+*
+*   Settings: the player preferences every game shares (fullscreen, music on/off, volume)
+*
+*   One set of settings lives in one file for all the games, so the volume picked in space
+*   invaders is the volume snake starts with. LoadGameSettings() reads it at start-up and
+*   applies it (window mode, mixer music volume); UpdateSettingsControls() is the settings
+*   screen's input (F fullscreen, M music, LEFT/RIGHT volume), applying and saving changes.
+*
+*   The file is GAMES_SETTINGS if set, else raylib-games.cfg in the user's config directory
+*   (XDG_CONFIG_HOME or ~/.config, %APPDATA% on Windows), as "key = value" lines. Headless
+*   builds use only GAMES_SETTINGS, so runs never depend on the machine's saved settings.
+*   A missing or unreadable file leaves the defaults.
+*
+********************************************************************************************/
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include "platform.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct GameSettings {
+    bool fullscreen;
+    bool musicOn;
+    float musicVolume;              // 0.0f..1.0f
+} GameSettings;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void LoadGameSettings(void);                // Read and apply; call after InitWindow() and InitMixer()
+void SaveGameSettings(void);
+GameSettings GetGameSettings(void);
+void SetGameSettings(GameSettings settings);    // Applied now, saved on the next SaveGameSettings()
+bool UpdateSettingsControls(void);          // true: a key changed something this frame
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SETTINGS_H
@@ -0,0 +1,727 @@
+/*******************************************************************************************
+*
+*   Store, see store.h
+*
+********************************************************************************************/
+#include "store.h"
+#include "platform.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+    #include <direct.h>
+    #include <io.h>
+#else
+    #include <sys/file.h>
+    #include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define STORE_LOG_MAGIC         "GSWL"
+#define STORE_SNAPSHOT_MAGIC    "GSSN"
+#define STORE_VERSION           1
+#define STORE_DIRECTORY_NAME    "raylib-games"
+#define MAX_STORE_PATH          512
+
+#if defined(_WIN32)
+    #define OpenStoreFile(path, flags)  _open(path, (flags) | _O_BINARY, _S_IREAD | _S_IWRITE)
+    #define CloseStoreFile              _close
+    #define ReadStoreFile               _read
+    #define WriteStoreFile              _write
+    #define SeekStoreFile               _lseek
+    #define TruncateStoreFile           _chsize_s
+#else
+    #define OpenStoreFile(path, flags)  open(path, flags, 0644)
+    #define CloseStoreFile              close
+    #define ReadStoreFile               read
+    #define WriteStoreFile              write
+    #define SeekStoreFile               lseek
+    #define TruncateStoreFile           ftruncate
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum StoreRecordType {
+    RECORD_VALUE = 1,
+    RECORD_SCORE
+} StoreRecordType;
+
+typedef struct StoreRecord {
+    uint32_t crc;                   // CRC-32 of the bytes after it
+    uint8_t type;                   // StoreRecordType
+    uint8_t reserved[3];
+    uint64_t sequence;              // From 1, one up per record
+    int64_t value;                  // The value, or the score
+    uint64_t time;                  // Scores: milliseconds since the epoch
+    char name[STORE_MAX_NAME];      // Key or board, zero padded
+} StoreRecord;
+
+_Static_assert(sizeof(StoreRecord) == 64, "records are 64 bytes on disk");
+_Static_assert(sizeof(StoreFileHeader) == 24, "the file header is 24 bytes on disk");
+
+typedef struct StoreBoard {
+    char name[STORE_MAX_NAME];
+    int count;
+    StoreScore scores[STORE_BOARD_SIZE];    // Best first
+} StoreBoard;
+
+// What the records so far add up to: the game thread's copy answers queries, the writer's
+// copy is what it compacts into a snapshot
+typedef struct StoreState {
+    uint64_t sequence;              // Of the last record applied
+    int valueCount;
+    char keys[STORE_MAX_VALUES][STORE_MAX_NAME];
+    int64_t values[STORE_MAX_VALUES];
+    int boardCount;
+    StoreBoard boards[STORE_MAX_BOARDS];
+} StoreState;
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static StoreState live = { 0 };
+
+static struct {
+    bool open;
+    char logPath[MAX_STORE_PATH];
+    char snapshotPath[MAX_STORE_PATH];
+    char directory[MAX_STORE_PATH];
+
+    // Game thread writes head, the writer thread writes tail
+    StoreRecord ring[STORE_QUEUE];
+    atomic_uint head;
+    atomic_uint tail;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    atomic_bool closing;
+
+    // Writer thread only (and OpenStore() before it starts)
+    int logFile;
+    uint64_t logBytes;              // Header and whole records: where a failed write is cut back to
+    int logRecords;
+    StoreState durable;
+    StoreRecord batch[STORE_QUEUE];
+} store = { 0 };
+
+static TelemetryMetric *commitTime = NULL;
+static TelemetryMetric *recordCount = NULL;
+static TelemetryMetric *droppedCount = NULL;
+static TelemetryMetric *compactionCount = NULL;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions: records and tables
+//----------------------------------------------------------------------------------
+static uint32_t ComputeCrc(uint32_t crc, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+static uint32_t GetRecordCrc(const StoreRecord *record)
+{
+    return ComputeCrc(0, (const unsigned char *)record + sizeof(record->crc), sizeof(StoreRecord) - sizeof(record->crc));
+}
+
+static uint64_t GetStoreTime(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (uint64_t)now.tv_sec*1000u + (uint64_t)(now.tv_nsec/1000000);
+}
+
+static StoreRecord MakeRecord(StoreRecordType type, const char *name, int64_t value, uint64_t time)
+{
+    StoreRecord record = { 0 };
+
+    record.type = (uint8_t)type;
+    record.value = value;
+    record.time = time;
+    strncpy(record.name, name, STORE_MAX_NAME - 1);
+    return record;
+}
+
+static StoreBoard *FindBoard(StoreState *state, const char *name, bool add)
+{
+    for (int i = 0; i < state->boardCount; i++)
+    {
+        if (strncmp(state->boards[i].name, name, STORE_MAX_NAME - 1) == 0) return &state->boards[i];
+    }
+    if (!add || (state->boardCount == STORE_MAX_BOARDS)) return NULL;
+
+    StoreBoard *board = &state->boards[state->boardCount++];
+    snprintf(board->name, STORE_MAX_NAME, "%s", name);
+    board->count = 0;
+    return board;
+}
+
+// Scores above score (ties included when after is set): a binary search over the sorted board
+static int FindRank(const StoreBoard *board, int64_t score, bool after)
+{
+    int low = 0, high = board->count;
+
+    while (low < high)
+    {
+        int middle = (low + high)/2;
+        bool above = after? (board->scores[middle].score >= score) : (board->scores[middle].score > score);
+        if (above) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+// Returns the rank the record took for scores, 0 for values; -1 if it found no room
+static int ApplyRecord(StoreState *state, const StoreRecord *record)
+{
+    int result = -1;
+
+    if (record->type == RECORD_VALUE)
+    {
+        int i = 0;
+        while ((i < state->valueCount) && (strncmp(state->keys[i], record->name, STORE_MAX_NAME - 1) != 0)) i++;
+        if (i < STORE_MAX_VALUES)
+        {
+            if (i == state->valueCount)
+            {
+                snprintf(state->keys[i], STORE_MAX_NAME, "%s", record->name);
+                state->valueCount++;
+            }
+            state->values[i] = record->value;
+            result = 0;
+        }
+    }
+    else if (record->type == RECORD_SCORE)
+    {
+        StoreBoard *board = FindBoard(state, record->name, true);
+        int rank = (board != NULL)? FindRank(board, record->value, true) : STORE_BOARD_SIZE;
+        if (rank < STORE_BOARD_SIZE)
+        {
+            int moved = ((board->count < STORE_BOARD_SIZE)? board->count : STORE_BOARD_SIZE - 1) - rank;
+            memmove(&board->scores[rank + 1], &board->scores[rank], (size_t)moved*sizeof(StoreScore));
+            board->scores[rank] = (StoreScore){ record->value, record->time };
+            if (board->count < STORE_BOARD_SIZE) board->count++;
+            result = rank;
+        }
+    }
+
+    state->sequence = record->sequence;
+    return result;
+}
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions: files
+//----------------------------------------------------------------------------------
+// false: no store directory for this run
+static bool GetStoreDirectory(char *path, size_t size)
+{
+    const char *override = getenv("GAMES_STORE");
+    if ((override != NULL) && (override[0] != '\0')) return (snprintf(path, size, "%s", override) < (int)size);
+
+#if defined(PLATFORM_HEADLESS)
+    return false;
+#elif defined(_WIN32)
+    const char *appData = getenv("APPDATA");
+    return (appData != NULL) && (snprintf(path, size, "%s\\%s", appData, STORE_DIRECTORY_NAME) < (int)size);
+#else
+    const char *data = getenv("XDG_DATA_HOME");
+    const char *home = getenv("HOME");
+    if ((data != NULL) && (data[0] != '\0')) return (snprintf(path, size, "%s/%s", data, STORE_DIRECTORY_NAME) < (int)size);
+    return (home != NULL) && (snprintf(path, size, "%s/.local/share/%s", home, STORE_DIRECTORY_NAME) < (int)size);
+#endif
+}
+
+static bool SyncFile(int fd)
+{
+#if defined(_WIN32)
+    return (_commit(fd) == 0);
+#elif defined(__APPLE__)
+    return (fcntl(fd, F_FULLFSYNC) == 0) || (fsync(fd) == 0);
+#else
+    return (fdatasync(fd) == 0);
+#endif
+}
+
+// A rename is only durable once the directory entry is flushed too (NTFS journals it itself)
+static void SyncDirectory(const char *directory)
+{
+#if defined(_WIN32)
+    (void)directory;
+#else
+    int fd = open(directory, O_RDONLY);
+    if (fd < 0) return;
+
+    fsync(fd);
+    close(fd);
+#endif
+}
+
+static bool RenameOver(const char *from, const char *to)
+{
+#if defined(_WIN32)
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    return (rename(from, to) == 0);
+#endif
+}
+
+static bool WriteAll(int fd, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    while (size > 0)
+    {
+        int written = (int)WriteStoreFile(fd, bytes, (unsigned int)size);
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+static bool ReadAll(int fd, void *data, size_t size)
+{
+    unsigned char *bytes = (unsigned char *)data;
+
+    while (size > 0)
+    {
+        int count = (int)ReadStoreFile(fd, bytes, (unsigned int)size);
+        if ((count < 0) && (errno == EINTR)) continue;
+        if (count <= 0) return false;
+        bytes += count;
+        size -= (size_t)count;
+    }
+    return true;
+}
+
+static StoreFileHeader MakeHeader(const char *magic, uint32_t records, uint32_t crc, uint64_t sequence)
+{
+    StoreFileHeader header = { { 0 }, STORE_VERSION, records, crc, sequence };
+    memcpy(header.magic, magic, 4);
+    return header;
+}
+
+// A snapshot whose records do not match its CRC is ignored whole
+static bool LoadSnapshot(StoreState *state)
+{
+    int fd = OpenStoreFile(store.snapshotPath, O_RDONLY);
+    if (fd < 0) return false;
+
+    StoreFileHeader header;
+    bool ok = ReadAll(fd, &header, sizeof(header)) && (memcmp(header.magic, STORE_SNAPSHOT_MAGIC, 4) == 0) && (header.version == STORE_VERSION);
+    uint32_t crc = 0;
+
+    for (uint32_t i = 0; ok && (i < header.records); i++)
+    {
+        StoreRecord record;
+        ok = ReadAll(fd, &record, sizeof(record));
+        if (ok)
+        {
+            crc = ComputeCrc(crc, &record, sizeof(record));
+            ApplyRecord(state, &record);
+        }
+    }
+    CloseStoreFile(fd);
+
+    if (ok && (crc == header.crc))
+    {
+        state->sequence = header.sequence;
+        return true;
+    }
+
+    TraceLog(LOG_WARNING, "STORE: [%s] Snapshot damaged, ignored", store.snapshotPath);
+    *state = (StoreState){ 0 };
+    return false;
+}
+
+// Replays the records past the snapshot and cuts the log after the last good one
+static bool OpenLog(StoreState *state)
+{
+    int fd = OpenStoreFile(store.logPath, O_RDWR | O_CREAT);
+    if (fd < 0) return false;
+
+#if !defined(_WIN32)
+    // One process per store: a second copy of the game runs in memory only
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+    {
+        CloseStoreFile(fd);
+        return false;
+    }
+#endif
+
+    StoreFileHeader header;
+    uint64_t good = 0;
+    if (ReadAll(fd, &header, sizeof(header)) && (memcmp(header.magic, STORE_LOG_MAGIC, 4) == 0) && (header.version == STORE_VERSION))
+    {
+        uint64_t previous = 0;
+        good = sizeof(header);
+        for (StoreRecord record; ReadAll(fd, &record, sizeof(record)); good += sizeof(record))
+        {
+            if ((record.crc != GetRecordCrc(&record)) || (record.sequence <= previous)) break;
+            if (record.sequence > state->sequence) ApplyRecord(state, &record);
+            previous = record.sequence;
+            store.logRecords++;
+        }
+    }
+
+    bool ok = true;
+    if (good == 0)
+    {
+        header = MakeHeader(STORE_LOG_MAGIC, 0, 0, state->sequence);
+        ok = (TruncateStoreFile(fd, 0) == 0) && (SeekStoreFile(fd, 0, SEEK_SET) == 0) && WriteAll(fd, &header, sizeof(header));
+        good = sizeof(header);
+    }
+    else ok = (TruncateStoreFile(fd, (long)good) == 0);
+
+    ok = ok && (SeekStoreFile(fd, (long)good, SEEK_SET) == (long)good) && SyncFile(fd);
+    if (!ok)
+    {
+        CloseStoreFile(fd);
+        return false;
+    }
+
+    store.logFile = fd;
+    store.logBytes = good;
+    return true;
+}
+
+// Writer thread: one write and one flush for the whole batch
+static void CommitBatch(int count)
+{
+    uint64_t start = GetTelemetryTicks();
+    size_t size = (size_t)count*sizeof(StoreRecord);
+
+    if (WriteAll(store.logFile, store.batch, size) && SyncFile(store.logFile))
+    {
+        store.logBytes += size;
+        store.logRecords += count;
+    }
+    else
+    {
+        // Cut back any part of it that made it, so later records do not follow a torn one
+        TruncateStoreFile(store.logFile, (long)store.logBytes);
+        SeekStoreFile(store.logFile, (long)store.logBytes, SEEK_SET);
+        AddTelemetryCount(droppedCount, (uint64_t)count);
+    }
+
+    for (int i = 0; i < count; i++) ApplyRecord(&store.durable, &store.batch[i]);
+    RecordTelemetrySince(commitTime, start);
+    AddTelemetryCount(recordCount, (uint64_t)count);
+}
+
+// Numbers and checksums the first count records of the batch, then writes them
+static bool WriteSnapshotRecords(int fd, StoreFileHeader *header, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        store.batch[i].sequence = header->sequence;
+        store.batch[i].crc = GetRecordCrc(&store.batch[i]);
+        header->crc = ComputeCrc(header->crc, &store.batch[i], sizeof(StoreRecord));
+    }
+
+    header->records += (uint32_t)count;
+    return WriteAll(fd, store.batch, (size_t)count*sizeof(StoreRecord));
+}
+
+// Writer thread: the batch is free between commits, so the records go through it
+static bool WriteSnapshot(void)
+{
+    char temporary[MAX_STORE_PATH + 4];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", store.snapshotPath);
+
+    int fd = OpenStoreFile(temporary, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0) return false;
+
+    // Header last, once the CRC of the records is known
+    const StoreState *state = &store.durable;
+    StoreFileHeader header = MakeHeader(STORE_SNAPSHOT_MAGIC, 0, 0, state->sequence);
+    bool ok = WriteAll(fd, &header, sizeof(header));
+    int count = 0;
+
+    for (int i = 0; i < state->valueCount; i++)
+    {
+        store.batch[count++] = MakeRecord(RECORD_VALUE, state->keys[i], state->values[i], 0);
+        if (count == STORE_QUEUE)
+        {
+            ok = WriteSnapshotRecords(fd, &header, count) && ok;
+            count = 0;
+        }
+    }
+
+    for (int b = 0; b < state->boardCount; b++)
+    {
+        const StoreBoard *board = &state->boards[b];
+        for (int i = 0; i < board->count; i++)
+        {
+            store.batch[count++] = MakeRecord(RECORD_SCORE, board->name, board->scores[i].score, board->scores[i].time);
+            if (count == STORE_QUEUE)
+            {
+                ok = WriteSnapshotRecords(fd, &header, count) && ok;
+                count = 0;
+            }
+        }
+    }
+
+    ok = WriteSnapshotRecords(fd, &header, count) && ok;
+    ok = ok && (SeekStoreFile(fd, 0, SEEK_SET) == 0) && WriteAll(fd, &header, sizeof(header)) && SyncFile(fd);
+    ok = (CloseStoreFile(fd) == 0) && ok;
+
+    if (ok) ok = RenameOver(temporary, store.snapshotPath);
+    if (!ok)
+    {
+        remove(temporary);
+        return false;
+    }
+
+    SyncDirectory(store.directory);
+    return true;
+}
+
+// Writer thread: snapshot first, so at no point is a record in neither file
+static void CompactLog(void)
+{
+    if (!WriteSnapshot()) return;
+
+    StoreFileHeader header = MakeHeader(STORE_LOG_MAGIC, 0, 0, store.durable.sequence);
+    bool ok = (TruncateStoreFile(store.logFile, 0) == 0) && (SeekStoreFile(store.logFile, 0, SEEK_SET) == 0) &&
+              WriteAll(store.logFile, &header, sizeof(header)) && SyncFile(store.logFile);
+
+    // A log that failed to restart still only holds records the snapshot has: replay skips them
+    if (ok)
+    {
+        store.logBytes = sizeof(header);
+        store.logRecords = 0;
+    }
+    AddTelemetryCount(compactionCount, 1);
+}
+
+static void *WriterMain(void *argument)
+{
+    (void)argument;
+
+    for (;;)
+    {
+        bool closing = atomic_load(&store.closing);
+
+        unsigned int tail = atomic_load_explicit(&store.tail, memory_order_relaxed);
+        unsigned int head = atomic_load(&store.head);
+        int count = 0;
+        for (; tail != head; tail++) store.batch[count++] = store.ring[tail & (STORE_QUEUE - 1)];
+        atomic_store(&store.tail, tail);
+
+        if (count > 0) CommitBatch(count);
+        if ((store.logRecords >= STORE_COMPACT_RECORDS) || (closing && (store.logRecords > 0))) CompactLog();
+
+        // Whatever was queued before closing was set is in by now
+        if (closing) break;
+
+        // Nothing queued: sleep until QueueRecord() finds the ring empty and signals. head and
+        // tail are sequentially consistent, so either it sees the tail stored above or this
+        // sees its head
+        pthread_mutex_lock(&store.lock);
+        while (!atomic_load(&store.closing) && (atomic_load(&store.head) == tail)) pthread_cond_wait(&store.wake, &store.lock);
+
+        // A record is in: hold the group commit open for the ones that follow it, unless a burst
+        // has half filled the ring already
+        if (!atomic_load(&store.closing) && (atomic_load(&store.head) - tail < STORE_QUEUE/2))
+        {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += STORE_COMMIT_MS*1000000L;
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&store.wake, &store.lock, &deadline);
+        }
+        pthread_mutex_unlock(&store.lock);
+    }
+
+    return NULL;
+}
+
+// Game thread: the record is already applied to the live tables
+static void QueueRecord(StoreRecord *record)
+{
+    if (!store.open) return;
+
+    unsigned int head = atomic_load_explicit(&store.head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&store.tail, memory_order_acquire);
+    if (head - tail >= STORE_QUEUE)
+    {
+        AddTelemetryCount(droppedCount, 1);
+        return;
+    }
+
+    record->crc = GetRecordCrc(record);
+    store.ring[head & (STORE_QUEUE - 1)] = *record;
+    atomic_store(&store.head, head + 1);
+
+    // The first record since the writer drained the ring wakes it; only a burst fills half
+    // the ring within one commit window: hurry that up (without the lock, a missed signal
+    // just waits out the window)
+    if (atomic_load(&store.tail) == head)
+    {
+        pthread_mutex_lock(&store.lock);
+        pthread_cond_signal(&store.wake);
+        pthread_mutex_unlock(&store.lock);
+    }
+    else if (head - tail + 1 == STORE_QUEUE/2) pthread_cond_signal(&store.wake);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool OpenStore(const char *game)
+{
+    commitTime = RegisterTelemetryHistogram("games_store_commit_seconds", "Time to write and flush one batch of store records", 1e-9);
+    recordCount = RegisterTelemetryCounter("games_store_records_total", "Store records committed to the log");
+    droppedCount = RegisterTelemetryCounter("games_store_dropped_total", "Store records lost to a full queue or a failed write");
+    compactionCount = RegisterTelemetryCounter("games_store_compactions_total", "Store logs compacted into a snapshot");
+
+    live = (StoreState){ 0 };
+    store.open = false;
+    store.logFile = -1;
+    store.logRecords = 0;
+    store.durable = (StoreState){ 0 };
+
+    if (!GetStoreDirectory(store.directory, sizeof(store.directory))) return false;
+    if ((snprintf(store.logPath, sizeof(store.logPath), "%s/%s.wal", store.directory, game) >= (int)sizeof(store.logPath)) ||
+        (snprintf(store.snapshotPath, sizeof(store.snapshotPath), "%s/%s.snap", store.directory, game) >= (int)sizeof(store.snapshotPath))) return false;
+
+#if defined(_WIN32)
+    _mkdir(store.directory);
+#else
+    mkdir(store.directory, 0755);
+#endif
+
+    LoadSnapshot(&store.durable);
+    uint64_t snapshotSequence = store.durable.sequence;
+    if (!OpenLog(&store.durable))
+    {
+        TraceLog(LOG_WARNING, "STORE: [%s] Failed to open the log (or another process has it), nothing is kept this run", store.logPath);
+        store.durable = (StoreState){ 0 };
+        return false;
+    }
+
+    atomic_init(&store.head, 0);
+    atomic_init(&store.tail, 0);
+    atomic_init(&store.closing, false);
+    pthread_mutex_init(&store.lock, NULL);
+    pthread_cond_init(&store.wake, NULL);
+
+    if (pthread_create(&store.thread, NULL, WriterMain, NULL) != 0)
+    {
+        CloseStoreFile(store.logFile);
+        pthread_mutex_destroy(&store.lock);
+        pthread_cond_destroy(&store.wake);
+        store.durable = (StoreState){ 0 };
+        return false;
+    }
+
+    live = store.durable;
+    store.open = true;
+    TraceLog(LOG_INFO, "STORE: [%s] Loaded %i values, %i boards (snapshot to #%llu, %i log records)", store.logPath,
+             live.valueCount, live.boardCount, (unsigned long long)snapshotSequence, store.logRecords);
+    return true;
+}
+
+void CloseStore(void)
+{
+    if (!store.open) return;
+
+    pthread_mutex_lock(&store.lock);
+    atomic_store(&store.closing, true);
+    pthread_cond_signal(&store.wake);
+    pthread_mutex_unlock(&store.lock);
+
+    pthread_join(store.thread, NULL);
+    pthread_mutex_destroy(&store.lock);
+    pthread_cond_destroy(&store.wake);
+    CloseStoreFile(store.logFile);
+
+    store.logFile = -1;
+    store.open = false;
+}
+
+bool GetStoreValue(const char *key, int64_t *value)
+{
+    for (int i = 0; i < live.valueCount; i++)
+    {
+        if (strncmp(live.keys[i], key, STORE_MAX_NAME - 1) == 0)
+        {
+            *value = live.values[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void SetStoreValue(const char *key, int64_t value)
+{
+    int64_t current = 0;
+    if (GetStoreValue(key, &current) && (current == value)) return;
+
+    StoreRecord record = MakeRecord(RECORD_VALUE, key, value, 0);
+    record.sequence = live.sequence + 1;
+    if (ApplyRecord(&live, &record) < 0)
+    {
+        TraceLog(LOG_WARNING, "STORE: [%s] No room for another value", key);
+        return;
+    }
+    QueueRecord(&record);
+}
+
+int AddStoreScore(const char *board, int64_t score)
+{
+    StoreRecord record = MakeRecord(RECORD_SCORE, board, score, GetStoreTime());
+    record.sequence = live.sequence + 1;
+
+    // A score below the board changes nothing to replay
+    int rank = ApplyRecord(&live, &record);
+    if (rank >= 0) QueueRecord(&record);
+    return rank;
+}
+
+int GetStoreTopScores(const char *board, StoreScore *scores, int count)
+{
+    const StoreBoard *found = FindBoard(&live, board, false);
+    int available = (found != NULL)? found->count : 0;
+    if (count > available) count = available;
+
+    for (int i = 0; i < count; i++) scores[i] = found->scores[i];
+    return count;
+}
+
+int GetStoreScoreRank(const char *board, int64_t score)
+{
+    const StoreBoard *found = FindBoard(&live, board, false);
+    return (found != NULL)? FindRank(found, score, false) : 0;
+}
@@ -0,0 +1,89 @@
+/*******************************************************************************************
+*
+*   Store: a crash-safe profile (named values) and high-score tables kept between runs
+*
+*   Each game opens its own store, two files in the store directory:
+*
+*       <game>.wal      StoreFileHeader, then fixed 64-byte records: CRC-32, type, sequence
+*                       number, value, time, name (a value's key or a score's board)
+*       <game>.snap     StoreFileHeader with the record count and their CRC-32, then one
+*                       record per value and per score on a board: everything up to the
+*                       header's sequence number
+*
+*   Setting a value or adding a score changes the in-memory tables at once, for the game
+*   thread to read back, and queues the record in a single-producer single-consumer ring.
+*   A writer thread sleeps until a record arrives, waits STORE_COMMIT_MS more (less when
+*   the ring is half full) and commits all that is queued with one write and one fsync: a
+*   group commit, so a burst of changes costs one flush and the game thread never waits for
+*   the disk. A record is durable within STORE_COMMIT_MS plus the flush; when the ring is
+*   full it is dropped and counted instead of blocking the frame (games_store_dropped_total).
+*   A score too low for its board is not logged at all.
+*
+*   Once the log holds STORE_COMPACT_RECORDS, and at CloseStore(), the writer compacts it:
+*   the snapshot is written to <game>.snap.tmp, flushed and renamed over the old one, then
+*   the log is cut back to its header. On open the snapshot is loaded and the log replayed
+*   from the first record past its sequence number, up to the first record whose CRC fails:
+*   a write torn by a power cut loses at most the commit in flight, and the log is cut back
+*   there before new records follow. A crash between the rename and the cut only leaves
+*   records the snapshot already holds, which replay skips.
+*
+*   A board keeps its best STORE_BOARD_SIZE scores sorted, best first, so the top K are its
+*   first K entries and the rank of a score is a binary search: O(log n). Equal scores rank
+*   in the order they were set.
+*
+*   The directory is GAMES_STORE if set, else raylib-games in the user's data directory
+*   (XDG_DATA_HOME or ~/.local/share, %APPDATA% on Windows). Headless builds use only
+*   GAMES_STORE, so runs never depend on the machine's saved profile. Without a directory,
+*   or when another process holds the log, the store still works, in memory only, for the
+*   run. Game thread only, between OpenStore() and CloseStore().
+*
+********************************************************************************************/
+#ifndef STORE_H
+#define STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define STORE_MAX_NAME          32      // Keys and board names, terminator included
+#define STORE_MAX_VALUES        32
+#define STORE_MAX_BOARDS        4
+#define STORE_BOARD_SIZE        256     // Scores kept per board
+#define STORE_QUEUE             1024    // Records waiting for the writer; power of two
+#define STORE_COMMIT_MS         20
+#define STORE_COMPACT_RECORDS   4096
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct StoreFileHeader {
+    char magic[4];                  // "GSWL" log, "GSSN" snapshot
+    uint32_t version;
+    uint32_t records;               // Snapshot only
+    uint32_t crc;                   // Snapshot only: of its records
+    uint64_t sequence;              // Snapshot: the last record it holds; log: the snapshot it follows
+} StoreFileHeader;
+
+typedef struct StoreScore {
+    int64_t score;
+    uint64_t time;                  // Milliseconds since the epoch
+} StoreScore;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+bool OpenStore(const char *game);           // Loads and starts the writer; false: in memory only (call after InitTelemetry())
+void CloseStore(void);                      // Commits what is queued, compacts, stops the writer
+
+bool GetStoreValue(const char *key, int64_t *value);    // false: never set (value untouched)
+void SetStoreValue(const char *key, int64_t value);
+
+int AddStoreScore(const char *board, int64_t score);    // Rank it took (0: best), -1 if below the board
+int GetStoreTopScores(const char *board, StoreScore *scores, int count);    // Best first; how many there were
+int GetStoreScoreRank(const char *board, int64_t score);    // Scores above it
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // STORE_H
@@ -0,0 +1,555 @@
+/*******************************************************************************************
+*
+*   Telemetry, see telemetry.h
+*
+********************************************************************************************/
+#include "telemetry.h"
+#include "pacing.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+// HDR buckets: values below HDR_EXACT each get one, then HDR_HALF per power of two up to
+// 2^HDR_MAX_EXPONENT; anything larger lands in the last
+#define HDR_SUB_BITS        6
+#define HDR_EXACT           (1 << HDR_SUB_BITS)
+#define HDR_HALF            (HDR_EXACT/2)
+#define HDR_MAX_EXPONENT    40
+#define HDR_BUCKETS         (HDR_EXACT + (HDR_MAX_EXPONENT - HDR_SUB_BITS + 1)*HDR_HALF)
+
+#define METRIC_NAME_SIZE    64
+#define EXPORT_BUFFER_SIZE  (256*1024)
+#define REQUEST_SIZE        2048
+#define DEFAULT_INTERVAL    60
+
+#if defined(_WIN32)
+    #define NO_SOCKET               INVALID_SOCKET
+    #define CloseSocket             closesocket
+    #define PollSockets             WSAPoll
+    #define SEND_FLAGS              0
+#else
+    #define NO_SOCKET               -1
+    #define CloseSocket             close
+    #define PollSockets             poll
+    #define SEND_FLAGS              MSG_NOSIGNAL
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#if defined(_WIN32)
+typedef SOCKET ExportSocket;
+#else
+typedef int ExportSocket;
+#endif
+
+typedef enum TelemetryKind { METRIC_COUNTER = 0, METRIC_GAUGE, METRIC_HISTOGRAM } TelemetryKind;
+
+struct TelemetryMetric {
+    TelemetryKind kind;
+    char family[METRIC_NAME_SIZE];          // Name before the braces
+    char labels[METRIC_NAME_SIZE];          // Inside them, "" for none
+    const char *help;                       // Kept, not copied
+    double scale;                           // Histograms: exported unit per recorded integer
+
+    atomic_uint_fast64_t count;             // Counter total
+    atomic_int_fast64_t value;              // Gauge
+    atomic_uint_fast64_t *buckets;          // Histogram, HDR_BUCKETS
+};
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static TelemetryMetric metrics[MAX_TELEMETRY_METRICS];
+static atomic_int metricCount = 0;          // Published with release once a metric is filled in
+static atomic_uint_fast64_t histogramBuckets[MAX_TELEMETRY_HISTOGRAMS][HDR_BUCKETS];
+static int histogramCount = 0;
+static char gameName[METRIC_NAME_SIZE] = "unknown";
+
+static TelemetryMetric *frameTime = NULL;
+static uint64_t lastFrame = 0;
+static bool lastFrameContinuous = false;
+
+// Exporter thread
+static struct {
+    bool running;
+    pthread_t thread;
+    atomic_bool stop;
+    bool socketsStarted;                    // WSAStartup() done (Windows)
+    ExportSocket listenSocket;              // NO_SOCKET: no HTTP endpoint
+    ExportSocket wakeSocket;                // UDP, connected to itself: WSAPoll() takes no pipes
+    const char *snapshotFile;               // NULL: no snapshots
+    char snapshotTemp[1024];
+    int interval;                           // Seconds between snapshots
+    char buffer[EXPORT_BUFFER_SIZE];        // Exporter thread only (and CloseTelemetry() after the join)
+} exporter = { .listenSocket = NO_SOCKET, .wakeSocket = NO_SOCKET };
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static inline int GetHdrBucket(uint64_t value)
+{
+    if (value < HDR_EXACT) return (int)value;
+
+    int exponent = 63 - __builtin_clzll(value);
+    if (exponent > HDR_MAX_EXPONENT) return HDR_BUCKETS - 1;
+    int mantissa = (int)(value >> (exponent - HDR_SUB_BITS + 1));     // HDR_HALF .. HDR_EXACT - 1
+    return HDR_EXACT + (exponent - HDR_SUB_BITS)*HDR_HALF + (mantissa - HDR_HALF);
+}
+
+static uint64_t GetHdrBucketLow(int bucket)
+{
+    if (bucket < HDR_EXACT) return (uint64_t)bucket;
+
+    int exponent = HDR_SUB_BITS + (bucket - HDR_EXACT)/HDR_HALF;
+    uint64_t mantissa = HDR_HALF + (bucket - HDR_EXACT)%HDR_HALF;
+    return mantissa << (exponent - HDR_SUB_BITS + 1);
+}
+
+// Within 1/64 of anything recorded in the bucket
+static double GetHdrBucketMiddle(int bucket)
+{
+    uint64_t width = (bucket < HDR_EXACT)? 1 : 1ull << (1 + (bucket - HDR_EXACT)/HDR_HALF);
+    return (double)GetHdrBucketLow(bucket) + (double)(width - 1)/2.0;
+}
+
+static TelemetryMetric *RegisterMetric(TelemetryKind kind, const char *name, const char *help, double scale)
+{
+    int index = atomic_load_explicit(&metricCount, memory_order_relaxed);
+    if ((index >= MAX_TELEMETRY_METRICS) || ((kind == METRIC_HISTOGRAM) && (histogramCount >= MAX_TELEMETRY_HISTOGRAMS)))
+    {
+        fprintf(stderr, "TELEMETRY: No room for metric %s\n", name);
+        return NULL;
+    }
+
+    TelemetryMetric *metric = &metrics[index];
+    const char *brace = strchr(name, '{');
+    int familyLength = (brace != NULL)? (int)(brace - name) : (int)strlen(name);
+    snprintf(metric->family, sizeof(metric->family), "%.*s", familyLength, name);
+    if (brace != NULL) snprintf(metric->labels, sizeof(metric->labels), "%.*s", (int)strcspn(brace + 1, "}"), brace + 1);
+
+    metric->kind = kind;
+    metric->help = help;
+    metric->scale = scale;
+    if (kind == METRIC_HISTOGRAM) metric->buckets = histogramBuckets[histogramCount++];
+
+    atomic_store_explicit(&metricCount, index + 1, memory_order_release);
+    return metric;
+}
+
+static bool Append(char *buffer, int size, int *length, const char *format, ...)
+{
+    if (*length < 0) return false;
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer + *length, (size_t)(size - *length), format, args);
+    va_end(args);
+
+    if ((written < 0) || (written >= size - *length)) *length = -1;
+    else *length += written;
+    return *length >= 0;
+}
+
+// {game="...",labels[,extra]}
+static void AppendLabels(char *buffer, int size, int *length, const TelemetryMetric *metric, const char *extra)
+{
+    Append(buffer, size, length, "{game=\"%s\"%s%s%s%s}", gameName, (metric->labels[0] != '\0')? "," : "", metric->labels,
+           (extra != NULL)? "," : "", (extra != NULL)? extra : "");
+}
+
+static void AppendHistogram(char *buffer, int size, int *length, const TelemetryMetric *metric)
+{
+    uint64_t counts[HDR_BUCKETS];
+    uint64_t total = 0;
+    double sum = 0.0;
+    for (int i = 0; i < HDR_BUCKETS; i++)
+    {
+        total += counts[i] = atomic_load_explicit(&metric->buckets[i], memory_order_relaxed);
+        sum += (double)counts[i]*GetHdrBucketMiddle(i);
+    }
+
+    // Power-of-two bounds fall on bucket edges, so the cumulative counts are exact
+    uint64_t below = 0;
+    int bucket = 0;
+    for (int exponent = 0; exponent <= HDR_MAX_EXPONENT; exponent++)
+    {
+        uint64_t bound = 1ull << exponent;
+        for (; (bucket < HDR_BUCKETS) && (GetHdrBucketLow(bucket) < bound); bucket++) below += counts[bucket];
+
+        char le[48];
+        snprintf(le, sizeof(le), "le=\"%.6g\"", (double)bound*metric->scale);
+        Append(buffer, size, length, "%s_bucket", metric->family);
+        AppendLabels(buffer, size, length, metric, le);
+        Append(buffer, size, length, " %llu\n", (unsigned long long)below);
+    }
+    Append(buffer, size, length, "%s_bucket", metric->family);
+    AppendLabels(buffer, size, length, metric, "le=\"+Inf\"");
+    Append(buffer, size, length, " %llu\n", (unsigned long long)total);
+
+    Append(buffer, size, length, "%s_sum", metric->family);
+    AppendLabels(buffer, size, length, metric, NULL);
+    Append(buffer, size, length, " %.9g\n", sum*metric->scale);
+    Append(buffer, size, length, "%s_count", metric->family);
+    AppendLabels(buffer, size, length, metric, NULL);
+    Append(buffer, size, length, " %llu\n", (unsigned long long)total);
+}
+
+// Middle of the bucket holding the quantile, from the full-resolution buckets
+static void AppendQuantiles(char *buffer, int size, int *length, const TelemetryMetric *metric)
+{
+    static const char *names[] = { "0.5", "0.9", "0.99", "0.999" };
+    static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+    uint64_t total = 0;
+    for (int i = 0; i < HDR_BUCKETS; i++) total += atomic_load_explicit(&metric->buckets[i], memory_order_relaxed);
+
+    for (int q = 0; q < 4; q++)
+    {
+        uint64_t rank = (uint64_t)(quantiles[q]*(double)total + 0.999999);
+        uint64_t seen = 0;
+        double value = 0.0;
+        for (int i = 0; (i < HDR_BUCKETS) && (total > 0); i++)
+        {
+            seen += atomic_load_explicit(&metric->buckets[i], memory_order_relaxed);
+            if (seen >= rank)
+            {
+                value = GetHdrBucketMiddle(i)*metric->scale;
+                break;
+            }
+        }
+
+        char label[32];
+        snprintf(label, sizeof(label), "quantile=\"%s\"", names[q]);
+        Append(buffer, size, length, "%s_quantile", metric->family);
+        AppendLabels(buffer, size, length, metric, label);
+        Append(buffer, size, length, " %.6g\n", value);
+    }
+}
+
+static void WriteSnapshot(void)
+{
+    int length = FormatTelemetry(exporter.buffer, EXPORT_BUFFER_SIZE);
+    if (length < 0) return;
+
+    FILE *file = fopen(exporter.snapshotTemp, "wb");
+    if (file == NULL) return;
+    bool written = (fwrite(exporter.buffer, 1, (size_t)length, file) == (size_t)length);
+    if (fclose(file) != 0) written = false;
+
+    if (written) rename(exporter.snapshotTemp, exporter.snapshotFile);
+    else remove(exporter.snapshotTemp);
+}
+
+static void SendAll(ExportSocket socket, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        int sent = (int)send(socket, data, (int)size, SEND_FLAGS);
+        if (sent <= 0) return;
+        data += sent;
+        size -= (size_t)sent;
+    }
+}
+
+// One request per connection, HTTP/1.0 style: read the request line, answer, close
+static void ServeRequest(void)
+{
+    ExportSocket client = accept(exporter.listenSocket, NULL, NULL);
+    if (client == NO_SOCKET) return;
+
+    // A client that never finishes its request is dropped
+#if defined(_WIN32)
+    DWORD timeout = 1000;
+#else
+    struct timeval timeout = { 1, 0 };
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+
+    char request[REQUEST_SIZE];
+    int received = 0;
+    while (received < REQUEST_SIZE - 1)
+    {
+        int count = (int)recv(client, request + received, REQUEST_SIZE - 1 - received, 0);
+        if (count <= 0) break;
+        received += count;
+        request[received] = '\0';
+        if (strstr(request, "\r\n\r\n") != NULL) break;
+    }
+    request[received] = '\0';
+
+    char header[256];
+    int length = -1;
+    bool found = (strncmp(request, "GET /metrics ", 13) == 0) || (strncmp(request, "GET / ", 6) == 0);
+    if (found) length = FormatTelemetry(exporter.buffer, EXPORT_BUFFER_SIZE);
+
+    if (length >= 0)
+    {
+        int size = snprintf(header, sizeof(header), "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                                                    "Content-Length: %d\r\nConnection: close\r\n\r\n", length);
+        SendAll(client, header, (size_t)size);
+        SendAll(client, exporter.buffer, (size_t)length);
+    }
+    else
+    {
+        const char *status = found? "500 Internal Server Error" : "404 Not Found";
+        int size = snprintf(header, sizeof(header), "HTTP/1.0 %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", status);
+        SendAll(client, header, (size_t)size);
+    }
+
+    CloseSocket(client);
+}
+
+static void *ExporterThread(void *arg)
+{
+    uint64_t nextSnapshot = GetTelemetryTicks() + (uint64_t)exporter.interval*1000000000ull;
+
+    while (!atomic_load(&exporter.stop))
+    {
+        int timeout = -1;
+        if (exporter.snapshotFile != NULL)
+        {
+            uint64_t now = GetTelemetryTicks();
+            timeout = (now >= nextSnapshot)? 0 : (int)((nextSnapshot - now)/1000000 + 1);
+        }
+
+        // The wake socket first, so an exporter with no endpoint polls it alone
+        struct pollfd fds[2] = { { exporter.wakeSocket, POLLIN, 0 }, { exporter.listenSocket, POLLIN, 0 } };
+        int count = (exporter.listenSocket != NO_SOCKET)? 2 : 1;
+        if ((PollSockets(fds, count, timeout) < 0) && (errno != EINTR)) break;
+
+        if ((count > 1) && (fds[1].revents & POLLIN)) ServeRequest();
+        if ((exporter.snapshotFile != NULL) && (GetTelemetryTicks() >= nextSnapshot))
+        {
+            WriteSnapshot();
+            nextSnapshot = GetTelemetryTicks() + (uint64_t)exporter.interval*1000000000ull;
+        }
+    }
+
+    return NULL;
+}
+
+static ExportSocket OpenListenSocket(int port)
+{
+    ExportSocket listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener == NO_SOCKET) return NO_SOCKET;
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char *)&reuse, sizeof(reuse));
+
+    struct sockaddr_in address = { 0 };
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);       // Local only: scraped by an agent on the kiosk
+
+    if ((bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0) || (listen(listener, 8) != 0))
+    {
+        fprintf(stderr, "TELEMETRY: Could not listen on 127.0.0.1:%d (%s)\n", port, strerror(errno));
+        CloseSocket(listener);
+        return NO_SOCKET;
+    }
+
+    return listener;
+}
+
+// A datagram socket on the loopback sending to itself: CloseTelemetry() wakes the poll with
+// one byte, the same on every platform
+static ExportSocket OpenWakeSocket(void)
+{
+    ExportSocket wake = socket(AF_INET, SOCK_DGRAM, 0);
+    if (wake == NO_SOCKET) return NO_SOCKET;
+
+    struct sockaddr_in address = { 0 };
+    socklen_t length = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if ((bind(wake, (struct sockaddr *)&address, sizeof(address)) != 0) ||
+        (getsockname(wake, (struct sockaddr *)&address, &length) != 0) ||
+        (connect(wake, (struct sockaddr *)&address, sizeof(address)) != 0))
+    {
+        CloseSocket(wake);
+        return NO_SOCKET;
+    }
+
+    return wake;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void InitTelemetry(const char *game)
+{
+    snprintf(gameName, sizeof(gameName), "%s", game);
+
+    TelemetryMetric *started = RegisterTelemetryGauge("process_start_time_seconds", "Unix time the game started");
+    SetTelemetryGauge(started, (int64_t)time(NULL));
+    frameTime = RegisterTelemetryHistogram("games_frame_seconds", "Time from one frame to the next while animating", 1e-9);
+
+    const char *port = getenv("GAMES_METRICS_PORT");
+    const char *file = getenv("GAMES_METRICS_FILE");
+    const char *interval = getenv("GAMES_METRICS_INTERVAL");
+
+    bool serve = (port != NULL) && (atoi(port) > 0);
+    bool snapshot = (file != NULL) && (file[0] != '\0');
+    if (!serve && !snapshot) return;
+
+#if defined(_WIN32)
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+    {
+        fprintf(stderr, "TELEMETRY: Could not start Winsock\n");
+        return;
+    }
+    exporter.socketsStarted = true;
+#endif
+
+    if (serve) exporter.listenSocket = OpenListenSocket(atoi(port));
+    if (snapshot)
+    {
+        exporter.snapshotFile = file;
+        snprintf(exporter.snapshotTemp, sizeof(exporter.snapshotTemp), "%s.tmp", file);
+    }
+    exporter.interval = ((interval != NULL) && (atoi(interval) > 0))? atoi(interval) : DEFAULT_INTERVAL;
+
+    if ((exporter.listenSocket == NO_SOCKET) && (exporter.snapshotFile == NULL)) return;
+
+    atomic_store(&exporter.stop, false);
+    exporter.wakeSocket = OpenWakeSocket();
+    if ((exporter.wakeSocket == NO_SOCKET) || (pthread_create(&exporter.thread, NULL, ExporterThread, NULL) != 0))
+    {
+        fprintf(stderr, "TELEMETRY: Could not start the exporter\n");
+        return;
+    }
+    exporter.running = true;
+}
+
+void CloseTelemetry(void)
+{
+    if (exporter.running)
+    {
+        atomic_store(&exporter.stop, true);
+        send(exporter.wakeSocket, "", 1, 0);
+        pthread_join(exporter.thread, NULL);
+        exporter.running = false;
+    }
+
+    if (exporter.snapshotFile != NULL) WriteSnapshot();
+
+    if (exporter.listenSocket != NO_SOCKET) CloseSocket(exporter.listenSocket);
+    if (exporter.wakeSocket != NO_SOCKET) CloseSocket(exporter.wakeSocket);
+    exporter.listenSocket = exporter.wakeSocket = NO_SOCKET;
+    exporter.snapshotFile = NULL;
+
+#if defined(_WIN32)
+    if (exporter.socketsStarted) WSACleanup();
+    exporter.socketsStarted = false;
+#endif
+}
+
+TelemetryMetric *RegisterTelemetryCounter(const char *name, const char *help) { return RegisterMetric(METRIC_COUNTER, name, help, 1.0); }
+TelemetryMetric *RegisterTelemetryGauge(const char *name, const char *help) { return RegisterMetric(METRIC_GAUGE, name, help, 1.0); }
+TelemetryMetric *RegisterTelemetryHistogram(const char *name, const char *help, double scale) { return RegisterMetric(METRIC_HISTOGRAM, name, help, scale); }
+
+void AddTelemetryCount(TelemetryMetric *counter, uint64_t amount)
+{
+    if (counter != NULL) atomic_fetch_add_explicit(&counter->count, amount, memory_order_relaxed);
+}
+
+void SetTelemetryGauge(TelemetryMetric *gauge, int64_t value)
+{
+    if (gauge != NULL) atomic_store_explicit(&gauge->value, value, memory_order_relaxed);
+}
+
+void RecordTelemetryValue(TelemetryMetric *histogram, uint64_t value)
+{
+    if (histogram == NULL) return;
+
+    // One atomic add: the sum is rebuilt from the buckets rather than kept alongside
+    atomic_fetch_add_explicit(&histogram->buckets[GetHdrBucket(value)], 1, memory_order_relaxed);
+}
+
+uint64_t GetTelemetryTicks(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec*1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+void RecordTelemetrySince(TelemetryMetric *histogram, uint64_t ticks)
+{
+    RecordTelemetryValue(histogram, GetTelemetryTicks() - ticks);
+}
+
+// Frames that slept waiting for input or a timer would only measure the wait: skipped
+void EndTelemetryFrame(void)
+{
+    uint64_t now = GetTelemetryTicks();
+    if ((lastFrame != 0) && lastFrameContinuous) RecordTelemetryValue(frameTime, now - lastFrame);
+
+    lastFrame = now;
+    lastFrameContinuous = (GetFramePacingMode() == FRAMES_CONTINUOUS);
+}
+
+int FormatTelemetry(char *buffer, int size)
+{
+    int count = atomic_load_explicit(&metricCount, memory_order_acquire);
+    int length = 0;
+    static const char *types[] = { "counter", "gauge", "histogram" };
+
+    for (int i = 0; i < count; i++)
+    {
+        const TelemetryMetric *metric = &metrics[i];
+        if ((i == 0) || (strcmp(metric->family, metrics[i - 1].family) != 0))
+        {
+            Append(buffer, size, &length, "# HELP %s %s\n# TYPE %s %s\n", metric->family, metric->help, metric->family, types[metric->kind]);
+        }
+
+        if (metric->kind == METRIC_HISTOGRAM) AppendHistogram(buffer, size, &length, metric);
+        else
+        {
+            Append(buffer, size, &length, "%s", metric->family);
+            AppendLabels(buffer, size, &length, metric, NULL);
+            if (metric->kind == METRIC_COUNTER) Append(buffer, size, &length, " %llu\n", (unsigned long long)atomic_load_explicit(&metric->count, memory_order_relaxed));
+            else Append(buffer, size, &length, " %lld\n", (long long)atomic_load_explicit(&metric->value, memory_order_relaxed));
+        }
+    }
+
+    // Quantile gauges after everything, so no family is split by another
+    for (int i = 0; i < count; i++)
+    {
+        const TelemetryMetric *metric = &metrics[i];
+        if (metric->kind != METRIC_HISTOGRAM) continue;
+        if ((i == 0) || (strcmp(metric->family, metrics[i - 1].family) != 0))
+        {
+            Append(buffer, size, &length, "# HELP %s_quantile %s, percentiles\n# TYPE %s_quantile gauge\n", metric->family, metric->help, metric->family);
+        }
+        AppendQuantiles(buffer, size, &length, metric);
+    }
+
+    return length;
+}
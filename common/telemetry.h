@@ -0,0 +1,70 @@
+/*******************************************************************************************
+*
+*   Telemetry: lock-free counters, gauges and HDR histograms, exported as Prometheus text
+*
+*   Metrics are registered once at start-up (RegisterTelemetry*(), main thread) and recorded
+*   from any thread with one relaxed atomic and no locks or allocation: a counter add, a
+*   gauge store or a histogram record, each around 10 ns. Histograms are HDR-style log-linear
+*   buckets over unsigned integers (nanoseconds, chips...), exact below 64 and within 1/32
+*   of the value above it, up to 2^40; the scale given at registration converts the integers
+*   to the exported unit (1e-9 for nanoseconds to seconds). The exported _sum is rebuilt
+*   from the buckets, to the same precision.
+*
+*   A metric name may carry a label set, "blackjack_hands_total{outcome=\"win\"}": metrics
+*   registered one after the other with the same name before the braces share a family.
+*   Every sample is also labelled game="..." from InitTelemetry().
+*
+*   InitTelemetry() registers games_frame_seconds, recorded by EndDrawing() through
+*   EndTelemetryFrame(), and reads its exporter settings from the environment:
+*
+*     GAMES_METRICS_PORT=<port>      serve GET /metrics on 127.0.0.1:<port>
+*     GAMES_METRICS_FILE=<path>      write a snapshot to <path> (through <path>.tmp and a
+*                                    rename, so readers never see half a file) every
+*     GAMES_METRICS_INTERVAL=<s>     <s> seconds (default 60) and on CloseTelemetry()
+*
+*   Snapshots use the same text format, which node_exporter's textfile collector reads as is.
+*   Both run on one exporter thread, started only when either is set. Histograms export
+*   power-of-two buckets (le counts values below the bound) plus <name>_quantile gauges for
+*   the 50th to 99.9th percentiles read from the full-resolution buckets.
+*
+********************************************************************************************/
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_TELEMETRY_METRICS       64
+#define MAX_TELEMETRY_HISTOGRAMS    16
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct TelemetryMetric TelemetryMetric;     // NULL handles record nothing
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void InitTelemetry(const char *game);
+void CloseTelemetry(void);                      // Stops the exporter after a last snapshot
+
+TelemetryMetric *RegisterTelemetryCounter(const char *name, const char *help);
+TelemetryMetric *RegisterTelemetryGauge(const char *name, const char *help);
+TelemetryMetric *RegisterTelemetryHistogram(const char *name, const char *help, double scale);
+
+void AddTelemetryCount(TelemetryMetric *counter, uint64_t amount);
+void SetTelemetryGauge(TelemetryMetric *gauge, int64_t value);
+void RecordTelemetryValue(TelemetryMetric *histogram, uint64_t value);
+
+uint64_t GetTelemetryTicks(void);                                       // Monotonic nanoseconds
+void RecordTelemetrySince(TelemetryMetric *histogram, uint64_t ticks);  // Nanoseconds since ticks
+void EndTelemetryFrame(void);                                           // Called by EndDrawing()
+
+int FormatTelemetry(char *buffer, int size);    // Prometheus text; length, or -1 if it does not fit
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // TELEMETRY_H
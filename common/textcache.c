@@ -0,0 +1,226 @@
+/*******************************************************************************************
+*
+*   Text cache, see textcache.h
+*
+********************************************************************************************/
+#include "textcache.h"
+
+#if !defined(PLATFORM_HEADLESS)
+    #include "rlgl.h"
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define TEXT_CACHE_ENTRIES      512         // Power of two, kept at most 3/4 full
+#define TEXT_CACHE_QUADS      16384
+#define DEFAULT_FONT_SIZE        10         // raylib's DrawText() scales its spacing by this
+#define TEXT_LINE_SPACING         2         // raylib's default extra gap between lines
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct TextQuad {
+    Rectangle source;               // In atlas pixels
+    Rectangle dest;                 // Relative to the text origin
+} TextQuad;
+
+typedef struct TextEntry {
+    TextLayout layout;
+    uint32_t hash;
+    unsigned int fontId;
+    float fontSize;
+    float spacing;
+    bool used;
+    char text[MAX_CACHED_TEXT];
+} TextEntry;
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static TextEntry entries[TEXT_CACHE_ENTRIES];
+static TextQuad quads[TEXT_CACHE_QUADS];
+static int entryCount = 0;
+static int quadCount = 0;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static uint32_t HashText(const char *text, size_t length, unsigned int fontId, float fontSize, float spacing)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t bits[3] = { fontId, 0, 0 };
+    memcpy(&bits[1], &fontSize, sizeof(float));
+    memcpy(&bits[2], &spacing, sizeof(float));
+
+    for (size_t i = 0; i < length; i++) hash = (hash ^ (unsigned char)text[i])*16777619u;
+    for (int i = 0; i < 3; i++) hash = (hash ^ bits[i])*16777619u;
+    return hash;
+}
+
+// Same walk as DrawTextEx() for the quads and MeasureTextEx() for the size
+static bool LayoutText(TextEntry *entry, Font font, const char *text)
+{
+    float scale = entry->fontSize/(float)font.baseSize;
+    float padding = (float)font.glyphPadding;
+    float x = 0.0f, y = 0.0f;
+    float lineWidth = 0.0f, maxWidth = 0.0f;
+    int lineGlyphs = 0, lines = 1;
+
+    entry->layout.firstQuad = quadCount;
+    entry->layout.quadCount = 0;
+    entry->layout.texture = font.texture;
+
+    for (int i = 0; text[i] != '\0';)
+    {
+        int size = 0;
+        int codepoint = GetCodepointNext(&text[i], &size);
+        i += size;
+
+        if (codepoint == '\n')
+        {
+            x = 0.0f;
+            y += entry->fontSize + TEXT_LINE_SPACING;
+            lines++;
+            lineWidth = 0.0f;
+            lineGlyphs = 0;
+            continue;
+        }
+
+        int index = GetGlyphIndex(font, codepoint);
+        Rectangle rec = font.recs[index];
+        GlyphInfo glyph = font.glyphs[index];
+
+        if ((codepoint != ' ') && (codepoint != '\t'))
+        {
+            if (quadCount >= TEXT_CACHE_QUADS) return false;
+
+            quads[quadCount++] = (TextQuad){
+                { rec.x - padding, rec.y - padding, rec.width + 2.0f*padding, rec.height + 2.0f*padding },
+                { x + (glyph.offsetX - padding)*scale, y + (glyph.offsetY - padding)*scale,
+                  (rec.width + 2.0f*padding)*scale, (rec.height + 2.0f*padding)*scale } };
+            entry->layout.quadCount++;
+        }
+
+        x += ((glyph.advanceX != 0)? (float)glyph.advanceX : rec.width)*scale + entry->spacing;
+        lineWidth += ((glyph.advanceX != 0)? (float)glyph.advanceX : rec.width + glyph.offsetX)*scale;
+        lineGlyphs++;
+
+        float width = lineWidth + (float)(lineGlyphs - 1)*entry->spacing;
+        if (width > maxWidth) maxWidth = width;
+    }
+
+    entry->layout.size = (Vector2){ maxWidth, entry->fontSize + (float)(lines - 1)*(entry->fontSize + TEXT_LINE_SPACING) };
+    return true;
+}
+
+static TextEntry *FindSlot(uint32_t hash, const char *text, size_t length, unsigned int fontId, float fontSize, float spacing)
+{
+    for (uint32_t i = hash;; i++)
+    {
+        TextEntry *entry = &entries[i & (TEXT_CACHE_ENTRIES - 1)];
+
+        if (!entry->used) return entry;
+        if ((entry->hash == hash) && (entry->fontId == fontId) && (entry->fontSize == fontSize) &&
+            (entry->spacing == spacing) && (memcmp(entry->text, text, length + 1) == 0)) return entry;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+const TextLayout *GetTextLayout(Font font, const char *text, float fontSize, float spacing)
+{
+    size_t length = strlen(text);
+    if ((length >= MAX_CACHED_TEXT) || (font.glyphCount == 0)) return NULL;
+
+    uint32_t hash = HashText(text, length, font.texture.id, fontSize, spacing);
+    TextEntry *entry = FindSlot(hash, text, length, font.texture.id, fontSize, spacing);
+    if (entry->used) return &entry->layout;
+
+    if (entryCount >= TEXT_CACHE_ENTRIES*3/4)
+    {
+        ClearTextCache();
+        entry = FindSlot(hash, text, length, font.texture.id, fontSize, spacing);
+    }
+
+    *entry = (TextEntry){ .hash = hash, .fontId = font.texture.id, .fontSize = fontSize, .spacing = spacing };
+    memcpy(entry->text, text, length + 1);
+
+    if (!LayoutText(entry, font, text))
+    {
+        // Quad buffer full: start over; a string that cannot fit even then is not cached
+        ClearTextCache();
+        entry = FindSlot(hash, text, length, font.texture.id, fontSize, spacing);
+        *entry = (TextEntry){ .hash = hash, .fontId = font.texture.id, .fontSize = fontSize, .spacing = spacing };
+        memcpy(entry->text, text, length + 1);
+        if (!LayoutText(entry, font, text))
+        {
+            ClearTextCache();
+            return NULL;
+        }
+    }
+
+    entry->used = true;
+    entryCount++;
+    return &entry->layout;
+}
+
+void DrawTextLayout(const TextLayout *layout, Vector2 position, Color tint)
+{
+    if (layout->quadCount == 0) return;
+
+    float width = (float)layout->texture.width;
+    float height = (float)layout->texture.height;
+
+    rlCheckRenderBatchLimit(4*layout->quadCount);
+    rlSetTexture(layout->texture.id);
+    rlBegin(RL_QUADS);
+    rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+
+    for (int i = layout->firstQuad; i < layout->firstQuad + layout->quadCount; i++)
+    {
+        Rectangle source = quads[i].source;
+        float x = position.x + quads[i].dest.x, y = position.y + quads[i].dest.y;
+        float w = quads[i].dest.width, h = quads[i].dest.height;
+
+        rlTexCoord2f(source.x/width, source.y/height);
+        rlVertex2f(x, y);
+        rlTexCoord2f(source.x/width, (source.y + source.height)/height);
+        rlVertex2f(x, y + h);
+        rlTexCoord2f((source.x + source.width)/width, (source.y + source.height)/height);
+        rlVertex2f(x + w, y + h);
+        rlTexCoord2f((source.x + source.width)/width, source.y/height);
+        rlVertex2f(x + w, y);
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void DrawTextCached(const char *text, int posX, int posY, int fontSize, Color color)
+{
+    if (fontSize < DEFAULT_FONT_SIZE) fontSize = DEFAULT_FONT_SIZE;
+
+    const TextLayout *layout = GetTextLayout(GetFontDefault(), text, (float)fontSize, (float)(fontSize/DEFAULT_FONT_SIZE));
+    if (layout != NULL) DrawTextLayout(layout, (Vector2){ (float)posX, (float)posY }, color);
+    else DrawText(text, posX, posY, fontSize, color);
+}
+
+int MeasureTextCached(const char *text, int fontSize)
+{
+    if (fontSize < DEFAULT_FONT_SIZE) fontSize = DEFAULT_FONT_SIZE;
+
+    const TextLayout *layout = GetTextLayout(GetFontDefault(), text, (float)fontSize, (float)(fontSize/DEFAULT_FONT_SIZE));
+    return (layout != NULL)? (int)layout->size.x : MeasureText(text, fontSize);
+}
+
+void ClearTextCache(void)
+{
+    for (int i = 0; i < TEXT_CACHE_ENTRIES; i++) entries[i].used = false;
+    entryCount = 0;
+    quadCount = 0;
+}
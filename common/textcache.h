@@ -0,0 +1,51 @@
+/*******************************************************************************************
+*
+*   Text cache: laid-out glyph quads for strings drawn every frame
+*
+*   DrawText() decodes the string and looks up every glyph each time it is called. The cache
+*   does that once per (string, font, size, spacing) and keeps the result as quads relative
+*   to the text origin, so drawing a cached string is one texture bind and four vertices per
+*   glyph, and measuring it is a lookup. The layout rules follow raylib's DrawTextEx() and
+*   MeasureTextEx(), newlines included.
+*
+*   Storage is a fixed table plus a fixed quad buffer. When either fills up the whole cache
+*   is dropped and refilled by the next calls, so memory never grows and nothing is freed one
+*   entry at a time. Strings longer than MAX_CACHED_TEXT bytes fall through to DrawText().
+*   Game thread only; a layout pointer stays valid until the next GetTextLayout() call.
+*
+********************************************************************************************/
+#ifndef TEXTCACHE_H
+#define TEXTCACHE_H
+
+#include "platform.h"
+
+#define MAX_CACHED_TEXT     128
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct TextLayout {
+    Vector2 size;                   // What MeasureTextEx() returns for the string
+    Texture2D texture;              // Font atlas the quads sample
+    int firstQuad;
+    int quadCount;
+} TextLayout;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+const TextLayout *GetTextLayout(Font font, const char *text, float fontSize, float spacing);   // NULL: not cacheable
+void DrawTextLayout(const TextLayout *layout, Vector2 position, Color tint);
+
+// Drop-in replacements for DrawText()/MeasureText() with the default font
+void DrawTextCached(const char *text, int posX, int posY, int fontSize, Color color);
+int MeasureTextCached(const char *text, int fontSize);
+
+void ClearTextCache(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // TEXTCACHE_H
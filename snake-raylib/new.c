@@ -9,11 +9,17 @@
 *   - Restart/Quit options on game over
 *
 ********************************************************************************************/
-#include "raylib.h"
-
-#if defined(PLATFORM_WEB)
-    #include <emscripten/emscripten.h>
-#endif
+#include "platform.h"
+#include "assets.h"
+#include "fixed.h"
+#include "jobs.h"
+#include "layers.h"
+#include "pacing.h"
+#include "quality.h"
+#include "scenes.h"
+#include "store.h"
+#include "textcache.h"
+#include "packedsnake.h"
 
 //----------------------------------------------------------------------------------
 // Defines and Constants
@@ -21,24 +27,27 @@
 #define SNAKE_LENGTH   256
 #define SQUARE_SIZE     31
 #define MAX_MENU_ITEMS  3
+#define SEGMENT_GRAIN   64      // Segments per job
+
+_Static_assert(SNAKE_LENGTH <= PACKED_SNAKE_SEGMENTS, "snakeState holds every segment");
 
-// Game states
-typedef enum GameScreen { MENU, PLAY, HOW_TO_PLAY } GameScreen;
 typedef enum GameOverChoice { RESTART, QUIT } GameOverChoice;
 
 //----------------------------------------------------------------------------------
 // Structures Definition
 //----------------------------------------------------------------------------------
+// Positions are fixed-point (fixed.h): the grid sits on half pixels, and the collision tests
+// compare them exactly whatever the compiler does with floats
 typedef struct Snake {
-    Vector2 position;
-    Vector2 size;
-    Vector2 speed;
+    FixedVector2 position;
+    FixedVector2 size;
+    FixedVector2 speed;
     Color color;
 } Snake;
 
 typedef struct Food {
-    Vector2 position;
-    Vector2 size;
+    FixedVector2 position;
+    FixedVector2 size;
     bool active;
     Color color;
 } Food;
@@ -50,7 +59,6 @@ static const int screenWidth = 800;
 static const int screenHeight = 450;
 
 // Game state
-static GameScreen currentScreen = MENU;
 static GameOverChoice gameOverChoice = RESTART;
 static int framesCounter = 0;
 static bool gameOver = false;
@@ -59,22 +67,39 @@ static bool pause = false;
 // Game objects
 static Food fruit = { 0 };
 static Snake snake[SNAKE_LENGTH] = { 0 };
-static Vector2 snakePosition[SNAKE_LENGTH] = { 0 };
+static FixedVector2 snakePosition[SNAKE_LENGTH] = { 0 };
 static bool allowMove = false;
-static Vector2 offset = { 0 };
+static FixedVector2 offset = { 0 };
 static int counterTail = 0;
+static bool segmentHit[SNAKE_LENGTH] = { 0 };     // Self collision per segment, merged in order
+static PackedSnake snakeState = { 0 };              // The round in 72 bytes (packedsnake.h), stepped with the head
 
 // Menu
 static int menuItemSelected = 0;
 static const char* menuItems[MAX_MENU_ITEMS] = { "PLAY", "HOW TO PLAY", "EXIT" };
 
 // Audio
-static Music backgroundMusic;
-static Sound eatSound;
-static Sound dieSound;
+static AssetHandle backgroundMusic;
+static AssetHandle eatSound;
+static AssetHandle dieSound;
 
 // Graphics
-static Texture2D grassTexture;
+static AssetHandle grassTexture;
+
+// Menus, score and game over overlay, redrawn into their textures only when they change
+static ScreenLayer menuLayer = { 0 };
+static ScreenLayer howToPlayLayer = { 0 };
+static ScreenLayer scoreLayer = { 0 };
+static ScreenLayer gameOverLayer = { 0 };
+
+// Telemetry (see telemetry.h)
+static TelemetryMetric *roundsStarted = NULL;
+static TelemetryMetric *fruitsEaten = NULL;
+static TelemetryMetric *snakeLength = NULL;
+
+// High scores (store.h): the round's score goes on the board once, when it ends
+static bool scoreSaved = false;
+static int scoreRank = -1;
 
 // Speed control
 static int snakeSpeedDelay = 15;    // Higher = slower movement
@@ -85,12 +110,32 @@ static const int SPEED_CHANGE = 1;  // How much to change speed by
 // Function Declarations
 //------------------------------------------------------------------------------------
 static void InitGame(void);
+static void StartGame(void);
 static void UpdateGame(void);
 static void DrawGame(void);
+static bool IsGameAnimating(void);
+static void UpdateMenu(void);
 static void DrawMenu(void);
+static void UpdateHowToPlay(void);
 static void DrawHowToPlay(void);
-static void UpdateDrawFrame(void);
+static void LoadPlayAssets(void);
+static bool IsPlayReady(void);
+static void UnloadPlayAssets(void);
 static void UnloadGame(void);
+static void SnapshotSegments(void *data, int begin, int end);
+static void FollowSegments(void *data, int begin, int end);
+static void CheckSegmentHits(void *data, int begin, int end);
+static SnakeCell GetPositionCell(FixedVector2 position);
+static void SetHeading(SnakeDirection heading);
+
+//------------------------------------------------------------------------------------
+// Screens (scenes.h): play is preloaded while the menu is up
+//------------------------------------------------------------------------------------
+static const Scene playScene = {
+    .name = "play", .preload = LoadPlayAssets, .isReady = IsPlayReady, .enter = StartGame,
+    .update = UpdateGame, .draw = DrawGame, .isAnimating = IsGameAnimating, .unload = UnloadPlayAssets };
+static const Scene menuScene = { .name = "menu", .update = UpdateMenu, .draw = DrawMenu, .next = &playScene };
+static const Scene howToPlayScene = { .name = "how to play", .update = UpdateHowToPlay, .draw = DrawHowToPlay };
 
 //------------------------------------------------------------------------------------
 // Program Entry Point
@@ -100,32 +145,39 @@ int main(void)
     // Initialize window
     InitWindow(screenWidth, screenHeight, "Snake Game");
     InitAudioDevice();
+    InitMixer(0);
+    InitAssets(0);
+    InitJobs(0);
+    InitTelemetry("snake");
+    OpenStore("snake");
+    MountAssetPack("resources.pak");
 
-    // Load resources
-    grassTexture = LoadTexture("resources/snake_grass.jpg");
-    backgroundMusic = LoadMusicStream("resources/snake_background.wav");
-    eatSound = LoadSound("resources/snake_eat.wav");
-    dieSound = LoadSound("resources/snake_die.wav");
+    roundsStarted = RegisterTelemetryCounter("games_rounds_total", "Games started");
+    fruitsEaten = RegisterTelemetryCounter("snake_fruits_total", "Fruits eaten");
+    snakeLength = RegisterTelemetryGauge("snake_length", "Segments in the current snake");
 
-    // Start music
-    SetMusicVolume(backgroundMusic, 0.5f);
-    PlayMusicStream(backgroundMusic);
+    // Request the music (decoded in the background, streamed once ready); play's assets come with its scene
+    backgroundMusic = RequestMusic("resources/snake_background.wav");
 
-    InitGame();
+    menuLayer = LoadScreenLayer(0, 0, screenWidth, screenHeight);
+    howToPlayLayer = LoadScreenLayer(0, 0, screenWidth, screenHeight);
+    scoreLayer = LoadScreenLayer(0, 0, 240, 50);
+    gameOverLayer = LoadScreenLayer(0, 0, screenWidth, screenHeight);
 
     // Main game loop
-    SetTargetFPS(60);
-#if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
-#else
-    while (!WindowShouldClose())
-    {
-        UpdateDrawFrame();
-    }
-#endif
+    InitFramePacing(60);
+    InitScenes(&menuScene, SCENE_TRANSITION_SECONDS);
+    SetSceneMusic(backgroundMusic);
+    RunScenes();
 
     // Cleanup
+    CloseScenes();
     UnloadGame();
+    CloseStore();
+    CloseTelemetry();
+    CloseJobs();
+    CloseAssets();
+    CloseMixer();
     CloseAudioDevice();
     CloseWindow();
 
@@ -141,332 +193,402 @@ void InitGame(void)
     counterTail = 1;
     allowMove = false;
     snakeSpeedDelay = 15;  // Reset to initial speed
+    scoreSaved = false;
+    scoreRank = -1;
 
-    offset.x = screenWidth % SQUARE_SIZE;
-    offset.y = screenHeight % SQUARE_SIZE;
+    offset.x = IntToFixed(screenWidth % SQUARE_SIZE);
+    offset.y = IntToFixed(screenHeight % SQUARE_SIZE);
 
     // Initialize snake
     for (int i = 0; i < SNAKE_LENGTH; i++)
     {
-        snake[i].position = (Vector2){ offset.x/2, offset.y/2 };
-        snake[i].size = (Vector2){ SQUARE_SIZE, SQUARE_SIZE };
-        snake[i].speed = (Vector2){ SQUARE_SIZE, 0 };
+        snake[i].position = (FixedVector2){ offset.x/2, offset.y/2 };
+        snake[i].size = (FixedVector2){ IntToFixed(SQUARE_SIZE), IntToFixed(SQUARE_SIZE) };
+        snake[i].speed = (FixedVector2){ IntToFixed(SQUARE_SIZE), 0 };
         snake[i].color = (i == 0) ? DARKGREEN : GREEN;
     }
 
     // Initialize fruit
-    fruit.size = (Vector2){ SQUARE_SIZE, SQUARE_SIZE };
+    fruit.size = (FixedVector2){ IntToFixed(SQUARE_SIZE), IntToFixed(SQUARE_SIZE) };
     fruit.color = RED;
     fruit.active = false;
+
+    SnakeCell head = GetPositionCell(snake[0].position);
+    PackSnake(&snakeState, &head, 1, SNAKE_RIGHT, SNAKE_NO_FRUIT);
+}
+
+// A new round, counted
+void StartGame(void)
+{
+    InitGame();
+    AddTelemetryCount(roundsStarted, 1);
+}
+
+// Only a running snake moves: menus, pause and game over sleep until the next key
+bool IsGameAnimating(void)
+{
+    return !gameOver && !pause;
+}
+
+// Requested while the menu is up; the round waits for the grass (or for it to be found missing)
+void LoadPlayAssets(void)
+{
+    grassTexture = RequestTexture("resources/snake_grass.jpg");
+    eatSound = RequestSound("resources/snake_eat.wav");
+    dieSound = RequestSound("resources/snake_die.wav");
+}
+
+bool IsPlayReady(void)
+{
+    return GetAssetState(grassTexture) != ASSET_LOADING;
+}
+
+void UnloadPlayAssets(void)
+{
+    ReleaseAsset(grassTexture);
+    ReleaseAsset(eatSound);
+    ReleaseAsset(dieSound);
 }
 
 // Draw main menu
 void DrawMenu(void)
 {
-    BeginDrawing();
-        ClearBackground(RAYWHITE);
-        
+    ClearBackground(RAYWHITE);
+    
+    if (BeginScreenLayer(&menuLayer, MixLayerKey(0, menuItemSelected)))
+    {
         // Title
-        DrawText("SNAKE GAME", screenWidth/2 - MeasureText("SNAKE GAME", 50)/2, 80, 50, DARKGREEN);
+        DrawTextCached("SNAKE GAME", screenWidth/2 - MeasureTextCached("SNAKE GAME", 50)/2, 80, 50, DARKGREEN);
         
         // Menu items
         for (int i = 0; i < MAX_MENU_ITEMS; i++)
         {
             Color color = (i == menuItemSelected) ? DARKGREEN : LIGHTGRAY;
-            DrawText(menuItems[i],
-                    screenWidth/2 - MeasureText(menuItems[i], 40)/2,
+            DrawTextCached(menuItems[i],
+                    screenWidth/2 - MeasureTextCached(menuItems[i], 40)/2,
                     200 + i * 70,
                     40,
                     color);
         }
         
         // Controls hint
-        DrawText("Use ARROW KEYS to navigate, ENTER to select", 
-                screenWidth/2 - MeasureText("Use ARROW KEYS to navigate, ENTER to select", 20)/2,
+        DrawTextCached("Use ARROW KEYS to navigate, ENTER to select", 
+                screenWidth/2 - MeasureTextCached("Use ARROW KEYS to navigate, ENTER to select", 20)/2,
                 screenHeight - 50, 20, GRAY);
-    EndDrawing();
+        EndScreenLayer(&menuLayer);
+    }
+    DrawScreenLayer(&menuLayer, WHITE);
 }
 
 // Draw instructions screen
 void DrawHowToPlay(void)
 {
-    BeginDrawing();
-        ClearBackground(RAYWHITE);
-        
+    ClearBackground(RAYWHITE);
+    
+    if (BeginScreenLayer(&howToPlayLayer, 0))
+    {
         // Title
-        DrawText("HOW TO PLAY", screenWidth/2 - MeasureText("HOW TO PLAY", 40)/2, 40, 40, DARKGREEN);
+        DrawTextCached("HOW TO PLAY", screenWidth/2 - MeasureTextCached("HOW TO PLAY", 40)/2, 40, 40, DARKGREEN);
         
         // Controls
-        DrawText("CONTROLS:", 40, 100, 30, DARKGRAY);
-        DrawText("- Arrow keys to move", 60, 140, 25, GRAY);
-        DrawText("- P to pause", 60, 170, 25, GRAY);
-        DrawText("- C to return to menu", 60, 200, 25, GRAY);
+        DrawTextCached("CONTROLS:", 40, 100, 30, DARKGRAY);
+        DrawTextCached("- Arrow keys to move", 60, 140, 25, GRAY);
+        DrawTextCached("- P to pause", 60, 170, 25, GRAY);
+        DrawTextCached("- C to return to menu", 60, 200, 25, GRAY);
         
         // Gameplay
-        DrawText("GAMEPLAY:", 40, 250, 30, DARKGRAY);
-        DrawText("- Eat red fruits to grow", 60, 290, 25, GRAY);
-        DrawText("- Avoid walls and yourself", 60, 320, 25, GRAY);
-        DrawText("- Longer snake = higher score and higher risk of death", 60, 350, 25, GRAY);
+        DrawTextCached("GAMEPLAY:", 40, 250, 30, DARKGRAY);
+        DrawTextCached("- Eat red fruits to grow", 60, 290, 25, GRAY);
+        DrawTextCached("- Avoid walls and yourself", 60, 320, 25, GRAY);
+        DrawTextCached("- Longer snake = higher score and higher risk of death", 60, 350, 25, GRAY);
         
         // Return hint
-        DrawText("Press C to return to menu", 
-                screenWidth/2 - MeasureText("Press C to return to menu", 20)/2,
+        DrawTextCached("Press C to return to menu", 
+                screenWidth/2 - MeasureTextCached("Press C to return to menu", 20)/2,
                 screenHeight - 50, 20, GRAY);
-    EndDrawing();
+        EndScreenLayer(&howToPlayLayer);
+    }
+    DrawScreenLayer(&howToPlayLayer, WHITE);
 }
 
 // Draw gameplay screen
 void DrawGame(void)
 {
-    BeginDrawing();
-        // Draw grass background
-        DrawTextureEx(grassTexture, (Vector2){0,0}, 0, 
-                     (float)screenWidth/grassTexture.width, WHITE);
-        
-        // Draw grid (semi-transparent)
-        for (int i = 0; i < screenWidth/SQUARE_SIZE + 1; i++)
-        {
-            DrawLineV((Vector2){SQUARE_SIZE*i + offset.x/2, offset.y/2}, 
-                     (Vector2){SQUARE_SIZE*i + offset.x/2, screenHeight - offset.y/2}, 
-                     (Color){0, 100, 0, 50});
-        }
-        for (int i = 0; i < screenHeight/SQUARE_SIZE + 1; i++)
-        {
-            DrawLineV((Vector2){offset.x/2, SQUARE_SIZE*i + offset.y/2}, 
-                     (Vector2){screenWidth - offset.x/2, SQUARE_SIZE*i + offset.y/2}, 
-                     (Color){0, 100, 0, 50});
-        }
-        
-        // Draw snake
-        for (int i = 0; i < counterTail; i++)
-            DrawRectangleV(snake[i].position, snake[i].size, snake[i].color);
-        
-        // Draw fruit
-        if (fruit.active)
-            DrawRectangleV(fruit.position, fruit.size, fruit.color);
-        
-        // Draw score
-        DrawText(TextFormat("SCORE: %04d", counterTail - 1), 20, 20, 20, WHITE);
-        
-        // Pause screen
-        if (pause)  
-        {
-            DrawRectangle(0, 0, screenWidth, screenHeight, (Color){0, 0, 0, 150});
-            DrawText("GAME PAUSED", screenWidth/2 - MeasureText("GAME PAUSED", 40)/2, 
-                    screenHeight/2 - 40, 40, WHITE);
-        }
+    Texture2D grass = GetAssetTexture(grassTexture);
+    Vector2 margin = FixedVector2ToVector2((FixedVector2){ offset.x/2, offset.y/2 });
+    QualityLevel quality = GetQuality();
+
+    // Draw grass background (plain fill until the texture is uploaded, or under load)
+    if ((grass.id > 0) && quality.background) DrawTextureEx(grass, (Vector2){0,0}, 0, (float)screenWidth/grass.width, WHITE);
+    else ClearBackground(DARKGREEN);
+    
+    // Draw grid (semi-transparent), dropped first when the governor sheds detail
+    for (int i = 0; quality.gridLines && (i < screenWidth/SQUARE_SIZE + 1); i++)
+    {
+        DrawLineV((Vector2){SQUARE_SIZE*i + margin.x, margin.y}, 
+                 (Vector2){SQUARE_SIZE*i + margin.x, screenHeight - margin.y}, 
+                 (Color){0, 100, 0, 50});
+    }
+    for (int i = 0; quality.gridLines && (i < screenHeight/SQUARE_SIZE + 1); i++)
+    {
+        DrawLineV((Vector2){margin.x, SQUARE_SIZE*i + margin.y}, 
+                 (Vector2){screenWidth - margin.x, SQUARE_SIZE*i + margin.y}, 
+                 (Color){0, 100, 0, 50});
+    }
+    
+    // Draw snake
+    for (int i = 0; i < counterTail; i++)
+        DrawRectangleV(FixedVector2ToVector2(snake[i].position), FixedVector2ToVector2(snake[i].size), snake[i].color);
+    
+    // Draw fruit
+    if (fruit.active)
+        DrawRectangleV(FixedVector2ToVector2(fruit.position), FixedVector2ToVector2(fruit.size), fruit.color);
+    
+    // Draw score
+    if (BeginScreenLayer(&scoreLayer, MixLayerKey(0, counterTail)))
+    {
+        DrawText(FrameFormat("SCORE: %04d", counterTail - 1), 20, 20, 20, WHITE);
+        EndScreenLayer(&scoreLayer);
+    }
+    DrawScreenLayer(&scoreLayer, WHITE);
+    
+    // Pause screen
+    if (pause)  
+    {
+        DrawRectangle(0, 0, screenWidth, screenHeight, (Color){0, 0, 0, 150});
+        DrawTextCached("GAME PAUSED", screenWidth/2 - MeasureTextCached("GAME PAUSED", 40)/2, 
+                screenHeight/2 - 40, 40, WHITE);
+    }
+    
+    // Game over screen
+    if (gameOver)
+    {
+        StoreScore best = { 0 };
+        GetStoreTopScores("scores", &best, 1);
+        DrawRectangle(0, 0, screenWidth, screenHeight, (Color){0, 0, 0, 200});
         
-        // Game over screen
-        if (gameOver)
+        if (BeginScreenLayer(&gameOverLayer, MixLayerKey(MixLayerKey(MixLayerKey(0, counterTail), gameOverChoice), (int)best.score)))
         {
-            DrawRectangle(0, 0, screenWidth, screenHeight, (Color){0, 0, 0, 200});
-            
-            //score text
-            DrawText(TextFormat("SCORE: %04d", counterTail - 1), 330, 100, 20, WHITE);
+            //score text, and the best one kept between runs
+            DrawText(FrameFormat("SCORE: %04d", counterTail - 1), 330, 100, 20, WHITE);
+            DrawText(FrameFormat("BEST: %04d", (int)best.score), 330, 125, 20, (scoreRank == 0) ? YELLOW : LIGHTGRAY);
             
             // Game over text
-            DrawText("GAME OVER", screenWidth/2 - MeasureText("GAME OVER", 40)/2, 
+            DrawTextCached("GAME OVER", screenWidth/2 - MeasureTextCached("GAME OVER", 40)/2, 
                     screenHeight/2 - 80, 40, RED);
             
             // Options
-            DrawText("RESTART", screenWidth/2 - MeasureText("RESTART", 30)/2, 
+            DrawTextCached("RESTART", screenWidth/2 - MeasureTextCached("RESTART", 30)/2, 
                     screenHeight/2, 30, (gameOverChoice == RESTART) ? YELLOW : WHITE);
-            DrawText("QUIT", screenWidth/2 - MeasureText("QUIT", 30)/2, 
+            DrawTextCached("QUIT", screenWidth/2 - MeasureTextCached("QUIT", 30)/2, 
                     screenHeight/2 + 40, 30, (gameOverChoice == QUIT) ? YELLOW : WHITE);
             
             // Controls
-            DrawText("Use ARROW KEYS to choose, ENTER to confirm", 
-                    screenWidth/2 - MeasureText("Use ARROW KEYS to choose, ENTER to confirm", 20)/2,
+            DrawTextCached("Use ARROW KEYS to choose, ENTER to confirm", 
+                    screenWidth/2 - MeasureTextCached("Use ARROW KEYS to choose, ENTER to confirm", 20)/2,
                     screenHeight - 50, 20, LIGHTGRAY);
+            EndScreenLayer(&gameOverLayer);
         }
-    EndDrawing();
+        DrawScreenLayer(&gameOverLayer, WHITE);
+    }
 }
 
-// Update game logic
-void UpdateGame(void)
+// Menu navigation
+void UpdateMenu(void)
 {
-    // Update music
-    UpdateMusicStream(backgroundMusic);
+    if (IsKeyPressed(KEY_DOWN)) menuItemSelected = (menuItemSelected + 1) % MAX_MENU_ITEMS;
+    if (IsKeyPressed(KEY_UP)) menuItemSelected = (menuItemSelected - 1 + MAX_MENU_ITEMS) % MAX_MENU_ITEMS;
 
-    // Menu navigation
-    if (currentScreen == MENU)
+    if (IsKeyPressed(KEY_ENTER))
     {
-        if (IsKeyPressed(KEY_DOWN)) menuItemSelected = (menuItemSelected + 1) % MAX_MENU_ITEMS;
-        if (IsKeyPressed(KEY_UP)) menuItemSelected = (menuItemSelected - 1 + MAX_MENU_ITEMS) % MAX_MENU_ITEMS;
-        
-        if (IsKeyPressed(KEY_ENTER))
+        switch(menuItemSelected)
         {
-            switch(menuItemSelected)
-            {
-                case 0: currentScreen = PLAY; InitGame(); break;
-                case 1: currentScreen = HOW_TO_PLAY; break;
-                case 2: CloseWindow(); break;
-            }
+            case 0: SwitchScene(&playScene); break;
+            case 1: PushScene(&howToPlayScene); break;
+            case 2: QuitScenes(); break;
         }
     }
-    // Instructions screen
-    else if (currentScreen == HOW_TO_PLAY)
-    {
-        if (IsKeyPressed(KEY_C)) currentScreen = MENU;
-    }
-    // Gameplay
-    else if (currentScreen == PLAY)
+}
+
+// Instructions screen
+void UpdateHowToPlay(void)
+{
+    if (IsKeyPressed(KEY_C)) PopScene();
+}
+
+// Update game logic
+void UpdateGame(void)
+{
+    if (!gameOver && !pause)
     {
-        if (!gameOver && !pause)
+        // Movement controls
+        if (IsKeyPressed(KEY_RIGHT) && (snake[0].speed.x == 0) && allowMove)
         {
-            // Movement controls
-            if (IsKeyPressed(KEY_RIGHT) && (snake[0].speed.x == 0) && allowMove)
-            {
-                snake[0].speed = (Vector2){ SQUARE_SIZE , 0 };
-                allowMove = false;
-            }
-            if (IsKeyPressed(KEY_LEFT) && (snake[0].speed.x == 0) && allowMove)
-            {
-                snake[0].speed = (Vector2){ -SQUARE_SIZE, 0 };
-                allowMove = false;
-            }
-            if (IsKeyPressed(KEY_UP) && (snake[0].speed.y == 0) && allowMove)
-            {
-                snake[0].speed = (Vector2){ 0, -SQUARE_SIZE };
-                allowMove = false;
-            }
-            if (IsKeyPressed(KEY_DOWN) && (snake[0].speed.y == 0) && allowMove)
-            {
-                snake[0].speed = (Vector2){ 0, SQUARE_SIZE };
-                allowMove = false;
-            }
+            SetHeading(SNAKE_RIGHT);
+            allowMove = false;
+        }
+        if (IsKeyPressed(KEY_LEFT) && (snake[0].speed.x == 0) && allowMove)
+        {
+            SetHeading(SNAKE_LEFT);
+            allowMove = false;
+        }
+        if (IsKeyPressed(KEY_UP) && (snake[0].speed.y == 0) && allowMove)
+        {
+            SetHeading(SNAKE_UP);
+            allowMove = false;
+        }
+        if (IsKeyPressed(KEY_DOWN) && (snake[0].speed.y == 0) && allowMove)
+        {
+            SetHeading(SNAKE_DOWN);
+            allowMove = false;
+        }
 
-            // Snake movement
-            for (int i = 0; i < counterTail; i++) snakePosition[i] = snake[i].position;
-            
-            if ((framesCounter % snakeSpeedDelay) == 0)
-            {
-                for (int i = 0; i < counterTail; i++)
-                {
-                    if (i == 0)
-                    {
-                        snake[0].position.x += snake[0].speed.x;
-                        snake[0].position.y += snake[0].speed.y;
-                        allowMove = true;
-                    }
-                    else snake[i].position = snakePosition[i-1];
-                }
-            }
+        // Snake movement
+        ParallelFor(counterTail, SEGMENT_GRAIN, SnapshotSegments, NULL);
+        
+        if ((framesCounter % snakeSpeedDelay) == 0)
+        {
+            snake[0].position = FixedVector2Add(snake[0].position, snake[0].speed);
+            allowMove = true;
+            ParallelFor(counterTail, SEGMENT_GRAIN, FollowSegments, NULL);
 
-            // Wall collision
-            if ((snake[0].position.x < offset.x/2) || 
-               (snake[0].position.x + SQUARE_SIZE > screenWidth - offset.x/2) ||
-               (snake[0].position.y < offset.y/2) || 
-               (snake[0].position.y + SQUARE_SIZE > screenHeight - offset.y/2))
+            // Reaching the fruit is what grows the snake below
+            AdvancePackedSnake(&snakeState, GetPositionCell(snake[0].position) == snakeState.fruit);
+        }
+
+        // Wall collision
+        if ((snake[0].position.x < offset.x/2) || 
+           (snake[0].position.x + snake[0].size.x > IntToFixed(screenWidth) - offset.x/2) ||
+           (snake[0].position.y < offset.y/2) || 
+           (snake[0].position.y + snake[0].size.y > IntToFixed(screenHeight) - offset.y/2))
+        {
+            gameOver = true;
+            PlayMixerSound(GetAssetSound(dieSound));
+        }
+
+        // Self collision
+        ParallelFor(counterTail, SEGMENT_GRAIN, CheckSegmentHits, NULL);
+        for (int i = 1; i < counterTail; i++)
+        {
+            if (segmentHit[i])
             {
                 gameOver = true;
-                PlaySound(dieSound);
+                PlayMixerSound(GetAssetSound(dieSound));
             }
+        }
 
-            // Self collision
-            for (int i = 1; i < counterTail; i++)
-            {
-                if ((snake[0].position.x == snake[i].position.x) && 
-                    (snake[0].position.y == snake[i].position.y))
-                {
-                    gameOver = true;
-                    PlaySound(dieSound);
-                }
-            }
+        if (gameOver && !scoreSaved)
+        {
+            scoreRank = AddStoreScore("scores", counterTail - 1);
+            scoreSaved = true;
+        }
 
-            // Fruit spawning
-            if (!fruit.active)
+        // Fruit spawning
+        if (!fruit.active)
+        {
+            fruit.active = true;
+            fruit.position = (FixedVector2){ 
+                IntToFixed(GetRandomValue(0, (screenWidth/SQUARE_SIZE) - 1)*SQUARE_SIZE) + offset.x/2, 
+                IntToFixed(GetRandomValue(0, (screenHeight/SQUARE_SIZE) - 1)*SQUARE_SIZE) + offset.y/2 
+            };
+
+            // Ensure fruit doesn't spawn on snake: one pass over the packed cells marks them all
+            SnakeCell cells[SNAKE_LENGTH];
+            uint64_t occupied[SNAKE_GRID_CELLS/64] = { 0 };
+            int length = UnpackSnake(&snakeState, cells);
+            for (int i = 0; i < length; i++) occupied[cells[i]/64] |= 1ULL << (cells[i]%64);
+
+            SnakeCell cell = GetPositionCell(fruit.position);
+            while (occupied[cell/64] & (1ULL << (cell%64)))
             {
-                fruit.active = true;
-                fruit.position = (Vector2){ 
-                    GetRandomValue(0, (screenWidth/SQUARE_SIZE) - 1)*SQUARE_SIZE + offset.x/2, 
-                    GetRandomValue(0, (screenHeight/SQUARE_SIZE) - 1)*SQUARE_SIZE + offset.y/2 
+                fruit.position = (FixedVector2){ 
+                    IntToFixed(GetRandomValue(0, (screenWidth/SQUARE_SIZE) - 1)*SQUARE_SIZE) + offset.x/2, 
+                    IntToFixed(GetRandomValue(0, (screenHeight/SQUARE_SIZE) - 1)*SQUARE_SIZE) + offset.y/2 
                 };
-
-                // Ensure fruit doesn't spawn on snake
-                for (int i = 0; i < counterTail; i++)
-                {
-                    while ((fruit.position.x == snake[i].position.x) && 
-                           (fruit.position.y == snake[i].position.y))
-                    {
-                        fruit.position = (Vector2){ 
-                            GetRandomValue(0, (screenWidth/SQUARE_SIZE) - 1)*SQUARE_SIZE + offset.x/2, 
-                            GetRandomValue(0, (screenHeight/SQUARE_SIZE) - 1)*SQUARE_SIZE + offset.y/2 
-                        };
-                        i = 0;
-                    }
-                }
+                cell = GetPositionCell(fruit.position);
             }
-
-            // Fruit collision
-            if ((snake[0].position.x < (fruit.position.x + fruit.size.x)) &&
-               (snake[0].position.x + snake[0].size.x > fruit.position.x) &&
-               (snake[0].position.y < (fruit.position.y + fruit.size.y)) &&
-               (snake[0].position.y + snake[0].size.y > fruit.position.y))
-            {
-                PlaySound(eatSound);
-                snake[counterTail].position = snakePosition[counterTail - 1];
-                if (counterTail < SNAKE_LENGTH) counterTail++;
-                fruit.active = false;
-                
-                // Gradual speed increase every 3 fruits
-                if (counterTail % 3 == 0 && snakeSpeedDelay > MIN_SPEED) {
-                    snakeSpeedDelay -= SPEED_CHANGE;
-                }
-            }
-
-            framesCounter++;
+            snakeState.fruit = cell;
         }
 
-        // Pause toggle
-        if (IsKeyPressed(KEY_P)) pause = !pause;
-
-        // Game over handling
-        if (gameOver)
+        // Fruit collision
+        if (CheckCollisionFixedRecs((FixedRect){ snake[0].position.x, snake[0].position.y, snake[0].size.x, snake[0].size.y },
+                                    (FixedRect){ fruit.position.x, fruit.position.y, fruit.size.x, fruit.size.y }))
         {
-            if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_DOWN))
-                gameOverChoice = !gameOverChoice;
+            PlayMixerSound(GetAssetSound(eatSound));
+            snake[counterTail].position = snakePosition[counterTail - 1];
+            if (counterTail < SNAKE_LENGTH) counterTail++;
+            fruit.active = false;
+            snakeState.fruit = SNAKE_NO_FRUIT;
+            AddTelemetryCount(fruitsEaten, 1);
             
-            if (IsKeyPressed(KEY_ENTER))
-            {
-                if (gameOverChoice == RESTART) 
-                {
-                    InitGame();
-                    gameOver = false;
-                }
-                else 
-                {
-                    currentScreen = MENU;
-                    gameOver = false;
-                }
+            // Gradual speed increase every 3 fruits
+            if (counterTail % 3 == 0 && snakeSpeedDelay > MIN_SPEED) {
+                snakeSpeedDelay -= SPEED_CHANGE;
             }
         }
-        // Return to menu
-        else if (IsKeyPressed(KEY_ESCAPE)) 
+
+        SetTelemetryGauge(snakeLength, counterTail);
+        framesCounter++;
+    }
+
+    // Pause toggle
+    if (IsKeyPressed(KEY_P)) pause = !pause;
+
+    // Game over handling
+    if (gameOver)
+    {
+        if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_DOWN))
+            gameOverChoice = !gameOverChoice;
+        
+        if (IsKeyPressed(KEY_ENTER))
         {
-            currentScreen = MENU;
+            if (gameOverChoice == RESTART) StartGame();
+            else SwitchScene(&menuScene);
         }
     }
+    // Return to menu
+    else if (IsKeyPressed(KEY_ESCAPE)) SwitchScene(&menuScene);
+}
+
+// Cleanup resources
+void UnloadGame(void)
+{
+    ReleaseAsset(backgroundMusic);
+    UnloadScreenLayer(&menuLayer);
+    UnloadScreenLayer(&howToPlayLayer);
+    UnloadScreenLayer(&scoreLayer);
+    UnloadScreenLayer(&gameOverLayer);
+}
+// Segment jobs: each writes only its own range, so the split never changes the result
+void SnapshotSegments(void *data, int begin, int end)
+{
+    for (int i = begin; i < end; i++) snakePosition[i] = snake[i].position;
+}
+
+// Every segment but the head steps into the place of the one ahead of it
+void FollowSegments(void *data, int begin, int end)
+{
+    for (int i = (begin > 0)? begin : 1; i < end; i++) snake[i].position = snakePosition[i-1];
+}
+
+void CheckSegmentHits(void *data, int begin, int end)
+{
+    for (int i = begin; i < end; i++)
+    {
+        segmentHit[i] = (i > 0) && FixedVector2Equals(snake[0].position, snake[i].position);
+    }
 }
 
-// Main update/draw frame
-void UpdateDrawFrame(void)
+// Grid cell of a segment or fruit position, as packedsnake.h numbers them
+SnakeCell GetPositionCell(FixedVector2 position)
 {
-    UpdateGame();
-    
-    if (currentScreen == MENU)
-        DrawMenu();
-    else if (currentScreen == HOW_TO_PLAY)
-        DrawHowToPlay();
-    else if (currentScreen == PLAY)
-        DrawGame();
+    return GetSnakeCell(FixedToInt(position.x - offset.x/2)/SQUARE_SIZE, FixedToInt(position.y - offset.y/2)/SQUARE_SIZE);
 }
 
-// Cleanup resources
-void UnloadGame(void)
+void SetHeading(SnakeDirection heading)
 {
-    UnloadTexture(grassTexture);
-    UnloadMusicStream(backgroundMusic);
-    UnloadSound(eatSound);
-    UnloadSound(dieSound);
-}
\ No newline at end of file
+    Fixed step = IntToFixed(SQUARE_SIZE);
+    snake[0].speed = (FixedVector2){ (heading == SNAKE_RIGHT)? step : (heading == SNAKE_LEFT)? -step : 0,
+                                     (heading == SNAKE_DOWN)? step : (heading == SNAKE_UP)? -step : 0 };
+    snakeState.heading = (uint8_t)heading;
+}
@@ -0,0 +1,133 @@
+/*******************************************************************************************
+*
+*   PackedSnake, see packedsnake.h
+*
+********************************************************************************************/
+#include "packedsnake.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define LINK_WORDS      (PACKED_SNAKE_SEGMENTS/32)
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static inline int GetLink(const uint64_t *links, int index)
+{
+    return (int)(links[index/32] >> (2*(index%32))) & 3;
+}
+
+// Zero links index and up, keeping packed rounds comparable as bytes
+static void ClearLinksFrom(uint64_t *links, int index)
+{
+    int word = index/32;
+    int bit = 2*(index%32);
+    if (word >= LINK_WORDS) return;
+
+    links[word] &= (bit == 0)? 0 : ~0ULL >> (64 - bit);
+    for (int i = word + 1; i < LINK_WORDS; i++) links[i] = 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool PackSnake(PackedSnake *snake, const SnakeCell *cells, int length, int heading, SnakeCell fruit)
+{
+    uint64_t links[LINK_WORDS] = { 0 };
+    int count = length - 1;
+    int i = 0;
+
+    if ((length < 1) || (length > PACKED_SNAKE_SEGMENTS)) return false;
+
+#if defined(__SSE2__)
+    // Eight links at a time: the step to the next cell is compared against the four
+    // directions, and the codes are gathered into 16 bits by one multiply-add
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i two = _mm_set1_epi16(2);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i step = _mm_sub_epi16(_mm_loadu_si128((const __m128i *)(cells + i + 1)), _mm_loadu_si128((const __m128i *)(cells + i)));
+        __m128i right = _mm_cmpeq_epi16(step, one);
+        __m128i down = _mm_cmpeq_epi16(step, _mm_set1_epi16(SNAKE_GRID_STRIDE));
+        __m128i left = _mm_cmpeq_epi16(step, _mm_set1_epi16(-1));
+        __m128i up = _mm_cmpeq_epi16(step, _mm_set1_epi16(-SNAKE_GRID_STRIDE));
+        __m128i valid = _mm_or_si128(_mm_or_si128(right, down), _mm_or_si128(left, up));
+        if (_mm_movemask_epi8(valid) != 0xffff) return false;
+
+        __m128i codes = _mm_or_si128(_mm_and_si128(_mm_or_si128(down, up), one), _mm_and_si128(_mm_or_si128(left, up), two));
+        __m128i pairs = _mm_madd_epi16(codes, _mm_setr_epi16(1, 4, 16, 64, 1, 4, 16, 64));
+        __m128i bytes = _mm_add_epi32(pairs, _mm_srli_epi64(pairs, 32));
+        uint64_t chunk = (uint64_t)(_mm_cvtsi128_si32(bytes) & 0xff) | ((uint64_t)(_mm_extract_epi16(bytes, 4) & 0xff) << 8);
+        links[i/32] |= chunk << (2*(i%32));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        int step = cells[i + 1] - cells[i];
+        int code = (step == 1)? SNAKE_RIGHT : (step == SNAKE_GRID_STRIDE)? SNAKE_DOWN : (step == -1)? SNAKE_LEFT :
+                   (step == -SNAKE_GRID_STRIDE)? SNAKE_UP : -1;
+        if (code < 0) return false;
+        links[i/32] |= (uint64_t)code << (2*(i%32));
+    }
+
+    memcpy(snake->links, links, sizeof(links));
+    snake->head = cells[0];
+    snake->fruit = fruit;
+    snake->length = (uint16_t)length;
+    snake->heading = (uint8_t)(heading & 3);
+    snake->reserved = 0;
+    return true;
+}
+
+int UnpackSnake(const PackedSnake *snake, SnakeCell *cells)
+{
+    int count = snake->length - 1;
+    int i = 0;
+
+    cells[0] = snake->head;
+
+#if defined(__SSE2__)
+    // Eight links at a time: each lane shifts its own 2 bits to the top with a multiply,
+    // turns them into a step, and a prefix sum over the lanes walks the steps from the
+    // last cell written
+    const __m128i one = _mm_set1_epi16(1);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i chunk = _mm_set1_epi16((short)(snake->links[i/32] >> (2*(i%32))));
+        __m128i codes = _mm_srli_epi16(_mm_mullo_epi16(chunk, _mm_setr_epi16(1 << 14, 1 << 12, 1 << 10, 1 << 8, 1 << 6, 1 << 4, 1 << 2, 1)), 14);
+        __m128i vertical = _mm_cmpeq_epi16(_mm_and_si128(codes, one), one);
+        __m128i backwards = _mm_cmpgt_epi16(codes, one);
+        __m128i size = _mm_or_si128(_mm_and_si128(vertical, _mm_set1_epi16(SNAKE_GRID_STRIDE)), _mm_andnot_si128(vertical, one));
+        __m128i steps = _mm_sub_epi16(_mm_xor_si128(size, backwards), backwards);
+
+        steps = _mm_add_epi16(steps, _mm_slli_si128(steps, 2));
+        steps = _mm_add_epi16(steps, _mm_slli_si128(steps, 4));
+        steps = _mm_add_epi16(steps, _mm_slli_si128(steps, 8));
+        _mm_storeu_si128((__m128i *)(cells + i + 1), _mm_add_epi16(steps, _mm_set1_epi16((short)cells[i])));
+    }
+#endif
+
+    for (; i < count; i++) cells[i + 1] = (SnakeCell)(cells[i] + GetSnakeStep(GetLink(snake->links, i)));
+
+    return snake->length;
+}
+
+// The new link leads from the new head back to the old one; shifting every link up one
+// place drops the tail's off the end, unless the snake grows and keeps it
+void AdvancePackedSnake(PackedSnake *snake, bool grow)
+{
+    for (int i = LINK_WORDS - 1; i > 0; i--) snake->links[i] = (snake->links[i] << 2) | (snake->links[i - 1] >> 62);
+    snake->links[0] = (snake->links[0] << 2) | (uint64_t)(snake->heading ^ 2);
+
+    snake->head = (SnakeCell)(snake->head + GetSnakeStep(snake->heading));
+    if (grow && (snake->length < PACKED_SNAKE_SEGMENTS)) snake->length++;
+    ClearLinksFrom(snake->links, snake->length - 1);
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************************
+*
+*   PackedSnake: a whole snake round in 72 bytes, for replays, rollback and training buffers
+*
+*   Only the head and the way each segment turns matter: every other segment sits one cell
+*   from the one ahead of it. A PackedSnake keeps the head cell, then 2 bits per link (the
+*   step from segment i to segment i + 1, towards the tail), the heading and the fruit cell,
+*   against about 9 KB for the Snake array and its position copy in new.c.
+*
+*   Cells are numbered on a padded grid, SNAKE_GRID_STRIDE cells per row with one ring of
+*   cells around the board, so a head that has just run into a wall still has a cell and
+*   every step is a fixed offset. Links past length - 1 are always zero, so two equal
+*   rounds pack to the same bytes and can be compared or hashed as memory.
+*
+*   PackSnake()/UnpackSnake() convert eight links per SSE2 instruction where available, with
+*   the same result as the scalar loop. AdvancePackedSnake() follows one step of the game in
+*   a few word shifts: the head moves, a link is added behind it and the tail drops, or
+*   stays when the snake grows.
+*
+********************************************************************************************/
+#ifndef PACKEDSNAKE_H
+#define PACKEDSNAKE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PACKED_SNAKE_SEGMENTS   256
+#define SNAKE_GRID_STRIDE        32     // Board columns plus the ring must fit
+#define SNAKE_GRID_ROWS          32
+#define SNAKE_GRID_CELLS        (SNAKE_GRID_STRIDE*SNAKE_GRID_ROWS)
+#define SNAKE_NO_FRUIT          0xffff
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum SnakeDirection {
+    SNAKE_RIGHT = 0,
+    SNAKE_DOWN,
+    SNAKE_LEFT,                     // Opposite of d is d ^ 2
+    SNAKE_UP
+} SnakeDirection;
+
+typedef uint16_t SnakeCell;         // (row + 1)*SNAKE_GRID_STRIDE + column + 1
+
+typedef struct PackedSnake {
+    uint64_t links[PACKED_SNAKE_SEGMENTS/32];   // Link i in bits 2i..2i+1 of the 512
+    SnakeCell head;
+    SnakeCell fruit;                // SNAKE_NO_FRUIT when none is out
+    uint16_t length;                // Segments, head included
+    uint8_t heading;                // SnakeDirection of the head's next step
+    uint8_t reserved;
+} PackedSnake;
+
+//----------------------------------------------------------------------------------
+// Cells, inline: board columns and rows run from -1 (the ring) to SNAKE_GRID_STRIDE - 2
+//----------------------------------------------------------------------------------
+static inline SnakeCell GetSnakeCell(int column, int row) { return (SnakeCell)((row + 1)*SNAKE_GRID_STRIDE + column + 1); }
+static inline int GetSnakeCellColumn(SnakeCell cell) { return cell%SNAKE_GRID_STRIDE - 1; }
+static inline int GetSnakeCellRow(SnakeCell cell) { return cell/SNAKE_GRID_STRIDE - 1; }
+
+static inline int GetSnakeStep(int direction)
+{
+    static const int steps[4] = { 1, SNAKE_GRID_STRIDE, -1, -SNAKE_GRID_STRIDE };
+    return steps[direction & 3];
+}
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// cells[0] is the head; false, leaving snake alone, unless each cell is one step from the last
+bool PackSnake(PackedSnake *snake, const SnakeCell *cells, int length, int heading, SnakeCell fruit);
+int UnpackSnake(const PackedSnake *snake, SnakeCell *cells);        // Fills length cells, head first; returns length
+void AdvancePackedSnake(PackedSnake *snake, bool grow);             // One step along heading
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PACKEDSNAKE_H
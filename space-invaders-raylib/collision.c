@@ -0,0 +1,194 @@
+/*******************************************************************************************
+*
+*   Collision, see collision.h
+*
+********************************************************************************************/
+#include "collision.h"
+
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define SWEEP_ARRAYS    15              // ax, ay, aw, ah, bx, by, bw, bh, dx, dy, sx, sy, sw, sh, time
+#define NO_IMPACT       (2*FIXED_ONE)
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+// When a box [a, a + aSize) moving by d starts and stops overlapping a still [b, b + bSize),
+// in Q16.16 step fractions held wide enough that no quotient overflows
+static inline void SweepAxis(Fixed a, Fixed aSize, Fixed b, Fixed bSize, Fixed d, int64_t *entry, int64_t *exit)
+{
+    int64_t lead = (int64_t)b - ((int64_t)a + aSize);
+    int64_t trail = ((int64_t)b + bSize) - a;
+    int64_t near = (d >= 0)? lead : trail;
+    int64_t far = (d >= 0)? trail : lead;
+
+    if (d != 0)
+    {
+        *entry = near*FIXED_ONE/d;
+        *exit = far*FIXED_ONE/d;
+    }
+    else
+    {
+        // Not moving on this axis: overlapping all step long or never
+        bool overlap = (near < 0) && (far > 0);
+        *entry = overlap? INT64_MIN : INT64_MAX;
+        *exit = overlap? INT64_MAX : INT64_MIN;
+    }
+}
+
+static inline Fixed SweepImpact(Fixed ax, Fixed ay, Fixed aw, Fixed ah, Fixed bx, Fixed by, Fixed bw, Fixed bh, Fixed dx, Fixed dy)
+{
+    int64_t entryX, exitX, entryY, exitY;
+    SweepAxis(ax, aw, bx, bw, dx, &entryX, &exitX);
+    SweepAxis(ay, ah, by, bh, dy, &entryY, &exitY);
+
+    int64_t entry = (entryX > entryY)? entryX : entryY;
+    int64_t exit = (exitX < exitY)? exitX : exitY;
+    if ((entry < exit) && (entry <= FIXED_ONE) && (exit > 0)) return (entry > 0)? (Fixed)entry : 0;
+    return NO_IMPACT;
+}
+
+// Boxes above or below the area land in the edge bands, so nothing is ever missed
+static void GetBandRange(const SweepBands *bands, SweptRec swept, int *first, int *last)
+{
+    FixedRect bounds = GetSweptBounds(swept);
+    int64_t top = (int64_t)bounds.y - bands->top;
+    int64_t bottom = top + bounds.height;
+    *first = (top > 0)? (int)(top/bands->bandHeight) : 0;
+    *last = (bottom > 0)? (int)(bottom/bands->bandHeight) : 0;
+    if (*last > SWEEP_BANDS - 1) *last = SWEEP_BANDS - 1;
+    if (*first > *last) *first = *last;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+FixedRect GetSweptBounds(SweptRec swept)
+{
+    FixedRect rec = swept.rec;
+    if (swept.motion.x < 0) rec.x += swept.motion.x;
+    if (swept.motion.y < 0) rec.y += swept.motion.y;
+    rec.width += (swept.motion.x < 0)? -swept.motion.x : swept.motion.x;
+    rec.height += (swept.motion.y < 0)? -swept.motion.y : swept.motion.y;
+    return rec;
+}
+
+FixedRect GetSweptRecAt(SweptRec swept, Fixed time)
+{
+    FixedRect rec = swept.rec;
+    rec.x += FixedMul(swept.motion.x, time);
+    rec.y += FixedMul(swept.motion.y, time);
+    return rec;
+}
+
+Fixed GetSweptImpactTime(SweptRec a, SweptRec b)
+{
+    return SweepImpact(a.rec.x, a.rec.y, a.rec.width, a.rec.height, b.rec.x, b.rec.y, b.rec.width, b.rec.height,
+                       a.motion.x - b.motion.x, a.motion.y - b.motion.y);
+}
+
+void ClearSweepBands(SweepBands *bands, Fixed top, Fixed height)
+{
+    bands->top = top;
+    bands->bandHeight = ((height > FIXED_ONE)? height : FIXED_ONE)/SWEEP_BANDS;
+    for (int i = 0; i < SWEEP_BANDS; i++) bands->masks[i] = 0;
+}
+
+void AddSweepBands(SweepBands *bands, SweptRec swept, int id)
+{
+    int first, last;
+    GetBandRange(bands, swept, &first, &last);
+    for (int i = first; i <= last; i++) bands->masks[i] |= 1ull << id;
+}
+
+uint64_t QuerySweepBands(const SweepBands *bands, SweptRec swept)
+{
+    int first, last;
+    uint64_t mask = 0;
+    GetBandRange(bands, swept, &first, &last);
+    for (int i = first; i <= last; i++) mask |= bands->masks[i];
+    return mask;
+}
+
+SweepBatch *LoadSweepBatch(int capacity)
+{
+    SweepBatch *batch = (SweepBatch *)calloc(1, sizeof(SweepBatch));
+    if (batch == NULL) return NULL;
+
+    batch->capacity = capacity;
+    batch->block = (Fixed *)calloc((size_t)capacity*SWEEP_ARRAYS, sizeof(Fixed));
+    batch->first = (int *)calloc((size_t)capacity*2, sizeof(int));
+    batch->reach = (uint8_t *)calloc((size_t)capacity, sizeof(uint8_t));
+    if ((batch->block == NULL) || (batch->first == NULL) || (batch->reach == NULL))
+    {
+        UnloadSweepBatch(batch);
+        return NULL;
+    }
+
+    Fixed **arrays[SWEEP_ARRAYS] = { &batch->ax, &batch->ay, &batch->aw, &batch->ah, &batch->bx, &batch->by,
+                                     &batch->bw, &batch->bh, &batch->dx, &batch->dy, &batch->sx, &batch->sy,
+                                     &batch->sw, &batch->sh, &batch->time };
+    for (int i = 0; i < SWEEP_ARRAYS; i++) *arrays[i] = batch->block + (size_t)i*capacity;
+    batch->second = batch->first + capacity;
+
+    return batch;
+}
+
+void UnloadSweepBatch(SweepBatch *batch)
+{
+    if (batch == NULL) return;
+
+    free(batch->block);
+    free(batch->first);
+    free(batch->reach);
+    free(batch);
+}
+
+void ClearSweepBatch(SweepBatch *batch)
+{
+    batch->count = 0;
+}
+
+bool AddSweepPair(SweepBatch *batch, SweptRec a, int first, SweptRec b, int second)
+{
+    if (batch->count >= batch->capacity) return false;
+
+    int i = batch->count++;
+    batch->ax[i] = a.rec.x;
+    batch->ay[i] = a.rec.y;
+    batch->aw[i] = a.rec.width;
+    batch->ah[i] = a.rec.height;
+    batch->bx[i] = b.rec.x;
+    batch->by[i] = b.rec.y;
+    batch->bw[i] = b.rec.width;
+    batch->bh[i] = b.rec.height;
+    batch->dx[i] = a.motion.x - b.motion.x;
+    batch->dy[i] = a.motion.y - b.motion.y;
+
+    FixedRect bounds = GetSweptBounds((SweptRec){ a.rec, (FixedVector2){ batch->dx[i], batch->dy[i] } });
+    batch->sx[i] = bounds.x;
+    batch->sy[i] = bounds.y;
+    batch->sw[i] = bounds.width;
+    batch->sh[i] = bounds.height;
+    batch->first[i] = first;
+    batch->second[i] = second;
+    return true;
+}
+
+// Most candidates from the bands are nowhere near: the integer overlap pass, four pairs at a
+// time, leaves the divisions to the few whose swept bounds do reach
+void SweepPairs(SweepBatch *batch)
+{
+    CheckCollisionFixedRecPairs(batch->sx, batch->sy, batch->sw, batch->sh,
+                                batch->bx, batch->by, batch->bw, batch->bh, batch->count, batch->reach);
+
+    for (int i = 0; i < batch->count; i++)
+    {
+        batch->time[i] = !batch->reach[i]? NO_IMPACT :
+            SweepImpact(batch->ax[i], batch->ay[i], batch->aw[i], batch->ah[i],
+                        batch->bx[i], batch->by[i], batch->bw[i], batch->bh[i], batch->dx[i], batch->dy[i]);
+    }
+}
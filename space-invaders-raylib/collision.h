@@ -0,0 +1,76 @@
+/*******************************************************************************************
+*
+*   Collision: swept rectangles, so fast movers hit what they pass through between frames
+*
+*   A SweptRec is a rectangle and the straight-line motion it makes over one step, both
+*   fixed-point (see fixed.h). Two of them touch at the time of impact, the fraction of the
+*   step at which their boxes first overlap (0 if they already do), found per axis as in a
+*   swept AABB test and returned in Q16.16, FIXED_ONE being the whole step. Overlap is
+*   strict, as in CheckCollisionRecs(): boxes that only share an edge do not touch.
+*
+*   The broadphase, SweepBands, slices the play area into horizontal bands holding a bitmask
+*   of the (at most 64) boxes whose swept bounds cross each band; a query ORs the bands a
+*   mover crosses. Candidate pairs go into a SweepBatch, structure-of-arrays: SweepPairs()
+*   first throws out, four lanes at a time, the pairs whose swept bounds miss, then solves
+*   the time of impact of the rest in exact integer math.
+*
+********************************************************************************************/
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "fixed.h"
+
+#include <stdint.h>
+
+#define SWEEP_BANDS     32
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct SweptRec {
+    FixedRect rec;                  // At the start of the step
+    FixedVector2 motion;            // Over the whole step
+} SweptRec;
+
+typedef struct SweepBands {
+    Fixed top;
+    Fixed bandHeight;
+    uint64_t masks[SWEEP_BANDS];    // Bit i: box i crosses the band
+} SweepBands;
+
+typedef struct SweepBatch {
+    int capacity;
+    int count;
+    Fixed *ax, *ay, *aw, *ah;       // First box at the start of the step
+    Fixed *bx, *by, *bw, *bh;       // Second box
+    Fixed *dx, *dy;                 // Motion of the first relative to the second
+    Fixed *sx, *sy, *sw, *sh;       // Swept bounds of the first, relative to the second
+    Fixed *time;                    // SweepPairs(): time of impact, > FIXED_ONE for none this step
+    int *first, *second;            // Caller's ids for each pair
+    uint8_t *reach;                 // SweepPairs(): swept bounds overlap the second box
+    Fixed *block;                   // One allocation behind the Fixed arrays
+} SweepBatch;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FixedRect GetSweptBounds(SweptRec swept);                   // Everything the box covers over the step
+FixedRect GetSweptRecAt(SweptRec swept, Fixed time);
+Fixed GetSweptImpactTime(SweptRec a, SweptRec b);           // > FIXED_ONE: no contact this step
+
+void ClearSweepBands(SweepBands *bands, Fixed top, Fixed height);
+void AddSweepBands(SweepBands *bands, SweptRec swept, int id);  // id < 64
+uint64_t QuerySweepBands(const SweepBands *bands, SweptRec swept);
+
+SweepBatch *LoadSweepBatch(int capacity);
+void UnloadSweepBatch(SweepBatch *batch);
+void ClearSweepBatch(SweepBatch *batch);
+bool AddSweepPair(SweepBatch *batch, SweptRec a, int first, SweptRec b, int second);    // false when full
+void SweepPairs(SweepBatch *batch);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // COLLISION_H
@@ -0,0 +1,243 @@
+/*******************************************************************************************
+*
+*   Particles, see particles.h
+*
+********************************************************************************************/
+#include "particles.h"
+
+#if !defined(PLATFORM_HEADLESS)
+    #include "rlgl.h"
+#endif
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE__) || defined(_M_X64)
+    #include <xmmintrin.h>
+    #define PARTICLES_SSE
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define PARTICLE_ARRAYS     8           // x, y, vx, vy, life, fade, drag, size
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct ParticleSystem {
+    int capacity;                       // Multiple of 4, so lanes past count stay in bounds
+    int count;
+    int limit;                          // New particles are dropped from here on, capacity at most
+    float *x, *y;
+    float *vx, *vy;
+    float *life;                        // Seconds left
+    float *fade;                        // 1/lifetime: life*fade is the fraction left
+    float *drag;
+    float *size;
+    Color *color;
+    float *block;                       // One allocation behind all the arrays
+    uint32_t random;
+    rlRenderBatch batch;                // Holds the whole pool, so drawing it never splits
+};
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+// xorshift32, uniform in [0, 1)
+static float NextRandom(ParticleSystem *system)
+{
+    uint32_t x = system->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    system->random = x;
+    return (float)(x >> 8)*(1.0f/16777216.0f);
+}
+
+static float RandomRange(ParticleSystem *system, float min, float max)
+{
+    return min + (max - min)*NextRandom(system);
+}
+
+static void MoveParticle(ParticleSystem *system, int to, int from)
+{
+    system->x[to] = system->x[from];
+    system->y[to] = system->y[from];
+    system->vx[to] = system->vx[from];
+    system->vy[to] = system->vy[from];
+    system->life[to] = system->life[from];
+    system->fade[to] = system->fade[from];
+    system->drag[to] = system->drag[from];
+    system->size[to] = system->size[from];
+    system->color[to] = system->color[from];
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+ParticleSystem *LoadParticleSystem(int capacity)
+{
+    ParticleSystem *system = (ParticleSystem *)calloc(1, sizeof(ParticleSystem));
+    if (system == NULL) return NULL;
+
+    system->capacity = (capacity + 3) & ~3;
+    system->block = (float *)calloc((size_t)system->capacity*PARTICLE_ARRAYS, sizeof(float));
+    system->color = (Color *)calloc((size_t)system->capacity, sizeof(Color));
+    if ((system->block == NULL) || (system->color == NULL))
+    {
+        free(system->block);
+        free(system->color);
+        free(system);
+        return NULL;
+    }
+
+    float **arrays[PARTICLE_ARRAYS] = { &system->x, &system->y, &system->vx, &system->vy, &system->life, &system->fade, &system->drag, &system->size };
+    for (int i = 0; i < PARTICLE_ARRAYS; i++) *arrays[i] = system->block + (size_t)i*system->capacity;
+
+    system->limit = system->capacity;
+    system->random = 0x9E3779B9u;
+    system->batch = rlLoadRenderBatch(1, system->capacity);
+    return system;
+}
+
+void UnloadParticleSystem(ParticleSystem *system)
+{
+    if (system == NULL) return;
+
+    rlUnloadRenderBatch(system->batch);
+    free(system->block);
+    free(system->color);
+    free(system);
+}
+
+void ClearParticles(ParticleSystem *system)
+{
+    system->count = 0;
+}
+
+int GetParticleCount(const ParticleSystem *system)
+{
+    return system->count;
+}
+
+// Particles already past a lowered limit live out their lifetimes
+void SetParticleLimit(ParticleSystem *system, int limit)
+{
+    system->limit = (limit < 0)? 0 : (limit > system->capacity)? system->capacity : limit;
+}
+
+int EmitParticles(ParticleSystem *system, const ParticleEmitter *emitter, int count)
+{
+    if (system->count >= system->limit) return 0;
+    if (count > system->limit - system->count) count = system->limit - system->count;
+
+    for (int n = 0; n < count; n++)
+    {
+        int i = system->count++;
+        float angle = emitter->angle + emitter->spread*(2.0f*NextRandom(system) - 1.0f);
+        float speed = RandomRange(system, emitter->minSpeed, emitter->maxSpeed);
+        float life = RandomRange(system, emitter->minLife, emitter->maxLife);
+        float blend = NextRandom(system);
+
+        system->x[i] = emitter->position.x;
+        system->y[i] = emitter->position.y;
+        system->vx[i] = emitter->velocity.x + cosf(angle)*speed;
+        system->vy[i] = emitter->velocity.y + sinf(angle)*speed;
+        system->life[i] = life;
+        system->fade[i] = (life > 0.0f)? 1.0f/life : 0.0f;
+        system->drag[i] = emitter->drag;
+        system->size[i] = RandomRange(system, emitter->minSize, emitter->maxSize);
+        system->color[i] = (Color){
+            (unsigned char)(emitter->colors[0].r + (emitter->colors[1].r - emitter->colors[0].r)*blend),
+            (unsigned char)(emitter->colors[0].g + (emitter->colors[1].g - emitter->colors[0].g)*blend),
+            (unsigned char)(emitter->colors[0].b + (emitter->colors[1].b - emitter->colors[0].b)*blend),
+            (unsigned char)(emitter->colors[0].a + (emitter->colors[1].a - emitter->colors[0].a)*blend) };
+    }
+
+    return count;
+}
+
+void UpdateParticleEmitter(ParticleSystem *system, ParticleEmitter *emitter, float deltaTime)
+{
+    emitter->pending += emitter->rate*deltaTime;
+    int count = (int)emitter->pending;
+    emitter->pending -= (float)count;
+    if (count > 0) EmitParticles(system, emitter, count);
+}
+
+void UpdateParticles(ParticleSystem *system, float deltaTime)
+{
+    int count = system->count;
+    int i = 0;
+
+    // Integrate: position by velocity, velocity by drag (linearised, floored at a stop)
+#if defined(PARTICLES_SSE)
+    __m128 dt = _mm_set1_ps(deltaTime);
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 zero = _mm_setzero_ps();
+
+    for (; i < count; i += 4)       // Lanes past count are padding inside the capacity
+    {
+        __m128 vx = _mm_loadu_ps(system->vx + i);
+        __m128 vy = _mm_loadu_ps(system->vy + i);
+        __m128 damping = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(_mm_loadu_ps(system->drag + i), dt)));
+
+        _mm_storeu_ps(system->x + i, _mm_add_ps(_mm_loadu_ps(system->x + i), _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(system->y + i, _mm_add_ps(_mm_loadu_ps(system->y + i), _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(system->vx + i, _mm_mul_ps(vx, damping));
+        _mm_storeu_ps(system->vy + i, _mm_mul_ps(vy, damping));
+        _mm_storeu_ps(system->life + i, _mm_sub_ps(_mm_loadu_ps(system->life + i), dt));
+    }
+#else
+    for (; i < count; i++)
+    {
+        float damping = fmaxf(0.0f, 1.0f - system->drag[i]*deltaTime);
+        system->x[i] += system->vx[i]*deltaTime;
+        system->y[i] += system->vy[i]*deltaTime;
+        system->vx[i] *= damping;
+        system->vy[i] *= damping;
+        system->life[i] -= deltaTime;
+    }
+#endif
+
+    // Retire the dead: the last live particle fills each hole, so the front stays packed
+    i = 0;
+    while (i < count)
+    {
+        if (system->life[i] > 0.0f) i++;
+        else MoveParticle(system, i, --count);
+    }
+    system->count = count;
+}
+
+void DrawParticles(ParticleSystem *system)
+{
+    if (system->count == 0) return;
+
+    rlSetRenderBatchActive(&system->batch);
+    rlSetTexture(rlGetTextureIdDefault());
+    rlBegin(RL_QUADS);
+
+    for (int i = 0; i < system->count; i++)
+    {
+        // Fade out and shrink to half size over the lifetime
+        float left = system->life[i]*system->fade[i];
+        float half = system->size[i]*(0.25f + 0.25f*left);
+        float x = system->x[i], y = system->y[i];
+        Color color = system->color[i];
+
+        rlColor4ub(color.r, color.g, color.b, (unsigned char)(color.a*left));
+        rlTexCoord2f(0.0f, 0.0f);
+        rlVertex2f(x - half, y - half);
+        rlVertex2f(x - half, y + half);
+        rlVertex2f(x + half, y + half);
+        rlVertex2f(x + half, y - half);
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+    rlSetRenderBatchActive(NULL);   // Draws the pool in one call, back to raylib's batch
+}
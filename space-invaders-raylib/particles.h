@@ -0,0 +1,59 @@
+/*******************************************************************************************
+*
+*   Particles: a fixed-capacity pool for explosions, shot trails and thrusters
+*
+*   Particles live in structure-of-arrays form, alive ones packed at the front, so the
+*   per-frame integration (position, velocity drag, lifetime) runs four lanes at a time
+*   over contiguous floats. Dead particles are swapped out with the last live one. When
+*   the pool is full new particles are dropped, never reallocated. SetParticleLimit() lowers
+*   where "full" is, for the quality governor (quality.h) to shed particles under load.
+*
+*   DrawParticles() sends every particle as one quad through a render batch sized for the
+*   whole pool, so the lot goes out in a single draw call instead of one DrawRectangle()
+*   per particle.
+*
+********************************************************************************************/
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "platform.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ParticleEmitter {
+    Vector2 position;
+    Vector2 velocity;               // Added to every particle: the motion of the source
+    float angle;                    // Direction of emission, radians (0 = +x)
+    float spread;                   // Half-angle of the cone
+    float minSpeed, maxSpeed;       // Pixels per second
+    float minLife, maxLife;         // Seconds
+    float minSize, maxSize;         // Pixels
+    float drag;                     // Fraction of the velocity lost per second
+    Color colors[2];                // Each particle takes a random blend of the two
+    float rate;                     // Particles per second for UpdateParticleEmitter()
+    float pending;                  // Fractional particle carried to the next frame
+} ParticleEmitter;
+
+typedef struct ParticleSystem ParticleSystem;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+ParticleSystem *LoadParticleSystem(int capacity);
+void UnloadParticleSystem(ParticleSystem *system);
+void ClearParticles(ParticleSystem *system);
+int GetParticleCount(const ParticleSystem *system);
+void SetParticleLimit(ParticleSystem *system, int limit);      // Up to the capacity it was loaded with
+
+int EmitParticles(ParticleSystem *system, const ParticleEmitter *emitter, int count);     // Returns how many fitted
+void UpdateParticleEmitter(ParticleSystem *system, ParticleEmitter *emitter, float deltaTime);     // Continuous emission at emitter->rate
+void UpdateParticles(ParticleSystem *system, float deltaTime);
+void DrawParticles(ParticleSystem *system);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PARTICLES_H
@@ -1,13 +1,18 @@
-#include "raylib.h"
+#include "platform.h"
+#include "assets.h"
+#include "particles.h"
+#include "fixed.h"
+#include "collision.h"
+#include "jobs.h"
+#include "layers.h"
+#include "pacing.h"
+#include "quality.h"
+#include "scenes.h"
+#include "settings.h"
+#include "store.h"
+#include "textcache.h"
+#include <stdint.h>
 #include <stdlib.h>
-#include <math.h>
-
-#if defined(PLATFORM_WEB)
-    #include <emscripten/emscripten.h>
-#endif
-
-// Game states
-typedef enum { MENU, PLAY, SETTINGS, HOW_TO_PLAY } GameScreen;
 
 // Enemy waves
 typedef enum { FIRST = 0, SECOND, THIRD } EnemyWave;
@@ -17,26 +22,32 @@ typedef enum { FIRST = 0, SECOND, THIRD } EnemyWave;
 #define NUM_MAX_ENEMIES 50
 #define FIRST_WAVE 10
 #define MAX_MENU_ITEMS 4
+#define MAX_PARTICLES 131072
+#define ENTITY_GRAIN 16     // Entities per job: smaller batches cost more to hand out than to run
+#define SHOT_SPEED IntToFixed(15)
+#define MAX_SWEEP_PAIRS ((NUM_SHOOTS + 1) * NUM_MAX_ENEMIES)   // Every shot and the player against every enemy
 
 // Game Structure
-typedef struct Player { Rectangle rec; Vector2 speed; Color color; } Player;
-typedef struct Enemy  { Rectangle rec; Vector2 speed; bool active; Color color; } Enemy;
-typedef struct Shoot  { Rectangle rec; Vector2 speed; bool active; Color color; } Shoot;
+// Simulation state is fixed-point (fixed.h), so a seed and its input replay the same on any build
+typedef struct Player { FixedRect rec; FixedVector2 speed; Color color; } Player;
+typedef struct Enemy  { FixedRect rec; FixedVector2 speed; bool active; Color color; } Enemy;
+typedef struct Shoot  { FixedRect rec; FixedVector2 speed; bool active; Color color; } Shoot;
+typedef struct Hit    { Fixed time; int shot; int enemy; } Hit;    // shot -1: the player
 
 // Global Variables
 static const int screenWidth = 800;
 static const int screenHeight = 600;
-static GameScreen currentScreen = MENU;
 static int menuItemSelected = 0;
 static const char* menuItems[MAX_MENU_ITEMS] = { "PLAY", "HOW TO PLAY", "SETTINGS", "EXIT" };
 static int scorePerKill = 100;
-static Texture2D playerTexture;
-static Texture2D enemyTexture;
+static AssetHandle playerTexture;
+static AssetHandle enemyTexture;
 static float playerScale = 0.175f;  
 static float enemyScale  = 0.175f;  
 
 static bool gameOver = false;
 static int score = 0;
+static int scoreRank = -1;          // On the high-score board (store.h) once the game is over
 static int activeEnemies = FIRST_WAVE;
 static EnemyWave wave = FIRST;
 
@@ -44,92 +55,192 @@ static Player player = { 0 };
 static Enemy enemy[NUM_MAX_ENEMIES] = { 0 };
 static Shoot shoot[NUM_SHOOTS]   = { 0 };
 
+// Particles: one pool, emitters shaped per effect
+static ParticleSystem *particles = NULL;
+
+// Static screens and the score, redrawn into their textures only when what they show changes
+static ScreenLayer menuLayer = { 0 };
+static ScreenLayer settingsLayer = { 0 };
+static ScreenLayer howToPlayLayer = { 0 };
+static ScreenLayer scoreLayer = { 0 };
+
+// Per-frame results of the parallel phases, one slot per entity, merged in index order
+_Static_assert(NUM_MAX_ENEMIES <= 64, "shotTargets holds one bit per enemy");
+static bool enemyWrapped[NUM_MAX_ENEMIES];
+static uint64_t shotTargets[NUM_SHOOTS];
+
+// Collision: where everything started the frame and how far it moved, tested as swept boxes
+// so a shot that jumps clean over an enemy between two frames still hits it
+static SweptRec playerSweep;
+static SweptRec enemySweep[NUM_MAX_ENEMIES];
+static SweptRec shotSweep[NUM_SHOOTS];
+static SweepBands enemyBands;
+static SweepBatch *sweeps = NULL;
+static Hit hits[MAX_SWEEP_PAIRS];
+static atomic_int enemiesAlive;
+static ParticleEmitter thruster = {
+    .angle = PI, .spread = 0.25f, .minSpeed = 60, .maxSpeed = 160, .minLife = 0.15f, .maxLife = 0.4f,
+    .minSize = 2, .maxSize = 5, .drag = 1.5f, .colors = { { 80, 180, 255, 255 }, { 255, 255, 255, 200 } }, .rate = 240 };
+static const ParticleEmitter explosion = {
+    .angle = 0, .spread = PI, .minSpeed = 40, .maxSpeed = 320, .minLife = 0.3f, .maxLife = 1.1f,
+    .minSize = 2, .maxSize = 7, .drag = 2.5f, .colors = { { 255, 230, 120, 255 }, { 230, 41, 55, 255 } } };
+static const ParticleEmitter shotTrail = {
+    .angle = PI, .spread = 0.15f, .minSpeed = 20, .maxSpeed = 90, .minLife = 0.1f, .maxLife = 0.25f,
+    .minSize = 1, .maxSize = 3, .drag = 3.0f, .colors = { { 255, 255, 255, 220 }, { 120, 220, 255, 160 } } };
+
+// Telemetry (see telemetry.h)
+static TelemetryMetric *roundsStarted = NULL;
+static TelemetryMetric *kills = NULL;
+static TelemetryMetric *enemiesGauge = NULL;
+static TelemetryMetric *shotsGauge = NULL;
+static TelemetryMetric *particlesGauge = NULL;
+
 // Audio
-static Music bgMusic;
-static Sound shootSound;
-static Sound explosionSound;
-static bool musicOn = true;
-static float musicVolume = 0.5f;
-static bool isFullscreen = false;
+static AssetHandle bgMusic;
+static AssetHandle shootSound;
+static AssetHandle explosionSound;
 
 void InitGame(void);
 void UpdateGame(void);
 void DrawGame(void);
 void UnloadGame(void);
+void EmitExplosion(FixedRect rec, int count);
+void PlaceEnemy(Enemy *e);
 
-void DrawMainMenu() {
-    BeginDrawing();
-        ClearBackground(BLACK);
-        DrawText("SPACE INVADERS", screenWidth/2 - MeasureText("SPACE INVADERS", 50)/2, 50, 50, GREEN);
+// Screens (scenes.h): the menu preloads play, settings and how to play sit on top of the menu
+static const Scene menuScene, settingsScene, howToPlayScene, playScene;
+
+void UpdateMainMenu(void) {
+    if (IsKeyPressed(KEY_DOWN)) menuItemSelected = (menuItemSelected + 1) % MAX_MENU_ITEMS;
+    if (IsKeyPressed(KEY_UP))   menuItemSelected = (menuItemSelected - 1 + MAX_MENU_ITEMS) % MAX_MENU_ITEMS;
+    if (IsKeyPressed(KEY_ENTER)) {
+        switch (menuItemSelected) {
+            case 0: SwitchScene(&playScene);      break;
+            case 1: PushScene(&howToPlayScene);   break;
+            case 2: PushScene(&settingsScene);    break;
+            case 3: QuitScenes();                 break;
+        }
+    }
+}
+
+void DrawMainMenu(void) {
+    ClearBackground(BLACK);
+    if (BeginScreenLayer(&menuLayer, MixLayerKey(0, menuItemSelected))) {
+        DrawTextCached("SPACE INVADERS", screenWidth/2 - MeasureTextCached("SPACE INVADERS", 50)/2, 50, 50, GREEN);
         for (int i = 0; i < MAX_MENU_ITEMS; i++) {
             Color color = (i == menuItemSelected) ? GREEN : WHITE;
-            DrawText(menuItems[i],
-                     screenWidth/2 - MeasureText(menuItems[i], 40)/2,
+            DrawTextCached(menuItems[i],
+                     screenWidth/2 - MeasureTextCached(menuItems[i], 40)/2,
                      200 + i * 70, 40, color);
         }
-        DrawText("Use ARROW KEYS to navigate, ENTER to select",
-                 screenWidth/2 - MeasureText("Use ARROW KEYS to navigate, ENTER to select", 20)/2,
+        DrawTextCached("Use ARROW KEYS to navigate, ENTER to select",
+                 screenWidth/2 - MeasureTextCached("Use ARROW KEYS to navigate, ENTER to select", 20)/2,
                  screenHeight - 50, 20, WHITE);
-    EndDrawing();
+        EndScreenLayer(&menuLayer);
+    }
+    DrawScreenLayer(&menuLayer, WHITE);
 }
 
-void DrawSettings() {
-    BeginDrawing();
-        ClearBackground(BLACK);
-        DrawText("SETTINGS", screenWidth/2 - MeasureText("SETTINGS", 50)/2, 50, 50, GREEN);
-        DrawText(TextFormat("Fullscreen: %s (Press F)", isFullscreen ? "ON" : "OFF"), 50, 150, 30, WHITE);
-        DrawText(TextFormat("Music: %s (Press M)", musicOn ? "ON" : "OFF"),         50, 200, 30, WHITE);
-        DrawText(TextFormat("Volume: %.0f%% (LEFT/RIGHT)", musicVolume * 100),       50, 250, 30, WHITE);
-        DrawText("Press C to return to MENU",
-                 screenWidth/2 - MeasureText("Press C to return to MENU", 20)/2,
+// F, M and LEFT/RIGHT are the shared settings' keys (settings.h)
+void UpdateSettings(void) {
+    UpdateSettingsControls();
+    if (IsKeyPressed(KEY_C)) PopScene();
+}
+
+void DrawSettings(void) {
+    GameSettings settings = GetGameSettings();
+    unsigned int key = MixLayerKey(MixLayerKey(MixLayerKey(0, settings.fullscreen), settings.musicOn), (int)(settings.musicVolume * 1000));
+    ClearBackground(BLACK);
+    if (BeginScreenLayer(&settingsLayer, key)) {
+        DrawTextCached("SETTINGS", screenWidth/2 - MeasureTextCached("SETTINGS", 50)/2, 50, 50, GREEN);
+        DrawTextCached(FrameFormat("Fullscreen: %s (Press F)", settings.fullscreen ? "ON" : "OFF"), 50, 150, 30, WHITE);
+        DrawTextCached(FrameFormat("Music: %s (Press M)", settings.musicOn ? "ON" : "OFF"),         50, 200, 30, WHITE);
+        DrawText(FrameFormat("Volume: %.0f%% (LEFT/RIGHT)", settings.musicVolume * 100),          50, 250, 30, WHITE);
+        DrawTextCached("Press C to return to MENU",
+                 screenWidth/2 - MeasureTextCached("Press C to return to MENU", 20)/2,
                  screenHeight - 50, 20, WHITE);
-    EndDrawing();
+        EndScreenLayer(&settingsLayer);
+    }
+    DrawScreenLayer(&settingsLayer, WHITE);
 }
 
-void DrawHowToPlay() {
-    BeginDrawing();
-        ClearBackground(BLACK);
-        DrawText("HOW TO PLAY", screenWidth/2 - MeasureText("HOW TO PLAY", 50)/2, 50, 50, GREEN);
-        DrawText("MOVEMENT:", 50, 120, 30, WHITE);
-        DrawText("Use ARROW KEYS to move", 70, 160, 25, GREEN);
-        DrawText("SHOOTING:", 50, 200, 30, WHITE);
-        DrawText("Press SPACE to fire", 70, 240, 25, GREEN);
-        DrawText("OBJECTIVE:", 50, 280, 30, WHITE);
-        DrawText("Destroy all alien waves!", 70, 320, 25, GREEN);
-        DrawText("Press C to return to MENU",
-                 screenWidth/2 - MeasureText("Press C to return to MENU", 20)/2,
+void UpdateHowToPlay(void) {
+    if (IsKeyPressed(KEY_C)) PopScene();
+}
+
+void DrawHowToPlay(void) {
+    ClearBackground(BLACK);
+    if (BeginScreenLayer(&howToPlayLayer, 0)) {
+        DrawTextCached("HOW TO PLAY", screenWidth/2 - MeasureTextCached("HOW TO PLAY", 50)/2, 50, 50, GREEN);
+        DrawTextCached("MOVEMENT:", 50, 120, 30, WHITE);
+        DrawTextCached("Use ARROW KEYS to move", 70, 160, 25, GREEN);
+        DrawTextCached("SHOOTING:", 50, 200, 30, WHITE);
+        DrawTextCached("Press SPACE to fire", 70, 240, 25, GREEN);
+        DrawTextCached("OBJECTIVE:", 50, 280, 30, WHITE);
+        DrawTextCached("Destroy all alien waves!", 70, 320, 25, GREEN);
+        DrawTextCached("Press C to return to MENU",
+                 screenWidth/2 - MeasureTextCached("Press C to return to MENU", 20)/2,
                  screenHeight - 50, 20, WHITE);
-    EndDrawing();
+        EndScreenLayer(&howToPlayLayer);
+    }
+    DrawScreenLayer(&howToPlayLayer, WHITE);
+}
+
+// Play's assets are requested while the menu is up; the round starts once the textures are in
+void LoadPlayAssets(void) {
+    playerTexture   = RequestTexture("resources/space_player.png");
+    enemyTexture    = RequestTexture("resources/space_enemy.png");
+    shootSound      = RequestSound("resources/space_shoot.wav");
+    explosionSound  = RequestSound("resources/space_explosion.wav");
+}
+
+// Missing textures do not hold the game back: the ships are then sized 0 as before
+bool IsPlayReady(void) {
+    return (GetAssetState(playerTexture) != ASSET_LOADING) && (GetAssetState(enemyTexture) != ASSET_LOADING);
+}
+
+void StartGame(void) {
+    InitGame();
+    AddTelemetryCount(roundsStarted, 1);
+}
+
+bool IsPlayAnimating(void) { return true; }
+
+void UnloadPlayAssets(void) {
+    ReleaseAsset(shootSound);
+    ReleaseAsset(explosionSound);
+    ReleaseAsset(playerTexture);
+    ReleaseAsset(enemyTexture);
 }
 
 void InitGame(void) {
     score = 0;
+    scoreRank = -1;
     gameOver = false;
     wave = FIRST;
     activeEnemies = FIRST_WAVE;
     scorePerKill = 100;
 
-    // Load textures
-    playerTexture = LoadTexture("resources/space_player.png");
-    enemyTexture  = LoadTexture("resources/space_enemy.png");
+    // The play scene is only entered once the textures are in (IsPlayReady())
+    Texture2D playerTex = GetAssetTexture(playerTexture);
+    Texture2D enemyTex  = GetAssetTexture(enemyTexture);
 
     // Initialize player rectangle
-    player.rec.width  = playerTexture.width  * playerScale;
-    player.rec.height = playerTexture.height * playerScale;
-    player.rec.x = 20;
-    player.rec.y = 50;
-    player.speed.x = 5;
-    player.speed.y = 5;
+    player.rec.width  = FloatToFixed(playerTex.width  * playerScale);
+    player.rec.height = FloatToFixed(playerTex.height * playerScale);
+    player.rec.x = IntToFixed(20);
+    player.rec.y = IntToFixed(50);
+    player.speed.x = IntToFixed(5);
+    player.speed.y = IntToFixed(5);
     player.color = GREEN;
 
     // Initialize enemies with scaled size
     for (int i = 0; i < NUM_MAX_ENEMIES; i++) {
-        enemy[i].rec.width  = enemyTexture.width  * enemyScale;
-        enemy[i].rec.height = enemyTexture.height * enemyScale;
-        enemy[i].rec.x = GetRandomValue(screenWidth, screenWidth + 1000);
-        enemy[i].rec.y = GetRandomValue(0, screenHeight - enemy[i].rec.height);
-        enemy[i].speed.x = 5;
-        enemy[i].speed.y = 5;
+        enemy[i].rec.width  = FloatToFixed(enemyTex.width  * enemyScale);
+        enemy[i].rec.height = FloatToFixed(enemyTex.height * enemyScale);
+        PlaceEnemy(&enemy[i]);
+        enemy[i].speed.x = IntToFixed(5);
+        enemy[i].speed.y = IntToFixed(5);
         enemy[i].active  = true;
         enemy[i].color   = RED;
     }
@@ -139,80 +250,185 @@ void InitGame(void) {
         shoot[i].active = false;
         shoot[i].color  = WHITE;
     }
+
+    ClearParticles(particles);
 }
 
-void UpdateGame(void) {
-    if (!gameOver) {
-        // Player movement
-        if (IsKeyDown(KEY_RIGHT)) player.rec.x += player.speed.x;
-        if (IsKeyDown(KEY_LEFT))  player.rec.x -= player.speed.x;
-        if (IsKeyDown(KEY_UP))    player.rec.y -= player.speed.y;
-        if (IsKeyDown(KEY_DOWN))  player.rec.y += player.speed.y;
+// Burst from the centre of whatever blew up
+void EmitExplosion(FixedRect rec, int count) {
+    ParticleEmitter burst = explosion;
+    burst.position = (Vector2){ FixedToFloat(rec.x + rec.width/2), FixedToFloat(rec.y + rec.height/2) };
+    EmitParticles(particles, &burst, count);
+}
 
-        // Enemy-player collision
-        for (int i = 0; i < activeEnemies; i++) {
-            if (enemy[i].active && CheckCollisionRecs(player.rec, enemy[i].rec)) {
-                gameOver = true;
-                PlaySound(explosionSound);
-            }
+// Somewhere off the right edge, on a whole pixel
+void PlaceEnemy(Enemy *e) {
+    e->rec.x = IntToFixed(GetRandomValue(screenWidth, screenWidth + 1000));
+    e->rec.y = IntToFixed(GetRandomValue(0, FixedToInt(IntToFixed(screenHeight) - e->rec.height)));
+}
+
+// Jobs: each touches only its own range of enemy[]/shoot[] and the result slots beside them.
+// Anything random, audible or scored happens afterwards on the main thread, in index order,
+// so a replay comes out the same whatever the thread count
+static void MoveEnemies(void *data, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        enemyWrapped[i] = false;
+        if (enemy[i].active) {
+            enemySweep[i] = (SweptRec){ enemy[i].rec, (FixedVector2){ -enemy[i].speed.x, 0 } };
+            enemy[i].rec.x -= enemy[i].speed.x;
+            enemyWrapped[i] = (enemy[i].rec.x < 0);
         }
+    }
+}
 
-        // Enemy movement & wrap
-        for (int i = 0; i < activeEnemies; i++) {
-            if (enemy[i].active) {
-                enemy[i].rec.x -= enemy[i].speed.x;
-                if (enemy[i].rec.x < 0) {
-                    enemy[i].rec.x = GetRandomValue(screenWidth, screenWidth + 1000);
-                    enemy[i].rec.y = GetRandomValue(0, screenHeight - enemy[i].rec.height);
-                }
+// Every enemy whose band a shot's path crosses: only candidates, the sweep decides which it hits
+static void MoveShoots(void *data, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        shotTargets[i] = 0;
+        if (!shoot[i].active) continue;
+        shotSweep[i] = (SweptRec){ shoot[i].rec, (FixedVector2){ SHOT_SPEED, 0 } };
+        shoot[i].rec.x += SHOT_SPEED;
+        if (shoot[i].rec.x > IntToFixed(screenWidth)) shoot[i].active = false;
+        shotTargets[i] = QuerySweepBands(&enemyBands, shotSweep[i]);
+    }
+}
+
+// Earliest first; ties in pair order, so the outcome never depends on the sort
+static int CompareHits(const void *a, const void *b) {
+    const Hit *ha = (const Hit *)a, *hb = (const Hit *)b;
+    if (ha->time != hb->time) return (ha->time < hb->time) ? -1 : 1;
+    if (ha->shot != hb->shot) return (ha->shot < hb->shot) ? -1 : 1;
+    return (ha->enemy > hb->enemy) - (ha->enemy < hb->enemy);
+}
+
+// Every candidate pair swept at once, then resolved in time order: a shot stops at the first
+// enemy it reaches and an enemy dies once, however many shots cross it this frame
+static void ResolveSweeps(const bool *shotWasActive) {
+    ClearSweepBatch(sweeps);
+    for (uint64_t targets = QuerySweepBands(&enemyBands, playerSweep); targets != 0; targets &= targets - 1) {
+        int j = __builtin_ctzll(targets);
+        AddSweepPair(sweeps, playerSweep, -1, enemySweep[j], j);
+    }
+    for (int i = 0; i < NUM_SHOOTS; i++) {
+        if (!shotWasActive[i]) continue;
+        for (uint64_t targets = shotTargets[i]; targets != 0; targets &= targets - 1) {
+            int j = __builtin_ctzll(targets);
+            AddSweepPair(sweeps, shotSweep[i], i, enemySweep[j], j);
+        }
+    }
+    SweepPairs(sweeps);
+
+    int hitCount = 0;
+    for (int k = 0; k < sweeps->count; k++) {
+        if (sweeps->time[k] <= FIXED_ONE) hits[hitCount++] = (Hit){ sweeps->time[k], sweeps->first[k], sweeps->second[k] };
+    }
+    qsort(hits, hitCount, sizeof(Hit), CompareHits);
+
+    bool shotSpent[NUM_SHOOTS] = { 0 };
+    for (int k = 0; k < hitCount; k++) {
+        int i = hits[k].shot, j = hits[k].enemy;
+        if (!enemy[j].active) continue;
+        if (i < 0) {
+            if (!gameOver) {
+                EmitExplosion(GetSweptRecAt(playerSweep, hits[k].time), 4000);
+                PlayMixerSoundEx(GetAssetSound(explosionSound), 1.0f, 1.0f, 0.5f, 2);
+                scoreRank = AddStoreScore("scores", score);
             }
+            gameOver = true;
+        } else if (!shotSpent[i]) {
+            shotSpent[i] = true;
+            shoot[i].active = false;
+            enemy[j].active = false;
+            EmitExplosion(GetSweptRecAt(enemySweep[j], hits[k].time), 600);
+            PlayMixerSoundEx(GetAssetSound(explosionSound), 1.0f, 1.0f, 0.5f, 1);
+            score += scorePerKill;
+            AddTelemetryCount(kills, 1);
         }
+    }
+}
 
-        // Keep player on-screen
+static void CountAlive(void *data, int begin, int end) {
+    int alive = 0;
+    for (int i = begin; i < end; i++) alive += enemy[i].active;
+    if (alive > 0) atomic_fetch_add(&enemiesAlive, alive);
+}
+
+void UpdateGame(void) {
+    // Under load the governor (quality.h) lets fewer new particles in
+    SetParticleLimit(particles, (int)(MAX_PARTICLES * GetQuality().particleShare));
+
+    if (!gameOver) {
+        // Player movement, kept on-screen
+        FixedRect playerStart = player.rec;
+        Fixed right = IntToFixed(screenWidth) - player.rec.width;
+        Fixed bottom = IntToFixed(screenHeight) - player.rec.height;
+        if (IsKeyDown(KEY_RIGHT)) player.rec.x += player.speed.x;
+        if (IsKeyDown(KEY_LEFT))  player.rec.x -= player.speed.x;
+        if (IsKeyDown(KEY_UP))    player.rec.y -= player.speed.y;
+        if (IsKeyDown(KEY_DOWN))  player.rec.y += player.speed.y;
         if (player.rec.x < 0) player.rec.x = 0;
-        if (player.rec.x > screenWidth - player.rec.width)  player.rec.x = screenWidth - player.rec.width;
+        if (player.rec.x > right)  player.rec.x = right;
         if (player.rec.y < 0) player.rec.y = 0;
-        if (player.rec.y > screenHeight - player.rec.height) player.rec.y = screenHeight - player.rec.height;
+        if (player.rec.y > bottom) player.rec.y = bottom;
+        playerSweep = (SweptRec){ playerStart, (FixedVector2){ player.rec.x - playerStart.x, player.rec.y - playerStart.y } };
 
         // Shooting
         if (IsKeyPressed(KEY_SPACE)) {
             for (int i = 0; i < NUM_SHOOTS; i++) {
                 if (!shoot[i].active) {
-                    shoot[i].rec.width  = 10;
-                    shoot[i].rec.height = 5;
+                    shoot[i].rec.width  = IntToFixed(10);
+                    shoot[i].rec.height = IntToFixed(5);
                     shoot[i].active    = true;
                     shoot[i].rec.x     = player.rec.x + player.rec.width;
                     shoot[i].rec.y     = player.rec.y + player.rec.height/4;
-                    PlaySound(shootSound);
+                    PlayMixerSound(GetAssetSound(shootSound));
                     break;
                 }
             }
         }
 
-        // Update shoots & collisions
+        // Enemy and shot movement, with the enemies' paths banded for the shots to look up
+        bool shotWasActive[NUM_SHOOTS];
+        for (int i = 0; i < NUM_SHOOTS; i++) shotWasActive[i] = shoot[i].active;
+        ParallelFor(activeEnemies, ENTITY_GRAIN, MoveEnemies, NULL);
+        ClearSweepBands(&enemyBands, 0, IntToFixed(screenHeight));
+        for (int i = 0; i < activeEnemies; i++) {
+            if (enemy[i].active) AddSweepBands(&enemyBands, enemySweep[i], i);
+        }
+        ParallelFor(NUM_SHOOTS, ENTITY_GRAIN, MoveShoots, NULL);
+
+        // Collisions along the way, then enemies that left the screen come back on the right
+        ResolveSweeps(shotWasActive);
+        for (int i = 0; i < activeEnemies; i++) {
+            if (enemyWrapped[i] && enemy[i].active) PlaceEnemy(&enemy[i]);
+        }
+
+        // Thruster behind the ship, burning harder while moving forward
+        if (!gameOver) {
+            thruster.position = FixedVector2ToVector2((FixedVector2){ player.rec.x, player.rec.y + player.rec.height/2 });
+            thruster.rate = IsKeyDown(KEY_RIGHT) ? 900.0f : 240.0f;
+            UpdateParticleEmitter(particles, &thruster, GetFrameTime());
+        }
+
+        // Shot trails
         for (int i = 0; i < NUM_SHOOTS; i++) {
-            if (shoot[i].active) {
-                shoot[i].rec.x += 15;
-                if (shoot[i].rec.x > screenWidth) shoot[i].active = false;
-                for (int j = 0; j < activeEnemies; j++) {
-                    if (enemy[j].active && CheckCollisionRecs(shoot[i].rec, enemy[j].rec)) {
-                        shoot[i].active = false;
-                        enemy[j].active = false;
-                        PlaySound(explosionSound);
-                        score += scorePerKill;
-                        break;
-                    }
-                }
+            if (shotWasActive[i]) {
+                ParticleEmitter trail = shotTrail;
+                trail.position = FixedVector2ToVector2((FixedVector2){ shoot[i].rec.x, shoot[i].rec.y + shoot[i].rec.height/2 });
+                EmitParticles(particles, &trail, 4);
             }
         }
     } else {
-        if (IsKeyPressed(KEY_ENTER)) InitGame();
+        if (IsKeyPressed(KEY_ENTER)) StartGame();
     }
 
+    // Debris keeps flying behind the game over text
+    UpdateParticles(particles, GetFrameTime());
+
     // Wave progression
-    bool allDead = true;
-    for (int i = 0; i < activeEnemies; i++) { if (enemy[i].active) { allDead = false; break; } }
-    if (allDead) {
+    atomic_store(&enemiesAlive, 0);
+    ParallelFor(activeEnemies, ENTITY_GRAIN, CountAlive, NULL);
+    if (atomic_load(&enemiesAlive) == 0) {
         int nextCount = activeEnemies * 2;
         if (nextCount > NUM_MAX_ENEMIES) nextCount = NUM_MAX_ENEMIES;
         if (activeEnemies != nextCount) {
@@ -220,97 +436,112 @@ void UpdateGame(void) {
             scorePerKill  *= 2;
         }
         for (int i = 0; i < activeEnemies; i++) {
-            enemy[i].rec.x     = GetRandomValue(screenWidth, screenWidth + 1000);
-            enemy[i].rec.y     = GetRandomValue(0, screenHeight - enemy[i].rec.height);
+            PlaceEnemy(&enemy[i]);
             enemy[i].active    = true;
         }
     }
+
+    int shots = 0;
+    for (int i = 0; i < NUM_SHOOTS; i++) shots += shoot[i].active;
+    SetTelemetryGauge(enemiesGauge, atomic_load(&enemiesAlive));
+    SetTelemetryGauge(shotsGauge, shots);
+    SetTelemetryGauge(particlesGauge, GetParticleCount(particles));
 }
 
 void DrawGame(void) {
-    BeginDrawing();
-        ClearBackground(BLACK);
-        if (!gameOver) {
-            // Draw player scaled
-            DrawTexturePro(
-                playerTexture,
-                (Rectangle){ 0, 0, (float)playerTexture.width,  (float)playerTexture.height },
-                (Rectangle){ player.rec.x, player.rec.y, player.rec.width, player.rec.height },
-                (Vector2){ 0, 0 }, 0.0f, WHITE
-            );
-            // Draw enemies scaled
-            for (int i = 0; i < activeEnemies; i++) {
-                if (enemy[i].active) {
-                    DrawTexturePro(
-                        enemyTexture,
-                        (Rectangle){ 0, 0, (float)enemyTexture.width,  (float)enemyTexture.height },
-                        (Rectangle){ enemy[i].rec.x, enemy[i].rec.y, enemy[i].rec.width, enemy[i].rec.height },
-                        (Vector2){ 0, 0 }, 0.0f, WHITE
-                    );
-                }
-            }
-            // Draw shoots
-            for (int i = 0; i < NUM_SHOOTS; i++) {
-                if (shoot[i].active) DrawRectangleRec(shoot[i].rec, shoot[i].color);
+    Texture2D playerTex = GetAssetTexture(playerTexture);
+    Texture2D enemyTex  = GetAssetTexture(enemyTexture);
+
+    ClearBackground(BLACK);
+    if (!gameOver) {
+        // Draw player scaled
+        DrawTexturePro(
+            playerTex,
+            (Rectangle){ 0, 0, (float)playerTex.width,  (float)playerTex.height },
+            FixedRectToRectangle(player.rec),
+            (Vector2){ 0, 0 }, 0.0f, WHITE
+        );
+        // Draw enemies scaled
+        for (int i = 0; i < activeEnemies; i++) {
+            if (enemy[i].active) {
+                DrawTexturePro(
+                    enemyTex,
+                    (Rectangle){ 0, 0, (float)enemyTex.width,  (float)enemyTex.height },
+                    FixedRectToRectangle(enemy[i].rec),
+                    (Vector2){ 0, 0 }, 0.0f, WHITE
+                );
             }
-            DrawText(TextFormat("SCORE: %04d", score), 20, 20, 30, GREEN);
-        } else {
-            DrawText("GAME OVER!", screenWidth/2 - 130, screenHeight/2 - 50, 40, RED);
-            DrawText("PRESS ENTER TO RESTART", screenWidth/2 - 150, screenHeight/2 + 10, 20, WHITE);
         }
-    EndDrawing();
+        // Draw shoots
+        for (int i = 0; i < NUM_SHOOTS; i++) {
+            if (shoot[i].active) DrawRectangleRec(FixedRectToRectangle(shoot[i].rec), shoot[i].color);
+        }
+        DrawParticles(particles);
+        if (BeginScreenLayer(&scoreLayer, MixLayerKey(0, score))) {
+            DrawText(FrameFormat("SCORE: %04d", score), 20, 20, 30, GREEN);
+            EndScreenLayer(&scoreLayer);
+        }
+        DrawScreenLayer(&scoreLayer, WHITE);
+    } else {
+        DrawParticles(particles);
+        DrawTextCached("GAME OVER!", screenWidth/2 - 130, screenHeight/2 - 50, 40, RED);
+        DrawTextCached("PRESS ENTER TO RESTART", screenWidth/2 - 150, screenHeight/2 + 10, 20, WHITE);
+
+        StoreScore best = { 0 };
+        GetStoreTopScores("scores", &best, 1);
+        DrawTextCached(FrameFormat("BEST: %04d", (int)best.score), screenWidth/2 - 60, screenHeight/2 + 50, 20, GREEN);
+        if (scoreRank == 0) DrawTextCached("NEW HIGH SCORE!", screenWidth/2 - 90, screenHeight/2 + 80, 20, YELLOW);
+    }
 }
 
 void UnloadGame(void) {
-    UnloadMusicStream(bgMusic);
-    UnloadSound(shootSound);
-    UnloadSound(explosionSound);
-    UnloadTexture(playerTexture);
-    UnloadTexture(enemyTexture);
+    UnloadParticleSystem(particles);
+    UnloadSweepBatch(sweeps);
+    UnloadScreenLayer(&menuLayer);
+    UnloadScreenLayer(&settingsLayer);
+    UnloadScreenLayer(&howToPlayLayer);
+    UnloadScreenLayer(&scoreLayer);
+    ReleaseAsset(bgMusic);
 }
 
+static const Scene playScene = {
+    .name = "play", .preload = LoadPlayAssets, .isReady = IsPlayReady, .enter = StartGame,
+    .update = UpdateGame, .draw = DrawGame, .isAnimating = IsPlayAnimating, .unload = UnloadPlayAssets };
+static const Scene menuScene = { .name = "menu", .update = UpdateMainMenu, .draw = DrawMainMenu, .next = &playScene };
+static const Scene settingsScene = { .name = "settings", .update = UpdateSettings, .draw = DrawSettings };
+static const Scene howToPlayScene = { .name = "how to play", .update = UpdateHowToPlay, .draw = DrawHowToPlay };
+
 int main(void) {
     InitWindow(screenWidth, screenHeight, "Space Invaders");
     InitAudioDevice();
-    bgMusic         = LoadMusicStream("resources/space_music.wav");
-    shootSound      = LoadSound("resources/space_shoot.wav");
-    explosionSound  = LoadSound("resources/space_explosion.wav");
-    SetMusicVolume(bgMusic, musicVolume);
-    PlayMusicStream(bgMusic);
-    SetTargetFPS(60);
-    while (!WindowShouldClose()) {
-        UpdateMusicStream(bgMusic);
-        switch (currentScreen) {
-            case MENU:
-                if (IsKeyPressed(KEY_DOWN)) menuItemSelected = (menuItemSelected + 1) % MAX_MENU_ITEMS;
-                if (IsKeyPressed(KEY_UP))   menuItemSelected = (menuItemSelected - 1 + MAX_MENU_ITEMS) % MAX_MENU_ITEMS;
-                if (IsKeyPressed(KEY_ENTER)) {
-                    switch (menuItemSelected) {
-                        case 0: currentScreen = PLAY;     InitGame(); break;
-                        case 1: currentScreen = HOW_TO_PLAY;           break;
-                        case 2: currentScreen = SETTINGS;             break;
-                        case 3: CloseWindow();                        break;
-                    }
-                }
-                DrawMainMenu(); break;
-            case SETTINGS:
-                if (IsKeyPressed(KEY_F)) ToggleFullscreen();
-                if (IsKeyPressed(KEY_M)) {
-                    musicOn = !musicOn;
-                    if (musicOn) PlayMusicStream(bgMusic); else StopMusicStream(bgMusic);
-                }
-                if (IsKeyDown(KEY_LEFT))  musicVolume = fmaxf(0.0f, musicVolume - 0.01f);
-                if (IsKeyDown(KEY_RIGHT)) musicVolume = fminf(1.0f, musicVolume + 0.01f);
-                SetMusicVolume(bgMusic, musicVolume);
-                if (IsKeyPressed(KEY_C)) currentScreen = MENU;
-                DrawSettings(); break;
-            case HOW_TO_PLAY:
-                if (IsKeyPressed(KEY_C)) currentScreen = MENU;
-                DrawHowToPlay(); break;
-            case PLAY:
-                UpdateGame(); DrawGame(); break;
-        }
+    InitMixer(0);
+    InitAssets(0);
+    InitJobs(0);
+    InitTelemetry("spaceinvaders");
+    OpenStore("spaceinvaders");
+    MountAssetPack("resources.pak");
+    roundsStarted   = RegisterTelemetryCounter("games_rounds_total", "Games started");
+    kills           = RegisterTelemetryCounter("spaceinvaders_kills_total", "Enemies shot down");
+    enemiesGauge    = RegisterTelemetryGauge("spaceinvaders_entities{kind=\"enemy\"}", "Live entities");
+    shotsGauge      = RegisterTelemetryGauge("spaceinvaders_entities{kind=\"shot\"}", "Live entities");
+    particlesGauge  = RegisterTelemetryGauge("spaceinvaders_entities{kind=\"particle\"}", "Live entities");
+    bgMusic         = RequestMusic("resources/space_music.wav");
+    particles       = LoadParticleSystem(MAX_PARTICLES);
+    sweeps          = LoadSweepBatch(MAX_SWEEP_PAIRS);
+    menuLayer       = LoadScreenLayer(0, 0, screenWidth, screenHeight);
+    settingsLayer   = LoadScreenLayer(0, 0, screenWidth, screenHeight);
+    howToPlayLayer  = LoadScreenLayer(0, 0, screenWidth, screenHeight);
+    scoreLayer      = LoadScreenLayer(0, 0, 320, 60);
+    if ((particles == NULL) || (sweeps == NULL)) {
+        // The frame loop never checks them, so stop before the first frame
+        TraceLog(LOG_WARNING, "GAME: Failed to allocate particles (%i) or collision pairs (%i)", MAX_PARTICLES, MAX_SWEEP_PAIRS);
+        UnloadGame(); CloseStore(); CloseTelemetry(); CloseJobs(); CloseAssets(); CloseMixer(); CloseAudioDevice(); CloseWindow();
+        return 1;
     }
-    UnloadGame(); CloseAudioDevice(); CloseWindow();
+    InitFramePacing(60);
+    InitScenes(&menuScene, SCENE_TRANSITION_SECONDS);
+    SetSceneMusic(bgMusic);
+    RunScenes();
+    CloseScenes(); UnloadGame(); CloseStore(); CloseTelemetry(); CloseJobs(); CloseAssets(); CloseMixer(); CloseAudioDevice(); CloseWindow();
     return 0;
 }
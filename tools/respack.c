@@ -0,0 +1,266 @@
+/*******************************************************************************************
+*
+*   respack - build-time resource packer (see common/pack.h for the format)
+*
+*   Usage: respack [--max-raw-kb N] <output.pak> <root> <file>...
+*
+*   Each <file> is read from <root>/<file> and stored under the name <file>, which is the
+*   path the game passes to RequestTexture()/RequestSound()/RequestMusic().
+*
+*   With raylib available, images are decoded once here and stored as raw pixels so the
+*   game can upload them straight from the mapping (images whose raw size would exceed
+*   --max-raw-kb, default 1024, stay encoded to keep the pack small), and WAV files are
+*   re-encoded as QOA when that is smaller. Headless builds have no decoders and store every
+*   file as-is, which still gives a single mapped file with one index.
+*
+********************************************************************************************/
+#include "platform.h"
+#include "pack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct PackItem {
+    PackEntry entry;
+    const char *name;
+    unsigned char *data;
+    size_t size;
+    bool ownedByRaylib;         // data must be released with MemFree()/UnloadImage()
+} PackItem;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static unsigned char *LoadFileBytes(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char *data = (unsigned char *)malloc((length > 0)? (size_t)length : 1);
+    if ((data != NULL) && (length > 0) && (fread(data, 1, (size_t)length, file) != (size_t)length))
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+
+    *size = (data != NULL)? (size_t)length : 0;
+    return data;
+}
+
+#if !defined(PLATFORM_HEADLESS)
+static bool HasExtension(const char *name, const char *extensions)
+{
+    const char *dot = strrchr(name, '.');
+    if (dot == NULL) return false;
+
+    char ext[16] = { 0 };
+    for (int i = 0; (dot[i] != '\0') && (i < 15); i++) ext[i] = (char)((dot[i] >= 'A' && dot[i] <= 'Z')? dot[i] + 32 : dot[i]);
+
+    size_t length = strlen(ext);
+    for (const char *p = strstr(extensions, ext); p != NULL; p = strstr(p + 1, ext))
+    {
+        if ((p[length] == ';') || (p[length] == '\0')) return true;
+    }
+    return false;
+}
+
+// Decode once at build time so the game uploads the pixels as they are
+static bool ConvertImage(PackItem *item, const char *path, size_t maxRawBytes)
+{
+    Image image = LoadImage(path);
+    if (image.data == NULL) return false;
+
+    int rawSize = GetPixelDataSize(image.width, image.height, image.format);
+    if ((size_t)rawSize > maxRawBytes)
+    {
+        UnloadImage(image);
+        return false;
+    }
+
+    free(item->data);
+    item->data = (unsigned char *)image.data;
+    item->size = (size_t)rawSize;
+    item->ownedByRaylib = true;
+    item->entry.kind = PACK_ENTRY_IMAGE;
+    item->entry.format = (uint32_t)image.format;
+    item->entry.width = image.width;
+    item->entry.height = image.height;
+    return true;
+}
+
+// raylib can only export QOA to a file, so round-trip through a temporary next to the output
+static bool ConvertWave(PackItem *item, const char *path, const char *tempPath)
+{
+    Wave wave = LoadWave(path);
+    if (wave.data == NULL) return false;
+
+    bool exported = (wave.sampleSize == 16) && ExportWave(wave, tempPath);
+    UnloadWave(wave);
+    if (!exported) return false;
+
+    size_t size = 0;
+    unsigned char *data = LoadFileBytes(tempPath, &size);
+    remove(tempPath);
+
+    if ((data == NULL) || (size >= item->size))
+    {
+        free(data);
+        return false;
+    }
+
+    free(item->data);
+    item->data = data;
+    item->size = size;
+    item->entry.kind = PACK_ENTRY_QOA;
+    return true;
+}
+#endif
+
+static int CompareItems(const void *a, const void *b)
+{
+    const PackItem *itemA = (const PackItem *)a;
+    const PackItem *itemB = (const PackItem *)b;
+
+    if (itemA->entry.nameHash != itemB->entry.nameHash) return (itemA->entry.nameHash < itemB->entry.nameHash)? -1 : 1;
+    return strcmp(itemA->name, itemB->name);
+}
+
+static bool WritePadding(FILE *file, uint64_t *offset)
+{
+    static const unsigned char zeros[PACK_DATA_ALIGNMENT] = { 0 };
+    size_t padding = (size_t)((PACK_DATA_ALIGNMENT - (*offset % PACK_DATA_ALIGNMENT)) % PACK_DATA_ALIGNMENT);
+
+    *offset += padding;
+    return fwrite(zeros, 1, padding, file) == padding;
+}
+
+static bool WritePack(const char *outputPath, PackItem *items, int count)
+{
+    FILE *file = fopen(outputPath, "wb");
+    if (file == NULL) return false;
+
+    PackHeader header = { 0 };
+    memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.entryCount = (uint32_t)count;
+
+    bool ok = (fwrite(&header, sizeof(header), 1, file) == 1);
+    uint64_t offset = sizeof(header);
+
+    for (int i = 0; ok && (i < count); i++)
+    {
+        ok = WritePadding(file, &offset) && (fwrite(items[i].data, 1, items[i].size, file) == items[i].size);
+        items[i].entry.offset = offset;
+        items[i].entry.size = items[i].size;
+        offset += items[i].size;
+    }
+
+    uint32_t stringsSize = 0;
+    for (int i = 0; i < count; i++)
+    {
+        items[i].entry.nameOffset = stringsSize;
+        stringsSize += (uint32_t)strlen(items[i].name) + 1;
+    }
+
+    ok = ok && WritePadding(file, &offset);
+    header.indexOffset = offset;
+    header.stringsSize = stringsSize;
+
+    for (int i = 0; ok && (i < count); i++) ok = (fwrite(&items[i].entry, sizeof(PackEntry), 1, file) == 1);
+    for (int i = 0; ok && (i < count); i++) ok = (fwrite(items[i].name, 1, strlen(items[i].name) + 1, file) == strlen(items[i].name) + 1);
+
+    ok = ok && (fseek(file, 0, SEEK_SET) == 0) && (fwrite(&header, sizeof(header), 1, file) == 1);
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok) remove(outputPath);
+    return ok;
+}
+
+//------------------------------------------------------------------------------------
+// Program Entry Point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    size_t maxRawBytes = 1024*1024;
+    int arg = 1;
+
+    if ((argc > arg + 1) && (strcmp(argv[arg], "--max-raw-kb") == 0))
+    {
+        maxRawBytes = (size_t)atol(argv[arg + 1])*1024;
+        arg += 2;
+    }
+
+    if (argc - arg < 3)
+    {
+        fprintf(stderr, "usage: respack [--max-raw-kb N] <output.pak> <root> <file>...\n");
+        return 1;
+    }
+
+    const char *outputPath = argv[arg];
+    const char *root = argv[arg + 1];
+    int count = argc - arg - 2;
+    char **names = argv + arg + 2;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    char tempPath[1024];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp.qoa", outputPath);
+
+    PackItem *items = (PackItem *)calloc((size_t)count, sizeof(PackItem));
+    size_t sourceBytes = 0;
+    size_t packedBytes = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", root, names[i]);
+
+        PackItem *item = &items[i];
+        item->name = names[i];
+        item->data = LoadFileBytes(path, &item->size);
+        if (item->data == NULL)
+        {
+            fprintf(stderr, "respack: cannot read %s\n", path);
+            return 1;
+        }
+
+        item->entry.nameHash = PackHashName(item->name);
+        item->entry.kind = PACK_ENTRY_FILE;
+        item->entry.sourceSize = (uint32_t)item->size;
+        sourceBytes += item->size;
+
+#if !defined(PLATFORM_HEADLESS)
+        if (HasExtension(item->name, ".png;.jpg;.jpeg;.bmp;.tga;.gif;.qoi")) ConvertImage(item, path, maxRawBytes);
+        else if (HasExtension(item->name, ".wav")) ConvertWave(item, path, tempPath);
+#else
+        (void)maxRawBytes;
+#endif
+        packedBytes += item->size;
+    }
+
+    qsort(items, (size_t)count, sizeof(PackItem), CompareItems);
+
+    bool ok = WritePack(outputPath, items, count);
+    if (ok) printf("respack: %s: %i entries, %zu KB source -> %zu KB packed\n", outputPath, count, sourceBytes/1024, packedBytes/1024);
+    else fprintf(stderr, "respack: failed to write %s\n", outputPath);
+
+    for (int i = 0; i < count; i++)
+    {
+#if !defined(PLATFORM_HEADLESS)
+        if (items[i].ownedByRaylib) { MemFree(items[i].data); continue; }
+#endif
+        free(items[i].data);
+    }
+    free(items);
+
+    return ok? 0 : 1;
+}
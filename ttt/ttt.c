@@ -1,14 +1,24 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
-#include <windows.h>
-#include <MMsystem.h>
+#if !defined(_WIN32)
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#include "console.h"
+#include "mixer.h"
+#include "telemetry.h"
+#include "ttt_mcts.h"
+#include "ttt_tablebase.h"
 
 #define COMPUTER 1
 #define HUMAN 2
 #define COMPUTERMOVE 'O'
 #define HUMANMOVE 'X'
+#define MCTS_SECONDS 0.3 // MCTS-iin neg nuudeld zartsuulah hugatsaa
 
 // Хамгийн сайн хөдөлгөөнийг хадгалах бүтэц
 struct Move {
@@ -18,6 +28,11 @@ struct Move {
 // Global variables
 char player = 'O', opponent = 'X';
 int difficulty = 3; // Default to Hard
+TttMcts *mcts = NULL; // 4-r tuvshnii MCTS hailt, togloom hoorond modoo dahin ashiglana
+TttTablebase *tablebase = NULL; // ttt-3x3.tb (ttt-tbgen), baihgui bol minimax ashiglana
+FILE *engineTo = NULL, *engineFrom = NULL; // ttt-engine (ttt_engine.c): hun bodoj baih zuur daraagiin nuudliig urid bodno
+TelemetryMetric *aiMoveTime = NULL; // computer-iin nuudel songoh hugatsaa (telemetry.h)
+TelemetryMetric *roundsStarted = NULL;
 
 // hudulguun uldsen eshiig shalgana
 bool isMovesLeft(char board[3][3]) {
@@ -90,10 +105,34 @@ int minimax(char board[3][3], int depth, bool isMax, int alpha, int beta) {
     }
 }
 
+// Tablebase-ees hamgiin sain nuudliig neg unshiltaar avna; tablebase-d 0-r toglogch ni ehelj nuusen tal
+bool findTablebaseMove(char board[3][3], struct Move *move) {
+    if (tablebase == NULL) return false;
+
+    uint64_t mine = 0, theirs = 0;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            if (board[i][j] == player) mine |= 1ULL << (i * 3 + j);
+            else if (board[i][j] == opponent) theirs |= 1ULL << (i * 3 + j);
+
+    // Chuluu tentsuu bol computer ehelsen
+    int me = (__builtin_popcountll(mine) == __builtin_popcountll(theirs)) ? 0 : 1;
+    TttBoard position = { { 0, 0 }, me };
+    position.stones[me] = mine;
+    position.stones[me ^ 1] = theirs;
+
+    int cell = GetTttTablebaseMove(tablebase, &position, NULL);
+    if (cell == TTT_NONE) return false;
+    move->row = cell / 3;
+    move->col = cell % 3;
+    return true;
+}
+
 // AI-iin best move oloh function
 struct Move findBestMove(char board[3][3]) {
     int bestVal = -1000;
     struct Move bestMove = {1, 1};
+    if (findTablebaseMove(board, &bestMove)) return bestMove;
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 3; j++) {
             if (board[i][j] == '_') {
@@ -121,48 +160,171 @@ struct Move makeRandomMove(char board[3][3]) {
     return move;
 }
 
+// ttt-engine-d tushaal ilgeej, prefix-eer ehelsen mor irtel unshina; engine untarsan bol false
+bool askEngine(const char *command, const char *prefix, char *reply, int size) {
+    if (fputs(command, engineTo) == EOF || fflush(engineTo) == EOF) return false;
+    while (fgets(reply, size, engineFrom) != NULL)
+        if (strncmp(reply, prefix, strlen(prefix)) == 0) return true;
+    return false;
+}
+
+void stopEngine() {
+    if (engineTo == NULL) return;
+    fputs("quit\n", engineTo);
+    fclose(engineTo);
+    fclose(engineFrom);
+    engineTo = engineFrom = NULL;
+#if !defined(_WIN32)
+    wait(NULL);
+#endif
+}
+
+// Ajillah havtasnaas ./ttt-engine-iig (duu shig) asaana; baihgui bol MCTS ene processdoo ajillana
+bool startEngine() {
+#if defined(_WIN32)
+    return false;
+#else
+    int toEngine[2], fromEngine[2];
+    if (pipe(toEngine) != 0) return false;
+    if (pipe(fromEngine) != 0) {
+        close(toEngine[0]);
+        close(toEngine[1]);
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(toEngine[0], STDIN_FILENO);
+        dup2(fromEngine[1], STDOUT_FILENO);
+        close(toEngine[0]);
+        close(toEngine[1]);
+        close(fromEngine[0]);
+        close(fromEngine[1]);
+        execl("./ttt-engine", "ttt-engine", (char *)NULL);
+        _exit(127);
+    }
+
+    close(toEngine[0]);
+    close(fromEngine[1]);
+    if (pid < 0) {
+        close(toEngine[1]);
+        close(fromEngine[0]);
+        return false;
+    }
+
+    signal(SIGPIPE, SIG_IGN); // engine untarval bichilt aldaa butsaana, process unahgui
+    engineTo = fdopen(toEngine[1], "w");
+    engineFrom = fdopen(fromEngine[0], "r");
+    char reply[128];
+    if (engineTo == NULL || engineFrom == NULL || !askEngine("ttt\n", "tttok", reply, sizeof(reply))) {
+        stopEngine();
+        return false;
+    }
+    return true;
+#endif
+}
+
+// Engine-ees nuudel asuuna: computeriin chuluu engine-d nuuh eeljtei tal bolno
+int askEngineMove(char board[3][3]) {
+    char cells[10], command[64], reply[128];
+    int computerStones = 0, humanStones = 0, cell = -1;
+    for (int i = 0; i < 9; i++) {
+        computerStones += (board[i / 3][i % 3] == COMPUTERMOVE);
+        humanStones += (board[i / 3][i % 3] == HUMANMOVE);
+    }
+    char computerMark = (computerStones == humanStones) ? 'x' : 'o';
+    for (int i = 0; i < 9; i++)
+        cells[i] = (board[i / 3][i % 3] == '_') ? '.' : (board[i / 3][i % 3] == COMPUTERMOVE) ? computerMark : (char)('x' + 'o' - computerMark);
+    cells[9] = '\0';
+
+    snprintf(command, sizeof(command), "position 3x3 cells %s\ngo movetime %d\n", cells, (int)(MCTS_SECONDS * 1000));
+    if (!askEngine(command, "bestmove", reply, sizeof(reply)) || sscanf(reply, "bestmove %d", &cell) != 1) {
+        stopEngine();
+        return -1;
+    }
+    return cell - 1;
+}
+
+// MCTS hudulguun: X ni 0-r, O ni 1-r toglogch
+struct Move makeMctsMove(char board[3][3]) {
+    static bool engineTried = false;
+    if (!engineTried) {
+        engineTried = true;
+        startEngine();
+    }
+    int cell = (engineTo != NULL) ? askEngineMove(board) : -1;
+    if (cell >= 0 && cell < 9 && board[cell / 3][cell % 3] == '_') {
+        struct Move move = {cell / 3, cell % 3};
+        return move;
+    }
+
+    if (mcts == NULL) {
+        TttMctsConfig config = { .maxNodes = 1 << 16, .seed = (unsigned long long)rand() };
+        mcts = LoadTttMcts(GetTttVariant(TTT_VARIANT_3X3), &config);
+        if (mcts == NULL) return findBestMove(board);
+    }
+
+    TttBoard position = { { 0, 0 }, 1 };
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            if (board[i][j] != '_') position.stones[board[i][j] == COMPUTERMOVE] |= 1ULL << (i * 3 + j);
+
+    SetTttMctsPosition(mcts, &position);
+    cell = SearchTttMcts(mcts, MCTS_SECONDS, 0, NULL);
+    struct Move move = {cell / 3, cell % 3};
+    return move;
+}
+
 // Dundaj hudulguun hiine
 struct Move makeMediumMove(char board[3][3]) {
     return (rand() % 2 == 0) ? makeRandomMove(board) : findBestMove(board);
 }
 
+// Delgetsiin oorchlogdson hesgiig zurj, daraa ni oroltyg unshina
+int readInput(const char *format, void *value) {
+    ConsolePresent();
+    int result = scanf(format, value);
+    ConsolePrint("\n"); // terminal Enter-iig haruulsan tul kursor daraagiin mort shiljsen
+    return result;
+}
+
 //her hetsuug n songoh function
 void ChooseDifficulty() {
-    printf("Her hetsuug n songo: 1. Amarhan  2. dundaj  3. Hetsuu\n");
-    while (scanf("%d", &difficulty) != 1 || difficulty < 1 || difficulty > 3) {
-        printf("Buruu songolt baina! 1, 2, 3 ali negiig n songo: ");
+    ConsolePrint("Her hetsuug n songo: 1. Amarhan  2. dundaj  3. Hetsuu  4. MCTS\n");
+    while (readInput("%d", &difficulty) != 1 || difficulty < 1 || difficulty > 4) {
+        ConsolePrint("Buruu songolt baina! 1, 2, 3, 4 ali negiig n songo: ");
         while (getchar() != '\n');
     }
 }
 
 // talbariig haruulah function
 void showBoard(char board[3][3]) {
-    system("cls"); //umnuh talbariig ustgana
-    printf("\n");
+    ConsoleClear(); //umnuh talbariig ustgana
+    ConsolePrint("\n");
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 3; j++) {
-            printf(" %c ", board[i][j]);
-            if (j < 2) printf("|");
+            ConsolePrint(" %c ", board[i][j]);
+            if (j < 2) ConsolePrint("|");
         }
-        if (i < 2) printf("\n-----------\n");
+        if (i < 2) ConsolePrint("\n-----------\n");
     }
-    printf("\n\n");
+    ConsolePrint("\n\n");
 }
 
 // Ur dung shalgana hojson tsenssen ylsan eshyg
 bool checkWinner(char board[3][3]) {
     int score = evaluate(board);
     if (score == 10) {
-        printf("HOJIGDCHIHLOO SUGAA!\n");
-        PlaySound(TEXT("Lose.wav"), NULL, SND_ASYNC);
+        ConsolePrint("HOJIGDCHIHLOO SUGAA!\n");
+        ConsolePlaySound("Lose.wav", CONSOLE_SOUND_ASYNC);
         return true;
     } else if (score == -10) {
-        printf("YALLAAA!\n");
-        PlaySound(TEXT("Victory.wav"), NULL, SND_ASYNC);
+        ConsolePrint("YALLAAA!\n");
+        ConsolePlaySound("Victory.wav", CONSOLE_SOUND_ASYNC);
         return true;
     } else if (!isMovesLeft(board)) {
-        printf("Uuu tentslee!\n");
-        PlaySound(TEXT("Lose.wav"), NULL, SND_ASYNC);
+        ConsolePrint("Uuu tentslee!\n");
+        ConsolePlaySound("Lose.wav", CONSOLE_SOUND_ASYNC);
         return true;
     }
     return false;
@@ -175,26 +337,28 @@ void playTicTacToe(int whoseTurn) {
     while (true) {
         int x, y;
         if (whoseTurn == COMPUTER) {
-            struct Move move = (difficulty == 1) ? makeRandomMove(board) : (difficulty == 2) ? makeMediumMove(board) : findBestMove(board);
+            uint64_t searchStart = GetTelemetryTicks();
+            struct Move move = (difficulty == 1) ? makeRandomMove(board) : (difficulty == 2) ? makeMediumMove(board) : (difficulty == 4) ? makeMctsMove(board) : findBestMove(board);
+            RecordTelemetrySince(aiMoveTime, searchStart);
             x = move.row;
             y = move.col;
             board[x][y] = COMPUTERMOVE;
-            printf("COMPUTER %c, %d tawilaa.\n", COMPUTERMOVE, x * 3 + y + 1);
+            ConsolePrint("COMPUTER %c, %d tawilaa.\n", COMPUTERMOVE, x * 3 + y + 1);
             showBoard(board);
             if (checkWinner(board)) return;
             whoseTurn = HUMAN;
         } else {
             int move;
-            printf("(1-9) too oruulj hudul: ");
-            if (scanf("%d", &move) != 1 || move < 1 || move > 9) {
-                printf("Buruu too baina 1ees 9iin hoorond too oruul.\n");
+            ConsolePrint("(1-9) too oruulj hudul: ");
+            if (readInput("%d", &move) != 1 || move < 1 || move > 9) {
+                ConsolePrint("Buruu too baina 1ees 9iin hoorond too oruul.\n");
                 while (getchar() != '\n');
                 continue;
             }
             x = (move - 1) / 3;
             y = (move - 1) % 3;
             if (board[x][y] != '_') {
-                printf("Buruu nuudel baina. Uur nud deer tavih gej uzne uu.\n");
+                ConsolePrint("Buruu nuudel baina. Uur nud deer tavih gej uzne uu.\n");
                 continue;
             }
             board[x][y] = HUMANMOVE;
@@ -209,16 +373,16 @@ void playTicTacToe(int whoseTurn) {
 void mainmenu() {
     int choice;
     while (1) {
-        system("cls");
-        PlaySound(TEXT("Background.wav"), NULL, SND_ASYNC | SND_LOOP);
-        printf("\n\033[1;32m==== TIC-TAC-TOE ====");
-        printf("\n1. Togloh (Play)");
-        printf("\n2. Zaavar (Instructions)");
-        printf("\n3. Garah (Quit)");
-        printf("\n\nSongoltoo hiine uu: ");
+        ConsoleClear();
+        ConsolePlaySound("Background.wav", CONSOLE_SOUND_ASYNC | CONSOLE_SOUND_LOOP);
+        ConsolePrint("\n\033[1;32m==== TIC-TAC-TOE ====");
+        ConsolePrint("\n1. Togloh (Play)");
+        ConsolePrint("\n2. Zaavar (Instructions)");
+        ConsolePrint("\n3. Garah (Quit)");
+        ConsolePrint("\n\nSongoltoo hiine uu: ");
         
-        if (scanf("%d", &choice) != 1) {
-            printf("Buruu songolt baina! 1, 2, 3 ali negiig songono uu.\n");
+        if (readInput("%d", &choice) != 1) {
+            ConsolePrint("Buruu songolt baina! 1, 2, 3 ali negiig songono uu.\n");
             while (getchar() != '\n');
             continue;
         }
@@ -226,46 +390,56 @@ void mainmenu() {
         if (choice == 1) {
             ChooseDifficulty();
             int firstMove;
-            printf("Ehleed nuuhuu? (1 = Tiim, 2 = Ugui): ");
-            while (scanf("%d", &firstMove) != 1 || (firstMove != 1 && firstMove != 2)) {
-                printf("Buruu songolt baina 1 esvel 2iig songo: ");
+            ConsolePrint("Ehleed nuuhuu? (1 = Tiim, 2 = Ugui): ");
+            while (readInput("%d", &firstMove) != 1 || (firstMove != 1 && firstMove != 2)) {
+                ConsolePrint("Buruu songolt baina 1 esvel 2iig songo: ");
                 while (getchar() != '\n');
             }
+            AddTelemetryCount(roundsStarted, 1);
             playTicTacToe(firstMove == 1 ? HUMAN : COMPUTER);
+            if (engineTo != NULL) { // toglolt duussan tul urid bodohoo boliulna
+                fputs("stop\n", engineTo);
+                fflush(engineTo);
+            }
             {
                 char c;
-                printf("Nuur huudasruu butsahuu esvel garahuu? (y/n): ");
-                while (scanf(" %c", &c) != 1 || (c != 'y' && c != 'n')) {
-                    printf("Buruu songolt baina! y esvel n songo: ");
+                ConsolePrint("Nuur huudasruu butsahuu esvel garahuu? (y/n): ");
+                while (readInput(" %c", &c) != 1 || (c != 'y' && c != 'n')) {
+                    ConsolePrint("Buruu songolt baina! y esvel n songo: ");
                     while (getchar() != '\n');
                 }
                 if (c == 'n'){
-                    printf("\nTogloomnoos garlaa. Bayartai!\033[0m\n");
+                    ConsolePrint("\nTogloomnoos garlaa. Bayartai!\033[0m\n");
                     break;
                 };
             }
         } 
         else if (choice == 2) {
-            system("cls");
-            printf("\n==== Zaavar ====");
-            printf("\n1. Door haragdah 1-9 hurtel dugaar oruulj toglono:\n");
-            printf("\n 1 | 2 | 3 ");
-            printf("\n-----------");
-            printf("\n 4 | 5 | 6 ");
-            printf("\n-----------");
-            printf("\n 7 | 8 | 9 \n");
-            printf("\n2. Hudulguunuu hiihyn tuld hooson nud songono.\n");
-            printf("\nUrd ni ajillaj baisan toglolt baival, shine toglolt exelne.\n");
-            printf("\nEnter darj main menu ruu orno uu.\n");
+            ConsoleClear();
+            ConsolePrint("\n==== Zaavar ====");
+            ConsolePrint("\n1. Door haragdah 1-9 hurtel dugaar oruulj toglono:\n");
+            ConsolePrint("\n 1 | 2 | 3 ");
+            ConsolePrint("\n-----------");
+            ConsolePrint("\n 4 | 5 | 6 ");
+            ConsolePrint("\n-----------");
+            ConsolePrint("\n 7 | 8 | 9 \n");
+            ConsolePrint("\n2. Hudulguunuu hiihyn tuld hooson nud songono.\n");
+            ConsolePrint("\nUrd ni ajillaj baisan toglolt baival, shine toglolt exelne.\n");
+            ConsolePrint("\nEnter darj main menu ruu orno uu.\n");
+            ConsolePresent();
             getchar();
             getchar();
         } 
         else if (choice == 3) {
-            printf("\nTogloomnoos garlaa. Bayartai!\033[0m\n");
+            ConsolePrint("\nTogloomnoos garlaa. Bayartai!\033[0m\n");
+            stopEngine();
+            CloseMixer();
+            CloseAudioDevice();
+            CloseTelemetry();
             exit(0);
         } 
         else {
-            printf("Buruu songolt baina! 1, 2, 3 ali negiig songono uu.\n");
+            ConsolePrint("Buruu songolt baina! 1, 2, 3 ali negiig songono uu.\n");
         }
     }
 }
@@ -273,6 +447,17 @@ void mainmenu() {
 
 int main() {
     srand(time(0));
+    tablebase = LoadTttTablebase("ttt-3x3.tb");
+    InitTelemetry("ttt");
+    // Duunuud mixer-eer damjina: Victory/Lose ni Background-iig tasalahgui
+    InitAudioDevice();
+    InitMixer(0);
+    aiMoveTime = RegisterTelemetryHistogram("ttt_ai_move_seconds", "Time the computer takes to choose a move", 1e-9);
+    roundsStarted = RegisterTelemetryCounter("games_rounds_total", "Games started");
     mainmenu();
+    stopEngine();
+    CloseMixer();
+    CloseAudioDevice();
+    CloseTelemetry();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,192 @@
+/*******************************************************************************************
+*
+*   ttt-arena - headless matches between tic-tac-toe engines on any variant
+*
+*   Usage: ttt-arena [--variant 3x3|4x4|4x4x4] [--games N] [--seed S] [--threads T]
+*                    [--first ENGINE] [--second ENGINE]
+*
+*   ENGINE is random, mcts[:milliseconds] (default 100 ms per move) or tb:<file> (perfect
+*   play from a ttt-tbgen tablebase of the same variant). The two engines swap sides every
+*   game, so "first"/"second" name engines, not colours. Each MCTS engine keeps its tree
+*   between its own moves, as in a real game.
+*
+********************************************************************************************/
+#include "ttt_mcts.h"
+#include "ttt_tablebase.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define DEFAULT_MOVE_MS     100
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ArenaEngine {
+    bool mcts;
+    int milliseconds;
+    TttMcts *search;
+    const char *tablebaseFile;      // tb:<file> engine
+    TttTablebase *tablebase;
+    long long playouts;             // Totals over the match
+    double seconds;
+    int moves;
+} ArenaEngine;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static bool ParseEngine(const char *text, ArenaEngine *engine)
+{
+    *engine = (ArenaEngine){ 0 };
+
+    if (strcmp(text, "random") == 0) return true;
+    if (strncmp(text, "tb:", 3) == 0)
+    {
+        engine->tablebaseFile = text + 3;
+        return true;
+    }
+    if (strncmp(text, "mcts", 4) != 0) return false;
+
+    engine->mcts = true;
+    engine->milliseconds = (text[4] == ':')? atoi(text + 5) : DEFAULT_MOVE_MS;
+    return ((text[4] == '\0') || (text[4] == ':')) && (engine->milliseconds > 0);
+}
+
+static int ChooseMove(const TttVariant *variant, const TttBoard *board, ArenaEngine *engine, unsigned long long *rng)
+{
+    if (engine->tablebase != NULL) return GetTttTablebaseMove(engine->tablebase, board, NULL);
+
+    if (!engine->mcts)
+    {
+        uint64_t empty = GetTttEmpty(variant, board);
+        *rng = *rng*6364136223846793005ULL + 1442695040888963407ULL;
+        for (int skip = (int)((*rng >> 33) % (unsigned long long)__builtin_popcountll(empty)); skip > 0; skip--) empty &= empty - 1;
+        return __builtin_ctzll(empty);
+    }
+
+    TttMctsStats stats;
+    SetTttMctsPosition(engine->search, board);
+    int move = SearchTttMcts(engine->search, engine->milliseconds/1000.0, 0, &stats);
+
+    engine->playouts += stats.playouts;
+    engine->seconds += stats.seconds;
+    engine->moves++;
+    return move;
+}
+
+static const char *GetEngineName(const ArenaEngine *engine)
+{
+    static char names[2][32];
+    static int next = 0;
+
+    char *name = names[next++ & 1];
+    if (engine->mcts) snprintf(name, 32, "mcts:%i", engine->milliseconds);
+    else if (engine->tablebaseFile != NULL) snprintf(name, 32, "tablebase");
+    else snprintf(name, 32, "random");
+    return name;
+}
+
+//------------------------------------------------------------------------------------
+// Program Entry Point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const TttVariant *variant = GetTttVariant(TTT_VARIANT_4X4);
+    ArenaEngine engines[2] = { { true, DEFAULT_MOVE_MS }, { false } };
+    int games = 20;
+    int threads = 0;
+    unsigned long long seed = 1;
+    bool ok = true;
+
+    for (int i = 1; ok && (i < argc); i++)
+    {
+        const char *value = (i + 1 < argc)? argv[i + 1] : NULL;
+        ok = (value != NULL);
+        if (!ok) break;
+
+        if (strcmp(argv[i], "--variant") == 0) ok = ((variant = FindTttVariant(value)) != NULL);
+        else if (strcmp(argv[i], "--games") == 0) games = atoi(value);
+        else if (strcmp(argv[i], "--seed") == 0) seed = strtoull(value, NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0) threads = atoi(value);
+        else if (strcmp(argv[i], "--first") == 0) ok = ParseEngine(value, &engines[0]);
+        else if (strcmp(argv[i], "--second") == 0) ok = ParseEngine(value, &engines[1]);
+        else ok = false;
+        i++;
+    }
+
+    if (!ok || (games <= 0))
+    {
+        fprintf(stderr, "usage: ttt-arena [--variant 3x3|4x4|4x4x4] [--games N] [--seed S] [--threads T]\n"
+                        "                 [--first ENGINE] [--second ENGINE]\n"
+                        "       ENGINE: random | mcts[:milliseconds] | tb:<file>\n");
+        return 1;
+    }
+
+    for (int e = 0; e < 2; e++)
+    {
+        if (engines[e].tablebaseFile != NULL)
+        {
+            engines[e].tablebase = LoadTttTablebase(engines[e].tablebaseFile);
+            if ((engines[e].tablebase == NULL) || (GetTttTablebaseVariant(engines[e].tablebase) != variant))
+            {
+                fprintf(stderr, "ttt-arena: %s is not a %s tablebase\n", engines[e].tablebaseFile, variant->name);
+                return 1;
+            }
+        }
+
+        if (!engines[e].mcts) continue;
+
+        TttMctsConfig config = { .threads = threads, .seed = seed + (unsigned long long)e };
+        engines[e].search = LoadTttMcts(variant, &config);
+        if (engines[e].search == NULL)
+        {
+            fprintf(stderr, "ttt-arena: out of memory for the search tree\n");
+            return 1;
+        }
+    }
+
+    int wins[2] = { 0 }, draws = 0;
+    long long totalMoves = 0;
+    unsigned long long rng = seed;
+
+    for (int game = 0; game < games; game++)
+    {
+        int xEngine = game & 1;         // Engine playing player 0 this game
+        TttBoard board = { { 0, 0 }, 0 };
+        int winner = TTT_NONE;
+
+        while (winner == TTT_NONE)
+        {
+            int move = ChooseMove(variant, &board, &engines[board.toMove ^ xEngine], &rng);
+            PlayTttMove(&board, move);
+            winner = GetTttWinner(variant, &board);
+            totalMoves++;
+        }
+
+        if (winner == TTT_DRAW) draws++;
+        else wins[winner ^ xEngine]++;
+    }
+
+    printf("ttt-arena: %s, %i games, %s vs %s, seed %llu\n", variant->name, games, GetEngineName(&engines[0]), GetEngineName(&engines[1]), seed);
+    printf("  %-10s wins %6i  %6.2f%%\n", GetEngineName(&engines[0]), wins[0], 100.0*wins[0]/games);
+    printf("  %-10s wins %6i  %6.2f%%\n", GetEngineName(&engines[1]), wins[1], 100.0*wins[1]/games);
+    printf("  draws           %6i  %6.2f%%\n", draws, 100.0*draws/games);
+    printf("  mean game length %.1f moves\n", (double)totalMoves/games);
+
+    for (int e = 0; e < 2; e++)
+    {
+        UnloadTttTablebase(engines[e].tablebase);
+        if (!engines[e].mcts) continue;
+
+        printf("  engine %i: %lld playouts in %.2f s (%.0f playouts/s, %.0f per move)\n", e + 1, engines[e].playouts, engines[e].seconds,
+               (engines[e].seconds > 0.0)? engines[e].playouts/engines[e].seconds : 0.0, (double)engines[e].playouts/(engines[e].moves? engines[e].moves : 1));
+        UnloadTttMcts(engines[e].search);
+    }
+
+    return 0;
+}
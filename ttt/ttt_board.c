@@ -0,0 +1,125 @@
+/*******************************************************************************************
+*
+*   Tic-tac-toe variants on 64-bit bitboards
+*
+*   Lines are generated rather than listed: from every cell, each of the 13 directions of a
+*   3D neighbourhood (one of each opposite pair) gives a line when the cell is where that
+*   line starts and the last cell is still on the board. Flat variants skip the directions
+*   that leave the layer.
+*
+********************************************************************************************/
+#include "ttt_board.h"
+
+#include <pthread.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static TttVariant variants[TTT_VARIANT_COUNT] = {
+    { TTT_VARIANT_3X3, "3x3", 3, 1 },
+    { TTT_VARIANT_4X4, "4x4", 4, 1 },
+    { TTT_VARIANT_4X4X4, "4x4x4", 4, 4 },
+};
+static pthread_once_t variantsOnce = PTHREAD_ONCE_INIT;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static bool IsOnBoard(const TttVariant *variant, int x, int y, int z)
+{
+    return (x >= 0) && (x < variant->size) && (y >= 0) && (y < variant->size) && (z >= 0) && (z < variant->layers);
+}
+
+static void BuildLines(TttVariant *variant)
+{
+    int n = variant->size;
+    variant->cells = n*n*variant->layers;
+    variant->full = (variant->cells == 64)? ~0ULL : (1ULL << variant->cells) - 1;
+
+    for (int z = 0; z < variant->layers; z++)
+    {
+        for (int y = 0; y < n; y++)
+        {
+            for (int x = 0; x < n; x++)
+            {
+                for (int dz = 0; dz <= 1; dz++)
+                {
+                    for (int dy = -1; dy <= 1; dy++)
+                    {
+                        for (int dx = -1; dx <= 1; dx++)
+                        {
+                            // One direction of each opposite pair: first non-zero component positive
+                            if ((dz == 0) && ((dy < 0) || ((dy == 0) && (dx <= 0)))) continue;
+                            if (!IsOnBoard(variant, x - dx, y - dy, z - dz) && IsOnBoard(variant, x + (n - 1)*dx, y + (n - 1)*dy, z + (n - 1)*dz))
+                            {
+                                uint64_t line = 0;
+                                for (int i = 0; i < n; i++) line |= 1ULL << (((z + i*dz)*n + y + i*dy)*n + x + i*dx);
+
+                                int index = variant->lineCount++;
+                                variant->lines[index] = line;
+                                for (int cell = 0; cell < variant->cells; cell++)
+                                {
+                                    if (line & (1ULL << cell)) variant->cellLines[cell][variant->cellLineCount[cell]++] = (unsigned char)index;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void BuildVariants(void)
+{
+    for (int i = 0; i < TTT_VARIANT_COUNT; i++) BuildLines(&variants[i]);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+const TttVariant *GetTttVariant(TttVariantId id)
+{
+    pthread_once(&variantsOnce, BuildVariants);
+    return ((id >= 0) && (id < TTT_VARIANT_COUNT))? &variants[id] : NULL;
+}
+
+const TttVariant *FindTttVariant(const char *name)
+{
+    for (int i = 0; i < TTT_VARIANT_COUNT; i++)
+    {
+        if (strcmp(variants[i].name, name) == 0) return GetTttVariant((TttVariantId)i);
+    }
+
+    return NULL;
+}
+
+bool IsTttWinningMove(const TttVariant *variant, uint64_t stones, int cell)
+{
+    stones |= 1ULL << cell;
+    for (int i = 0; i < variant->cellLineCount[cell]; i++)
+    {
+        uint64_t line = variant->lines[variant->cellLines[cell][i]];
+        if ((stones & line) == line) return true;
+    }
+
+    return false;
+}
+
+int GetTttWinner(const TttVariant *variant, const TttBoard *board)
+{
+    for (int i = 0; i < variant->lineCount; i++)
+    {
+        if ((board->stones[0] & variant->lines[i]) == variant->lines[i]) return 0;
+        if ((board->stones[1] & variant->lines[i]) == variant->lines[i]) return 1;
+    }
+
+    return (GetTttEmpty(variant, board) == 0)? TTT_DRAW : TTT_NONE;
+}
+
+void PlayTttMove(TttBoard *board, int cell)
+{
+    board->stones[board->toMove] |= 1ULL << cell;
+    board->toMove ^= 1;
+}
@@ -0,0 +1,73 @@
+/*******************************************************************************************
+*
+*   Tic-tac-toe variants on 64-bit bitboards: 3x3, 4x4 and 4x4x4 (Qubic)
+*
+*   Cell index is (layer*size + row)*size + column, so on 3x3 it matches the 1-9 numbering
+*   of ttt.c minus one. A line is n in a row along any row, column, diagonal, pillar or
+*   space diagonal; every variant needs a full line of its board size.
+*
+*   Player 0 moves first (X in ttt.c), player 1 second.
+*
+********************************************************************************************/
+#ifndef TTT_BOARD_H
+#define TTT_BOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define TTT_MAX_CELLS           64
+#define TTT_MAX_LINES           76      // Qubic
+#define TTT_MAX_CELL_LINES       7      // Lines through a Qubic corner
+
+#define TTT_DRAW                 2      // GetTttWinner() result for a full board without a line
+#define TTT_NONE                -1
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum TttVariantId {
+    TTT_VARIANT_3X3 = 0,
+    TTT_VARIANT_4X4,
+    TTT_VARIANT_4X4X4,
+    TTT_VARIANT_COUNT
+} TttVariantId;
+
+typedef struct TttVariant {
+    TttVariantId id;
+    const char *name;               // "3x3", "4x4", "4x4x4"
+    int size;                       // Cells per side
+    int layers;                     // 1, or size for the cube
+    int cells;
+    uint64_t full;                  // Mask of every cell
+    int lineCount;
+    uint64_t lines[TTT_MAX_LINES];
+    unsigned char cellLineCount[TTT_MAX_CELLS];
+    unsigned char cellLines[TTT_MAX_CELLS][TTT_MAX_CELL_LINES];
+} TttVariant;
+
+typedef struct TttBoard {
+    uint64_t stones[2];             // Indexed by player
+    int toMove;
+} TttBoard;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+const TttVariant *GetTttVariant(TttVariantId id);
+const TttVariant *FindTttVariant(const char *name);                     // NULL if unknown
+
+static inline uint64_t GetTttEmpty(const TttVariant *variant, const TttBoard *board) { return variant->full & ~(board->stones[0] | board->stones[1]); }
+
+bool IsTttWinningMove(const TttVariant *variant, uint64_t stones, int cell); // Does adding cell to stones complete a line through it
+int GetTttWinner(const TttVariant *variant, const TttBoard *board);     // 0, 1, TTT_DRAW or TTT_NONE while playing
+void PlayTttMove(TttBoard *board, int cell);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // TTT_BOARD_H
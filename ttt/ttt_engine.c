@@ -0,0 +1,321 @@
+/*******************************************************************************************
+*
+*   ttt-engine - the MCTS player as a separate process, one text command per line
+*
+*   Usage: ttt-engine [--threads T] [--seed S]
+*
+*   Commands on stdin, cells numbered from 1 as in ttt.c (cell index + 1, ttt_board.h):
+*
+*     ttt                               -> id name ttt-engine, id variants ..., tttok
+*     isready                           -> readyok, also while searching
+*     setoption ponder on|off           Default on
+*     setoption threads <T>
+*     newgame                           Forget the tree of the last game
+*     position <variant> [cells <c>] [moves <cell>...]
+*                                       c is one character per cell, x, o or '.'; the side
+*                                       to move follows from the counts (x moves first)
+*     go [movetime <ms>] [playouts <n>] [infinite]
+*                                       -> info ..., then bestmove <cell> [ponder <cell>],
+*                                          or bestmove none on a finished position
+*     stop                              End the running go now; it still answers bestmove
+*     quit
+*
+*   Without a limit go thinks DEFAULT_MOVE_MS. Once it has answered, the engine plays its
+*   own move on the tree and goes on searching the opponent's replies on the same thread
+*   until a command that needs the tree, so the position that follows finds its subtree
+*   warm (reported as info reused). stop, quit, position and go end a running go early
+*   (it still answers); newgame and setoption let it run out its limit first.
+*
+********************************************************************************************/
+#include "ttt_mcts.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define DEFAULT_MOVE_MS     1000
+#define MAX_COMMAND_LENGTH  1024
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum EngineJob {
+    JOB_NONE = 0,
+    JOB_GO,                         // Answers bestmove
+    JOB_PONDER                      // Answers nothing, runs until stopped
+} EngineJob;
+
+typedef struct Engine {
+    const TttVariant *variant;
+    TttMctsConfig config;
+    TttMcts *mcts;                  // Touched by the reader only while no job runs
+    TttBoard board;                 // Last position command
+    bool ponder;
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    pthread_t thread;
+    EngineJob pending;              // Posted by the reader, taken by the search thread
+    EngineJob running;
+    bool stopping;                  // No ponder may follow the job being stopped
+    bool cancelling;                // Nor may a go run out its limit
+    bool quit;
+    double seconds;                 // Limits of the pending go
+    long long playouts;
+} Engine;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static void *SearchMain(void *arg)
+{
+    Engine *engine = (Engine *)arg;
+
+    pthread_mutex_lock(&engine->lock);
+    for (;;)
+    {
+        while ((engine->pending == JOB_NONE) && !engine->quit) pthread_cond_wait(&engine->changed, &engine->lock);
+        if (engine->quit) break;
+
+        // Under the lock, so a stop is either seen here or sent once the search runs
+        EngineJob job = engine->pending;
+        engine->pending = JOB_NONE;
+        engine->running = job;
+        if (engine->cancelling) StopTttMcts(engine->mcts);
+        else ClearTttMctsStop(engine->mcts);
+        pthread_mutex_unlock(&engine->lock);
+
+        TttMctsStats stats;
+        if (job == JOB_GO) SearchTttMcts(engine->mcts, engine->seconds, engine->playouts, &stats);
+        else SearchTttMcts(engine->mcts, 0.0, 0, &stats);
+
+        pthread_mutex_lock(&engine->lock);
+        if (job == JOB_GO)
+        {
+            printf("info playouts %lld nodes %i reused %i value %.3f time %.0f\n", stats.playouts, stats.nodes,
+                   stats.reusedNodes, stats.bestValue, stats.seconds*1000.0);
+            if (stats.bestMove == TTT_NONE) printf("bestmove none\n");
+            else if (stats.ponderMove == TTT_NONE) printf("bestmove %i\n", stats.bestMove + 1);
+            else printf("bestmove %i ponder %i\n", stats.bestMove + 1, stats.ponderMove + 1);
+            fflush(stdout);
+
+            // Think on the opponent's time: our move is as good as played
+            TttBoard next = engine->board;
+            if (stats.bestMove != TTT_NONE) PlayTttMove(&next, stats.bestMove);
+            if (engine->ponder && !engine->stopping && (stats.bestMove != TTT_NONE) && (GetTttWinner(engine->variant, &next) == TTT_NONE))
+            {
+                SetTttMctsPosition(engine->mcts, &next);
+                engine->pending = JOB_PONDER;
+            }
+        }
+        engine->running = JOB_NONE;
+        pthread_cond_broadcast(&engine->changed);
+    }
+    pthread_mutex_unlock(&engine->lock);
+
+    return NULL;
+}
+
+// Ends the ponder, and the one a go would chain, and waits for the thread to idle. A go
+// running or not yet taken is cut short when cancel is set, else it runs out its limit;
+// either way it answers
+static void StopSearch(Engine *engine, bool cancel)
+{
+    pthread_mutex_lock(&engine->lock);
+    if (engine->pending == JOB_PONDER) engine->pending = JOB_NONE;
+    engine->stopping = true;
+    engine->cancelling = cancel;
+    if ((engine->running == JOB_PONDER) || (cancel && (engine->running == JOB_GO))) StopTttMcts(engine->mcts);
+
+    while ((engine->running != JOB_NONE) || (engine->pending != JOB_NONE)) pthread_cond_wait(&engine->changed, &engine->lock);
+
+    engine->stopping = false;
+    engine->cancelling = false;
+    pthread_mutex_unlock(&engine->lock);
+}
+
+static bool LoadSearch(Engine *engine, const TttVariant *variant)
+{
+    UnloadTttMcts(engine->mcts);
+    engine->variant = variant;
+    engine->board = (TttBoard){ { 0, 0 }, 0 };
+    engine->mcts = LoadTttMcts(variant, &engine->config);
+    return (engine->mcts != NULL);
+}
+
+// "cells x.o......" then "moves 5 1"; false, leaving board alone, on anything malformed
+static bool ParsePosition(const TttVariant *variant, char **next, TttBoard *board)
+{
+    TttBoard position = { { 0, 0 }, 0 };
+    char *token = strtok_r(NULL, " \t\r\n", next);
+
+    if ((token != NULL) && (strcmp(token, "cells") == 0))
+    {
+        const char *cells = strtok_r(NULL, " \t\r\n", next);
+        if ((cells == NULL) || ((int)strlen(cells) != variant->cells)) return false;
+
+        for (int i = 0; i < variant->cells; i++)
+        {
+            if ((cells[i] == 'x') || (cells[i] == 'X')) position.stones[0] |= 1ULL << i;
+            else if ((cells[i] == 'o') || (cells[i] == 'O')) position.stones[1] |= 1ULL << i;
+            else if (cells[i] != '.') return false;
+        }
+
+        int lead = __builtin_popcountll(position.stones[0]) - __builtin_popcountll(position.stones[1]);
+        if ((lead < 0) || (lead > 1)) return false;
+        position.toMove = lead;
+        token = strtok_r(NULL, " \t\r\n", next);
+    }
+
+    if ((token != NULL) && (strcmp(token, "moves") == 0))
+    {
+        while ((token = strtok_r(NULL, " \t\r\n", next)) != NULL)
+        {
+            char *end;
+            long cell = strtol(token, &end, 10) - 1;
+            if ((*end != '\0') || (cell < 0) || (cell >= variant->cells)) return false;
+            if (!(GetTttEmpty(variant, &position) & (1ULL << cell)) || (GetTttWinner(variant, &position) != TTT_NONE)) return false;
+            PlayTttMove(&position, (int)cell);
+        }
+    }
+    else if (token != NULL) return false;
+
+    *board = position;
+    return true;
+}
+
+static void StartGo(Engine *engine, char **next)
+{
+    double seconds = 0.0;
+    long long playouts = 0;
+    bool infinite = false;
+
+    for (char *token = strtok_r(NULL, " \t\r\n", next); token != NULL; token = strtok_r(NULL, " \t\r\n", next))
+    {
+        bool movetime = (strcmp(token, "movetime") == 0);
+        const char *value = (movetime || (strcmp(token, "playouts") == 0))? strtok_r(NULL, " \t\r\n", next) : NULL;
+
+        if (strcmp(token, "infinite") == 0) infinite = true;
+        else if (value == NULL) printf("info string go: ignoring %s\n", token);
+        else if (movetime) seconds = atof(value)/1000.0;
+        else playouts = atoll(value);
+    }
+    if (!infinite && (seconds <= 0.0) && (playouts <= 0)) seconds = DEFAULT_MOVE_MS/1000.0;
+
+    SetTttMctsPosition(engine->mcts, &engine->board);
+
+    pthread_mutex_lock(&engine->lock);
+    engine->seconds = infinite? 0.0 : seconds;
+    engine->playouts = infinite? 0 : playouts;
+    engine->pending = JOB_GO;
+    pthread_cond_broadcast(&engine->changed);
+    pthread_mutex_unlock(&engine->lock);
+}
+
+//------------------------------------------------------------------------------------
+// Program Entry Point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    Engine engine = { .ponder = true, .config = { .seed = 1 } };
+    bool ok = true;
+
+    for (int i = 1; ok && (i + 1 < argc); i += 2)
+    {
+        if (strcmp(argv[i], "--threads") == 0) engine.config.threads = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) engine.config.seed = strtoull(argv[i + 1], NULL, 10);
+        else ok = false;
+    }
+
+    if (!ok || (argc % 2 == 0))
+    {
+        fprintf(stderr, "usage: ttt-engine [--threads T] [--seed S]\n");
+        return 1;
+    }
+
+    if (!LoadSearch(&engine, GetTttVariant(TTT_VARIANT_3X3)))
+    {
+        fprintf(stderr, "ttt-engine: out of memory for the search tree\n");
+        return 1;
+    }
+
+    pthread_mutex_init(&engine.lock, NULL);
+    pthread_cond_init(&engine.changed, NULL);
+    if (pthread_create(&engine.thread, NULL, SearchMain, &engine) != 0)
+    {
+        fprintf(stderr, "ttt-engine: cannot start the search thread (%s)\n", strerror(errno));
+        return 1;
+    }
+
+    char line[MAX_COMMAND_LENGTH];
+    while (ok && (fgets(line, sizeof(line), stdin) != NULL))
+    {
+        char *next = NULL;
+        const char *command = strtok_r(line, " \t\r\n", &next);
+        if (command == NULL) continue;
+
+        bool cancels = (strcmp(command, "stop") == 0) || (strcmp(command, "quit") == 0) ||
+                       (strcmp(command, "position") == 0) || (strcmp(command, "go") == 0);
+        bool waits = (strcmp(command, "newgame") == 0) || (strcmp(command, "setoption") == 0);
+        if (cancels || waits) StopSearch(&engine, cancels);
+
+        if (strcmp(command, "isready") == 0) printf("readyok\n");
+        else if (strcmp(command, "ttt") == 0) printf("id name ttt-engine\nid variants 3x3 4x4 4x4x4\ntttok\n");
+        else if (strcmp(command, "quit") == 0) ok = false;
+        else if (strcmp(command, "stop") == 0) continue;
+        else if (strcmp(command, "go") == 0) StartGo(&engine, &next);
+        else if (strcmp(command, "newgame") == 0) ok = LoadSearch(&engine, engine.variant);
+        else if (strcmp(command, "setoption") == 0)
+        {
+            const char *name = strtok_r(NULL, " \t\r\n", &next);
+            const char *value = strtok_r(NULL, " \t\r\n", &next);
+
+            if ((name == NULL) || (value == NULL)) printf("info string setoption: missing name or value\n");
+            else if (strcmp(name, "ponder") == 0) engine.ponder = (strcmp(value, "on") == 0);
+            else if (strcmp(name, "threads") == 0)
+            {
+                TttBoard board = engine.board;
+                engine.config.threads = atoi(value);
+                ok = LoadSearch(&engine, engine.variant);
+                engine.board = board;
+            }
+            else printf("info string setoption: unknown option %s\n", name);
+        }
+        else if (strcmp(command, "position") == 0)
+        {
+            const char *name = strtok_r(NULL, " \t\r\n", &next);
+            const TttVariant *variant = (name != NULL)? FindTttVariant(name) : NULL;
+            TttBoard board;
+
+            if (variant == NULL) printf("info string position: unknown variant %s\n", (name != NULL)? name : "");
+            else if ((variant != engine.variant) && !(ok = LoadSearch(&engine, variant))) break;
+            else if (!ParsePosition(variant, &next, &board)) printf("info string position: illegal position, keeping the last one\n");
+            else
+            {
+                engine.board = board;
+                SetTttMctsPosition(engine.mcts, &board);
+            }
+        }
+        else printf("info string unknown command %s\n", command);
+
+        fflush(stdout);
+    }
+
+    if (engine.mcts == NULL) fprintf(stderr, "ttt-engine: out of memory for the search tree\n");
+
+    // At the end of input a go still answers in full; after quit nothing is running
+    StopSearch(&engine, false);
+    pthread_mutex_lock(&engine.lock);
+    engine.quit = true;
+    pthread_cond_broadcast(&engine.changed);
+    pthread_mutex_unlock(&engine.lock);
+    pthread_join(engine.thread, NULL);
+
+    UnloadTttMcts(engine.mcts);
+    return (engine.mcts == NULL)? 1 : 0;
+}
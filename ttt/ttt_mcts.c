@@ -0,0 +1,531 @@
+/*******************************************************************************************
+*
+*   Monte Carlo tree search for the tic-tac-toe variants
+*
+*   Node statistics are kept for the player who moved into the node, in half points (win 2,
+*   draw 1, loss 0), so selection maximises the same number at every level. A thread walking
+*   down adds its whole batch to the visit counts on the way (a virtual loss, as no score
+*   comes with it yet) and only adds the score on the way back.
+*
+*   Children of a node are one contiguous block of the pool. Expansion is claimed with a
+*   compare-and-swap on the node state; other threads arriving meanwhile simply run their
+*   playouts from the leaf. Nothing is ever freed during a search: when the pool runs out
+*   leaves stop expanding and the search goes on with playouts only.
+*
+*   A playout is a random game to the end, drawn without replacement from the empty cells
+*   and checked for a win only on the lines through each new stone. The final bitboards of
+*   every playout in a batch also give the RAVE update: a child's move counts as played by
+*   its side whenever that side owns the cell at the end.
+*
+********************************************************************************************/
+#include "ttt_mcts.h"
+
+#define PLATFORM_OS_ONLY            // Also built into ttt-engine and ttt-arena, which link no raylib
+#include "platform.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define MAX_MCTS_THREADS        64
+#define MAX_MCTS_BATCH          32
+#define MAX_MCTS_DEPTH          (TTT_MAX_CELLS + 1)
+
+#define DEFAULT_MAX_NODES       (1 << 20)
+#define DEFAULT_BATCH            8
+#define DEFAULT_EXPLORATION   0.4f
+#define DEFAULT_RAVE          500.0f
+
+#define NODE_LEAF                0
+#define NODE_EXPANDING           1
+#define NODE_EXPANDED            2
+#define NODE_FULL                3      // Expansion failed for lack of pool space
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Counters are 64-bit: an unbounded search (ttt-engine's go infinite) passes 2^31 playouts
+typedef struct MctsNode {
+    atomic_llong visits;            // Playouts through this node, including those in flight
+    atomic_llong score;             // Half points for the player who moved into the node
+    atomic_llong amafVisits;
+    atomic_llong amafScore;
+    int firstChild;
+    atomic_uchar state;
+    unsigned char childCount;
+    unsigned char move;             // Cell played to reach this node
+    signed char terminal;           // Winner, TTT_DRAW, or TTT_NONE
+} MctsNode;
+
+struct TttMcts {
+    const TttVariant *variant;
+    TttMctsConfig config;
+    MctsNode *pool[2];              // Current tree and the spare used for compaction
+    int current;
+    atomic_int nodeCount;
+    TttBoard rootBoard;             // The root is always node 0 of the current pool
+    int reusedNodes;
+    unsigned long long searches;
+
+    // Running search
+    atomic_bool stop;
+    atomic_bool treeFull;
+    atomic_llong playouts;
+    long long maxPlayouts;
+    double deadline;                // 0: none
+};
+
+typedef struct SearchWorker {
+    TttMcts *mcts;
+    uint64_t rng;
+    pthread_t thread;
+} SearchWorker;
+
+// One batch of playouts from the same leaf
+typedef struct PlayoutBatch {
+    int count;
+    int winner[MAX_MCTS_BATCH];
+    uint64_t stones[MAX_MCTS_BATCH][2];
+} PlayoutBatch;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static double WallTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+
+static uint64_t NextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static int PopCount(uint64_t value)
+{
+    return __builtin_popcountll(value);
+}
+
+static int LowestBit(uint64_t value)
+{
+    return __builtin_ctzll(value);
+}
+
+static void InitNode(MctsNode *node, int move, int terminal)
+{
+    atomic_init(&node->visits, 0);
+    atomic_init(&node->score, 0);
+    atomic_init(&node->amafVisits, 0);
+    atomic_init(&node->amafScore, 0);
+    atomic_init(&node->state, NODE_LEAF);
+    node->firstChild = 0;
+    node->childCount = 0;
+    node->move = (unsigned char)move;
+    node->terminal = (signed char)terminal;
+}
+
+static void ResetTree(TttMcts *mcts, const TttBoard *board)
+{
+    mcts->rootBoard = *board;
+    InitNode(&mcts->pool[mcts->current][0], 0, GetTttWinner(mcts->variant, board));
+    atomic_store(&mcts->nodeCount, 1);
+    mcts->reusedNodes = 0;
+}
+
+// Claim and fill the children block of a leaf; false if another thread has it or the pool is full
+static bool TryExpand(TttMcts *mcts, MctsNode *pool, MctsNode *node, const TttBoard *board)
+{
+    unsigned char expected = NODE_LEAF;
+    if (!atomic_compare_exchange_strong(&node->state, &expected, NODE_EXPANDING))
+    {
+        expected = NODE_FULL;       // Retry a node that failed before a compaction freed space
+        if (!atomic_compare_exchange_strong(&node->state, &expected, NODE_EXPANDING)) return false;
+    }
+
+    uint64_t empty = GetTttEmpty(mcts->variant, board);
+    int count = PopCount(empty);
+    int first = atomic_load(&mcts->nodeCount);          // Checked first so a full pool stops counting up
+    if (first + count <= mcts->config.maxNodes) first = atomic_fetch_add(&mcts->nodeCount, count);
+    if (first + count > mcts->config.maxNodes)
+    {
+        atomic_store(&mcts->treeFull, true);
+        atomic_store_explicit(&node->state, NODE_FULL, memory_order_release);
+        return false;
+    }
+
+    uint64_t mover = board->stones[board->toMove];
+    for (int i = 0; i < count; i++, empty &= empty - 1)
+    {
+        int cell = LowestBit(empty);
+        int terminal = IsTttWinningMove(mcts->variant, mover, cell)? board->toMove : (count == 1)? TTT_DRAW : TTT_NONE;
+        InitNode(&pool[first + i], cell, terminal);
+    }
+
+    node->firstChild = first;
+    node->childCount = (unsigned char)count;
+    atomic_store_explicit(&node->state, NODE_EXPANDED, memory_order_release);
+    return true;
+}
+
+static int SelectChild(const TttMcts *mcts, MctsNode *pool, MctsNode *node)
+{
+    float logVisits = logf((float)atomic_load_explicit(&node->visits, memory_order_relaxed) + 1.0f);
+    float exploration = mcts->config.exploration;
+    float equivalence = mcts->config.raveEquivalence;
+
+    int best = node->firstChild;
+    float bestValue = -1.0f;
+
+    for (int i = node->firstChild; i < node->firstChild + node->childCount; i++)
+    {
+        MctsNode *child = &pool[i];
+        long long visits = atomic_load_explicit(&child->visits, memory_order_relaxed);
+        long long amafVisits = atomic_load_explicit(&child->amafVisits, memory_order_relaxed);
+        float amaf = (amafVisits > 0)? 0.5f*(float)atomic_load_explicit(&child->amafScore, memory_order_relaxed)/(float)amafVisits : 0.5f;
+        float value;
+
+        if (visits == 0) value = 1000.0f + amaf;      // Try every child once, best RAVE guess first
+        else
+        {
+            float mean = 0.5f*(float)atomic_load_explicit(&child->score, memory_order_relaxed)/(float)visits;
+            float beta = (amafVisits > 0)? sqrtf(equivalence/(3.0f*(float)visits + equivalence)) : 0.0f;
+            value = (1.0f - beta)*mean + beta*amaf + exploration*sqrtf(logVisits/(float)visits);
+        }
+
+        if ((child->terminal >= 0) && (child->terminal != TTT_DRAW)) value += 1000.0f;      // An immediate win is always taken
+
+        if (value > bestValue)
+        {
+            bestValue = value;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+// Random games from board, each drawn without replacement from the empty cells
+static void RunPlayouts(const TttVariant *variant, const TttBoard *board, int terminal, uint64_t *rng, PlayoutBatch *batch)
+{
+    int cells[TTT_MAX_CELLS];
+    int count = 0;
+    for (uint64_t empty = GetTttEmpty(variant, board); empty != 0; empty &= empty - 1) cells[count++] = LowestBit(empty);
+
+    for (int lane = 0; lane < batch->count; lane++)
+    {
+        uint64_t stones[2] = { board->stones[0], board->stones[1] };
+        int toMove = board->toMove;
+        int winner = (terminal != TTT_NONE)? terminal : TTT_DRAW;
+
+        for (int i = 0; (terminal == TTT_NONE) && (i < count); i++)
+        {
+            int pick = i + (int)(((NextRandom(rng) >> 32)*(uint64_t)(count - i)) >> 32);
+            int cell = cells[pick];
+            cells[pick] = cells[i];
+            cells[i] = cell;
+
+            if (IsTttWinningMove(variant, stones[toMove], cell))
+            {
+                stones[toMove] |= 1ULL << cell;
+                winner = toMove;
+                break;
+            }
+
+            stones[toMove] |= 1ULL << cell;
+            toMove ^= 1;
+        }
+
+        batch->winner[lane] = winner;
+        batch->stones[lane][0] = stones[0];
+        batch->stones[lane][1] = stones[1];
+    }
+}
+
+static int GetHalfPoints(int winner, int player)
+{
+    return (winner == player)? 2 : (winner == TTT_DRAW)? 1 : 0;
+}
+
+static void Backup(TttMcts *mcts, MctsNode *pool, const int *path, int depth, const PlayoutBatch *batch)
+{
+    int points[2] = { 0, 0 };
+    for (int lane = 0; lane < batch->count; lane++)
+    {
+        points[0] += GetHalfPoints(batch->winner[lane], 0);
+        points[1] += GetHalfPoints(batch->winner[lane], 1);
+    }
+
+    for (int ply = 0; ply <= depth; ply++)
+    {
+        MctsNode *node = &pool[path[ply]];
+        int toMove = mcts->rootBoard.toMove ^ (ply & 1);
+
+        atomic_fetch_add_explicit(&node->score, points[toMove ^ 1], memory_order_relaxed);
+        if (atomic_load_explicit(&node->state, memory_order_acquire) != NODE_EXPANDED) continue;
+
+        // All moves as first: every cell the side to move ends up owning
+        for (int i = node->firstChild; i < node->firstChild + node->childCount; i++)
+        {
+            uint64_t bit = 1ULL << pool[i].move;
+            int visits = 0, score = 0;
+            for (int lane = 0; lane < batch->count; lane++)
+            {
+                if (batch->stones[lane][toMove] & bit)
+                {
+                    visits++;
+                    score += GetHalfPoints(batch->winner[lane], toMove);
+                }
+            }
+
+            if (visits == 0) continue;
+            atomic_fetch_add_explicit(&pool[i].amafVisits, visits, memory_order_relaxed);
+            atomic_fetch_add_explicit(&pool[i].amafScore, score, memory_order_relaxed);
+        }
+    }
+}
+
+static void RunIteration(TttMcts *mcts, uint64_t *rng)
+{
+    MctsNode *pool = mcts->pool[mcts->current];
+    PlayoutBatch batch;
+    batch.count = mcts->config.batch;
+
+    int path[MAX_MCTS_DEPTH];
+    int depth = 0;
+    int index = 0;
+    TttBoard board = mcts->rootBoard;
+
+    path[0] = 0;
+    atomic_fetch_add_explicit(&pool[0].visits, batch.count, memory_order_relaxed);
+
+    while (pool[index].terminal == TTT_NONE)
+    {
+        MctsNode *node = &pool[index];
+        int state = atomic_load_explicit(&node->state, memory_order_acquire);
+
+        // Expand on the second batch through a leaf, so one-off leaves cost no pool space
+        if ((state != NODE_EXPANDED) && (atomic_load_explicit(&node->visits, memory_order_relaxed) >= 2*batch.count))
+        {
+            if (TryExpand(mcts, pool, node, &board)) state = NODE_EXPANDED;
+        }
+        if (state != NODE_EXPANDED) break;
+
+        index = SelectChild(mcts, pool, node);
+        atomic_fetch_add_explicit(&pool[index].visits, batch.count, memory_order_relaxed);
+        PlayTttMove(&board, pool[index].move);
+        path[++depth] = index;
+    }
+
+    RunPlayouts(mcts->variant, &board, pool[index].terminal, rng, &batch);
+    Backup(mcts, pool, path, depth, &batch);
+    atomic_fetch_add_explicit(&mcts->playouts, batch.count, memory_order_relaxed);
+}
+
+static bool ShouldStop(TttMcts *mcts)
+{
+    if (atomic_load_explicit(&mcts->stop, memory_order_relaxed)) return true;
+    if ((mcts->maxPlayouts > 0) && (atomic_load_explicit(&mcts->playouts, memory_order_relaxed) >= mcts->maxPlayouts)) return true;
+    return (mcts->deadline > 0.0) && (WallTime() >= mcts->deadline);
+}
+
+static void *SearchMain(void *arg)
+{
+    SearchWorker *worker = (SearchWorker *)arg;
+    while (!ShouldStop(worker->mcts)) RunIteration(worker->mcts, &worker->rng);
+    return NULL;
+}
+
+// Copy the subtree under index into the spare pool, breadth first so sibling blocks stay
+// contiguous; the spare pool itself is the queue
+static int CompactTree(TttMcts *mcts, int index)
+{
+    MctsNode *from = mcts->pool[mcts->current];
+    MctsNode *to = mcts->pool[mcts->current ^ 1];
+    int count = 1;
+
+    memcpy(&to[0], &from[index], sizeof(MctsNode));
+    for (int i = 0; i < count; i++)
+    {
+        MctsNode *node = &to[i];
+        if (atomic_load(&node->state) != NODE_EXPANDED)
+        {
+            atomic_store(&node->state, NODE_LEAF);
+            continue;
+        }
+
+        memcpy(&to[count], &from[node->firstChild], sizeof(MctsNode)*node->childCount);
+        node->firstChild = count;
+        count += node->childCount;
+    }
+
+    mcts->current ^= 1;
+    atomic_store(&mcts->nodeCount, count);
+    return count;
+}
+
+static int FindChild(const MctsNode *pool, const MctsNode *node, int cell)
+{
+    if (atomic_load(&node->state) != NODE_EXPANDED) return -1;
+
+    for (int i = node->firstChild; i < node->firstChild + node->childCount; i++)
+    {
+        if (pool[i].move == cell) return i;
+    }
+
+    return -1;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+TttMcts *LoadTttMcts(const TttVariant *variant, const TttMctsConfig *config)
+{
+    TttMcts *mcts = (TttMcts *)calloc(1, sizeof(TttMcts));
+    if (mcts == NULL) return NULL;
+
+    mcts->variant = variant;
+    if (config != NULL) mcts->config = *config;
+
+    if (mcts->config.threads <= 0) mcts->config.threads = GetCpuCount();
+    if (mcts->config.threads > MAX_MCTS_THREADS) mcts->config.threads = MAX_MCTS_THREADS;
+    if (mcts->config.maxNodes <= TTT_MAX_CELLS) mcts->config.maxNodes = DEFAULT_MAX_NODES;
+    if (mcts->config.batch <= 0) mcts->config.batch = DEFAULT_BATCH;
+    if (mcts->config.batch > MAX_MCTS_BATCH) mcts->config.batch = MAX_MCTS_BATCH;
+    if (mcts->config.exploration <= 0.0f) mcts->config.exploration = DEFAULT_EXPLORATION;
+    if (mcts->config.raveEquivalence <= 0.0f) mcts->config.raveEquivalence = DEFAULT_RAVE;
+
+    mcts->pool[0] = (MctsNode *)malloc(sizeof(MctsNode)*(size_t)mcts->config.maxNodes);
+    mcts->pool[1] = (MctsNode *)malloc(sizeof(MctsNode)*(size_t)mcts->config.maxNodes);
+    if ((mcts->pool[0] == NULL) || (mcts->pool[1] == NULL))
+    {
+        UnloadTttMcts(mcts);
+        return NULL;
+    }
+
+    ResetTree(mcts, &(TttBoard){ { 0, 0 }, 0 });
+    return mcts;
+}
+
+void UnloadTttMcts(TttMcts *mcts)
+{
+    if (mcts == NULL) return;
+
+    free(mcts->pool[0]);
+    free(mcts->pool[1]);
+    free(mcts);
+}
+
+void SetTttMctsPosition(TttMcts *mcts, const TttBoard *board)
+{
+    const TttBoard *root = &mcts->rootBoard;
+    uint64_t added[2] = { board->stones[0] & ~root->stones[0], board->stones[1] & ~root->stones[1] };
+    bool descendant = ((root->stones[0] & ~board->stones[0]) == 0) && ((root->stones[1] & ~board->stones[1]) == 0);
+    int plies = PopCount(added[0]) + PopCount(added[1]);
+
+    // Our move, then possibly the reply: exactly one new stone per side in turn order
+    int mover = root->toMove;
+    bool reusable = descendant && (plies <= 2) && (board->toMove == (mover ^ (plies & 1))) &&
+                    (PopCount(added[mover]) == ((plies > 0)? 1 : 0)) && (PopCount(added[mover ^ 1]) == ((plies > 1)? 1 : 0));
+
+    int index = 0;
+    const MctsNode *pool = mcts->pool[mcts->current];
+    if (reusable && (plies > 0)) index = FindChild(pool, &pool[0], LowestBit(added[mover]));
+    if (reusable && (plies > 1) && (index >= 0)) index = FindChild(pool, &pool[index], LowestBit(added[mover ^ 1]));
+
+    if (!reusable || (index < 0))
+    {
+        ResetTree(mcts, board);
+        return;
+    }
+
+    mcts->reusedNodes = (index == 0)? atomic_load(&mcts->nodeCount) : CompactTree(mcts, index);
+    mcts->rootBoard = *board;
+}
+
+int SearchTttMcts(TttMcts *mcts, double seconds, long long maxPlayouts, TttMctsStats *stats)
+{
+    double start = WallTime();
+    MctsNode *pool = mcts->pool[mcts->current];
+    MctsNode *root = &pool[0];
+    int bestMove = TTT_NONE;
+
+    if (stats != NULL) *stats = (TttMctsStats){ .ponderMove = TTT_NONE };
+    atomic_store(&mcts->treeFull, false);
+    atomic_store(&mcts->playouts, 0);
+
+    // The root is expanded up front so there is always a move to return
+    if ((root->terminal == TTT_NONE) && ((atomic_load(&root->state) == NODE_EXPANDED) || TryExpand(mcts, pool, root, &mcts->rootBoard)))
+    {
+        mcts->maxPlayouts = maxPlayouts;
+        mcts->deadline = (seconds > 0.0)? start + seconds : 0.0;
+        mcts->searches++;
+
+        SearchWorker workers[MAX_MCTS_THREADS];
+        for (int i = 0; i < mcts->config.threads; i++)
+        {
+            workers[i] = (SearchWorker){ mcts, mcts->config.seed ^ (mcts->searches*0x9E3779B97F4A7C15ULL) ^ ((uint64_t)i << 48) };
+            if ((i > 0) && (pthread_create(&workers[i].thread, NULL, SearchMain, &workers[i]) != 0)) workers[i].mcts = NULL;
+        }
+        SearchMain(&workers[0]);
+        for (int i = 1; i < mcts->config.threads; i++)
+        {
+            if (workers[i].mcts != NULL) pthread_join(workers[i].thread, NULL);
+        }
+
+        int best = root->firstChild;
+        for (int i = root->firstChild; i < root->firstChild + root->childCount; i++)
+        {
+            if (atomic_load(&pool[i].visits) > atomic_load(&pool[best].visits)) best = i;
+        }
+        bestMove = pool[best].move;
+
+        if (stats != NULL)
+        {
+            const MctsNode *reply = &pool[best];
+            int ponder = -1;
+            for (int i = reply->firstChild; (atomic_load(&reply->state) == NODE_EXPANDED) && (i < reply->firstChild + reply->childCount); i++)
+            {
+                if ((ponder < 0) || (atomic_load(&pool[i].visits) > atomic_load(&pool[ponder].visits))) ponder = i;
+            }
+            stats->ponderMove = (ponder >= 0)? pool[ponder].move : TTT_NONE;
+
+            long long visits = atomic_load(&pool[best].visits);
+            stats->bestVisits = visits;
+            stats->bestValue = (visits > 0)? 0.5f*(float)atomic_load(&pool[best].score)/(float)visits : 0.5f;
+        }
+    }
+
+    if (stats != NULL)
+    {
+        int nodes = atomic_load(&mcts->nodeCount);
+        stats->playouts = atomic_load(&mcts->playouts);
+        stats->nodes = (nodes < mcts->config.maxNodes)? nodes : mcts->config.maxNodes;
+        stats->reusedNodes = mcts->reusedNodes;
+        stats->bestMove = bestMove;
+        stats->seconds = WallTime() - start;
+        stats->treeFull = atomic_load(&mcts->treeFull);
+    }
+
+    return bestMove;
+}
+
+void StopTttMcts(TttMcts *mcts)
+{
+    atomic_store(&mcts->stop, true);
+}
+
+void ClearTttMctsStop(TttMcts *mcts)
+{
+    atomic_store(&mcts->stop, false);
+}
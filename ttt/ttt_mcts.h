@@ -0,0 +1,65 @@
+/*******************************************************************************************
+*
+*   Monte Carlo tree search for the tic-tac-toe variants (ttt_board.h)
+*
+*   UCT with RAVE (all-moves-as-first) statistics, searched by several threads on one shared
+*   tree without locks: node statistics are atomics, children are allocated from a shared
+*   pool with one fetch-add, and a thread descending through a node adds its visits up front
+*   (virtual loss) so concurrent threads spread over different branches.
+*
+*   Each leaf reached runs a batch of random playouts at once, so the descent, expansion and
+*   atomic backup are paid once per batch. The search is anytime: it runs until the time
+*   budget, a playout limit or StopTttMcts(), and always has a best move ready.
+*
+*   SetTttMctsPosition() keeps the subtree of the new position when it is up to two plies
+*   below the current root (our move plus the reply), compacting it into the spare pool.
+*
+********************************************************************************************/
+#ifndef TTT_MCTS_H
+#define TTT_MCTS_H
+
+#include "ttt_board.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct TttMctsConfig {
+    int threads;                    // 0: one per online core
+    int maxNodes;                   // Per pool (two are allocated); 0: 1 << 20
+    int batch;                      // Playouts per leaf visit; 0: 8
+    float exploration;              // UCT constant; 0: 0.4
+    float raveEquivalence;          // Visits at which UCT and RAVE weigh the same; 0: 500
+    unsigned long long seed;
+} TttMctsConfig;
+
+typedef struct TttMctsStats {
+    long long playouts;
+    int nodes;                      // Pool nodes in use
+    int reusedNodes;                // Kept from the previous search by SetTttMctsPosition()
+    int bestMove;                   // Cell, or TTT_NONE when the position is over
+    int ponderMove;                 // Most searched reply to bestMove, or TTT_NONE
+    long long bestVisits;
+    float bestValue;                // Expected score of bestMove for the side to move, 0..1
+    double seconds;
+    bool treeFull;                  // Pool exhausted: leaves were no longer expanded
+} TttMctsStats;
+
+typedef struct TttMcts TttMcts;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+TttMcts *LoadTttMcts(const TttVariant *variant, const TttMctsConfig *config);   // NULL config: defaults
+void UnloadTttMcts(TttMcts *mcts);
+
+void SetTttMctsPosition(TttMcts *mcts, const TttBoard *board);     // Reuses the subtree when possible
+int SearchTttMcts(TttMcts *mcts, double seconds, long long maxPlayouts, TttMctsStats *stats);   // Best cell; stats may be NULL
+void StopTttMcts(TttMcts *mcts);                                    // From any thread: end the running search now, and later ones at once
+void ClearTttMctsStop(TttMcts *mcts);                               // Let searches run again after StopTttMcts()
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // TTT_MCTS_H
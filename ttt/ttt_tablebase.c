@@ -0,0 +1,677 @@
+/*******************************************************************************************
+*
+*   Retrograde-analysis tablebases for the flat tic-tac-toe variants
+*
+*   Layer s holds the positions with s stones: (s + 1)/2 X and s/2 O, X to move when s is
+*   even. A position's raw index in its layer is the colex rank of the X cells times the
+*   number of O subsets, plus the colex rank of the O cells among the cells X left free.
+*   The canonical position of a symmetry class is the one with the smallest (X << 16 | O)
+*   image; the layer bitmap marks canonical raw indices and a prefix count every 512 bits
+*   turns a raw index into a dense entry number.
+*
+*   File layout: header, then per layer the bitmap (64-bit words), the rank directory
+*   (32-bit counts) and the values (2 bits per entry, four to a byte), each 8-byte aligned.
+*
+*   Layers are solved from the full board down. A position is lost when the previous mover
+*   already has a line, drawn when the board is full, otherwise won if a move completes a
+*   line or leads to a position lost for the opponent, drawn if one leads to a draw, and
+*   lost otherwise. Threads split a layer by X subsets and OR their 2-bit values into the
+*   zeroed value block, so neighbouring entries owned by different threads never clash.
+*
+********************************************************************************************/
+#include "ttt_tablebase.h"
+
+#define PLATFORM_OS_ONLY            // Also built into ttt-tbgen and ttt-arena, which link no raylib
+#include "platform.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define TABLEBASE_MAGIC         "TTTB"
+#define TABLEBASE_VERSION        1
+#define MAX_TABLEBASE_LAYERS    (TTT_TABLEBASE_MAX_CELLS + 1)
+#define MAX_SYMMETRIES          64
+#define RANK_BLOCK_WORDS         8      // 512 bits per rank directory entry
+#define MAX_GENERATE_THREADS    64
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct TablebaseLayer {
+    uint64_t rawCount;              // Combinatorial index space of the layer
+    uint64_t entries;               // Canonical positions stored
+    uint64_t bitmapOffset;
+    uint64_t rankOffset;
+    uint64_t valueOffset;
+} TablebaseLayer;
+
+typedef struct TablebaseHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t variant;
+    uint32_t cells;
+    uint32_t layerCount;
+    uint32_t completedFrom;         // Layers >= this are solved; 0 in a finished tablebase
+    uint64_t fileSize;
+    TablebaseLayer layers[MAX_TABLEBASE_LAYERS];
+} TablebaseHeader;
+
+// Everything a probe needs, shared by the runtime and the generator
+typedef struct TablebaseIndex {
+    const TttVariant *variant;
+    int symmetryCount;
+    uint16_t transform[MAX_SYMMETRIES][2][256];     // Image of each byte of a bitboard
+    uint32_t binomial[TTT_TABLEBASE_MAX_CELLS + 1][TTT_TABLEBASE_MAX_CELLS + 1];
+    const TablebaseHeader *header;
+    const unsigned char *base;
+} TablebaseIndex;
+
+struct TttTablebase {
+    TablebaseIndex index;
+    size_t size;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static int PopCount(uint64_t value)
+{
+    return __builtin_popcountll(value);
+}
+
+static int LowestBit(uint64_t value)
+{
+    return __builtin_ctzll(value);
+}
+
+// Next larger integer with the same number of bits set (colex order of subsets)
+static uint32_t NextSubset(uint32_t subset)
+{
+    uint32_t lowest = subset & (~subset + 1);
+    uint32_t ripple = subset + lowest;
+    return ripple | (((subset ^ ripple) >> 2)/lowest);
+}
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+static void GetLayerCounts(int layer, int *xCount, int *oCount)
+{
+    *xCount = (layer + 1)/2;
+    *oCount = layer/2;
+}
+
+// Every coordinate relabelling combined with the 8 square symmetries that maps lines to lines
+static bool BuildIndex(TablebaseIndex *index, const TttVariant *variant)
+{
+    if ((variant->layers != 1) || (variant->cells > TTT_TABLEBASE_MAX_CELLS)) return false;
+
+    memset(index, 0, sizeof(TablebaseIndex));
+    index->variant = variant;
+
+    for (int n = 0; n <= TTT_TABLEBASE_MAX_CELLS; n++)
+    {
+        index->binomial[n][0] = 1;
+        for (int k = 1; k <= n; k++) index->binomial[n][k] = index->binomial[n - 1][k - 1] + ((k < n)? index->binomial[n - 1][k] : 0);
+    }
+
+    int n = variant->size;
+    int relabel[4] = { 0, 1, 2, 3 };
+    int permutations = 1;
+    for (int i = 2; i <= n; i++) permutations *= i;
+
+    unsigned char maps[MAX_SYMMETRIES][TTT_TABLEBASE_MAX_CELLS];
+
+    for (int p = 0; p < permutations; p++)
+    {
+        // p-th permutation of 0..n-1 (factorial number system)
+        int pool[4] = { 0, 1, 2, 3 };
+        for (int i = 0, rest = p, left = n; i < n; i++, left--)
+        {
+            int factorial = 1;
+            for (int f = 2; f < left; f++) factorial *= f;
+            int pick = rest/factorial;
+            rest %= factorial;
+            relabel[i] = pool[pick];
+            for (int j = pick; j < left - 1; j++) pool[j] = pool[j + 1];
+        }
+
+        for (int d = 0; d < 8; d++)
+        {
+            unsigned char map[TTT_TABLEBASE_MAX_CELLS];
+            for (int cell = 0; cell < variant->cells; cell++)
+            {
+                int x = relabel[cell%n], y = relabel[cell/n];
+                if (d & 1) x = n - 1 - x;
+                if (d & 2) y = n - 1 - y;
+                if (d & 4) { int t = x; x = y; y = t; }
+                map[cell] = (unsigned char)(y*n + x);
+            }
+
+            bool valid = true;
+            for (int l = 0; valid && (l < variant->lineCount); l++)
+            {
+                uint64_t image = 0;
+                for (uint64_t line = variant->lines[l]; line != 0; line &= line - 1) image |= 1ULL << map[LowestBit(line)];
+
+                valid = false;
+                for (int m = 0; m < variant->lineCount; m++) valid |= (variant->lines[m] == image);
+            }
+
+            for (int s = 0; valid && (s < index->symmetryCount); s++) valid = (memcmp(maps[s], map, (size_t)variant->cells) != 0);
+            if (!valid || (index->symmetryCount == MAX_SYMMETRIES)) continue;
+
+            memcpy(maps[index->symmetryCount++], map, (size_t)variant->cells);
+        }
+    }
+
+    for (int s = 0; s < index->symmetryCount; s++)
+    {
+        for (int half = 0; half < 2; half++)
+        {
+            for (int byte = 0; byte < 256; byte++)
+            {
+                uint16_t image = 0;
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    int cell = half*8 + bit;
+                    if ((byte & (1 << bit)) && (cell < variant->cells)) image |= (uint16_t)(1u << maps[s][cell]);
+                }
+                index->transform[s][half][byte] = image;
+            }
+        }
+    }
+
+    return true;
+}
+
+static uint32_t GetSymmetryKey(const TablebaseIndex *index, int symmetry, uint32_t x, uint32_t o)
+{
+    const uint16_t (*table)[256] = index->transform[symmetry];
+    uint32_t tx = table[0][x & 0xFF] | table[1][x >> 8];
+    uint32_t to = table[0][o & 0xFF] | table[1][o >> 8];
+    return (tx << 16) | to;
+}
+
+static uint32_t GetCanonicalKey(const TablebaseIndex *index, uint32_t x, uint32_t o)
+{
+    uint32_t best = (x << 16) | o;
+    for (int s = 0; s < index->symmetryCount; s++)
+    {
+        uint32_t key = GetSymmetryKey(index, s, x, o);
+        if (key < best) best = key;
+    }
+
+    return best;
+}
+
+static uint32_t RankSubset(const TablebaseIndex *index, uint32_t subset)
+{
+    uint32_t rank = 0;
+    for (int i = 1; subset != 0; i++, subset &= subset - 1) rank += index->binomial[LowestBit(subset)][i];
+    return rank;
+}
+
+static uint32_t UnrankSubset(const TablebaseIndex *index, uint32_t rank, int count)
+{
+    uint32_t subset = 0;
+    for (int i = count; i > 0; i--)
+    {
+        int c = i - 1;
+        while (index->binomial[c + 1][i] <= rank) c++;
+        rank -= index->binomial[c][i];
+        subset |= 1u << c;
+    }
+
+    return subset;
+}
+
+// Keep the bits of value that are in mask, packed down (software PEXT), and back (PDEP)
+static uint32_t CompressBits(uint32_t value, uint32_t mask)
+{
+    uint32_t result = 0;
+    for (int bit = 0; mask != 0; bit++, mask &= mask - 1)
+    {
+        if (value & (mask & (~mask + 1))) result |= 1u << bit;
+    }
+
+    return result;
+}
+
+static uint32_t DepositBits(uint32_t value, uint32_t mask)
+{
+    uint32_t result = 0;
+    for (; mask != 0; value >>= 1, mask &= mask - 1)
+    {
+        if (value & 1) result |= mask & (~mask + 1);
+    }
+
+    return result;
+}
+
+static uint64_t GetRawIndex(const TablebaseIndex *index, uint32_t x, uint32_t o)
+{
+    int cells = index->variant->cells;
+    uint32_t free = (uint32_t)index->variant->full & ~x;
+    return (uint64_t)RankSubset(index, x)*index->binomial[cells - PopCount(x)][PopCount(o)] + RankSubset(index, CompressBits(o, free));
+}
+
+static int GetEntryValue(const unsigned char *values, uint64_t entry)
+{
+    return (values[entry >> 2] >> ((entry & 3)*2)) & 3;
+}
+
+static TttValue ProbeLayer(const TablebaseIndex *index, uint32_t x, uint32_t o)
+{
+    uint32_t key = GetCanonicalKey(index, x, o);
+    x = key >> 16;
+    o = key & 0xFFFF;
+
+    const TablebaseLayer *layer = &index->header->layers[PopCount(x) + PopCount(o)];
+    const uint64_t *bitmap = (const uint64_t *)(index->base + layer->bitmapOffset);
+    const uint32_t *ranks = (const uint32_t *)(index->base + layer->rankOffset);
+
+    uint64_t raw = GetRawIndex(index, x, o);
+    uint64_t word = raw >> 6;
+    uint64_t entry = ranks[word/RANK_BLOCK_WORDS];
+    for (uint64_t w = word & ~(uint64_t)(RANK_BLOCK_WORDS - 1); w < word; w++) entry += (uint64_t)PopCount(bitmap[w]);
+    entry += (uint64_t)PopCount(bitmap[word] & ((1ULL << (raw & 63)) - 1));
+
+    return (TttValue)GetEntryValue(index->base + layer->valueOffset, entry);
+}
+
+static bool HasLine(const TttVariant *variant, uint64_t stones)
+{
+    for (int i = 0; i < variant->lineCount; i++)
+    {
+        if ((stones & variant->lines[i]) == variant->lines[i]) return true;
+    }
+
+    return false;
+}
+
+// Value for the side to move; children are probed in the layer above, which must be solved
+static TttValue SolvePosition(const TablebaseIndex *index, uint32_t x, uint32_t o)
+{
+    const TttVariant *variant = index->variant;
+    bool xToMove = (PopCount(x) == PopCount(o));
+    uint32_t mover = xToMove? x : o;
+    uint32_t other = xToMove? o : x;
+
+    if (HasLine(variant, other)) return TTT_VALUE_LOSS;
+
+    uint32_t empty = (uint32_t)variant->full & ~(x | o);
+    if (empty == 0) return TTT_VALUE_DRAW;
+
+    TttValue best = TTT_VALUE_LOSS;
+    for (uint32_t moves = empty; moves != 0; moves &= moves - 1)
+    {
+        int cell = LowestBit(moves);
+        if (IsTttWinningMove(variant, mover, cell)) return TTT_VALUE_WIN;
+
+        uint32_t next = mover | (1u << cell);
+        TttValue reply = xToMove? ProbeLayer(index, next, o) : ProbeLayer(index, x, next);
+        if (reply == TTT_VALUE_LOSS) return TTT_VALUE_WIN;
+        if (reply == TTT_VALUE_DRAW) best = TTT_VALUE_DRAW;
+    }
+
+    return best;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+TttTablebase *LoadTttTablebase(const char *fileName)
+{
+    TttTablebase *tablebase = (TttTablebase *)calloc(1, sizeof(TttTablebase));
+    if (tablebase == NULL) return NULL;
+
+    const unsigned char *base = NULL;
+
+#if defined(_WIN32)
+    tablebase->file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (tablebase->file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER size;
+        GetFileSizeEx(tablebase->file, &size);
+        tablebase->size = (size_t)size.QuadPart;
+        tablebase->mapping = CreateFileMappingA(tablebase->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (tablebase->mapping != NULL) base = (const unsigned char *)MapViewOfFile(tablebase->mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    int fd = open(fileName, O_RDONLY);
+    struct stat info;
+    if ((fd >= 0) && (fstat(fd, &info) == 0) && (info.st_size >= (off_t)sizeof(TablebaseHeader)))
+    {
+        tablebase->size = (size_t)info.st_size;
+        void *data = mmap(NULL, tablebase->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) base = (const unsigned char *)data;
+    }
+    if (fd >= 0) close(fd);
+#endif
+
+    const TablebaseHeader *header = (const TablebaseHeader *)base;
+    bool valid = (base != NULL) && (tablebase->size >= sizeof(TablebaseHeader)) &&
+                 (memcmp(header->magic, TABLEBASE_MAGIC, 4) == 0) && (header->version == TABLEBASE_VERSION) &&
+                 (header->completedFrom == 0) && (header->fileSize == tablebase->size) &&
+                 (header->variant < TTT_VARIANT_COUNT) && BuildIndex(&tablebase->index, GetTttVariant((TttVariantId)header->variant)) &&
+                 (header->cells == (uint32_t)tablebase->index.variant->cells);
+
+    tablebase->index.header = header;
+    tablebase->index.base = base;
+
+    if (!valid)
+    {
+        if (base == NULL) tablebase->size = 0;
+        UnloadTttTablebase(tablebase);
+        return NULL;
+    }
+
+    return tablebase;
+}
+
+void UnloadTttTablebase(TttTablebase *tablebase)
+{
+    if (tablebase == NULL) return;
+
+#if defined(_WIN32)
+    if (tablebase->index.base != NULL) UnmapViewOfFile(tablebase->index.base);
+    if (tablebase->mapping != NULL) CloseHandle(tablebase->mapping);
+    if ((tablebase->file != NULL) && (tablebase->file != INVALID_HANDLE_VALUE)) CloseHandle(tablebase->file);
+#else
+    if (tablebase->index.base != NULL) munmap((void *)tablebase->index.base, tablebase->size);
+#endif
+
+    free(tablebase);
+}
+
+const TttVariant *GetTttTablebaseVariant(const TttTablebase *tablebase)
+{
+    return tablebase->index.variant;
+}
+
+TttValue ProbeTttTablebase(const TttTablebase *tablebase, const TttBoard *board)
+{
+    const TttVariant *variant = tablebase->index.variant;
+    uint64_t x = board->stones[0], o = board->stones[1];
+
+    if (((x | o) & ~variant->full) || (x & o)) return TTT_VALUE_UNKNOWN;
+    if ((PopCount(x) - PopCount(o) != board->toMove) || (board->toMove > 1)) return TTT_VALUE_UNKNOWN;
+
+    return ProbeLayer(&tablebase->index, (uint32_t)x, (uint32_t)o);
+}
+
+int GetTttTablebaseMove(const TttTablebase *tablebase, const TttBoard *board, TttValue *value)
+{
+    const TttVariant *variant = tablebase->index.variant;
+    TttValue current = ProbeTttTablebase(tablebase, board);
+    int bestMove = TTT_NONE;
+    TttValue best = TTT_VALUE_UNKNOWN;
+
+    if ((current != TTT_VALUE_UNKNOWN) && (GetTttWinner(variant, board) == TTT_NONE))
+    {
+        uint64_t mover = board->stones[board->toMove];
+        for (uint64_t moves = GetTttEmpty(variant, board); moves != 0; moves &= moves - 1)
+        {
+            int cell = LowestBit(moves);
+            if (IsTttWinningMove(variant, mover, cell)) { bestMove = cell; best = TTT_VALUE_WIN; break; }
+
+            TttBoard next = *board;
+            PlayTttMove(&next, cell);
+            TttValue reply = ProbeTttTablebase(tablebase, &next);
+            TttValue mine = (reply == TTT_VALUE_LOSS)? TTT_VALUE_WIN : (reply == TTT_VALUE_WIN)? TTT_VALUE_LOSS : TTT_VALUE_DRAW;
+
+            // Win > draw > loss; the first such cell keeps the choice deterministic
+            int rank = (mine == TTT_VALUE_WIN)? 2 : (mine == TTT_VALUE_DRAW)? 1 : 0;
+            int bestRank = (bestMove == TTT_NONE)? -1 : (best == TTT_VALUE_WIN)? 2 : (best == TTT_VALUE_DRAW)? 1 : 0;
+            if (rank > bestRank) { bestMove = cell; best = mine; }
+        }
+    }
+
+    if (value != NULL) *value = (bestMove != TTT_NONE)? best : current;
+    return bestMove;
+}
+
+#if defined(_WIN32)
+bool GenerateTttTablebase(const TttVariant *variant, const char *fileName, int threads, TttTablebaseProgress progress)
+{
+    (void)variant; (void)fileName; (void)threads; (void)progress;
+    return false;       // Generation needs mmap/ftruncate; generate on a POSIX host, the file is portable
+}
+#else
+
+//----------------------------------------------------------------------------------
+// Generation
+//----------------------------------------------------------------------------------
+typedef struct GenerateTask {
+    TablebaseIndex *index;
+    unsigned char *base;            // Writable view of the .part file (bitmap phase: NULL)
+    uint64_t *bitmap;               // Bitmap phase output
+    int layer;
+    uint32_t begin, end;            // Range of X subset ranks
+    long long positions;
+    pthread_t thread;
+} GenerateTask;
+
+static double WallTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+
+// Visit every position of the task's layer whose X subset rank is in [begin, end), in raw index order
+static void VisitLayer(GenerateTask *task, void (*visit)(GenerateTask *task, uint32_t x, uint32_t o, uint64_t raw))
+{
+    const TablebaseIndex *index = task->index;
+    int xCount, oCount;
+    GetLayerCounts(task->layer, &xCount, &oCount);
+    uint32_t oSubsets = index->binomial[index->variant->cells - xCount][oCount];
+
+    uint32_t x = UnrankSubset(index, task->begin, xCount);
+    for (uint32_t rankX = task->begin; rankX < task->end; rankX++)
+    {
+        uint32_t free = (uint32_t)index->variant->full & ~x;
+        uint32_t packed = (1u << oCount) - 1;
+
+        for (uint32_t rankO = 0; rankO < oSubsets; rankO++)
+        {
+            visit(task, x, DepositBits(packed, free), (uint64_t)rankX*oSubsets + rankO);
+            if (oCount > 0) packed = NextSubset(packed);
+        }
+
+        if (xCount > 0) x = NextSubset(x);
+    }
+}
+
+static void MarkCanonical(GenerateTask *task, uint32_t x, uint32_t o, uint64_t raw)
+{
+    if (GetCanonicalKey(task->index, x, o) != ((x << 16) | o)) return;
+
+    __atomic_fetch_or(&task->bitmap[raw >> 6], 1ULL << (raw & 63), __ATOMIC_RELAXED);
+    task->positions++;
+}
+
+static void SolveEntry(GenerateTask *task, uint32_t x, uint32_t o, uint64_t raw)
+{
+    const TablebaseLayer *layer = &task->index->header->layers[task->layer];
+    const uint64_t *bitmap = (const uint64_t *)(task->base + layer->bitmapOffset);
+    uint64_t word = raw >> 6;
+    uint64_t bit = 1ULL << (raw & 63);
+    if (!(bitmap[word] & bit)) return;
+
+    const uint32_t *ranks = (const uint32_t *)(task->base + layer->rankOffset);
+    uint64_t entry = ranks[word/RANK_BLOCK_WORDS];
+    for (uint64_t w = word & ~(uint64_t)(RANK_BLOCK_WORDS - 1); w < word; w++) entry += (uint64_t)PopCount(bitmap[w]);
+    entry += (uint64_t)PopCount(bitmap[word] & (bit - 1));
+
+    unsigned char value = (unsigned char)SolvePosition(task->index, x, o);
+    if (value != 0) __atomic_fetch_or(&task->base[layer->valueOffset + (entry >> 2)], (unsigned char)(value << ((entry & 3)*2)), __ATOMIC_RELAXED);
+    task->positions++;
+}
+
+static void *MarkCanonicalMain(void *arg)
+{
+    VisitLayer((GenerateTask *)arg, MarkCanonical);
+    return NULL;
+}
+
+static void *SolveLayerMain(void *arg)
+{
+    VisitLayer((GenerateTask *)arg, SolveEntry);
+    return NULL;
+}
+
+// Split the X subsets of a layer over the threads and run one phase
+static long long RunLayerTasks(TablebaseIndex *index, unsigned char *base, uint64_t *bitmap, int layer, int threads, void *(*main)(void *))
+{
+    static GenerateTask tasks[MAX_GENERATE_THREADS];
+    int xCount, oCount;
+    GetLayerCounts(layer, &xCount, &oCount);
+    uint32_t xSubsets = index->binomial[index->variant->cells][xCount];
+    if ((uint32_t)threads > xSubsets) threads = (int)xSubsets;
+
+    for (int t = 0; t < threads; t++)
+    {
+        tasks[t] = (GenerateTask){ index, base, bitmap, layer, (uint32_t)((uint64_t)xSubsets*t/threads), (uint32_t)((uint64_t)xSubsets*(t + 1)/threads), 0 };
+        if ((t > 0) && (pthread_create(&tasks[t].thread, NULL, main, &tasks[t]) != 0)) main(&tasks[t]);
+    }
+    main(&tasks[0]);
+
+    long long positions = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        if (t > 0) pthread_join(tasks[t].thread, NULL);
+        positions += tasks[t].positions;
+    }
+
+    return positions;
+}
+
+bool GenerateTttTablebase(const TttVariant *variant, const char *fileName, int threads, TttTablebaseProgress progress)
+{
+    static TablebaseIndex index;
+    if (!BuildIndex(&index, variant)) return false;
+
+    if (threads <= 0) threads = GetCpuCount();
+    if (threads > MAX_GENERATE_THREADS) threads = MAX_GENERATE_THREADS;
+
+    // Canonical positions of every layer, which fix the file layout
+    TablebaseHeader header = { .version = TABLEBASE_VERSION, .variant = (uint32_t)variant->id, .cells = (uint32_t)variant->cells, .layerCount = (uint32_t)variant->cells + 1 };
+    memcpy(header.magic, TABLEBASE_MAGIC, 4);
+
+    uint64_t *bitmaps[MAX_TABLEBASE_LAYERS] = { 0 };
+    uint64_t offset = AlignOffset(sizeof(TablebaseHeader));
+    bool ok = true;
+
+    for (int s = 0; ok && (s <= variant->cells); s++)
+    {
+        int xCount, oCount;
+        GetLayerCounts(s, &xCount, &oCount);
+        TablebaseLayer *layer = &header.layers[s];
+        layer->rawCount = (uint64_t)index.binomial[variant->cells][xCount]*index.binomial[variant->cells - xCount][oCount];
+
+        uint64_t words = (layer->rawCount + 63)/64;
+        uint64_t blocks = (words + RANK_BLOCK_WORDS - 1)/RANK_BLOCK_WORDS;
+        bitmaps[s] = (uint64_t *)calloc(blocks*RANK_BLOCK_WORDS, sizeof(uint64_t));
+        if (bitmaps[s] == NULL) { ok = false; break; }
+
+        layer->entries = (uint64_t)RunLayerTasks(&index, NULL, bitmaps[s], s, threads, MarkCanonicalMain);
+        layer->bitmapOffset = offset;
+        layer->rankOffset = AlignOffset(layer->bitmapOffset + words*sizeof(uint64_t));
+        layer->valueOffset = AlignOffset(layer->rankOffset + blocks*sizeof(uint32_t));
+        offset = AlignOffset(layer->valueOffset + (layer->entries + 3)/4);
+    }
+    header.fileSize = offset;
+    header.completedFrom = header.layerCount;
+
+    // Resume from a checkpoint with the same layout, or start a new one
+    char partName[1024];
+    snprintf(partName, sizeof(partName), "%s.part", fileName);
+
+    int fd = ok? open(partName, O_RDWR | O_CREAT, 0644) : -1;
+    unsigned char *base = NULL;
+    if (fd >= 0)
+    {
+        TablebaseHeader saved = { 0 };
+        bool resume = (pread(fd, &saved, sizeof(saved), 0) == (ssize_t)sizeof(saved));
+        saved.completedFrom = header.completedFrom;
+        resume = resume && (memcmp(&saved, &header, sizeof(header)) == 0);
+        if (!resume && (ftruncate(fd, 0) != 0)) ok = false;
+
+        if (ok && (ftruncate(fd, (off_t)header.fileSize) == 0))
+        {
+            void *data = mmap(NULL, header.fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED) base = (unsigned char *)data;
+        }
+        close(fd);
+
+        if (base != NULL && !resume) memcpy(base, &header, sizeof(header));
+    }
+    ok = ok && (base != NULL);
+
+    TablebaseHeader *mapped = (TablebaseHeader *)base;
+    index.header = mapped;
+    index.base = base;
+
+    for (int s = 0; ok && (s <= variant->cells); s++)
+    {
+        const TablebaseLayer *layer = &header.layers[s];
+        uint64_t words = (layer->rawCount + 63)/64;
+        uint32_t *ranks = (uint32_t *)(base + layer->rankOffset);
+        uint32_t count = 0;
+
+        memcpy(base + layer->bitmapOffset, bitmaps[s], words*sizeof(uint64_t));
+        for (uint64_t w = 0; w < words; w++)
+        {
+            if ((w % RANK_BLOCK_WORDS) == 0) ranks[w/RANK_BLOCK_WORDS] = count;
+            count += (uint32_t)PopCount(bitmaps[s][w]);
+        }
+    }
+
+    double start = WallTime();
+    for (int s = (int)(ok? mapped->completedFrom : 0) - 1; ok && (s >= 0); s--)
+    {
+        const TablebaseLayer *layer = &header.layers[s];
+        memset(base + layer->valueOffset, 0, (size_t)((layer->entries + 3)/4));
+
+        long long positions = RunLayerTasks(&index, base, NULL, s, threads, SolveLayerMain);
+
+        // The layer is durable before the header says so
+        ok = (msync(base, header.fileSize, MS_SYNC) == 0);
+        mapped->completedFrom = (uint32_t)s;
+        ok = ok && (msync(base, sizeof(TablebaseHeader), MS_SYNC) == 0);
+
+        if (progress != NULL) progress(s, (int)header.layerCount, positions, WallTime() - start);
+    }
+
+    if (base != NULL) munmap(base, header.fileSize);
+    for (int s = 0; s <= variant->cells; s++) free(bitmaps[s]);
+
+    return ok && (rename(partName, fileName) == 0);
+}
+#endif
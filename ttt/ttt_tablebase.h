@@ -0,0 +1,63 @@
+/*******************************************************************************************
+*
+*   Retrograde-analysis tablebases for the flat tic-tac-toe variants (3x3, 4x4)
+*
+*   Every position is solved once, offline, from the full boards back to the empty one, and
+*   stored as 2 bits (draw, win or loss for the side to move). Only one position of each
+*   symmetry class is kept (8 symmetries on 3x3, 32 on 4x4), and its slot is found with a
+*   minimal perfect hash: the position's combinatorial index within its stone-count layer,
+*   ranked among the canonical positions of that layer through a bitmap and a rank
+*   directory. At runtime the file is memory-mapped read-only, so a probe is a handful of
+*   table lookups into page-cached memory and a move choice is one probe per empty cell.
+*
+*   Generation runs each layer on several threads and can resume: layers are solved into
+*   "<file>.part", which records the lowest layer completed after each one is synced, and
+*   is renamed to <file> when layer 0 is done.
+*
+*   4x4x4 (Qubic) has 3^64 positions and cannot be tablebased this way; it is refused and
+*   left to the MCTS engine (ttt_mcts.h).
+*
+********************************************************************************************/
+#ifndef TTT_TABLEBASE_H
+#define TTT_TABLEBASE_H
+
+#include "ttt_board.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Constants
+//----------------------------------------------------------------------------------
+#define TTT_TABLEBASE_MAX_CELLS     16
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum TttValue {
+    TTT_VALUE_DRAW = 0,             // For the side to move, with perfect play from both sides
+    TTT_VALUE_WIN,
+    TTT_VALUE_LOSS,
+    TTT_VALUE_UNKNOWN               // Probe failed (no tablebase, wrong variant)
+} TttValue;
+
+typedef struct TttTablebase TttTablebase;
+
+// Generation progress, called after each layer is synced
+typedef void (*TttTablebaseProgress)(int layer, int layerCount, long long positions, double seconds);
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+TttTablebase *LoadTttTablebase(const char *fileName);                  // Map a generated tablebase, NULL if missing or invalid
+void UnloadTttTablebase(TttTablebase *tablebase);
+const TttVariant *GetTttTablebaseVariant(const TttTablebase *tablebase);
+
+TttValue ProbeTttTablebase(const TttTablebase *tablebase, const TttBoard *board);
+int GetTttTablebaseMove(const TttTablebase *tablebase, const TttBoard *board, TttValue *value);    // Best cell (an immediate win first), TTT_NONE if over
+
+bool GenerateTttTablebase(const TttVariant *variant, const char *fileName, int threads, TttTablebaseProgress progress);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // TTT_TABLEBASE_H
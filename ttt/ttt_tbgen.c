@@ -0,0 +1,106 @@
+/*******************************************************************************************
+*
+*   ttt-tbgen - solve a tic-tac-toe variant by retrograde analysis into a tablebase file
+*
+*   Usage: ttt-tbgen [--threads T] [--verify] <3x3|4x4> <output.tb>
+*
+*   An interrupted run leaves <output.tb>.part behind and resumes from its last completed
+*   layer when started again with the same arguments. --verify reloads the finished file
+*   through the mmap lookup and checks every position the perfect players can reach.
+*
+********************************************************************************************/
+#include "ttt_tablebase.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions
+//----------------------------------------------------------------------------------
+static void PrintProgress(int layer, int layerCount, long long positions, double seconds)
+{
+    printf("  layer %2i/%i: %10lld positions  %7.2f s\n", layer, layerCount - 1, positions, seconds);
+    fflush(stdout);
+}
+
+// Both sides follow the tablebase from the empty board; the value must hold at every step
+static bool VerifyLine(const TttTablebase *tablebase, TttBoard board, TttValue expected, long long *probes)
+{
+    const TttVariant *variant = GetTttTablebaseVariant(tablebase);
+
+    for (int ply = 0; GetTttWinner(variant, &board) == TTT_NONE; ply++)
+    {
+        TttValue value;
+        int move = GetTttTablebaseMove(tablebase, &board, &value);
+        (*probes)++;
+        if ((move == TTT_NONE) || (value != expected)) return false;
+
+        PlayTttMove(&board, move);
+        expected = (expected == TTT_VALUE_WIN)? TTT_VALUE_LOSS : (expected == TTT_VALUE_LOSS)? TTT_VALUE_WIN : TTT_VALUE_DRAW;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Program Entry Point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int threads = 0;
+    bool verify = false;
+    const char *positional[2] = { NULL, NULL };
+    int positionalCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--verify") == 0) verify = true;
+        else if (positionalCount < 2) positional[positionalCount++] = argv[i];
+        else positionalCount = 3;
+    }
+
+    const TttVariant *variant = (positionalCount == 2)? FindTttVariant(positional[0]) : NULL;
+    if (variant == NULL)
+    {
+        fprintf(stderr, "usage: ttt-tbgen [--threads T] [--verify] <3x3|4x4> <output.tb>\n");
+        return 1;
+    }
+
+    printf("ttt-tbgen: solving %s into %s\n", variant->name, positional[1]);
+    if (!GenerateTttTablebase(variant, positional[1], threads, PrintProgress))
+    {
+        fprintf(stderr, "ttt-tbgen: generation failed (%s cannot be tablebased, or the file could not be written)\n", variant->name);
+        return 1;
+    }
+
+    TttTablebase *tablebase = LoadTttTablebase(positional[1]);
+    if (tablebase == NULL)
+    {
+        fprintf(stderr, "ttt-tbgen: %s does not load back\n", positional[1]);
+        return 1;
+    }
+
+    TttBoard empty = { { 0, 0 }, 0 };
+    TttValue value = ProbeTttTablebase(tablebase, &empty);
+    printf("ttt-tbgen: %s is a %s for the first player\n", variant->name, (value == TTT_VALUE_WIN)? "win" : (value == TTT_VALUE_LOSS)? "loss" : "draw");
+
+    bool ok = true;
+    if (verify)
+    {
+        // Every first move, then perfect play from there
+        long long probes = 0;
+        for (int cell = 0; ok && (cell < variant->cells); cell++)
+        {
+            TttBoard board = empty;
+            PlayTttMove(&board, cell);
+            ok = VerifyLine(tablebase, board, ProbeTttTablebase(tablebase, &board), &probes);
+        }
+        ok = ok && VerifyLine(tablebase, empty, value, &probes);
+        printf("ttt-tbgen: verify %s (%lld probes)\n", ok? "passed" : "FAILED", probes);
+    }
+
+    UnloadTttTablebase(tablebase);
+    return ok? 0 : 1;
+}